@@ -0,0 +1,176 @@
+#include <new>
+#include "AllocTracker.h"
+
+std::atomic< uint32_t > AllocTracker::m_allocations( 0 );
+std::atomic< uint32_t > AllocTracker::m_frees( 0 );
+std::atomic< int32_t >  AllocTracker::m_live_max( 0 );
+std::atomic< uint32_t > AllocTracker::m_hot_path_allocations( 0 );
+
+// Per task, so another task allocating while the hot path is preempted isn't counted against it.
+static thread_local int s_hot_path_depth = 0;
+
+void AllocTracker::EnterHotPath() {
+  s_hot_path_depth++;
+}
+
+void AllocTracker::LeaveHotPath() {
+  s_hot_path_depth--;
+}
+
+unsigned long AllocTracker::GetAllocationCount() {
+  return m_allocations.load( std::memory_order_relaxed );
+}
+
+unsigned long AllocTracker::GetFreeCount() {
+  return m_frees.load( std::memory_order_relaxed );
+}
+
+long AllocTracker::GetLiveCount() {
+  return (int32_t)( m_allocations.load( std::memory_order_relaxed ) - m_frees.load( std::memory_order_relaxed ) );
+}
+
+long AllocTracker::GetLiveCountMax() {
+  return m_live_max.load( std::memory_order_relaxed );
+}
+
+unsigned long AllocTracker::GetHotPathAllocationCount() {
+  return m_hot_path_allocations.load( std::memory_order_relaxed );
+}
+
+void AllocTracker::ResetStats() {
+  m_hot_path_allocations = 0;
+  m_live_max             = AllocTracker::GetLiveCount();
+}
+
+void* AllocTracker::Allocate( size_t size ) {
+  void* ptr = malloc( size == 0 ? 1 : size );
+#if !ALLOC_TRACKER_COUNTS_MALLOC
+  if( ptr != nullptr ) {
+    AllocTracker::CountAllocation();
+  }
+#endif
+  return ptr;
+}
+
+void AllocTracker::Free( void* ptr ) {
+#if !ALLOC_TRACKER_COUNTS_MALLOC
+  if( ptr != nullptr ) {
+    AllocTracker::CountFree();
+  }
+#endif
+  free( ptr );
+}
+
+void IRAM_ATTR AllocTracker::CountAllocation() {
+  int32_t live = (int32_t)( m_allocations.fetch_add( 1, std::memory_order_relaxed ) + 1 - m_frees.load( std::memory_order_relaxed ) );
+  // A task preempted between the load & the store can lower the mark by a few, it's only a high water mark.
+  if( live > m_live_max.load( std::memory_order_relaxed ) ) {
+    m_live_max.store( live, std::memory_order_relaxed );
+  }
+  if( s_hot_path_depth > 0 ) {
+    m_hot_path_allocations.fetch_add( 1, std::memory_order_relaxed );
+  }
+}
+
+void IRAM_ATTR AllocTracker::CountFree() {
+  m_frees.fetch_add( 1, std::memory_order_relaxed );
+}
+
+#if defined( CONFIG_HEAP_USE_HOOKS ) && CONFIG_HEAP_USE_HOOKS
+// Called by heap_caps for every successful allocation & free, so malloc(), realloc() & the Arduino String are seen.
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook( void* ptr, size_t size, uint32_t caps ) {
+  AllocTracker::CountAllocation();
+}
+
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook( void* ptr ) {
+  AllocTracker::CountFree();
+}
+#elif defined( ALLOC_TRACKER_WRAP_MALLOC )
+// The linker sends every malloc() family call of the program here, & the library's own to __real_*().
+extern "C" {
+void* __real_malloc( size_t size );
+void* __real_calloc( size_t count, size_t size );
+void* __real_realloc( void* ptr, size_t size );
+void  __real_free( void* ptr );
+
+void* __wrap_malloc( size_t size ) {
+  void* ptr = __real_malloc( size );
+  if( ptr != nullptr ) {
+    AllocTracker::CountAllocation();
+  }
+  return ptr;
+}
+
+void* __wrap_calloc( size_t count, size_t size ) {
+  void* ptr = __real_calloc( count, size );
+  if( ptr != nullptr ) {
+    AllocTracker::CountAllocation();
+  }
+  return ptr;
+}
+
+void* __wrap_realloc( void* ptr, size_t size ) {
+  void* ptr_resized = __real_realloc( ptr, size );
+  if( ptr != nullptr && ( ptr_resized != nullptr || size == 0 ) ) {
+    AllocTracker::CountFree();
+  }
+  if( ptr_resized != nullptr ) {
+    AllocTracker::CountAllocation();
+  }
+  return ptr_resized;
+}
+
+void __wrap_free( void* ptr ) {
+  if( ptr != nullptr ) {
+    AllocTracker::CountFree();
+  }
+  __real_free( ptr );
+}
+}
+#endif
+
+// Replace the library's global operators, so every C++ allocation goes through the tracker.
+
+static void* AllocateOrFail( size_t size ) {
+  void* ptr = AllocTracker::Allocate( size );
+  if( ptr == nullptr ) {
+#if __cpp_exceptions
+    throw std::bad_alloc();
+#else
+    abort();
+#endif
+  }
+  return ptr;
+}
+
+void* operator new( size_t size ) {
+  return AllocateOrFail( size );
+}
+
+void* operator new[]( size_t size ) {
+  return AllocateOrFail( size );
+}
+
+void* operator new( size_t size, const std::nothrow_t& ) noexcept {
+  return AllocTracker::Allocate( size );
+}
+
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept {
+  return AllocTracker::Allocate( size );
+}
+
+void operator delete( void* ptr ) noexcept {
+  AllocTracker::Free( ptr );
+}
+
+void operator delete[]( void* ptr ) noexcept {
+  AllocTracker::Free( ptr );
+}
+
+void operator delete( void* ptr, size_t ) noexcept {
+  AllocTracker::Free( ptr );
+}
+
+void operator delete[]( void* ptr, size_t ) noexcept {
+  AllocTracker::Free( ptr );
+}
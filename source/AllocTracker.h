@@ -0,0 +1,52 @@
+#ifndef _ALLOCTRACKER_H_
+#define _ALLOCTRACKER_H_
+
+#include <Arduino.h>
+#include <atomic>
+
+// Where malloc() & realloc() can be seen as well: the ESP-IDF heap hooks (CONFIG_HEAP_USE_HOOKS), or on the host
+// a build with ALLOC_TRACKER_WRAP_MALLOC linked with -Wl,--wrap=malloc,--wrap=realloc,--wrap=calloc,--wrap=free.
+// operator new is then counted through malloc(), not twice.
+#if ( defined( CONFIG_HEAP_USE_HOOKS ) && CONFIG_HEAP_USE_HOOKS ) || defined( ALLOC_TRACKER_WRAP_MALLOC )
+#define ALLOC_TRACKER_COUNTS_MALLOC  1
+#else
+#define ALLOC_TRACKER_COUNTS_MALLOC  0
+#endif
+
+// Counts every allocation & free, & which allocations were made on the hot path: packet receive, parsing, merge,
+// mods, the DMX output & its stats.  After Start() the hot path must not allocate, so a long running node never
+// fragments or shrinks its heap.  Web requests & Start() allocate & free as they always have, they are not steady
+// state.  With ALLOC_TRACKER_COUNTS_MALLOC that includes malloc() & realloc(), e.g. an Arduino String growing,
+// otherwise only operator new & delete, which are replaced in AllocTracker.cpp.  Resizing a block with realloc()
+// counts as an allocation, even when it stays in place.
+class AllocTracker {
+public:
+  // Any task.  Calls may nest, allocations by the calling task are counted as hot path until the last Leave.
+  static void EnterHotPath();
+  static void LeaveHotPath();
+
+  static unsigned long GetAllocationCount();
+  static unsigned long GetFreeCount();
+  static long          GetLiveCount();
+  static long          GetLiveCountMax();            // High water mark of GetLiveCount().
+  static unsigned long GetHotPathAllocationCount();
+
+  // Hot path count & the high water mark.
+  static void ResetStats();
+
+  // operator new & delete.
+  static void* Allocate( size_t size );
+  static void  Free( void* ptr );
+
+  // From Allocate() & Free(), or the heap hooks & malloc() wrappers.  Any context.
+  static void IRAM_ATTR CountAllocation();
+  static void IRAM_ATTR CountFree();
+
+private:
+  static std::atomic< uint32_t > m_allocations;
+  static std::atomic< uint32_t > m_frees;
+  static std::atomic< int32_t >  m_live_max;
+  static std::atomic< uint32_t > m_hot_path_allocations;
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "ArtNetForwarder.h"
+
+ArtNetForwarder::ArtNetForwarder() {
+  this->Clear();
+}
+
+ArtNetForwarder::~ArtNetForwarder() {
+}
+
+void ArtNetForwarder::Clear() {
+  memset( m_targets, 0, sizeof( m_targets ) );
+  memset( m_frame, 0, sizeof( m_frame ) );
+  m_target_count     = 0;
+  m_length           = 0;
+  m_frame_count      = 0;
+  m_revision         = 0;
+  m_send_time_us_max = 0;
+}
+
+void ArtNetForwarder::ResetStats() {
+  for( int i = 0; i < m_target_count; i++ ) {
+    m_targets[ i ].m_sent         = 0;
+    m_targets[ i ].m_dropped_rate = 0;
+    m_targets[ i ].m_unchanged    = 0;
+    m_targets[ i ].m_send_failed  = 0;
+  }
+  m_send_time_us_max = 0;
+}
+
+bool ArtNetForwarder::AddTarget( uint32_t ip, uint16_t universe, int max_fps, bool change_only ) {
+  if( m_target_count >= ARTNET_FORWARD_TARGETS_MAX ) {
+    return false;
+  }
+
+  ArtNetForwardTarget& target = m_targets[ m_target_count++ ];
+  memset( &target, 0, sizeof( target ) );
+  target.m_ip          = ip;
+  target.m_universe    = universe & 0x7FFF;
+  target.m_interval_ms = ( max_fps > 0 ) ? 1000 / max_fps : 0;
+  target.m_change_only = change_only;
+
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)&target.m_header[ 0 ];
+  memcpy( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) );
+  ptr_header->m_OpCode = ARTNET_OPCODE_DMX;
+
+  ArtNetPacketDMX* ptr_packet_dmx = (ArtNetPacketDMX*)&target.m_header[ ARTNET_PACKET_PAYLOAD_START ];
+  ptr_packet_dmx->m_ProtocolLo = ARTNET_VERSION;
+  ptr_packet_dmx->m_SubUni     = target.m_universe & 0xFF;
+  ptr_packet_dmx->m_Net        = target.m_universe >> 8;
+
+  return true;
+}
+
+void ArtNetForwarder::SetFrame( const uint8_t* ptr_data, uint16_t length ) {
+  if( m_target_count == 0 ) {
+    return;
+  }
+  if( length > 512 ) {
+    length = 512;
+  }
+  // ArtDmx length must be even, 2 to 512.
+  uint16_t length_even = ( length + 1 ) & ~1;
+  if( length_even < 2 ) {
+    length_even = 2;
+  }
+
+  bool changed = ( length_even != m_length ) || ( memcmp( m_frame, ptr_data, length ) != 0 );
+
+  for( int i = 0; i < m_target_count; i++ ) {
+    ArtNetForwardTarget& target = m_targets[ i ];
+    if( target.m_change_only ) {
+      if( !changed ) {
+        target.m_unchanged++;
+      } else if( target.m_frame_sent != m_revision ) {
+        target.m_dropped_rate++;
+      }
+    } else if( target.m_frame_sent != m_frame_count ) {
+      target.m_dropped_rate++;
+    }
+  }
+
+  if( changed ) {
+    memcpy( m_frame, ptr_data, length );
+    if( length_even > length ) {
+      m_frame[ length ] = 0;
+    }
+    m_length = length_even;
+    m_revision++;
+  }
+  m_frame_count++;
+}
+
+void ArtNetForwarder::Update( UdpSocket& socket, unsigned long time_ms ) {
+  for( int i = 0; i < m_target_count; i++ ) {
+    ArtNetForwardTarget& target = m_targets[ i ];
+    if( !this->IsDue( target, time_ms ) ) {
+      continue;
+    }
+
+    this->PrepareHeader( target );
+
+    // Header & frame are sent as 2 parts of the one datagram, the frame is never copied into a packet.
+    unsigned long send_start_us = micros();
+    if( socket.SendTo( target.m_ip, ARTNET_UDP_PORT, target.m_header, sizeof( target.m_header ), m_frame, m_length ) ) {
+      target.m_sent++;
+    } else {
+      target.m_send_failed++;
+    }
+    unsigned long send_time_us = micros() - send_start_us;
+    if( send_time_us > m_send_time_us_max ) {
+      m_send_time_us_max = send_time_us;
+    }
+
+    target.m_sent_ms    = time_ms;
+    target.m_frame_sent = target.m_change_only ? m_revision : m_frame_count;
+  }
+}
+
+bool ArtNetForwarder::IsDue( const ArtNetForwardTarget& target, unsigned long time_ms ) const {
+  if( m_frame_count == 0 ) {
+    return false;
+  }
+
+  unsigned long since_sent_ms = time_ms - target.m_sent_ms;
+  if( target.m_sent != 0 && since_sent_ms < target.m_interval_ms ) {
+    return false;
+  }
+
+  if( target.m_change_only ) {
+    return target.m_frame_sent != m_revision || since_sent_ms >= ARTNET_FORWARD_KEEPALIVE_MS;
+  }
+  return target.m_frame_sent != m_frame_count;
+}
+
+void ArtNetForwarder::PrepareHeader( ArtNetForwardTarget& target ) {
+  target.m_sequence = ( target.m_sequence == 255 ) ? 1 : target.m_sequence + 1;
+
+  ArtNetPacketDMX* ptr_packet_dmx = (ArtNetPacketDMX*)&target.m_header[ ARTNET_PACKET_PAYLOAD_START ];
+  ptr_packet_dmx->m_Sequence = target.m_sequence;
+  ptr_packet_dmx->m_LengthHi = m_length >> 8;
+  ptr_packet_dmx->m_Length   = m_length & 0xFF;
+}
+
+int ArtNetForwarder::GetTargetCount() const {
+  return m_target_count;
+}
+
+const ArtNetForwardTarget& ArtNetForwarder::GetTarget( int index ) const {
+  return m_targets[ index ];
+}
+
+unsigned long ArtNetForwarder::GetSendTimeUsMax() const {
+  return m_send_time_us_max;
+}
+
+unsigned long ArtNetForwarder::Benchmark( int iterations ) {
+  // Uses the targets as scratch, so only run before any are added.
+  this->Clear();
+  for( int i = 0; i < ARTNET_FORWARD_TARGETS_MAX; i++ ) {
+    this->AddTarget( 0, i, 0, ( i & 1 ) != 0 );
+  }
+
+  uint8_t frame[ 512 ];
+  memset( frame, 0, sizeof( frame ) );
+
+  unsigned long start_us = micros();
+  for( int i = 0; i < iterations; i++ ) {
+    // Last channel changes, so the whole frame is compared & copied.
+    frame[ 511 ] = i;
+    this->SetFrame( frame, sizeof( frame ) );
+    for( int target = 0; target < m_target_count; target++ ) {
+      this->PrepareHeader( m_targets[ target ] );
+      m_targets[ target ].m_frame_sent = m_targets[ target ].m_change_only ? m_revision : m_frame_count;
+    }
+  }
+  unsigned long elapsed_us = micros() - start_us;
+
+  this->Clear();
+
+  return ( elapsed_us * 1000UL ) / iterations;
+}
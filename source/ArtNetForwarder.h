@@ -0,0 +1,72 @@
+#ifndef _ARTNETFORWARDER_H_
+#define _ARTNETFORWARDER_H_
+
+#include <Arduino.h>
+#include "ArtNet_Spec.h"
+#include "UdpSocket.h"
+
+#define ARTNET_FORWARD_TARGETS_MAX   4
+#define ARTNET_FORWARD_KEEPALIVE_MS  1000  // Change only targets still get the frame this often, so they don't time out.
+
+struct ArtNetForwardTarget {
+  uint32_t      m_ip;                 // Network order.
+  uint16_t      m_universe;
+  unsigned long m_interval_ms;        // From the max frame rate, 0 = every frame.
+  bool          m_change_only;
+  unsigned long m_sent_ms;
+  unsigned long m_frame_sent;         // m_frame_count or m_revision when last sent.
+  uint8_t       m_sequence;
+  uint8_t       m_header[ ARTNET_PACKET_DMX_DATA_START ];  // Built once, only sequence & length change.
+
+  // Stats
+  unsigned long m_sent;
+  unsigned long m_dropped_rate;       // Replaced by a newer frame before the rate limit allowed sending.
+  unsigned long m_unchanged;          // Not sent, same as the last frame.
+  unsigned long m_send_failed;
+};
+
+// Re-transmits the processed DMX output as ArtDmx to unicast targets, each on its own universe.
+class ArtNetForwarder {
+public:
+  ArtNetForwarder();
+
+  ~ArtNetForwarder();
+
+  void Clear();
+
+  void ResetStats();
+
+  // max_fps 0 = no limit.  Returns false if there are already ARTNET_FORWARD_TARGETS_MAX targets.
+  bool AddTarget( uint32_t ip, uint16_t universe, int max_fps, bool change_only );
+
+  // Keeps a copy of the frame, only if it changed.  Frames are sent from this copy by Update().
+  void SetFrame( const uint8_t* ptr_data, uint16_t length );
+
+  // Sends the frame to every target that is due.
+  void Update( UdpSocket& socket, unsigned long time_ms );
+
+  int  GetTargetCount() const;
+
+  const ArtNetForwardTarget& GetTarget( int index ) const;
+
+  unsigned long GetSendTimeUsMax() const;
+
+  // Times SetFrame() with a changed frame & the header preparation for ARTNET_FORWARD_TARGETS_MAX targets,
+  // without the socket.  Returns nanoseconds per frame.
+  unsigned long Benchmark( int iterations );
+
+private:
+  bool IsDue( const ArtNetForwardTarget& target, unsigned long time_ms ) const;
+
+  void PrepareHeader( ArtNetForwardTarget& target );
+
+  ArtNetForwardTarget m_targets[ ARTNET_FORWARD_TARGETS_MAX ];
+  int                 m_target_count;
+  uint8_t             m_frame[ 512 ];
+  uint16_t            m_length;         // Even, as ArtDmx requires.
+  unsigned long       m_frame_count;    // Every SetFrame().
+  unsigned long       m_revision;       // SetFrame() with a changed frame.
+  unsigned long       m_send_time_us_max;
+};
+
+#endif
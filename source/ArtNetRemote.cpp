@@ -0,0 +1,277 @@
+#include "ArtNetRemote.h"
+
+ArtNetRemote::ArtNetRemote() {
+  this->Clear();
+  this->ResetStats();
+}
+
+ArtNetRemote::~ArtNetRemote() {
+}
+
+void ArtNetRemote::Clear() {
+  memset( &m_changes, 0, sizeof( m_changes ) );
+  m_changes.m_universe   = -1;
+  m_changes.m_merge_mode = -1;
+  m_changes.m_indicator  = -1;
+  m_has_changes          = false;
+}
+
+void ArtNetRemote::ResetStats() {
+  m_address_count = 0;
+  m_command_count = 0;
+  m_ip_prog_count = 0;
+  m_rejected      = 0;
+  m_ignored       = 0;
+  m_applied       = 0;
+  m_apply_us_last = 0;
+  m_apply_us_max  = 0;
+}
+
+bool ArtNetRemote::HandleAddress( const ArtNetPacketAddress* ptr_packet, int packet_size_in_bytes, uint16_t universe, bool dmx_input, uint32_t source_ip ) {
+  // Only the root device, there is a single port.
+  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_ADDRESS || ptr_packet->m_BindIndex > 1 ) {
+    m_ignored++;
+    return false;
+  }
+  m_address_count++;
+
+  // On top of any change that hasn't been applied yet.
+  if( m_changes.m_universe >= 0 ) {
+    universe = m_changes.m_universe;
+  }
+  uint16_t universe_new = universe;
+  if( ptr_packet->m_NetSwitch & ARTNET_ADDRESS_PROGRAM ) {
+    universe_new = ( universe_new & 0x00FF ) | ( ( ptr_packet->m_NetSwitch & 0x7F ) << 8 );
+  }
+  if( ptr_packet->m_SubSwitch & ARTNET_ADDRESS_PROGRAM ) {
+    universe_new = ( universe_new & 0x7F0F ) | ( ( ptr_packet->m_SubSwitch & 0x0F ) << 4 );
+  }
+  uint8_t port_switch = dmx_input ? ptr_packet->m_SwIn[ 0 ] : ptr_packet->m_SwOut[ 0 ];
+  if( port_switch & ARTNET_ADDRESS_PROGRAM ) {
+    universe_new = ( universe_new & 0x7FF0 ) | ( port_switch & 0x0F );
+  }
+  if( universe_new != universe ) {
+    m_changes.m_universe = universe_new;
+  }
+
+  if( ptr_packet->m_PortName[ 0 ] != 0 ) {
+    ArtNetRemote::CopyName( m_changes.m_short_name, sizeof( m_changes.m_short_name ), ptr_packet->m_PortName, sizeof( ptr_packet->m_PortName ) );
+  }
+  if( ptr_packet->m_LongName[ 0 ] != 0 ) {
+    ArtNetRemote::CopyName( m_changes.m_long_name, sizeof( m_changes.m_long_name ), ptr_packet->m_LongName, sizeof( ptr_packet->m_LongName ) );
+  }
+
+  switch( ptr_packet->m_Command ) {
+    case ARTNET_AC_NONE:
+    case ARTNET_AC_RESET_RX_FLAGS: {
+      break;
+    }
+    case ARTNET_AC_CANCEL_MERGE: {
+      m_changes.m_cancel_merge = true;
+      break;
+    }
+    case ARTNET_AC_LED_NORMAL: {
+      m_changes.m_indicator = ARTNETINDICATOR::INDICATOR_NORMAL;
+      break;
+    }
+    case ARTNET_AC_LED_MUTE: {
+      m_changes.m_indicator = ARTNETINDICATOR::INDICATOR_MUTE;
+      break;
+    }
+    case ARTNET_AC_LED_LOCATE: {
+      m_changes.m_indicator = ARTNETINDICATOR::INDICATOR_LOCATE;
+      break;
+    }
+    case ARTNET_AC_MERGE_LTP_0: {
+      m_changes.m_merge_mode = MERGEMODE::LTP;
+      break;
+    }
+    case ARTNET_AC_MERGE_HTP_0: {
+      m_changes.m_merge_mode = MERGEMODE::HTP;
+      break;
+    }
+    case ARTNET_AC_CLEAR_OP_0: {
+      m_changes.m_clear_output = true;
+      break;
+    }
+    default: {
+      // Fail-over, protocol & direction commands aren't supported, the rest of the packet still is.
+      m_ignored++;
+      break;
+    }
+  }
+
+  // The controller is told the result with an ArtPollReply, even if nothing changed.
+  m_changes.m_poll_reply    = true;
+  m_changes.m_poll_reply_ip = source_ip;
+  m_has_changes             = true;
+  return true;
+}
+
+bool ArtNetRemote::HandleCommand( const ArtNetPacketCommand* ptr_packet, int packet_size_in_bytes, uint32_t source_ip ) {
+  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_COMMAND ) {
+    m_ignored++;
+    return false;
+  }
+  uint16_t esta_man = ptr_packet->m_EstaManLo | ptr_packet->m_EstaManHi << 8;
+  if( esta_man != ARTNET_ESTA_MAN && esta_man != ARTNET_ESTA_MAN_ALL ) {
+    // For another manufacturer's nodes.
+    return false;
+  }
+  m_command_count++;
+
+  int length = ptr_packet->m_Length | ptr_packet->m_LengthHi << 8;
+  int length_max = packet_size_in_bytes - ARTNET_PACKET_MINSIZE_COMMAND;
+  if( length > length_max ) {
+    length = length_max;
+  }
+  if( length > ARTNET_COMMAND_DATA_LENGTH ) {
+    length = ARTNET_COMMAND_DATA_LENGTH;
+  }
+  const char* ptr_text = (const char*)ptr_packet->m_Data;
+  length = strnlen( ptr_text, length );
+
+  bool handled = false;
+  int  position = 0;
+  while( position < length ) {
+    int end = position;
+    while( end < length && ptr_text[ end ] != '&' ) {
+      end++;
+    }
+    int equals = position;
+    while( equals < end && ptr_text[ equals ] != '=' ) {
+      equals++;
+    }
+    if( end > position ) {
+      int value_start = ( equals < end ) ? equals + 1 : end;
+      if( this->HandleCommandPair( &ptr_text[ position ], equals - position, &ptr_text[ value_start ], end - value_start ) ) {
+        handled = true;
+      } else {
+        m_ignored++;
+      }
+    }
+    position = end + 1;
+  }
+
+  if( handled ) {
+    m_changes.m_poll_reply    = true;
+    m_changes.m_poll_reply_ip = source_ip;
+    m_has_changes             = true;
+  }
+  return handled;
+}
+
+bool ArtNetRemote::HandleCommandPair( const char* ptr_command, int command_length, const char* ptr_value, int value_length ) {
+  char value[ ARTNET_LONG_NAME_LENGTH ];
+  int  copy_length = min( value_length, (int)sizeof( value ) - 1 );
+  memcpy( value, ptr_value, copy_length );
+  value[ copy_length ] = 0;
+
+  if( ArtNetRemote::IsCommand( ptr_command, command_length, "Universe" ) ) {
+    char* ptr_end;
+    long  universe = strtol( value, &ptr_end, 10 );
+    if( copy_length == 0 || *ptr_end != 0 || universe < 0 || universe > ARTNET_REMOTE_UNIVERSE_MAX ) {
+      return false;
+    }
+    m_changes.m_universe = universe;
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "ShortName" ) && copy_length > 0 ) {
+    strlcpy( m_changes.m_short_name, value, sizeof( m_changes.m_short_name ) );
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "LongName" ) && copy_length > 0 ) {
+    strlcpy( m_changes.m_long_name, value, sizeof( m_changes.m_long_name ) );
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "MergeMode" ) && strcasecmp( value, "HTP" ) == 0 ) {
+    m_changes.m_merge_mode = MERGEMODE::HTP;
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "MergeMode" ) && strcasecmp( value, "LTP" ) == 0 ) {
+    m_changes.m_merge_mode = MERGEMODE::LTP;
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "CancelMerge" ) ) {
+    m_changes.m_cancel_merge = true;
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "Locate" ) && strcasecmp( value, "On" ) == 0 ) {
+    m_changes.m_indicator = ARTNETINDICATOR::INDICATOR_LOCATE;
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "Locate" ) && strcasecmp( value, "Off" ) == 0 ) {
+    m_changes.m_indicator = ARTNETINDICATOR::INDICATOR_NORMAL;
+  } else if( ArtNetRemote::IsCommand( ptr_command, command_length, "ClearOutput" ) ) {
+    m_changes.m_clear_output = true;
+  } else {
+    // Includes SwoutText & SwinText, there is no playback text to show.
+    return false;
+  }
+  return true;
+}
+
+bool ArtNetRemote::HandleIpProg( const ArtNetPacketIpProg* ptr_packet, int packet_size_in_bytes, uint32_t source_ip ) {
+  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_IPPROG ) {
+    m_ignored++;
+    return false;
+  }
+  m_ip_prog_count++;
+
+  m_changes.m_ip_prog          = true;
+  m_changes.m_ip_prog_reply_ip = source_ip;
+  m_changes.m_ip_prog_command  = ptr_packet->m_Command;
+  memcpy( m_changes.m_ip_prog_ip, ptr_packet->m_ProgIp, sizeof( m_changes.m_ip_prog_ip ) );
+  memcpy( m_changes.m_ip_prog_subnet, ptr_packet->m_ProgSm, sizeof( m_changes.m_ip_prog_subnet ) );
+  m_has_changes = true;
+  return true;
+}
+
+void ArtNetRemote::Reject() {
+  m_rejected++;
+}
+
+bool ArtNetRemote::HasChanges() const {
+  return m_has_changes;
+}
+
+const ArtNetRemoteChanges& ArtNetRemote::GetChanges() const {
+  return m_changes;
+}
+
+void ArtNetRemote::Applied( unsigned long apply_us ) {
+  this->Clear();
+  m_applied++;
+  m_apply_us_last = apply_us;
+  if( apply_us > m_apply_us_max ) {
+    m_apply_us_max = apply_us;
+  }
+}
+
+unsigned long ArtNetRemote::GetAddressCount() const {
+  return m_address_count;
+}
+
+unsigned long ArtNetRemote::GetCommandCount() const {
+  return m_command_count;
+}
+
+unsigned long ArtNetRemote::GetIpProgCount() const {
+  return m_ip_prog_count;
+}
+
+unsigned long ArtNetRemote::GetRejectedCount() const {
+  return m_rejected;
+}
+
+unsigned long ArtNetRemote::GetIgnoredCount() const {
+  return m_ignored;
+}
+
+unsigned long ArtNetRemote::GetAppliedCount() const {
+  return m_applied;
+}
+
+unsigned long ArtNetRemote::GetApplyUsLast() const {
+  return m_apply_us_last;
+}
+
+unsigned long ArtNetRemote::GetApplyUsMax() const {
+  return m_apply_us_max;
+}
+
+bool ArtNetRemote::IsCommand( const char* ptr_command, int command_length, const char* ptr_name ) {
+  return (int)strlen( ptr_name ) == command_length && strncasecmp( ptr_command, ptr_name, command_length ) == 0;
+}
+
+void ArtNetRemote::CopyName( char* ptr_destination, int destination_size, const uint8_t* ptr_source, int source_length ) {
+  int length = strnlen( (const char*)ptr_source, min( source_length, destination_size - 1 ) );
+  memcpy( ptr_destination, ptr_source, length );
+  ptr_destination[ length ] = 0;
+}
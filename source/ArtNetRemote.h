@@ -0,0 +1,110 @@
+#ifndef _ARTNETREMOTE_H_
+#define _ARTNETREMOTE_H_
+
+#include <Arduino.h>
+#include "ArtNet_Spec.h"
+#include "SourceMerger.h"
+
+#define ARTNET_REMOTE_UNIVERSE_MAX  32767   // 15 bit Port-Address.
+
+enum ARTNETINDICATOR : int {
+  INDICATOR_NORMAL = 0,
+  INDICATOR_MUTE   = 1,
+  INDICATOR_LOCATE = 2,   // Identify, the built in LED blinks.
+};
+
+inline const char* IndicatorAsString( int indicator ) {
+  switch( indicator ) {
+    case INDICATOR_NORMAL: return "normal";
+    case INDICATOR_MUTE:   return "mute";
+    case INDICATOR_LOCATE: return "locate";
+    default:               return "unknown";
+  }
+};
+
+// What controllers asked for since the engine last applied the changes.  -1 or an empty name = unchanged.
+struct ArtNetRemoteChanges {
+  int      m_universe;
+  char     m_short_name[ ARTNET_SHORT_NAME_LENGTH ];
+  char     m_long_name[ ARTNET_LONG_NAME_LENGTH ];
+  int      m_merge_mode;                   // MERGEMODE
+  bool     m_cancel_merge;
+  int      m_indicator;                    // ARTNETINDICATOR
+  bool     m_clear_output;
+  bool     m_poll_reply;                   // ArtPollReply to m_poll_reply_ip, once applied.
+  uint32_t m_poll_reply_ip;
+
+  // ArtIpProg, the last one received.
+  bool     m_ip_prog;                      // ArtIpProgReply to m_ip_prog_reply_ip, once applied.
+  uint32_t m_ip_prog_reply_ip;
+  uint8_t  m_ip_prog_command;              // ARTNET_IPPROG_* bits, without ARTNET_IPPROG_ENABLE nothing is programmed.
+  uint8_t  m_ip_prog_ip[ 4 ];
+  uint8_t  m_ip_prog_subnet[ 4 ];
+};
+
+// Parses ArtAddress, ArtCommand & ArtIpProg from the packet path into changes, without allocating.  The engine applies
+// them from loop() between frames, so a controller can repatch or rename the node without restarting the DMX output.
+//
+// ArtCommand text is "Command=Value&..", commands are not case sensitive:
+//   Universe=<0-32767>, ShortName=<text>, LongName=<text>, MergeMode=HTP|LTP, CancelMerge, Locate=On|Off, ClearOutput
+class ArtNetRemote {
+public:
+  ArtNetRemote();
+
+  ~ArtNetRemote();
+
+  // Drops the pending changes.
+  void Clear();
+
+  void ResetStats();
+
+  // universe is the current Port-Address, switches that aren't programmed keep its bits.  Returns false if ignored.
+  bool HandleAddress( const ArtNetPacketAddress* ptr_packet, int packet_size_in_bytes, uint16_t universe, bool dmx_input, uint32_t source_ip );
+
+  bool HandleCommand( const ArtNetPacketCommand* ptr_packet, int packet_size_in_bytes, uint32_t source_ip );
+
+  bool HandleIpProg( const ArtNetPacketIpProg* ptr_packet, int packet_size_in_bytes, uint32_t source_ip );
+
+  // From a source that isn't allowed, or remote config is off.
+  void Reject();
+
+  bool HasChanges() const;
+
+  const ArtNetRemoteChanges& GetChanges() const;
+
+  // The engine has applied the changes, clears them.
+  void Applied( unsigned long apply_us );
+
+  unsigned long GetAddressCount() const;
+  unsigned long GetCommandCount() const;
+  unsigned long GetIpProgCount() const;
+  unsigned long GetRejectedCount() const;
+  unsigned long GetIgnoredCount() const;       // Invalid packets & unknown commands.
+  unsigned long GetAppliedCount() const;
+  unsigned long GetApplyUsLast() const;
+  unsigned long GetApplyUsMax() const;
+
+private:
+  // One "Command=Value", value is empty if there was no '='.  Returns false if unknown.
+  bool HandleCommandPair( const char* ptr_command, int command_length, const char* ptr_value, int value_length );
+
+  static bool IsCommand( const char* ptr_command, int command_length, const char* ptr_name );
+
+  // Copies a name that may fill its field without a null.
+  static void CopyName( char* ptr_destination, int destination_size, const uint8_t* ptr_source, int source_length );
+
+  ArtNetRemoteChanges m_changes;
+  bool                m_has_changes;
+
+  // Stats
+  unsigned long       m_address_count;
+  unsigned long       m_command_count;
+  unsigned long       m_ip_prog_count;
+  unsigned long       m_rejected;
+  unsigned long       m_ignored;
+  unsigned long       m_applied;
+  unsigned long       m_apply_us_last;
+  unsigned long       m_apply_us_max;
+};
+
+#endif
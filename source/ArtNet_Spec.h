@@ -10,6 +10,8 @@
 //    Art-Net Packet DMX (Standard dmx packet structure)
 //    Art-Net Packet Poll
 //    Art-Net Packet Poll Reply
+//    Art-Net Packet Sync
+//    Art-Net Packet Address, Command, IpProg & IpProgReply
 
 #define ARTNET_HEADER_ID        "Art-Net"
 #define ARTNET_VERSION          14
@@ -17,13 +19,89 @@
 #define ARTNET_OPCODE_POLL      0x2000
 #define ARTNET_OPCODE_POLLREPLY 0x2100
 #define ARTNET_OPCODE_DMX       0x5000
+#define ARTNET_OPCODE_SYNC      0x5200
+#define ARTNET_OPCODE_ADDRESS   0x6000
+#define ARTNET_OPCODE_COMMAND   0x2400
+#define ARTNET_OPCODE_IPPROG    0xF800
+#define ARTNET_OPCODE_IPPROGREPLY 0xF900
+#define ARTNET_OPCODE_TIMECODE  0x9700
 
 #define ARTNET_PACKET_MINSIZE_HEADER    10
 #define ARTNET_PACKET_MINSIZE_DMX       21
 #define ARTNET_PACKET_MINSIZE_POLL      14
+#define ARTNET_PACKET_MINSIZE_POLL_TARGETED 22
 #define ARTNET_PACKET_MINSIZE_POLLREPLY 207
+#define ARTNET_PACKET_MINSIZE_SYNC      14
+#define ARTNET_PACKET_MINSIZE_ADDRESS   107
+#define ARTNET_PACKET_MINSIZE_COMMAND   16    // Header & fields before the data.
+#define ARTNET_PACKET_MINSIZE_IPPROG    34
+#define ARTNET_PACKET_MINSIZE_TIMECODE  19
 #define ARTNET_PACKET_MAXSIZE           530   // DMX = 10 for header + 8 packet info + 512 dmx data. To Check: Any other packets go larger?
 #define ARTNET_PACKET_PAYLOAD_START     10
+#define ARTNET_PACKET_HEADER_PEEK_SIZE  18    // Header + ArtDmx fields before the data, enough to decide if a packet is wanted.
+#define ARTNET_PACKET_DMX_DATA_START    18    // m_Data of ArtDmx from the start of the packet.
+
+#define ARTNET_POLL_FLAG_TARGETED       0x20  // Only reply if a port address is within the target range.
+
+#define ARTNET_PORTTYPE_OUTPUT_DMX      0x80  // Port can output DMX512 from the network.
+#define ARTNET_PORTTYPE_INPUT_DMX       0x40  // Port can input DMX512 onto the network.
+#define ARTNET_GOODOUTPUTA_DATA         0x80  // DMX is being output.
+#define ARTNET_GOODINPUT_DATA           0x80  // DMX is being received.
+#define ARTNET_GOODINPUT_ERRORS         0x04  // Receive errors detected.
+#define ARTNET_GOODOUTPUTB_RDM_DISABLED 0x80
+#define ARTNET_GOODOUTPUTB_CONTINUOUS   0x40  // Output is continuous, not delta.
+#define ARTNET_GOODOUTPUTA_MERGING      0x08  // Output is merging more than one source.
+#define ARTNET_GOODOUTPUTA_MERGE_LTP    0x02  // Merge mode is LTP, otherwise HTP.
+#define ARTNET_STATUS1_INDICATOR_MASK   0xC0
+#define ARTNET_STATUS1_INDICATOR_NORMAL 0xC0
+#define ARTNET_STATUS1_INDICATOR_MUTE   0x80
+#define ARTNET_STATUS1_INDICATOR_LOCATE 0x40  // Identify.
+#define ARTNET_STATUS1_PORTADDR_PANEL   0x10  // Port-Address set from the device, here the web config.
+#define ARTNET_STATUS2_WEB_CONFIG       0x01
+#define ARTNET_STATUS2_DHCP_USED        0x02
+#define ARTNET_STATUS2_DHCP_CAPABLE     0x04
+#define ARTNET_STATUS2_PORTADDR_15BIT   0x08
+#define ARTNET_STYLE_NODE               0x00
+#define ARTNET_OEM_UNKNOWN              0x00FF
+#define ARTNET_SHORT_NAME_LENGTH        18
+#define ARTNET_LONG_NAME_LENGTH         64
+#define ARTNET_NODE_REPORT_LENGTH       64
+#define ARTNET_ESTA_MAN                 0x0000  // Sent in ArtPollReply, no code is registered for this node.
+#define ARTNET_ESTA_MAN_ALL             0xFFFF  // ArtCommand for every manufacturer.
+#define ARTNET_COMMAND_DATA_LENGTH      512
+
+// ArtAddress fields, a switch is only programmed with bit 7 set.  0x7F leaves it as it is.
+#define ARTNET_ADDRESS_PROGRAM          0x80
+#define ARTNET_ADDRESS_NO_CHANGE        0x7F
+
+// ArtAddress commands for port 0 of the bind index.
+#define ARTNET_AC_NONE                  0x00
+#define ARTNET_AC_CANCEL_MERGE          0x01  // The next ArtDmx received ends the merge, its source is then the only one.
+#define ARTNET_AC_LED_NORMAL            0x02
+#define ARTNET_AC_LED_MUTE              0x03
+#define ARTNET_AC_LED_LOCATE            0x04
+#define ARTNET_AC_RESET_RX_FLAGS        0x05
+#define ARTNET_AC_MERGE_LTP_0           0x10
+#define ARTNET_AC_MERGE_HTP_0           0x50
+#define ARTNET_AC_CLEAR_OP_0            0x90  // Output buffer of the port to 0.
+
+// ArtIpProg command bits.
+#define ARTNET_IPPROG_ENABLE            0x80  // Without it the packet is only a request for the settings.
+#define ARTNET_IPPROG_DHCP              0x40
+#define ARTNET_IPPROG_GATEWAY           0x10
+#define ARTNET_IPPROG_RESET             0x08  // IP, subnet & port back to their defaults.
+#define ARTNET_IPPROG_IP                0x04
+#define ARTNET_IPPROG_SUBNET            0x02
+#define ARTNET_IPPROG_PORT              0x01
+#define ARTNET_IPPROGREPLY_STATUS_DHCP  0x40
+
+// ArtTimeCode types, the frame rate.
+#define ARTNET_TIMECODE_FILM            0     // 24 fps
+#define ARTNET_TIMECODE_EBU             1     // 25 fps
+#define ARTNET_TIMECODE_DF              2     // 29.97 fps drop frame
+#define ARTNET_TIMECODE_SMPTE           3     // 30 fps
+
+#define ARTNET_SYNC_TIMEOUT_MS          4000  // No ArtSync for this long returns the node to immediate output.
 
 #pragma pack( push, 1 ) // Set packing alignment to 1 byte
 
@@ -54,6 +132,10 @@ typedef struct ArtNetPacketPoll
   uint8_t m_ProtocolLo;         //  4: Low byte of the Art-Net protocol revision number.
   uint8_t m_Flags;              //  5: 0x00 - Disable receiving diagnostics, etc & only send ArtPollReply in response to an ArtPoll.
   uint8_t m_DiagPriority;       //  6: 0x10 Low priority message.
+  uint8_t m_TargetPortAddressTopHi;     //  7: Top of the range of Port-Addresses to be tested if in Targeted Mode.
+  uint8_t m_TargetPortAddressTopLo;     //  8:
+  uint8_t m_TargetPortAddressBottomHi;  //  9: Bottom of the range of Port-Addresses to be tested if in Targeted Mode.
+  uint8_t m_TargetPortAddressBottomLo;  // 10:
 } __attribute__( ( packed ) ) ArtNetPacketPoll;
 
 // Consumers of ArtPollReply shall accept as valid a packet of length 207 bytes or larger.
@@ -95,9 +177,102 @@ typedef struct ArtNetPacketPollReply
   uint8_t  m_MAC_4;             // 35:
   uint8_t  m_MAC_5;             // 36:
   uint8_t  m_MAC_6_Lo;          // 37:
-
+  uint8_t  m_BindIp[ 4 ];       // 38: IP of the root device when a node has multiple bound IPs.
+  uint8_t  m_BindIndex;         // 39: Order of bound devices, 1 = root device.
+  uint8_t  m_Status2;           // 40:
+  uint8_t  m_GoodOutputB[ 4 ];  // 41:
+  uint8_t  m_Status3;           // 42:
+  uint8_t  m_DefaultRespUID[ 6 ]; // 43: RDMnet & LLRP default responder UID.
+  uint8_t  m_UserHi;            // 44:
+  uint8_t  m_UserLo;            // 45:
+  uint8_t  m_RefreshRateHi;     // 46: Maximum refresh rate in Hz, 0 = up to 44Hz.
+  uint8_t  m_RefreshRateLo;     // 47:
+  uint8_t  m_Filler[ 11 ];      // 48: Transmit as zero.
 } __attribute__( ( packed ) ) ArtNetPacketPollReply;
 
+// ArtSync tells all nodes to output the last received ArtDmx at the same time.
+typedef struct ArtNetPacketSync
+{
+  uint8_t m_ProtocolHi;         //  3: High byte of the Art-Net protocol revision number.
+  uint8_t m_ProtocolLo;         //  4: Low byte of the Art-Net protocol revision number.
+  uint8_t m_Aux1;               //  5: Transmit as zero.
+  uint8_t m_Aux2;               //  6: Transmit as zero.
+} __attribute__( ( packed ) ) ArtNetPacketSync;
+
+// ArtAddress programs the node's Port-Address, names & merge from a controller.
+typedef struct ArtNetPacketAddress
+{
+  uint8_t m_ProtocolHi;         //  3: High byte of the Art-Net protocol revision number.
+  uint8_t m_ProtocolLo;         //  4: Low byte of the Art-Net protocol revision number.
+  uint8_t m_NetSwitch;          //  5: Bits 14-8 of the Port-Address, when bit 7 is set.
+  uint8_t m_BindIndex;          //  6: Which bound node, 0 or 1 for the root device.
+  uint8_t m_PortName[ 18 ];     //  7: Short name, ignored if empty.
+  uint8_t m_LongName[ 64 ];     //  8: Long name, ignored if empty.
+  uint8_t m_SwIn[ 4 ];          //  9: Bits 3-0 of the input Port-Address, when bit 7 is set.
+  uint8_t m_SwOut[ 4 ];         // 10: Bits 3-0 of the output Port-Address, when bit 7 is set.
+  uint8_t m_SubSwitch;          // 11: Bits 7-4 of the Port-Address, when bit 7 is set.
+  uint8_t m_AcnPriority;        // 12: sACN priority for sACN sent by the node, 255 = no change.
+  uint8_t m_Command;            // 13: ARTNET_AC_*
+} __attribute__( ( packed ) ) ArtNetPacketAddress;
+
+// ArtCommand, text commands as "Command=Value&".
+typedef struct ArtNetPacketCommand
+{
+  uint8_t m_ProtocolHi;         //  3: High byte of the Art-Net protocol revision number.
+  uint8_t m_ProtocolLo;         //  4: Low byte of the Art-Net protocol revision number.
+  uint8_t m_EstaManHi;          //  5: ESTA code of the manufacturer the commands are for, 0xFFFF for all.
+  uint8_t m_EstaManLo;          //  6:
+  uint8_t m_LengthHi;           //  7: Length of the text, including the null.
+  uint8_t m_Length;             //  8:
+  uint8_t m_Data[ ARTNET_COMMAND_DATA_LENGTH ]; //  9: Null terminated text.
+} __attribute__( ( packed ) ) ArtNetPacketCommand;
+
+// ArtIpProg reprograms the IP & subnet, or with no command bits asks for them.
+typedef struct ArtNetPacketIpProg
+{
+  uint8_t m_ProtocolHi;         //  3: High byte of the Art-Net protocol revision number.
+  uint8_t m_ProtocolLo;         //  4: Low byte of the Art-Net protocol revision number.
+  uint8_t m_Filler1;            //  5:
+  uint8_t m_Filler2;            //  6:
+  uint8_t m_Command;            //  7: ARTNET_IPPROG_*
+  uint8_t m_Filler4;            //  8:
+  uint8_t m_ProgIp[ 4 ];        //  9: High byte first.
+  uint8_t m_ProgSm[ 4 ];        // 10: Subnet mask, high byte first.
+  uint8_t m_ProgPortHi;         // 11: Deprecated.
+  uint8_t m_ProgPortLo;         // 12:
+  uint8_t m_ProgDg[ 4 ];        // 13: Default gateway, high byte first.
+  uint8_t m_Spare[ 4 ];         // 14: Transmit as zero.
+} __attribute__( ( packed ) ) ArtNetPacketIpProg;
+
+typedef struct ArtNetPacketIpProgReply
+{
+  uint8_t m_ProtocolHi;         //  3: High byte of the Art-Net protocol revision number.
+  uint8_t m_ProtocolLo;         //  4: Low byte of the Art-Net protocol revision number.
+  uint8_t m_Filler[ 4 ];        //  5: Transmit as zero.
+  uint8_t m_ProgIp[ 4 ];        //  6: High byte first.
+  uint8_t m_ProgSm[ 4 ];        //  7:
+  uint8_t m_ProgPortHi;         //  8: Always 0x1936.
+  uint8_t m_ProgPortLo;         //  9:
+  uint8_t m_Status;             // 10: ARTNET_IPPROGREPLY_STATUS_DHCP
+  uint8_t m_Spare2;             // 11:
+  uint8_t m_ProgDg[ 4 ];        // 12: Default gateway.
+  uint8_t m_Spare[ 2 ];         // 13:
+} __attribute__( ( packed ) ) ArtNetPacketIpProgReply;
+
+// ArtTimeCode, sent by a controller or timecode source once per frame.
+typedef struct ArtNetPacketTimeCode
+{
+  uint8_t m_ProtocolHi;         //  3: High byte of the Art-Net protocol revision number.
+  uint8_t m_ProtocolLo;         //  4: Low byte of the Art-Net protocol revision number.
+  uint8_t m_Filler1;            //  5: Transmit as zero.
+  uint8_t m_StreamId;           //  6: 0 for the master stream.
+  uint8_t m_Frames;             //  7: 0 to 29, depending on the type.
+  uint8_t m_Seconds;            //  8: 0 to 59.
+  uint8_t m_Minutes;            //  9: 0 to 59.
+  uint8_t m_Hours;              // 10: 0 to 23.
+  uint8_t m_Type;               // 11: ARTNET_TIMECODE_*
+} __attribute__( ( packed ) ) ArtNetPacketTimeCode;
+
 #pragma pack( pop ) // Restore original packing alignment
 
 #endif
@@ -70,6 +70,129 @@ void ChannelModsHandler::RemoveAllForChannel( const unsigned int channel_number
   this->SortBySequenceAndRenumber();
 }
 
+void ChannelModsHandler::SetMods( const std::vector< ChannelMod >& mods ) {
+  m_channel_mods_vector = mods;
+
+  this->SortBySequenceAndRenumber();
+}
+
+int ChannelModsHandler::ApplyBatch( const std::vector< ChannelModsBatchOp >& operations, const char** ptr_error ) {
+  // Kept in order, sequence numbers are only used to find the mods that were there before.
+  std::vector< ChannelMod > mods = m_channel_mods_vector;
+  mods.reserve( mods.size() + operations.size() );
+
+  for( size_t i = 0; i < operations.size(); i++ ) {
+    const ChannelModsBatchOp& operation = operations[ i ];
+
+    switch( operation.m_op ) {
+      case MODS_BATCH_ADD: {
+        if( !ChannelModsHandler::IsValid( operation.m_channel, operation.m_mod_type, operation.m_mod_value, ptr_error ) ) {
+          return i;
+        }
+        // Same place AddMod() puts it, after the last mod on this or a lower channel.
+        size_t position = 0;
+        for( size_t m = 0; m < mods.size(); m++ ) {
+          if( mods[ m ].m_channel <= operation.m_channel ) {
+            position = m + 1;
+          }
+        }
+        ChannelMod mod;
+        mod.m_sequence  = 0;
+        mod.m_channel   = operation.m_channel;
+        mod.m_mod_type  = operation.m_mod_type;
+        mod.m_mod_value = operation.m_mod_value;
+        mods.insert( mods.begin() + position, mod );
+        break;
+      }
+      case MODS_BATCH_EDIT:
+      case MODS_BATCH_DELETE: {
+        auto mods_itr = mods.begin();
+        while( mods_itr != mods.end() && ( operation.m_sequence == 0 || mods_itr->m_sequence != operation.m_sequence ) ) {
+          ++mods_itr;
+        }
+        if( mods_itr == mods.end() ) {
+          *ptr_error = "no mod with this sequence";
+          return i;
+        }
+        if( operation.m_op == MODS_BATCH_DELETE ) {
+          mods.erase( mods_itr );
+          break;
+        }
+        int mod_type  = ( operation.m_mod_type >= 0 ) ? operation.m_mod_type : mods_itr->m_mod_type;
+        int mod_value = ( operation.m_mod_value >= 0 ) ? operation.m_mod_value : mods_itr->m_mod_value;
+        if( !ChannelModsHandler::IsValid( mods_itr->m_channel, mod_type, mod_value, ptr_error ) ) {
+          return i;
+        }
+        mods_itr->m_mod_type  = mod_type;
+        mods_itr->m_mod_value = mod_value;
+        break;
+      }
+      case MODS_BATCH_DELETE_CHANNEL: {
+        mods.erase( std::remove_if( mods.begin(), mods.end(), [ &operation ]( const ChannelMod& mod ) { return mod.m_channel == operation.m_channel; } ), mods.end() );
+        break;
+      }
+      case MODS_BATCH_CLEAR: {
+        mods.clear();
+        break;
+      }
+      default: {
+        *ptr_error = "unknown operation";
+        return i;
+      }
+    }
+  }
+
+  // Numbered in their order, so the one sort leaves them there.
+  unsigned int sequence_new = 10;
+  for( auto& mod: mods ) {
+    mod.m_sequence = sequence_new;
+    sequence_new += 10;
+  }
+  this->SetMods( mods );
+
+  return -1;
+}
+
+bool ChannelModsHandler::IsValid( unsigned int channel, int mod_type, int mod_value, const char** ptr_error ) {
+  if( channel < 1 || channel > 512 ) {
+    *ptr_error = "channel must be 1 to 512";
+    return false;
+  }
+  switch( mod_type ) {
+    case CHANNELMODTYPE::NOTHING: {
+      return true;
+    }
+    case CHANNELMODTYPE::EQUALS_VALUE:
+    case CHANNELMODTYPE::ADD_VALUE:
+    case CHANNELMODTYPE::MINUS_VALUE:
+    case CHANNELMODTYPE::ABOVE_0_ADD_VALUE:
+    case CHANNELMODTYPE::ABOVE_0_MINUS_VALUE: {
+      if( mod_value < 0 || mod_value > 255 ) {
+        *ptr_error = "mod_value must be 0 to 255";
+        return false;
+      }
+      return true;
+    }
+    case CHANNELMODTYPE::COPY_FROM_CHANNEL:
+    case CHANNELMODTYPE::ADD_FROM_CHANNEL:
+    case CHANNELMODTYPE::MINUS_FROM_CHANNEL:
+    case CHANNELMODTYPE::COPY_FROM_ARTNET:
+    case CHANNELMODTYPE::ADD_FROM_ARTNET:
+    case CHANNELMODTYPE::MINUS_FROM_ARTNET:
+    case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET: {
+      if( mod_value < 1 || mod_value > 512 ) {
+        *ptr_error = "mod_value must be a channel, 1 to 512";
+        return false;
+      }
+      return true;
+    }
+    default: {
+      *ptr_error = "unknown mod_type";
+      return false;
+    }
+  }
+}
+
 const std::vector< ChannelMod >& ChannelModsHandler::GetModsVector() const {
   return m_channel_mods_vector;
 }
@@ -115,3 +238,99 @@ void ChannelModsHandler::SortBySequenceAndRenumber() {
     sequence_new += 10;
   }
 }
+
+void ChannelModsHandler::ApplyMods( const std::vector< ChannelMod >& mods, uint8_t* ptr_dmx_buffer, const uint8_t* ptr_artnet_data ) {
+  for( const ChannelMod& mod : mods ) {
+    if( mod.m_channel < 513 ) {
+      switch( mod.m_mod_type ) {
+        case CHANNELMODTYPE::EQUALS_VALUE: {
+          ptr_dmx_buffer[ mod.m_channel ] = mod.m_mod_value;
+          break;
+        }
+        case CHANNELMODTYPE::ADD_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 255 - mod.m_mod_value ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 255;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] += (uint8_t) mod.m_mod_value;
+          }
+          break;
+        }
+        case CHANNELMODTYPE::MINUS_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] < mod.m_mod_value ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 0;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] -= (uint8_t) mod.m_mod_value;
+          }
+          break;
+        }
+        case CHANNELMODTYPE::COPY_FROM_CHANNEL: {
+          ptr_dmx_buffer[ mod.m_channel ] = ptr_dmx_buffer[ mod.m_mod_value ];
+          break;
+        }
+        case CHANNELMODTYPE::ADD_FROM_CHANNEL: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 255 - ptr_dmx_buffer[ mod.m_mod_value ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 255;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] += ptr_dmx_buffer[ mod.m_mod_value ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::MINUS_FROM_CHANNEL: {
+          if( ptr_dmx_buffer[ mod.m_channel ] < ptr_dmx_buffer[ mod.m_mod_value ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 0;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] -= ptr_dmx_buffer[ mod.m_mod_value ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::ABOVE_0_ADD_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 0 ) {
+            if( ptr_dmx_buffer[ mod.m_channel ] > 255 - mod.m_mod_value ) {
+              ptr_dmx_buffer[ mod.m_channel ] = 255;
+            } else {
+              ptr_dmx_buffer[ mod.m_channel ] += (uint8_t) mod.m_mod_value;
+            }
+          }
+          break;
+        }
+        case CHANNELMODTYPE::ABOVE_0_MINUS_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 0 ) {
+            if( ptr_dmx_buffer[ mod.m_channel ] < mod.m_mod_value ) {
+              ptr_dmx_buffer[ mod.m_channel ] = 0;
+            } else {
+              ptr_dmx_buffer[ mod.m_channel ] -= (uint8_t) mod.m_mod_value;
+            }
+          }
+          break;
+        }
+        case CHANNELMODTYPE::COPY_FROM_ARTNET: {
+          // Signed, so a value of 0 reads the byte before the data like on the 32 bit node, not 4GB past it.
+          ptr_dmx_buffer[ mod.m_channel ] = ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          break;
+        }
+        case CHANNELMODTYPE::ADD_FROM_ARTNET: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 255 - ptr_artnet_data[ (int)mod.m_mod_value - 1 ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 255;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] += ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::MINUS_FROM_ARTNET: {
+          if( ptr_dmx_buffer[ mod.m_channel ] < ptr_artnet_data[ (int)mod.m_mod_value - 1 ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 0;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] -= ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET: {
+          if( ptr_dmx_buffer[ mod.m_channel ] == 0 ) {
+            ptr_dmx_buffer[ mod.m_channel ] = ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          }
+          break;
+        }
+      }
+    }
+  }
+}
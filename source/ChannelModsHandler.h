@@ -1,10 +1,40 @@
 #ifndef _CHANNELMODSHANDLER_H_
 #define _CHANNELMODSHANDLER_H_
 
+#include <stdint.h>
 #include <vector>
 #include <algorithm> // std::sort
 #include "ChannelMod.h"
 
+#define MODS_BATCH_OPERATIONS_MAX  1024
+
+enum MODSBATCHOP : int {
+  MODS_BATCH_ADD            = 0,   // After the channel's last mod.
+  MODS_BATCH_EDIT           = 1,
+  MODS_BATCH_DELETE         = 2,
+  MODS_BATCH_DELETE_CHANNEL = 3,   // Every mod on the channel.
+  MODS_BATCH_CLEAR          = 4,
+};
+
+inline const char* ModsBatchOpAsString( int op ) {
+  switch( op ) {
+    case MODS_BATCH_ADD:            return "add";
+    case MODS_BATCH_EDIT:           return "edit";
+    case MODS_BATCH_DELETE:         return "delete";
+    case MODS_BATCH_DELETE_CHANNEL: return "delete_channel";
+    case MODS_BATCH_CLEAR:          return "clear";
+    default:                        return "unknown";
+  }
+};
+
+struct ChannelModsBatchOp {
+  int          m_op;          // MODSBATCHOP
+  unsigned int m_sequence;    // Edit & delete, as numbered before the batch.  Mods added by the batch can't be referred to.
+  unsigned int m_channel;     // Add & delete channel.
+  int          m_mod_type;    // Add & edit, -1 leaves an edited mod's type.
+  int          m_mod_value;   // Add & edit, -1 leaves an edited mod's value.
+};
+
 class ChannelModsHandler {
 public:
   ChannelModsHandler();
@@ -19,8 +49,21 @@ public:
   void UpdateForModValue( const unsigned int sequence_number, const unsigned int mod_value );
   void RemoveAllForChannel( const unsigned int channel_number );
 
+  // Replaces the mods, sorted by sequence & renumbered once.
+  void SetMods( const std::vector< ChannelMod >& mods );
+
+  // All or nothing.  The operations are applied in order to a copy, which replaces the mods only if every one
+  // of them was valid, with a single renumber.  Returns -1, or the index of the first invalid operation.
+  int ApplyBatch( const std::vector< ChannelModsBatchOp >& operations, const char** ptr_error );
+
+  // Channel 1 to 512, a known type & a value in range for it, a channel for the copy, add & minus from types.
+  static bool IsValid( unsigned int channel, int mod_type, int mod_value, const char** ptr_error );
+
   const std::vector< ChannelMod >& GetModsVector() const;
 
+  // Runs the mods in order.  ptr_dmx_buffer[ 0 ] is the start code, ptr_artnet_data[ 0 ] is Art-Net channel 1.
+  static void ApplyMods( const std::vector< ChannelMod >& mods, uint8_t* ptr_dmx_buffer, const uint8_t* ptr_artnet_data );
+
 private:
   unsigned int GetMaxSequence();
   unsigned int GetNextSequenceForChannel( const unsigned int channel_number );
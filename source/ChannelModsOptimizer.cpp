@@ -0,0 +1,418 @@
+#include <queue>
+#include "ChannelModsOptimizer.h"
+#include "ChannelModsHandler.h"
+
+// Operands past the DMX or Art-Net buffer can't be reasoned about, those mods are never folded.
+static bool IsOpaque( const ChannelMod& mod ) {
+  switch( mod.m_mod_type ) {
+    case CHANNELMODTYPE::COPY_FROM_CHANNEL:
+    case CHANNELMODTYPE::ADD_FROM_CHANNEL:
+    case CHANNELMODTYPE::MINUS_FROM_CHANNEL:
+      return mod.m_mod_value > 512;
+    case CHANNELMODTYPE::COPY_FROM_ARTNET:
+    case CHANNELMODTYPE::ADD_FROM_ARTNET:
+    case CHANNELMODTYPE::MINUS_FROM_ARTNET:
+    case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET:
+      return mod.m_mod_value < 1 || mod.m_mod_value > 512;
+    default:
+      return false;
+  }
+}
+
+static bool ReadsArtNet( const ChannelMod& mod ) {
+  return mod.m_mod_type >= CHANNELMODTYPE::COPY_FROM_ARTNET && mod.m_mod_type <= CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET;
+}
+
+// Output channel the mod reads, other than its own, -1 if none.
+static int ReadsChannel( const ChannelMod& mod ) {
+  switch( mod.m_mod_type ) {
+    case CHANNELMODTYPE::COPY_FROM_CHANNEL:
+    case CHANNELMODTYPE::ADD_FROM_CHANNEL:
+    case CHANNELMODTYPE::MINUS_FROM_CHANNEL:
+      return mod.m_mod_value <= 512 ? (int)mod.m_mod_value : -1;
+    default:
+      return -1;
+  }
+}
+
+// The result depends on the value of the mod's own channel.
+static bool ReadsOwnChannel( const ChannelMod& mod ) {
+  switch( mod.m_mod_type ) {
+    case CHANNELMODTYPE::EQUALS_VALUE:
+    case CHANNELMODTYPE::COPY_FROM_ARTNET:
+      return false;
+    case CHANNELMODTYPE::COPY_FROM_CHANNEL:
+      return mod.m_mod_value == mod.m_channel;
+    default:
+      return true;
+  }
+}
+
+static bool OverwritesChannel( const ChannelMod& mod ) {
+  return !ReadsOwnChannel( mod );
+}
+
+static bool IsNop( const ChannelMod& mod ) {
+  if( mod.m_channel > 512 ) {
+    // Skipped by ApplyMods().
+    return true;
+  }
+  switch( mod.m_mod_type ) {
+    case CHANNELMODTYPE::ADD_VALUE:
+    case CHANNELMODTYPE::ABOVE_0_ADD_VALUE:
+      // Values above 255 wrap, so 256 adds 0 as well.
+      return ( mod.m_mod_value & 0xFF ) == 0;
+    case CHANNELMODTYPE::MINUS_VALUE:
+    case CHANNELMODTYPE::ABOVE_0_MINUS_VALUE:
+      return mod.m_mod_value == 0;
+    case CHANNELMODTYPE::COPY_FROM_CHANNEL:
+      return mod.m_mod_value == mod.m_channel;
+    case CHANNELMODTYPE::EQUALS_VALUE:
+    case CHANNELMODTYPE::ADD_FROM_CHANNEL:
+    case CHANNELMODTYPE::MINUS_FROM_CHANNEL:
+    case CHANNELMODTYPE::COPY_FROM_ARTNET:
+    case CHANNELMODTYPE::ADD_FROM_ARTNET:
+    case CHANNELMODTYPE::MINUS_FROM_ARTNET:
+    case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET:
+      return false;
+    default:
+      // NOTHING & unknown types.
+      return true;
+  }
+}
+
+// One mod on a known channel value & a known output channel operand, the same arithmetic as ApplyMods().
+static uint8_t Evaluate( const ChannelMod& mod, uint8_t value, uint8_t operand ) {
+  switch( mod.m_mod_type ) {
+    case CHANNELMODTYPE::EQUALS_VALUE:
+      return mod.m_mod_value;
+    case CHANNELMODTYPE::ADD_VALUE:
+      return value > 255 - mod.m_mod_value ? 255 : (uint8_t)( value + (uint8_t)mod.m_mod_value );
+    case CHANNELMODTYPE::MINUS_VALUE:
+      return value < mod.m_mod_value ? 0 : (uint8_t)( value - (uint8_t)mod.m_mod_value );
+    case CHANNELMODTYPE::COPY_FROM_CHANNEL:
+      return operand;
+    case CHANNELMODTYPE::ADD_FROM_CHANNEL:
+      return value > 255 - operand ? 255 : (uint8_t)( value + operand );
+    case CHANNELMODTYPE::MINUS_FROM_CHANNEL:
+      return value < operand ? 0 : (uint8_t)( value - operand );
+    case CHANNELMODTYPE::ABOVE_0_ADD_VALUE:
+      if( value == 0 ) {
+        return 0;
+      }
+      return value > 255 - mod.m_mod_value ? 255 : (uint8_t)( value + (uint8_t)mod.m_mod_value );
+    case CHANNELMODTYPE::ABOVE_0_MINUS_VALUE:
+      if( value == 0 ) {
+        return 0;
+      }
+      return value < mod.m_mod_value ? 0 : (uint8_t)( value - (uint8_t)mod.m_mod_value );
+    default:
+      return value;
+  }
+}
+
+static uint8_t RandomValue() {
+  // Plenty of 0 & 255, so the 'if 0', 'above 0' & saturating mods take both paths.
+  uint32_t random_bits = esp_random();
+  switch( random_bits & 3 ) {
+    case 0:  return 0;
+    case 1:  return 255;
+    default: return random_bits >> 8;
+  }
+}
+
+ChannelModsOptimizer::ChannelModsOptimizer() {
+  m_mods_in          = 0;
+  m_mods_out         = 0;
+  m_reordered        = 0;
+  m_optimize_time_us = 0;
+  memset( m_counts, 0, sizeof( m_counts ) );
+}
+
+ChannelModsOptimizer::~ChannelModsOptimizer() {
+}
+
+void ChannelModsOptimizer::Optimize( const std::vector< ChannelMod >& mods, std::vector< ChannelMod >& optimized ) {
+  unsigned long start_us = micros();
+
+  m_mods_in   = mods.size();
+  m_reordered = 0;
+  memset( m_counts, 0, sizeof( m_counts ) );
+  m_report.clear();
+
+  std::vector< ChannelMod > folded;
+  this->Fold( mods, folded );
+  this->RemoveDead( folded );
+  this->Reorder( folded, optimized );
+
+  m_mods_out         = optimized.size();
+  m_optimize_time_us = micros() - start_us;
+}
+
+void ChannelModsOptimizer::Fold( const std::vector< ChannelMod >& mods, std::vector< ChannelMod >& folded ) {
+  std::vector< int16_t > known( MODS_OPTIMIZER_CHANNELS, -1 );        // Value of each channel, -1 if it depends on the data.
+  std::vector< int >     last_write( MODS_OPTIMIZER_CHANNELS, -1 );   // Index in folded of the last mod writing the channel.
+  std::vector< bool >    read_since_write( MODS_OPTIMIZER_CHANNELS, false );
+
+  folded.clear();
+  folded.reserve( mods.size() );
+
+  for( const ChannelMod& original : mods ) {
+    if( IsNop( original ) ) {
+      this->AddReport( original, MODS_REMOVED_NOP );
+      continue;
+    }
+
+    ChannelMod   mod       = original;
+    unsigned int channel   = mod.m_channel;
+    bool         rewritten = false;
+    bool         constant  = false;
+    uint8_t      result    = 0;
+
+    if( !IsOpaque( mod ) ) {
+      int source = ReadsChannel( mod );
+      if( mod.m_mod_type == CHANNELMODTYPE::MINUS_FROM_CHANNEL && source == (int)channel ) {
+        // Minus itself is always 0.
+        mod.m_mod_type  = CHANNELMODTYPE::EQUALS_VALUE;
+        mod.m_mod_value = 0;
+        rewritten       = true;
+      } else if( source >= 0 && source != (int)channel && known[ source ] >= 0 ) {
+        // A known operand is a plain value, the same arithmetic for values up to 255.
+        switch( mod.m_mod_type ) {
+          case CHANNELMODTYPE::COPY_FROM_CHANNEL:  mod.m_mod_type = CHANNELMODTYPE::EQUALS_VALUE; break;
+          case CHANNELMODTYPE::ADD_FROM_CHANNEL:   mod.m_mod_type = CHANNELMODTYPE::ADD_VALUE;    break;
+          case CHANNELMODTYPE::MINUS_FROM_CHANNEL: mod.m_mod_type = CHANNELMODTYPE::MINUS_VALUE;  break;
+        }
+        mod.m_mod_value = known[ source ];
+        rewritten       = true;
+      }
+
+      if( known[ channel ] == 0 ) {
+        switch( mod.m_mod_type ) {
+          case CHANNELMODTYPE::ADD_FROM_ARTNET:
+          case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET:
+            mod.m_mod_type = CHANNELMODTYPE::COPY_FROM_ARTNET;
+            rewritten      = true;
+            break;
+          case CHANNELMODTYPE::MINUS_FROM_ARTNET:
+            this->AddReport( original, MODS_FOLDED );
+            continue;
+        }
+      } else if( known[ channel ] > 0 && mod.m_mod_type == CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET ) {
+        this->AddReport( original, MODS_FOLDED );
+        continue;
+      }
+
+      if( IsNop( mod ) ) {
+        // e.g. add from a channel known to be 0.
+        this->AddReport( original, MODS_FOLDED );
+        continue;
+      }
+
+      source = ReadsChannel( mod );
+      if( mod.m_mod_type == CHANNELMODTYPE::MINUS_VALUE && mod.m_mod_value >= 255 ) {
+        constant = true;
+        result   = 0;
+      } else if( mod.m_mod_type == CHANNELMODTYPE::ADD_VALUE && mod.m_mod_value == 255 ) {
+        constant = true;
+        result   = 255;
+      } else if( !ReadsArtNet( mod ) && ( !ReadsOwnChannel( mod ) || known[ channel ] >= 0 ) && ( source < 0 || known[ source ] >= 0 ) ) {
+        constant = true;
+        result   = Evaluate( mod, known[ channel ] < 0 ? 0 : known[ channel ], source < 0 ? 0 : known[ source ] );
+      }
+
+      if( constant && ( mod.m_mod_type != CHANNELMODTYPE::EQUALS_VALUE || mod.m_mod_value != result ) ) {
+        mod.m_mod_type  = CHANNELMODTYPE::EQUALS_VALUE;
+        mod.m_mod_value = result;
+        rewritten       = true;
+      }
+
+      // Consecutive adds or minuses of a channel that nothing reads in between.
+      int previous = last_write[ channel ];
+      if( !constant && previous >= 0 && !read_since_write[ channel ] && mod.m_mod_value < 255 &&
+          ( mod.m_mod_type == CHANNELMODTYPE::ADD_VALUE || mod.m_mod_type == CHANNELMODTYPE::MINUS_VALUE ) &&
+          folded[ previous ].m_mod_type == mod.m_mod_type && folded[ previous ].m_mod_value < 255 ) {
+        unsigned int sum = folded[ previous ].m_mod_value + mod.m_mod_value;
+        if( sum >= 255 ) {
+          // Saturates whatever the value was.
+          known[ channel ] = ( mod.m_mod_type == CHANNELMODTYPE::ADD_VALUE ) ? 255 : 0;
+          folded[ previous ].m_mod_type  = CHANNELMODTYPE::EQUALS_VALUE;
+          folded[ previous ].m_mod_value = known[ channel ];
+        } else {
+          folded[ previous ].m_mod_value = sum;
+        }
+        this->AddReport( original, MODS_MERGED );
+        continue;
+      }
+    }
+
+    int source = ReadsChannel( mod );
+    if( source >= 0 ) {
+      read_since_write[ source ] = true;
+    }
+    last_write[ channel ]       = folded.size();
+    read_since_write[ channel ] = false;
+    known[ channel ]            = constant ? result : -1;
+    folded.push_back( mod );
+
+    if( rewritten ) {
+      this->AddReport( original, MODS_FOLDED );
+    }
+  }
+}
+
+void ChannelModsOptimizer::RemoveDead( std::vector< ChannelMod >& folded ) {
+  // Backwards, every channel is read by the output at the end.
+  std::vector< bool > live( MODS_OPTIMIZER_CHANNELS, true );
+  std::vector< bool > keep( folded.size(), true );
+
+  for( int i = folded.size() - 1; i >= 0; i-- ) {
+    const ChannelMod& mod = folded[ i ];
+    if( !live[ mod.m_channel ] ) {
+      keep[ i ] = false;
+      this->AddReport( mod, MODS_REMOVED_DEAD );
+      continue;
+    }
+    if( OverwritesChannel( mod ) ) {
+      live[ mod.m_channel ] = false;
+    }
+    int source = ReadsChannel( mod );
+    if( source >= 0 ) {
+      live[ source ] = true;
+    }
+  }
+
+  size_t kept = 0;
+  for( size_t i = 0; i < folded.size(); i++ ) {
+    if( keep[ i ] ) {
+      folded[ kept++ ] = folded[ i ];
+    }
+  }
+  folded.resize( kept );
+}
+
+void ChannelModsOptimizer::Reorder( const std::vector< ChannelMod >& folded, std::vector< ChannelMod >& optimized ) {
+  // A mod has to stay after the last mod writing a channel it reads or writes, & after every mod that read
+  // its channel since then.  Anything else can move, the ready mod with the lowest channel goes next.
+  int count = folded.size();
+  std::vector< std::vector< int > > successors( count );
+  std::vector< int >                predecessor_count( count, 0 );
+  std::vector< int >                last_writer( MODS_OPTIMIZER_CHANNELS, -1 );
+  std::vector< std::vector< int > > readers( MODS_OPTIMIZER_CHANNELS );
+
+  for( int i = 0; i < count; i++ ) {
+    unsigned int channel = folded[ i ].m_channel;
+    int          source  = ReadsChannel( folded[ i ] );
+
+    if( source >= 0 && last_writer[ source ] >= 0 ) {
+      successors[ last_writer[ source ] ].push_back( i );
+      predecessor_count[ i ]++;
+    }
+    if( last_writer[ channel ] >= 0 ) {
+      successors[ last_writer[ channel ] ].push_back( i );
+      predecessor_count[ i ]++;
+    }
+    for( int reader : readers[ channel ] ) {
+      successors[ reader ].push_back( i );
+      predecessor_count[ i ]++;
+    }
+    readers[ channel ].clear();
+    last_writer[ channel ] = i;
+    if( source >= 0 && source != (int)channel ) {
+      readers[ source ].push_back( i );
+    }
+  }
+
+  typedef std::pair< unsigned int, int > ReadyMod;   // Channel, index.
+  std::priority_queue< ReadyMod, std::vector< ReadyMod >, std::greater< ReadyMod > > ready;
+  for( int i = 0; i < count; i++ ) {
+    if( predecessor_count[ i ] == 0 ) {
+      ready.push( ReadyMod( folded[ i ].m_channel, i ) );
+    }
+  }
+
+  optimized.clear();
+  optimized.reserve( count );
+  while( !ready.empty() ) {
+    int i = ready.top().second;
+    ready.pop();
+    if( i != (int)optimized.size() ) {
+      m_reordered++;
+    }
+    optimized.push_back( folded[ i ] );
+    for( int successor : successors[ i ] ) {
+      if( --predecessor_count[ successor ] == 0 ) {
+        ready.push( ReadyMod( folded[ successor ].m_channel, successor ) );
+      }
+    }
+  }
+}
+
+bool ChannelModsOptimizer::Verify( const std::vector< ChannelMod >& mods, const std::vector< ChannelMod >& optimized, int frames ) {
+  // Only called from loop(), kept off the stack.
+  static uint8_t dmx_buffer[ MODS_OPTIMIZER_CHANNELS ];
+  static uint8_t dmx_buffer_optimized[ MODS_OPTIMIZER_CHANNELS ];
+  static uint8_t artnet_data[ 512 ];
+
+  // A mod reading past the DMX or Art-Net data reads whatever is next in memory, which is different for the
+  // two lists here, so they can't be compared.
+  for( const std::vector< ChannelMod >* ptr_mods : { &mods, &optimized } ) {
+    for( const ChannelMod& mod : *ptr_mods ) {
+      if( mod.m_channel <= 512 && IsOpaque( mod ) ) {
+        return false;
+      }
+    }
+  }
+
+  for( int frame = 0; frame < frames; frame++ ) {
+    for( int i = 0; i < 512; i++ ) {
+      artnet_data[ i ]    = RandomValue();
+      dmx_buffer[ i + 1 ] = RandomValue();
+    }
+    dmx_buffer[ 0 ] = 0;
+    memcpy( dmx_buffer_optimized, dmx_buffer, sizeof( dmx_buffer ) );
+
+    ChannelModsHandler::ApplyMods( mods, dmx_buffer, artnet_data );
+    ChannelModsHandler::ApplyMods( optimized, dmx_buffer_optimized, artnet_data );
+
+    if( memcmp( dmx_buffer, dmx_buffer_optimized, sizeof( dmx_buffer ) ) != 0 ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ChannelModsOptimizer::AddReport( const ChannelMod& mod, int action ) {
+  m_counts[ action ]++;
+  if( m_report.size() < MODS_OPTIMIZER_REPORT_MAX ) {
+    ModsOptimizerEntry entry;
+    entry.m_sequence = mod.m_sequence;
+    entry.m_channel  = mod.m_channel;
+    entry.m_action   = action;
+    m_report.push_back( entry );
+  }
+}
+
+int ChannelModsOptimizer::GetModsIn() const {
+  return m_mods_in;
+}
+
+int ChannelModsOptimizer::GetModsOut() const {
+  return m_mods_out;
+}
+
+int ChannelModsOptimizer::GetCount( int action ) const {
+  return m_counts[ action ];
+}
+
+int ChannelModsOptimizer::GetReordered() const {
+  return m_reordered;
+}
+
+unsigned long ChannelModsOptimizer::GetOptimizeTimeUs() const {
+  return m_optimize_time_us;
+}
+
+const std::vector< ModsOptimizerEntry >& ChannelModsOptimizer::GetReport() const {
+  return m_report;
+}
@@ -0,0 +1,76 @@
+#ifndef _CHANNELMODSOPTIMIZER_H_
+#define _CHANNELMODSOPTIMIZER_H_
+
+#include <Arduino.h>
+#include <vector>
+#include "ChannelMod.h"
+
+#define MODS_OPTIMIZER_CHANNELS       513   // Start code & channels 1 to 512, the channels a mod can write.
+#define MODS_OPTIMIZER_VERIFY_FRAMES  64    // Random frames both programs are compared on.
+#define MODS_OPTIMIZER_REPORT_MAX     64    // Entries kept for /stats, the counts include all of them.
+
+enum MODSOPTIMIZERACTION : int {
+  MODS_REMOVED_NOP  = 0,  // Never changes the output, e.g. add 0, a self copy or a channel above 512.
+  MODS_REMOVED_DEAD = 1,  // Overwritten before anything reads it.
+  MODS_FOLDED       = 2,  // Operands were known, replaced by a constant or a simpler mod.
+  MODS_MERGED       = 3,  // Added to the previous add or minus of the same channel.
+};
+
+inline const char* ModsOptimizerActionAsString( int action ) {
+  switch( action ) {
+    case MODS_REMOVED_NOP:  return "removed, no effect";
+    case MODS_REMOVED_DEAD: return "removed, overwritten";
+    case MODS_FOLDED:       return "folded";
+    case MODS_MERGED:       return "merged";
+    default:                return "unknown";
+  }
+};
+
+struct ModsOptimizerEntry {
+  unsigned int m_sequence;
+  unsigned int m_channel;
+  int          m_action;    // MODSOPTIMIZERACTION
+};
+
+// Rewrites a mod list into a shorter one giving the same output for any DMX & Art-Net data.
+//  - Constant folding : values set by 'equals' are tracked, mods on known values become 'equals', known
+//    'from channel' operands become plain values, & consecutive adds or minuses of a channel are merged.
+//  - Dead mods : a mod whose channel is overwritten before being read is removed.
+//  - Reordering : mods are put in channel order wherever that doesn't change what a mod reads.
+// Channel values at the start are unknown, so pixel maps & the Art-Net copy don't change the result.
+class ChannelModsOptimizer {
+public:
+  ChannelModsOptimizer();
+
+  ~ChannelModsOptimizer();
+
+  void Optimize( const std::vector< ChannelMod >& mods, std::vector< ChannelMod >& optimized );
+
+  // Runs both lists on the same random DMX & Art-Net frames, false if any output differs or a mod reads past the data.
+  static bool Verify( const std::vector< ChannelMod >& mods, const std::vector< ChannelMod >& optimized, int frames );
+
+  int           GetModsIn() const;
+  int           GetModsOut() const;
+  int           GetCount( int action ) const;
+  int           GetReordered() const;
+  unsigned long GetOptimizeTimeUs() const;
+  const std::vector< ModsOptimizerEntry >& GetReport() const;
+
+private:
+  void Fold( const std::vector< ChannelMod >& mods, std::vector< ChannelMod >& folded );
+
+  void RemoveDead( std::vector< ChannelMod >& folded );
+
+  void Reorder( const std::vector< ChannelMod >& folded, std::vector< ChannelMod >& optimized );
+
+  void AddReport( const ChannelMod& mod, int action );
+
+  int           m_mods_in;
+  int           m_mods_out;
+  int           m_counts[ MODS_MERGED + 1 ];
+  int           m_reordered;
+  unsigned long m_optimize_time_us;
+  std::vector< ModsOptimizerEntry > m_report;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "ChannelModsReference.h"
+
+void ChannelModsReference( const std::vector< ChannelMod >& mods, bool copy_artnet_to_dmx, const uint8_t* ptr_artnet_data, uint16_t number_of_channels, uint8_t* ptr_dmx_buffer ) {
+  if( copy_artnet_to_dmx ) {
+    memcpy( &ptr_dmx_buffer[ 1 ], ptr_artnet_data, number_of_channels * sizeof( uint8_t ) );
+  } else {
+    memset( ptr_dmx_buffer, 0, 513 );
+  }
+
+  // Process any channel mods
+  for( const ChannelMod& mod : mods ) {
+    if( mod.m_channel < 513 ) {
+      switch( mod.m_mod_type ) {
+        case CHANNELMODTYPE::EQUALS_VALUE: {
+          ptr_dmx_buffer[ mod.m_channel ] = mod.m_mod_value;
+          break;
+        }
+        case CHANNELMODTYPE::ADD_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 255 - mod.m_mod_value ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 255;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] += (uint8_t) mod.m_mod_value;
+          }
+          break;
+        }
+        case CHANNELMODTYPE::MINUS_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] < mod.m_mod_value ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 0;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] -= (uint8_t) mod.m_mod_value;
+          }
+          break;
+        }
+        case CHANNELMODTYPE::COPY_FROM_CHANNEL: {
+          ptr_dmx_buffer[ mod.m_channel ] = ptr_dmx_buffer[ mod.m_mod_value ];
+          break;
+        }
+        case CHANNELMODTYPE::ADD_FROM_CHANNEL: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 255 - ptr_dmx_buffer[ mod.m_mod_value ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 255;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] += ptr_dmx_buffer[ mod.m_mod_value ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::MINUS_FROM_CHANNEL: {
+          if( ptr_dmx_buffer[ mod.m_channel ] < ptr_dmx_buffer[ mod.m_mod_value ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 0;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] -= ptr_dmx_buffer[ mod.m_mod_value ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::ABOVE_0_ADD_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 0 ) {
+            if( ptr_dmx_buffer[ mod.m_channel ] > 255 - mod.m_mod_value ) {
+              ptr_dmx_buffer[ mod.m_channel ] = 255;
+            } else {
+              ptr_dmx_buffer[ mod.m_channel ] += (uint8_t) mod.m_mod_value;
+            }
+          }
+          break;
+        }
+        case CHANNELMODTYPE::ABOVE_0_MINUS_VALUE: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 0 ) {
+            if( ptr_dmx_buffer[ mod.m_channel ] < mod.m_mod_value ) {
+              ptr_dmx_buffer[ mod.m_channel ] = 0;
+            } else {
+              ptr_dmx_buffer[ mod.m_channel ] -= (uint8_t) mod.m_mod_value;
+            }
+          }
+          break;
+        }
+        case CHANNELMODTYPE::COPY_FROM_ARTNET: {
+          ptr_dmx_buffer[ mod.m_channel ] = ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          break;
+        }
+        case CHANNELMODTYPE::ADD_FROM_ARTNET: {
+          if( ptr_dmx_buffer[ mod.m_channel ] > 255 - ptr_artnet_data[ (int)mod.m_mod_value - 1 ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 255;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] += ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::MINUS_FROM_ARTNET: {
+          if( ptr_dmx_buffer[ mod.m_channel ] < ptr_artnet_data[ (int)mod.m_mod_value - 1 ] ) {
+            ptr_dmx_buffer[ mod.m_channel ] = 0;
+          } else {
+            ptr_dmx_buffer[ mod.m_channel ] -= ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          }
+          break;
+        }
+        case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET: {
+          if( ptr_dmx_buffer[ mod.m_channel ] == 0 ) {
+            ptr_dmx_buffer[ mod.m_channel ] = ptr_artnet_data[ (int)mod.m_mod_value - 1 ];
+          }
+          break;
+        }
+      }
+    }
+  }
+}
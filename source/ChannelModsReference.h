@@ -0,0 +1,14 @@
+#ifndef _CHANNELMODSREFERENCE_H_
+#define _CHANNELMODSREFERENCE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "ChannelMod.h"
+
+// Frozen copy of how an Art-Net frame & the channel mods made the DMX output before any optimization, including
+// the 'Copy Artnet to DMX' step.  Faster engines are tested against this, so it must never be changed to match them.
+// ptr_dmx_buffer[ 0 ] is the start code & keeps its contents between frames, like the engine's buffer.
+void ChannelModsReference( const std::vector< ChannelMod >& mods, bool copy_artnet_to_dmx, const uint8_t* ptr_artnet_data, uint16_t number_of_channels, uint8_t* ptr_dmx_buffer );
+
+#endif
@@ -0,0 +1,257 @@
+#include "ChannelModsTester.h"
+
+ChannelModsTester::ChannelModsTester() {
+  m_random_state               = 1;
+  m_cases_run                  = 0;
+  m_failure_engine             = -1;
+  m_failure_frame              = 0;
+  m_failure_channel            = 0;
+  m_failure_expected           = 0;
+  m_failure_result             = 0;
+  m_failure_mods_before_shrink = 0;
+  m_benchmark_reference_us     = 0;
+  memset( m_benchmark_engine_us, 0, sizeof( m_benchmark_engine_us ) );
+  memset( m_benchmark_mods_running, 0, sizeof( m_benchmark_mods_running ) );
+}
+
+ChannelModsTester::~ChannelModsTester() {
+}
+
+uint32_t ChannelModsTester::NextRandom( uint32_t& state ) {
+  // xorshift32, so a seed always gives the same cases.
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+bool ChannelModsTester::Run( int cases, uint32_t seed ) {
+  m_random_state   = seed == 0 ? 1 : seed;
+  m_cases_run      = 0;
+  m_failure_engine = -1;
+
+  TestCase test_case;
+  for( int i = 0; i < cases; i++ ) {
+    this->GenerateCase( test_case );
+    m_cases_run++;
+
+    for( int engine = 0; engine < MODS_ENGINE_COUNT; engine++ ) {
+      if( this->Differs( engine, test_case ) ) {
+        m_failure_engine             = engine;
+        m_failure_mods_before_shrink = test_case.m_mods.size();
+        this->Shrink( engine, test_case );
+        m_failure_case = test_case;
+        // Differs() on the shrunk case leaves the first difference in the failure fields.
+        this->Differs( engine, m_failure_case );
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void ChannelModsTester::GenerateCase( TestCase& test_case ) {
+  // Mods go in a small window of channels so they read & write each other.
+  uint32_t window_start = NextRandom( m_random_state ) % 8 == 0 ? 0 : 1 + NextRandom( m_random_state ) % 505;
+  int      count        = NextRandom( m_random_state ) % ( MODS_TEST_MODS_MAX + 1 );
+
+  test_case.m_mods.clear();
+  for( int i = 0; i < count; i++ ) {
+    ChannelMod mod = this->GenerateMod( window_start );
+    mod.m_sequence = ( i + 1 ) * 10;
+    test_case.m_mods.push_back( mod );
+  }
+  test_case.m_copy_artnet_to_dmx = NextRandom( m_random_state ) & 1;
+  test_case.m_frame_seed         = NextRandom( m_random_state ) | 1;
+}
+
+ChannelMod ChannelModsTester::GenerateMod( uint32_t window_start ) {
+  static const uint32_t edge_channels[] = { 0, 512, 513, MODS_TEST_VALUE_MAX };
+
+  ChannelMod mod;
+  if( NextRandom( m_random_state ) % 16 == 0 ) {
+    mod.m_channel = edge_channels[ NextRandom( m_random_state ) % 4 ];
+  } else {
+    mod.m_channel = window_start + NextRandom( m_random_state ) % 8;
+  }
+  // One past CHANNELMODTYPE::MAX, unknown types must do nothing.
+  mod.m_mod_type = NextRandom( m_random_state ) % ( CHANNELMODTYPE::MAX + 2 );
+
+  uint32_t random = NextRandom( m_random_state );
+  switch( random % 10 ) {
+    case 0:  mod.m_mod_value = 0;   break;
+    case 1:  mod.m_mod_value = 1;   break;
+    case 2:  mod.m_mod_value = 254; break;
+    case 3:  mod.m_mod_value = 255; break;
+    case 4:  mod.m_mod_value = 256 + ( random >> 8 ) % 256; break;
+    case 5:  mod.m_mod_value = 512 + ( random >> 8 ) % ( MODS_TEST_VALUE_MAX - 511 ); break;
+    case 6:  mod.m_mod_value = mod.m_channel; break;
+    case 7:  mod.m_mod_value = ( random >> 8 ) % 256; break;
+    default: mod.m_mod_value = window_start + ( random >> 8 ) % 8; break;
+  }
+  return mod;
+}
+
+void ChannelModsTester::GenerateFrame( uint32_t& state, uint16_t& number_of_channels ) {
+  for( int i = 0; i < (int)sizeof( m_artnet ); i++ ) {
+    // Plenty of 0 & 255, so the 'if 0', 'above 0' & saturating mods take both paths.
+    uint32_t random = NextRandom( state );
+    switch( random & 3 ) {
+      case 0:  m_artnet[ i ] = 0;   break;
+      case 1:  m_artnet[ i ] = 255; break;
+      default: m_artnet[ i ] = random >> 8; break;
+    }
+  }
+  number_of_channels = NextRandom( state ) % 2 == 0 ? 512 : 1 + NextRandom( state ) % 512;
+}
+
+bool ChannelModsTester::Differs( int engine, const TestCase& test_case ) {
+  uint32_t state = test_case.m_frame_seed;
+
+  // The buffers start with the same random contents, including the padding the mods can read.
+  for( int i = 0; i < (int)sizeof( m_dmx_reference ); i++ ) {
+    m_dmx_reference[ i ] = NextRandom( state );
+  }
+  memcpy( m_dmx_engine, m_dmx_reference, sizeof( m_dmx_engine ) );
+
+  if( engine == MODS_ENGINE_OPTIMIZED ) {
+    m_ChannelModsOptimizer.Optimize( test_case.m_mods, m_program );
+  } else {
+    m_program = test_case.m_mods;
+  }
+
+  for( int frame = 0; frame < MODS_TEST_FRAMES; frame++ ) {
+    uint16_t number_of_channels;
+    this->GenerateFrame( state, number_of_channels );
+
+    ChannelModsReference( test_case.m_mods, test_case.m_copy_artnet_to_dmx, &m_artnet[ 1 ], number_of_channels, m_dmx_reference );
+    this->RunEngine( engine, m_program, test_case.m_copy_artnet_to_dmx, number_of_channels, m_dmx_engine );
+
+    for( int channel = 0; channel < 513; channel++ ) {
+      if( m_dmx_reference[ channel ] != m_dmx_engine[ channel ] ) {
+        m_failure_frame    = frame;
+        m_failure_channel  = channel;
+        m_failure_expected = m_dmx_reference[ channel ];
+        m_failure_result   = m_dmx_engine[ channel ];
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void ChannelModsTester::RunEngine( int engine, const std::vector< ChannelMod >& program, bool copy_artnet_to_dmx, uint16_t number_of_channels, uint8_t* ptr_dmx_buffer ) {
+  // The frame set up as ESP32Artnet2DMX::HandleDMXFrame() does, without pixel maps.
+  if( copy_artnet_to_dmx ) {
+    memcpy( &ptr_dmx_buffer[ 1 ], &m_artnet[ 1 ], number_of_channels );
+  } else {
+    memset( ptr_dmx_buffer, 0, 513 );
+  }
+
+  switch( engine ) {
+    case MODS_ENGINE_HANDLER:
+    case MODS_ENGINE_OPTIMIZED:
+      ChannelModsHandler::ApplyMods( program, ptr_dmx_buffer, &m_artnet[ 1 ] );
+      break;
+  }
+}
+
+void ChannelModsTester::Shrink( int engine, TestCase& test_case ) {
+  // Drop one mod at a time while the case still fails, until no single mod can go.
+  TestCase candidate  = test_case;
+  bool     shrunk     = true;
+  while( shrunk ) {
+    shrunk = false;
+    for( int i = test_case.m_mods.size() - 1; i >= 0; i-- ) {
+      candidate.m_mods = test_case.m_mods;
+      candidate.m_mods.erase( candidate.m_mods.begin() + i );
+      if( this->Differs( engine, candidate ) ) {
+        test_case.m_mods = candidate.m_mods;
+        shrunk = true;
+      }
+    }
+  }
+}
+
+void ChannelModsTester::Benchmark( const std::vector< ChannelMod >& mods, bool copy_artnet_to_dmx ) {
+  uint32_t state = 1;
+  uint16_t number_of_channels;
+
+  m_benchmark_reference_us = 0;
+  for( int frame = 0; frame < MODS_BENCHMARK_FRAMES; frame++ ) {
+    this->GenerateFrame( state, number_of_channels );
+    unsigned long start_us = micros();
+    ChannelModsReference( mods, copy_artnet_to_dmx, &m_artnet[ 1 ], number_of_channels, m_dmx_reference );
+    m_benchmark_reference_us += micros() - start_us;
+  }
+
+  for( int engine = 0; engine < MODS_ENGINE_COUNT; engine++ ) {
+    if( engine == MODS_ENGINE_OPTIMIZED ) {
+      m_ChannelModsOptimizer.Optimize( mods, m_program );
+    } else {
+      m_program = mods;
+    }
+    m_benchmark_mods_running[ engine ] = m_program.size();
+
+    state = 1;
+    m_benchmark_engine_us[ engine ] = 0;
+    for( int frame = 0; frame < MODS_BENCHMARK_FRAMES; frame++ ) {
+      this->GenerateFrame( state, number_of_channels );
+      unsigned long start_us = micros();
+      this->RunEngine( engine, m_program, copy_artnet_to_dmx, number_of_channels, m_dmx_engine );
+      m_benchmark_engine_us[ engine ] += micros() - start_us;
+    }
+  }
+}
+
+int ChannelModsTester::GetCasesRun() const {
+  return m_cases_run;
+}
+
+int ChannelModsTester::GetFailureEngine() const {
+  return m_failure_engine;
+}
+
+uint32_t ChannelModsTester::GetFailureCaseSeed() const {
+  return m_failure_case.m_frame_seed;
+}
+
+bool ChannelModsTester::GetFailureCopyArtnetToDMX() const {
+  return m_failure_case.m_copy_artnet_to_dmx;
+}
+
+int ChannelModsTester::GetFailureFrame() const {
+  return m_failure_frame;
+}
+
+int ChannelModsTester::GetFailureChannel() const {
+  return m_failure_channel;
+}
+
+uint8_t ChannelModsTester::GetFailureExpected() const {
+  return m_failure_expected;
+}
+
+uint8_t ChannelModsTester::GetFailureResult() const {
+  return m_failure_result;
+}
+
+int ChannelModsTester::GetFailureModsBeforeShrink() const {
+  return m_failure_mods_before_shrink;
+}
+
+const std::vector< ChannelMod >& ChannelModsTester::GetFailureMods() const {
+  return m_failure_case.m_mods;
+}
+
+unsigned long ChannelModsTester::GetBenchmarkReferenceUs() const {
+  return m_benchmark_reference_us;
+}
+
+unsigned long ChannelModsTester::GetBenchmarkEngineUs( int engine ) const {
+  return m_benchmark_engine_us[ engine ];
+}
+
+int ChannelModsTester::GetBenchmarkModsRunning( int engine ) const {
+  return m_benchmark_mods_running[ engine ];
+}
@@ -0,0 +1,111 @@
+#ifndef _CHANNELMODSTESTER_H_
+#define _CHANNELMODSTESTER_H_
+
+#include <Arduino.h>
+#include <vector>
+#include "ChannelMod.h"
+#include "ChannelModsReference.h"
+#include "ChannelModsHandler.h"
+#include "ChannelModsOptimizer.h"
+
+#define MODS_TEST_CASES_DEFAULT   200
+#define MODS_TEST_CASES_MAX       5000
+#define MODS_TEST_MODS_MAX        48    // Mods in a random list.
+#define MODS_TEST_FRAMES          4     // Frames per mod list, the DMX buffer carries over between them like on the node.
+#define MODS_TEST_VALUE_MAX       600   // Mod values above 512 read past the buffers ..
+#define MODS_TEST_PADDING         128   // .. into this, which is the same in every engine.
+#define MODS_BENCHMARK_FRAMES     100
+
+enum MODSENGINE : int {
+  MODS_ENGINE_HANDLER   = 0,  // ChannelModsHandler::ApplyMods() on the mods as configured.
+  MODS_ENGINE_OPTIMIZED = 1,  // ChannelModsHandler::ApplyMods() on the ChannelModsOptimizer output, what the node runs.
+  MODS_ENGINE_COUNT     = 2,
+};
+
+inline const char* ModsEngineAsString( int engine ) {
+  switch( engine ) {
+    case MODS_ENGINE_HANDLER:   return "handler";
+    case MODS_ENGINE_OPTIMIZED: return "optimized";
+    default:                    return "unknown";
+  }
+};
+
+// Differential test of the mod engines against the frozen ChannelModsReference().  Random mod lists, including
+// values of 0 & above 512, self copies & values at the saturation edges, are run on random frames by the reference
+// & every engine & the outputs compared byte for byte.  A failing list is shrunk to the fewest mods that still fail.
+class ChannelModsTester {
+public:
+  ChannelModsTester();
+
+  virtual ~ChannelModsTester();
+
+  // Returns false on the first difference, see the failure getters.  The same seed gives the same mod lists.
+  bool Run( int cases, uint32_t seed );
+
+  // Times the reference & the engines on a mod list, e.g. the config.
+  void Benchmark( const std::vector< ChannelMod >& mods, bool copy_artnet_to_dmx );
+
+  int      GetCasesRun() const;
+  int      GetFailureEngine() const;
+  uint32_t GetFailureCaseSeed() const;
+  bool     GetFailureCopyArtnetToDMX() const;
+  int      GetFailureFrame() const;
+  int      GetFailureChannel() const;
+  uint8_t  GetFailureExpected() const;
+  uint8_t  GetFailureResult() const;
+  int      GetFailureModsBeforeShrink() const;
+  const std::vector< ChannelMod >& GetFailureMods() const;
+
+  unsigned long GetBenchmarkReferenceUs() const;
+  unsigned long GetBenchmarkEngineUs( int engine ) const;
+  int           GetBenchmarkModsRunning( int engine ) const;
+
+protected:
+  // Runs one frame of an engine.  Virtual so the host tests can break an engine & check the shrinker.
+  virtual void RunEngine( int engine, const std::vector< ChannelMod >& program, bool copy_artnet_to_dmx, uint16_t number_of_channels, uint8_t* ptr_dmx_buffer );
+
+  // Art-Net data starts at m_artnet[ 1 ], so a mod value of 0 reads m_artnet[ 0 ].
+  uint8_t       m_artnet[ 1 + 512 + MODS_TEST_PADDING ];
+
+private:
+  struct TestCase {
+    std::vector< ChannelMod > m_mods;
+    bool                      m_copy_artnet_to_dmx;
+    uint32_t                  m_frame_seed;
+  };
+
+  static uint32_t NextRandom( uint32_t& state );
+
+  void GenerateCase( TestCase& test_case );
+
+  ChannelMod GenerateMod( uint32_t window_start );
+
+  void GenerateFrame( uint32_t& state, uint16_t& number_of_channels );
+
+  // Runs the frames of the case on the reference & the engine, true on the first difference.
+  bool Differs( int engine, const TestCase& test_case );
+
+  void Shrink( int engine, TestCase& test_case );
+
+  uint32_t                  m_random_state;
+  ChannelModsOptimizer      m_ChannelModsOptimizer;
+  std::vector< ChannelMod > m_program;
+
+  uint8_t       m_dmx_reference[ 513 + MODS_TEST_PADDING ];
+  uint8_t       m_dmx_engine[ 513 + MODS_TEST_PADDING ];
+
+  int           m_cases_run;
+  int           m_failure_engine;          // -1 if none.
+  TestCase      m_failure_case;
+  int           m_failure_frame;
+  int           m_failure_channel;
+  uint8_t       m_failure_expected;
+  uint8_t       m_failure_result;
+  int           m_failure_mods_before_shrink;
+
+  unsigned long m_benchmark_reference_us;
+  unsigned long m_benchmark_engine_us[ MODS_ENGINE_COUNT ];
+  int           m_benchmark_mods_running[ MODS_ENGINE_COUNT ];
+};
+
+#endif
@@ -0,0 +1,311 @@
+#include "ChannelMonitor.h"
+
+ChannelMonitor::ChannelMonitor() : m_WebSocketsServer( MONITOR_WEBSOCKET_PORT ) {
+  memset( m_snapshot_length, 0, sizeof( m_snapshot_length ) );
+  memset( m_snapshot, 0, sizeof( m_snapshot ) );
+  memset( m_clients, 0, sizeof( m_clients ) );
+  m_is_started    = false;
+  m_rate_hz       = 0;
+  m_interval_ms   = 0;
+  m_capture_ms    = 0;
+  m_capture_count = 0;
+  m_client_count  = 0;
+  m_client_next   = 0;
+  this->ResetStats();
+}
+
+ChannelMonitor::~ChannelMonitor() {
+}
+
+void ChannelMonitor::Begin() {
+  if( m_is_started ) {
+    return;
+  }
+  m_WebSocketsServer.onEvent( std::bind( &ChannelMonitor::OnEvent, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4 ) );
+  m_WebSocketsServer.begin();
+  m_is_started = true;
+}
+
+void ChannelMonitor::SetRate( int rate_hz ) {
+  m_rate_hz     = constrain( rate_hz, 0, MONITOR_RATE_HZ_MAX );
+  m_interval_ms = ( m_rate_hz > 0 ) ? 1000 / m_rate_hz : 0;
+
+  if( m_rate_hz == 0 ) {
+    for( int i = 0; i < MONITOR_CLIENTS_MAX; i++ ) {
+      if( m_clients[ i ].m_connected ) {
+        m_WebSocketsServer.disconnect( i );
+      }
+    }
+  }
+}
+
+bool ChannelMonitor::IsCaptureDue( unsigned long time_ms ) const {
+  return m_rate_hz > 0 && m_client_count > 0 && time_ms - m_capture_ms >= m_interval_ms;
+}
+
+void ChannelMonitor::Capture( const uint8_t* ptr_input, uint16_t input_length, const uint8_t* ptr_output, uint16_t output_length, unsigned long time_ms ) {
+  m_snapshot_length[ MONITOR_STREAM_INPUT ]  = ( ptr_input != nullptr ) ? min( input_length, (uint16_t)512 ) : 0;
+  m_snapshot_length[ MONITOR_STREAM_OUTPUT ] = ( ptr_output != nullptr ) ? min( output_length, (uint16_t)512 ) : 0;
+  if( ptr_input != nullptr ) {
+    memcpy( m_snapshot[ MONITOR_STREAM_INPUT ], ptr_input, m_snapshot_length[ MONITOR_STREAM_INPUT ] );
+  }
+  if( ptr_output != nullptr ) {
+    memcpy( m_snapshot[ MONITOR_STREAM_OUTPUT ], ptr_output, m_snapshot_length[ MONITOR_STREAM_OUTPUT ] );
+  }
+  m_capture_ms = time_ms;
+  m_capture_count++;
+}
+
+void ChannelMonitor::Update( unsigned long time_ms ) {
+  if( !m_is_started ) {
+    return;
+  }
+  unsigned long start_us = micros();
+
+  m_WebSocketsServer.loop();
+
+  // The next client that hasn't had the latest snapshot.
+  for( int i = 0; i < MONITOR_CLIENTS_MAX; i++ ) {
+    int client_index = ( m_client_next + i ) % MONITOR_CLIENTS_MAX;
+    MonitorClient& client = m_clients[ client_index ];
+    if( client.m_connected && client.m_capture_sent != m_capture_count ) {
+      this->SendTo( client_index );
+      m_client_next = ( client_index + 1 ) % MONITOR_CLIENTS_MAX;
+      break;
+    }
+  }
+
+  unsigned long update_us = micros() - start_us;
+  if( update_us > m_update_us_max ) {
+    m_update_us_max = update_us;
+  }
+  this->UpdateWindow( time_ms, update_us );
+}
+
+void ChannelMonitor::ResetStats() {
+  m_messages         = 0;
+  m_full_frames      = 0;
+  m_bytes_sent       = 0;
+  m_send_failed      = 0;
+  m_rejected         = 0;
+  m_update_us_max    = 0;
+  m_window_start_ms  = millis();
+  m_window_bytes     = 0;
+  m_window_us        = 0;
+  m_bytes_per_second = 0;
+  m_cpu_permille     = 0;
+}
+
+int ChannelMonitor::GetRate() const {
+  return m_rate_hz;
+}
+
+int ChannelMonitor::GetClientCount() const {
+  return m_client_count;
+}
+
+unsigned long ChannelMonitor::GetCaptureCount() const {
+  return m_capture_count;
+}
+
+unsigned long ChannelMonitor::GetMessageCount() const {
+  return m_messages;
+}
+
+unsigned long ChannelMonitor::GetFullFrameCount() const {
+  return m_full_frames;
+}
+
+unsigned long ChannelMonitor::GetBytesSent() const {
+  return m_bytes_sent;
+}
+
+unsigned long ChannelMonitor::GetSendFailedCount() const {
+  return m_send_failed;
+}
+
+unsigned long ChannelMonitor::GetRejectedCount() const {
+  return m_rejected;
+}
+
+unsigned long ChannelMonitor::GetUpdateUsMax() const {
+  return m_update_us_max;
+}
+
+unsigned long ChannelMonitor::GetBytesPerSecond() const {
+  return m_bytes_per_second;
+}
+
+unsigned long ChannelMonitor::GetCpuPermille() const {
+  return m_cpu_permille;
+}
+
+void ChannelMonitor::OnEvent( uint8_t num, WStype_t type, uint8_t* payload, size_t length ) {
+  switch( type ) {
+    case WStype_CONNECTED: {
+      if( num >= MONITOR_CLIENTS_MAX || m_rate_hz == 0 ) {
+        m_rejected++;
+        m_WebSocketsServer.disconnect( num );
+        break;
+      }
+      MonitorClient& client = m_clients[ num ];
+      memset( &client, 0, sizeof( client ) );
+      client.m_connected    = true;
+      client.m_streams      = ( 1 << MONITOR_STREAM_INPUT ) | ( 1 << MONITOR_STREAM_OUTPUT );
+      client.m_capture_sent = m_capture_count - 1;   // Sent the current snapshot straight away.
+      m_client_count++;
+      break;
+    }
+    case WStype_DISCONNECTED: {
+      if( num < MONITOR_CLIENTS_MAX && m_clients[ num ].m_connected ) {
+        m_clients[ num ].m_connected = false;
+        m_client_count--;
+      }
+      break;
+    }
+    case WStype_TEXT: {
+      if( num >= MONITOR_CLIENTS_MAX || !m_clients[ num ].m_connected ) {
+        break;
+      }
+      MonitorClient& client = m_clients[ num ];
+      uint8_t streams = 0;
+      if( length == 5 && memcmp( payload, "input", 5 ) == 0 ) {
+        streams = 1 << MONITOR_STREAM_INPUT;
+      } else if( length == 6 && memcmp( payload, "output", 6 ) == 0 ) {
+        streams = 1 << MONITOR_STREAM_OUTPUT;
+      } else if( length == 4 && memcmp( payload, "both", 4 ) == 0 ) {
+        streams = ( 1 << MONITOR_STREAM_INPUT ) | ( 1 << MONITOR_STREAM_OUTPUT );
+      }
+      if( streams != 0 ) {
+        // A stream that is switched back on starts with a full frame, the browser cleared it.
+        client.m_streams = streams;
+        memset( client.m_sent_length, 0, sizeof( client.m_sent_length ) );
+        client.m_capture_sent = m_capture_count - 1;
+      }
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+bool ChannelMonitor::SendTo( int client_index ) {
+  MonitorClient& client = m_clients[ client_index ];
+  client.m_capture_sent = m_capture_count;
+
+  size_t position = WEBSOCKETS_MAX_HEADER_SIZE;
+  m_message[ position++ ] = MONITOR_MESSAGE_VERSION;
+  m_message[ position++ ] = m_capture_count & 0xFF;
+  m_message[ position++ ] = ( m_capture_count >> 8 ) & 0xFF;
+
+  bool changed = false;
+  for( int stream = 0; stream < MONITOR_STREAM_COUNT; stream++ ) {
+    if( client.m_streams & ( 1 << stream ) ) {
+      changed |= this->EncodeStream( client, stream, position );
+    }
+  }
+  if( !changed ) {
+    return true;
+  }
+
+  size_t length = position - WEBSOCKETS_MAX_HEADER_SIZE;
+  if( !m_WebSocketsServer.sendBIN( client_index, &m_message[ WEBSOCKETS_MAX_HEADER_SIZE ], length, true ) ) {
+    // The browser's copy is unknown now, start it again from full frames.
+    memset( client.m_sent_length, 0, sizeof( client.m_sent_length ) );
+    m_send_failed++;
+    return false;
+  }
+  m_messages++;
+  m_bytes_sent   += length;
+  m_window_bytes += length;
+  return true;
+}
+
+bool ChannelMonitor::EncodeStream( MonitorClient& client, int stream, size_t& position ) {
+  const uint8_t* ptr_snapshot = m_snapshot[ stream ];
+  uint8_t*       ptr_sent     = client.m_sent[ stream ];
+  uint16_t       length       = m_snapshot_length[ stream ];
+
+  if( length == 0 ) {
+    return false;
+  }
+
+  size_t   start        = position;
+  bool     full         = ( client.m_sent_length[ stream ] != length );
+  uint16_t run_count    = 0;
+  size_t   run_position = start + 6;
+
+  if( !full ) {
+    // Runs of changed slots, short gaps are sent rather than starting a new run.
+    int slot = 0;
+    while( slot < length ) {
+      if( ptr_snapshot[ slot ] == ptr_sent[ slot ] ) {
+        slot++;
+        continue;
+      }
+      int first = slot;
+      int last  = slot;
+      for( slot = slot + 1; slot < length && slot - last <= MONITOR_RUN_GAP_MERGE; slot++ ) {
+        if( ptr_snapshot[ slot ] != ptr_sent[ slot ] ) {
+          last = slot;
+        }
+      }
+      slot = last + 1;
+
+      uint16_t count = last - first + 1;
+      if( run_position + 4 + count > start + 6 + 4 + length ) {
+        // Bigger than the whole frame.
+        full = true;
+        break;
+      }
+      m_message[ run_position++ ] = first & 0xFF;
+      m_message[ run_position++ ] = first >> 8;
+      m_message[ run_position++ ] = count & 0xFF;
+      m_message[ run_position++ ] = count >> 8;
+      memcpy( &m_message[ run_position ], &ptr_snapshot[ first ], count );
+      run_position += count;
+      run_count++;
+    }
+    if( !full && run_count == 0 ) {
+      return false;
+    }
+  }
+
+  if( full ) {
+    run_count    = 1;
+    run_position = start + 6;
+    m_message[ run_position++ ] = 0;
+    m_message[ run_position++ ] = 0;
+    m_message[ run_position++ ] = length & 0xFF;
+    m_message[ run_position++ ] = length >> 8;
+    memcpy( &m_message[ run_position ], ptr_snapshot, length );
+    run_position += length;
+    m_full_frames++;
+  }
+
+  m_message[ start + 0 ] = stream;
+  m_message[ start + 1 ] = full ? 1 : 0;
+  m_message[ start + 2 ] = length & 0xFF;
+  m_message[ start + 3 ] = length >> 8;
+  m_message[ start + 4 ] = run_count & 0xFF;
+  m_message[ start + 5 ] = run_count >> 8;
+  position = run_position;
+
+  memcpy( ptr_sent, ptr_snapshot, length );
+  client.m_sent_length[ stream ] = length;
+  return true;
+}
+
+void ChannelMonitor::UpdateWindow( unsigned long time_ms, unsigned long update_us ) {
+  m_window_us += update_us;
+
+  unsigned long window_ms = time_ms - m_window_start_ms;
+  if( window_ms >= MONITOR_STATS_WINDOW_MS ) {
+    m_bytes_per_second = m_window_bytes * 1000 / window_ms;
+    m_cpu_permille     = m_window_us / window_ms;
+    m_window_start_ms  = time_ms;
+    m_window_bytes     = 0;
+    m_window_us        = 0;
+  }
+}
@@ -0,0 +1,120 @@
+#ifndef _CHANNELMONITOR_H_
+#define _CHANNELMONITOR_H_
+
+#include <Arduino.h>
+#include <WebSocketsServer.h>   // WebSockets library by Markus Sattler (links2004).
+
+#define MONITOR_WEBSOCKET_PORT      81
+#define MONITOR_CLIENTS_MAX         4     // Further browsers are disconnected.
+#define MONITOR_RATE_HZ_DEFAULT     10
+#define MONITOR_RATE_HZ_MAX         30
+#define MONITOR_RUN_GAP_MERGE       4     // Unchanged slots between changes that are cheaper to send than a new run header.
+#define MONITOR_STATS_WINDOW_MS     1000  // CPU & bandwidth are measured over this time.
+#define MONITOR_MESSAGE_VERSION     1
+
+// Streams, what a client can ask for with a text message of "input", "output" or "both".
+enum MONITORSTREAM : int {
+  MONITOR_STREAM_INPUT  = 0,   // Merged Art-Net or sACN of the patched universe, before pixel maps, mods & the patch.
+  MONITOR_STREAM_OUTPUT = 1,   // The DMX frame, as sent.
+  MONITOR_STREAM_COUNT  = 2,
+};
+
+inline const char* MonitorStreamAsString( int stream ) {
+  switch( stream ) {
+    case MONITOR_STREAM_INPUT:  return "input";
+    case MONITOR_STREAM_OUTPUT: return "output";
+    default:                    return "unknown";
+  }
+};
+
+struct MonitorClient {
+  bool          m_connected;
+  uint8_t       m_streams;                                      // Bit per MONITORSTREAM.
+  unsigned long m_capture_sent;                                 // m_capture_count when last sent.
+  uint16_t      m_sent_length[ MONITOR_STREAM_COUNT ];          // 0 = nothing sent yet, the next message is a full frame.
+  uint8_t       m_sent[ MONITOR_STREAM_COUNT ][ 512 ];          // What the browser has, deltas are against this.
+};
+
+// Streams the input & output frames of the DMX port to browsers over a WebSocket.  loop() copies both frames
+// into a snapshot at most rate_hz times a second, never from the packet path, & each client is sent only the
+// slots that changed since its last message.  One message is sent per Update(), however many clients there are,
+// so the time taken from loop() stays bounded.  The DMX output runs from the frame timer & is never waited on.
+//
+// Binary messages, little endian:
+//   u8 version, u16 capture count, then per stream that changed:
+//   u8 stream, u8 flags (1 = full frame), u16 frame length, u16 run count, runs of u16 first slot (0 based), u16 slots, data.
+class ChannelMonitor {
+public:
+  ChannelMonitor();
+
+  ~ChannelMonitor();
+
+  // Once the network is up.
+  void Begin();
+
+  // 0 = off, clients are disconnected.
+  void SetRate( int rate_hz );
+
+  // loop() only.  True when a snapshot is wanted.
+  bool IsCaptureDue( unsigned long time_ms ) const;
+
+  // loop() only.  Copies the frames into the snapshot, length 0 if the stream has nothing.
+  void Capture( const uint8_t* ptr_input, uint16_t input_length, const uint8_t* ptr_output, uint16_t output_length, unsigned long time_ms );
+
+  // loop() only.  Services the WebSocket & sends one client its changes.
+  void Update( unsigned long time_ms );
+
+  void ResetStats();
+
+  int           GetRate() const;
+  int           GetClientCount() const;
+  unsigned long GetCaptureCount() const;
+  unsigned long GetMessageCount() const;
+  unsigned long GetFullFrameCount() const;
+  unsigned long GetBytesSent() const;
+  unsigned long GetSendFailedCount() const;
+  unsigned long GetRejectedCount() const;       // Clients over MONITOR_CLIENTS_MAX.
+  unsigned long GetUpdateUsMax() const;
+  unsigned long GetBytesPerSecond() const;      // Over the last MONITOR_STATS_WINDOW_MS.
+  unsigned long GetCpuPermille() const;         // Time in Update(), per 1000 of the last MONITOR_STATS_WINDOW_MS.
+
+private:
+  void OnEvent( uint8_t num, WStype_t type, uint8_t* payload, size_t length );
+
+  bool SendTo( int client_index );
+
+  // Appends the stream's changes to the message, returns false if unchanged.
+  bool EncodeStream( MonitorClient& client, int stream, size_t& position );
+
+  void UpdateWindow( unsigned long time_ms, unsigned long update_us );
+
+  WebSocketsServer m_WebSocketsServer;
+  bool             m_is_started;
+  int              m_rate_hz;
+  unsigned long    m_interval_ms;
+  unsigned long    m_capture_ms;
+  unsigned long    m_capture_count;
+  uint16_t         m_snapshot_length[ MONITOR_STREAM_COUNT ];
+  uint8_t          m_snapshot[ MONITOR_STREAM_COUNT ][ 512 ];
+  MonitorClient    m_clients[ MONITOR_CLIENTS_MAX ];
+  int              m_client_count;
+  int              m_client_next;       // Round robin.
+
+  // Header room for the library to frame the message in place, so sending never allocates.
+  uint8_t          m_message[ WEBSOCKETS_MAX_HEADER_SIZE + 3 + MONITOR_STREAM_COUNT * ( 6 + 4 + 512 ) ];
+
+  // Stats
+  unsigned long    m_messages;
+  unsigned long    m_full_frames;
+  unsigned long    m_bytes_sent;
+  unsigned long    m_send_failed;
+  unsigned long    m_rejected;
+  unsigned long    m_update_us_max;
+  unsigned long    m_window_start_ms;
+  unsigned long    m_window_bytes;
+  unsigned long    m_window_us;
+  unsigned long    m_bytes_per_second;
+  unsigned long    m_cpu_permille;
+};
+
+#endif
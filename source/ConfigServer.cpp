@@ -3,7 +3,23 @@
 
 ConfigServer::ConfigServer() {
   m_settings_changed     = false;
+  m_settings_save_pending = false;
+  m_settings_save_due_ms = 0;
+  m_mods_revision        = 0;
   m_is_connected_to_wifi = false;
+  m_ptr_ShowRecorder     = nullptr;
+  m_ptr_ShowPlayer       = nullptr;
+  m_ptr_NodeStats        = nullptr;
+  m_ptr_SequenceTracker  = nullptr;
+  m_ptr_ArtNetForwarder  = nullptr;
+  m_ptr_PatchMatrix      = nullptr;
+  m_ptr_PixelMapper      = nullptr;
+  m_ptr_ChannelModsOptimizer = nullptr;
+  m_ptr_TraceRing        = nullptr;
+  m_ptr_ChannelMonitor   = nullptr;
+  m_ptr_ArtNetRemote     = nullptr;
+  m_ptr_CueEngine        = nullptr;
+  m_ptr_Logger           = nullptr;
 }
 
 ConfigServer::~ConfigServer() {
@@ -12,7 +28,7 @@ ConfigServer::~ConfigServer() {
 void ConfigServer::Init() {
 
   if( !this->SettingsLoad() ) {
-    Serial.println( "Settings failed to load - Resetting to default." );
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "Settings failed to load - Resetting to default." );
     this->ResetConfigToDefault();
   }
 
@@ -32,6 +48,11 @@ void ConfigServer::ResetConfigToDefault() {
   this->ResetESP32PinsToDefault();
   this->ResetArtnet2DMXToDefault();
   this->ResetChannelModsToDefault();
+  this->ResetPixelMapsToDefault();
+  this->ResetShowToDefault();
+  this->ResetTimecodeToDefault();
+  this->ResetTraceToDefault();
+  this->ResetMonitorToDefault();
 
   // Disable DMX output
   m_dmx_enabled = false;
@@ -51,7 +72,7 @@ void ConfigServer::ResetESP32PinsToDefault() {
   // DMX settings
   m_gpio_enable      = 21;  // Connect to DE & RE on MAX485.
   m_gpio_transmit    = 33;  // Connected to DI on MAX485.
-  m_gpio_receive     = 38;  // Ensure pin is not connected to anything.
+  m_gpio_receive     = 38;  // Only connected for DMX input mode.
 }
 
 void ConfigServer::ResetChannelModsToDefault() {
@@ -59,26 +80,80 @@ void ConfigServer::ResetChannelModsToDefault() {
   m_ChannelModsHandler.Clear();
 }
 
+void ConfigServer::ResetPixelMapsToDefault() {
+  m_pixel_maps.clear();
+}
+
+void ConfigServer::ResetShowToDefault() {
+  m_show_play_on_timeout = false;
+}
+
+void ConfigServer::ResetTimecodeToDefault() {
+  m_timecode_enabled    = false;
+  m_timecode_release_ms = CUE_RELEASE_MS_DEFAULT;
+}
+
+void ConfigServer::ResetTraceToDefault() {
+  m_trace_enabled = false;
+}
+
+void ConfigServer::ResetMonitorToDefault() {
+  m_monitor_rate_hz = MONITOR_RATE_HZ_DEFAULT;
+}
+
 void ConfigServer::ResetArtnet2DMXToDefault() {
   m_artnet_source_ip       = "255.255.255.255";  // Any IP source is fine.
+  m_artnet_merge_mode      = MERGEMODE::HTP;
   m_artnet_universe        = 1;                  // Universe to listen for, all other universes are ignored.
   m_artnet_timeout_ms      = 3000;               // Artnet timeout
   m_dmx_update_interval_ms = 23;                 // Roughly 4hz
+  m_dmx_frame_slots_min    = DMX_FRAME_SLOTS_MIN;
+  m_dmx_break_us           = DMX_BREAK_US_DEFAULT;
+  m_dmx_mab_us             = DMX_MAB_US_DEFAULT;
+  m_dmx_mode               = DMXMODE::DMX_OUTPUT;
+  m_dmx_input_target_ip    = "";                 // Broadcast.
+  m_dmx_input_keepalive_ms = DMX_INPUT_KEEPALIVE_MS_DEFAULT;
+  m_artnet_short_name      = "ESP32-Artnet2DMX";
+  m_artnet_long_name       = "ESP32 Art-Net to DMX converter";
+  m_artnet_pollreply_broadcast = false;          // Art-Net 4 replies to the controller directly.
+  m_sacn_enabled           = false;
+  m_sacn_universe          = 1;
+  m_network_receive_buffer_size = 0;            // Network stack default.
+  m_patch_matrix           = "";                 // Only the Art-Net universe.
+  m_artnet_forward_targets = "";                 // No forwarding.
+  m_artnet_remote_config   = true;               // ArtAddress, ArtCommand & ArtIpProg from the source IPs.
 }
 
 void ConfigServer::SettingsSave() {
   // Start LittleFS
   if( !LittleFS.begin( false ) ) {
-    Serial.println( "LittleFS failed.  Attempting format." );
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "LittleFS failed.  Attempting format." );
     if( !LittleFS.begin( true ) ) {
-      Serial.println( "LittleFS failed format. Config saving aborted." );
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_ERROR, "LittleFS failed format. Config saving aborted." );
       return;     
     } else {
-      Serial.println( "LittleFS: Formatted" );
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_INFO, "LittleFS: Formatted" );
     }
   }
 
-  // Adapter config
+  this->SettingsWriteAdapter();
+  this->SettingsWriteMods();
+
+  // A save that was waiting is included.
+  m_settings_save_pending = false;
+  m_settings_changed      = true;
+}
+
+void ConfigServer::SettingsSaveLater() {
+  m_settings_save_pending = true;
+  m_settings_save_due_ms  = millis() + CONFIG_SAVE_DELAY_MS;
+}
+
+void ConfigServer::SettingsSaveAndRestart() {
+  this->SettingsSave();
+}
+
+void ConfigServer::SettingsWriteAdapter() {
   DynamicJsonDocument doc( 32768 );
   doc[ "wifi_ssid" ]              = m_wifi_ssid;
   doc[ "wifi_pass" ]              = m_wifi_pass;
@@ -88,18 +163,44 @@ void ConfigServer::SettingsSave() {
   doc[ "gpio_transmit" ]          = m_gpio_transmit;
   doc[ "gpio_receive" ]           = m_gpio_receive;
   doc[ "artnet_source_ip" ]       = m_artnet_source_ip;
+  doc[ "artnet_merge_mode" ]      = m_artnet_merge_mode;
   doc[ "artnet_universe" ]        = m_artnet_universe;
   doc[ "artnet_timeout_ms" ]      = m_artnet_timeout_ms;
   doc[ "dmx_update_interval_ms" ] = m_dmx_update_interval_ms;
   doc[ "dmx_enabled" ]            = m_dmx_enabled;
-
+  doc[ "dmx_frame_slots_min" ]    = m_dmx_frame_slots_min;
+  doc[ "dmx_break_us" ]           = m_dmx_break_us;
+  doc[ "dmx_mab_us" ]             = m_dmx_mab_us;
+  doc[ "dmx_mode" ]               = m_dmx_mode;
+  doc[ "dmx_input_target_ip" ]    = m_dmx_input_target_ip;
+  doc[ "dmx_input_keepalive_ms" ] = m_dmx_input_keepalive_ms;
+  doc[ "artnet_short_name" ]      = m_artnet_short_name;
+  doc[ "artnet_long_name" ]       = m_artnet_long_name;
+  doc[ "artnet_pollreply_broadcast" ] = m_artnet_pollreply_broadcast;
+  doc[ "sacn_enabled" ]           = m_sacn_enabled;
+  doc[ "sacn_universe" ]          = m_sacn_universe;
+  doc[ "network_receive_buffer_size" ] = m_network_receive_buffer_size;
+  doc[ "patch_matrix" ]           = m_patch_matrix;
+  doc[ "artnet_forward_targets" ] = m_artnet_forward_targets;
+  doc[ "show_play_on_timeout" ]   = m_show_play_on_timeout;
+  doc[ "timecode_enabled" ]       = m_timecode_enabled;
+  doc[ "timecode_release_ms" ]    = m_timecode_release_ms;
+  doc[ "trace_enabled" ]          = m_trace_enabled;
+  doc[ "monitor_rate_hz" ]        = m_monitor_rate_hz;
+  doc[ "artnet_remote_config" ]   = m_artnet_remote_config;
+
+  this->Trace( TRACE_FLASH_WRITE_BEGIN, 0 );
   File config_adapter = LittleFS.open( CONFIG_ADAPTER, "w" );
-  serializeJson( doc, config_adapter );
+  size_t bytes_written = serializeJson( doc, config_adapter );
   config_adapter.close();
+  this->Trace( TRACE_FLASH_WRITE_END, bytes_written );
+}
 
-  // Clear out json
-  doc.clear();
+void ConfigServer::SettingsWriteMods() {
+  DynamicJsonDocument doc( 32768 );
 
+  m_mods_revision++;
+  doc[ "revision" ]           = m_mods_revision;
   doc[ "copy_artnet_to_dmx" ] = m_channel_mods_copy_artnet_to_dmx;
 
   // Mods config
@@ -113,17 +214,32 @@ void ConfigServer::SettingsSave() {
     obj[ "mod_value" ] = mod.m_mod_value;
   }
 
+  JsonArray array_pixelmaps = doc.createNestedArray( "pixel_maps" );
+
+  for( const PixelMap& map : m_pixel_maps ) {
+    JsonObject obj        = array_pixelmaps.createNestedObject();
+    obj[ "output_start" ] = map.m_output_start;
+    obj[ "pixel_count" ]  = map.m_pixel_count;
+    obj[ "input_start" ]  = map.m_input_start;
+    obj[ "colour_order" ] = map.m_colour_order;
+    obj[ "colour_plane" ] = map.m_colour_plane;
+    obj[ "grouping" ]     = map.m_grouping;
+    obj[ "reverse" ]      = map.m_reverse;
+    obj[ "zigzag_width" ] = map.m_zigzag_width;
+    obj[ "repeat" ]       = map.m_repeat;
+  }
+
+  this->Trace( TRACE_FLASH_WRITE_BEGIN, 0 );
   File config_mods = LittleFS.open( CONFIG_MODS, "w" );
-  serializeJson( doc, config_mods );
+  size_t bytes_written = serializeJson( doc, config_mods );
   config_mods.close();
-
-  m_settings_changed = true;
+  this->Trace( TRACE_FLASH_WRITE_END, bytes_written );
 }
 
 bool ConfigServer::SettingsLoad() {
   if( !LittleFS.begin( false ) ) {
     // Failed to start LittleFS, probably no save.
-    Serial.println( "Failed to start LittleFS" );
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_ERROR, "Failed to start LittleFS" );
     return false;
   }
 
@@ -132,7 +248,7 @@ bool ConfigServer::SettingsLoad() {
 
   if( !config_adapter ) {
     // File not exist.
-    Serial.println( "Failed to load adapter config file." );
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_ERROR, "Failed to load adapter config file." );
     return false;
   }
 
@@ -148,10 +264,31 @@ bool ConfigServer::SettingsLoad() {
   m_gpio_transmit          = doc[ "gpio_transmit" ];
   m_gpio_receive           = doc[ "gpio_receive" ];
   m_artnet_source_ip       = doc[ "artnet_source_ip" ].as<String>();
+  m_artnet_merge_mode      = doc[ "artnet_merge_mode" ];
   m_artnet_universe        = doc[ "artnet_universe" ];
   m_artnet_timeout_ms      = doc[ "artnet_timeout_ms" ];
   m_dmx_update_interval_ms = doc[ "dmx_update_interval_ms" ];
   m_dmx_enabled            = doc[ "dmx_enabled" ];
+  m_dmx_frame_slots_min    = doc[ "dmx_frame_slots_min" ] | DMX_FRAME_SLOTS_MIN;
+  m_dmx_break_us           = doc[ "dmx_break_us" ] | DMX_BREAK_US_DEFAULT;
+  m_dmx_mab_us             = doc[ "dmx_mab_us" ] | DMX_MAB_US_DEFAULT;
+  m_dmx_mode               = doc[ "dmx_mode" ];
+  m_dmx_input_target_ip    = doc[ "dmx_input_target_ip" ] | "";
+  m_dmx_input_keepalive_ms = doc[ "dmx_input_keepalive_ms" ] | DMX_INPUT_KEEPALIVE_MS_DEFAULT;
+  m_artnet_short_name      = doc[ "artnet_short_name" ] | "ESP32-Artnet2DMX";
+  m_artnet_long_name       = doc[ "artnet_long_name" ] | "ESP32 Art-Net to DMX converter";
+  m_artnet_pollreply_broadcast = doc[ "artnet_pollreply_broadcast" ];
+  m_sacn_enabled           = doc[ "sacn_enabled" ];
+  m_sacn_universe          = doc[ "sacn_universe" ] | 1;
+  m_network_receive_buffer_size = doc[ "network_receive_buffer_size" ];
+  m_patch_matrix           = doc[ "patch_matrix" ] | "";
+  m_artnet_forward_targets = doc[ "artnet_forward_targets" ] | "";
+  m_show_play_on_timeout   = doc[ "show_play_on_timeout" ];
+  m_timecode_enabled       = doc[ "timecode_enabled" ];
+  m_timecode_release_ms    = doc[ "timecode_release_ms" ] | CUE_RELEASE_MS_DEFAULT;
+  m_trace_enabled          = doc[ "trace_enabled" ];
+  m_monitor_rate_hz        = doc[ "monitor_rate_hz" ] | MONITOR_RATE_HZ_DEFAULT;
+  m_artnet_remote_config   = doc[ "artnet_remote_config" ] | true;
 
   // Clear out json
   doc.clear();
@@ -161,25 +298,49 @@ bool ConfigServer::SettingsLoad() {
 
   if( !config_mods ) {
     // File not exist.
-    Serial.println( "Failed to load adapter config file." );
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_ERROR, "Failed to load adapter config file." );
     return false;
   }
 
   deserializeJson( doc, config_mods );
   config_mods.close();
 
+  m_mods_revision                   = doc[ "revision" ] | 0;
   m_channel_mods_copy_artnet_to_dmx = doc[ "copy_artnet_to_dmx" ];
 
-  m_ChannelModsHandler.Clear();
-
+  // Sorted once, not per mod.
+  std::vector< ChannelMod > mods;
   JsonArray array_channelmods = doc[ "channel_mods" ];
+  mods.reserve( array_channelmods.size() );
   for( const JsonObject& obj : array_channelmods ) {
     ChannelMod mod;
     mod.m_sequence  = obj[ "sequence" ];
     mod.m_channel   = obj[ "channel" ];
     mod.m_mod_type  = obj[ "mod_type" ];
     mod.m_mod_value = obj[ "mod_value" ];
-    m_ChannelModsHandler.AddMod( mod );
+    mods.push_back( mod );
+  }
+  m_ChannelModsHandler.SetMods( mods );
+
+  m_pixel_maps.clear();
+
+  JsonArray array_pixelmaps = doc[ "pixel_maps" ];
+  for( const JsonObject& obj : array_pixelmaps ) {
+    PixelMap map;
+    map.m_output_start = obj[ "output_start" ];
+    map.m_pixel_count  = obj[ "pixel_count" ];
+    map.m_input_start  = obj[ "input_start" ];
+    strlcpy( map.m_colour_order, obj[ "colour_order" ] | "RGB", sizeof( map.m_colour_order ) );
+    map.m_colour_plane = obj[ "colour_plane" ];
+    map.m_grouping     = obj[ "grouping" ] | 1;
+    map.m_reverse      = obj[ "reverse" ];
+    map.m_zigzag_width = obj[ "zigzag_width" ];
+    map.m_repeat       = obj[ "repeat" ] | 1;
+    if( !PixelMapper::IsValid( map ) || m_pixel_maps.size() >= PIXEL_MAPS_MAX ) {
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "Pixel map at output channel %u ignored.", map.m_output_start );
+      continue;
+    }
+    m_pixel_maps.push_back( map );
   }
 
   return true;
@@ -242,6 +403,10 @@ bool ConfigServer::IsConnectedToWiFi() {
   return m_is_connected_to_wifi;
 }
 
+const String& ConfigServer::GetMACAddress() const {
+  return m_mac_address;
+}
+
 void ConfigServer::StartWebServer() {
   m_WebServer.onNotFound( std::bind( &ConfigServer::HandleWebServerDataOnNotFound, this ) );
 
@@ -252,14 +417,33 @@ void ConfigServer::StartWebServer() {
   m_WebServer.on( "/reset_esp32pins", HTTP_GET, std::bind( &ConfigServer::HandleResetESP32Pins, this ) );
   m_WebServer.on( "/reset_artnew2dmx", HTTP_GET, std::bind( &ConfigServer::HandleResetArtnet2DMX, this ) );
   m_WebServer.on( "/reset_channelmods", HTTP_GET, std::bind( &ConfigServer::HandleResetChannelMods, this ) );
+  m_WebServer.on( "/reset_pixelmaps", HTTP_GET, std::bind( &ConfigServer::HandleResetPixelMaps, this ) );
+  m_WebServer.on( "/reset_show", HTTP_GET, std::bind( &ConfigServer::HandleResetShow, this ) );
+  m_WebServer.on( "/reset_timecode", HTTP_GET, std::bind( &ConfigServer::HandleResetTimecode, this ) );
+  m_WebServer.on( "/reset_trace", HTTP_GET, std::bind( &ConfigServer::HandleResetTrace, this ) );
+  m_WebServer.on( "/reset_monitor", HTTP_GET, std::bind( &ConfigServer::HandleResetMonitor, this ) );
+  m_WebServer.on( "/reset_stats", HTTP_GET, std::bind( &ConfigServer::HandleResetStats, this ) );
 
   m_WebServer.on( "/settings_wifi", HTTP_GET, std::bind( &ConfigServer::SendWiFiSetupPage, this ) );
   m_WebServer.on( "/settings_esp32pins", HTTP_GET, std::bind( &ConfigServer::SendESP32PinsSetupPage, this ) );
   m_WebServer.on( "/settings_artnet2dmx", HTTP_GET, std::bind( &ConfigServer::SendArtnet2DMXSetupPage, this ) );
   m_WebServer.on( "/settings_channelmods", HTTP_GET, std::bind( &ConfigServer::SendChannelModsSetupPage, this ) );
-  m_WebServer.on( "/download", HTTP_GET, std::bind( &ConfigServer::SendModConfigFile, this ) ); // There's only 1 download, so ignoring filename.
+  m_WebServer.on( "/settings_pixelmaps", HTTP_GET, std::bind( &ConfigServer::SendPixelMapsSetupPage, this ) );
+  m_WebServer.on( "/settings_show", HTTP_GET, std::bind( &ConfigServer::SendShowSetupPage, this ) );
+  m_WebServer.on( "/settings_timecode", HTTP_GET, std::bind( &ConfigServer::SendTimecodeSetupPage, this ) );
+  m_WebServer.on( "/settings_trace", HTTP_GET, std::bind( &ConfigServer::SendTraceSetupPage, this ) );
+  m_WebServer.on( "/trace", HTTP_GET, std::bind( &ConfigServer::SendTrace, this ) );
+  m_WebServer.on( "/log", HTTP_GET, std::bind( &ConfigServer::SendLog, this ) );
+  m_WebServer.on( "/monitor", HTTP_GET, std::bind( &ConfigServer::SendMonitorPage, this ) );
+  m_WebServer.on( "/download", HTTP_GET, std::bind( &ConfigServer::SendDownloadFile, this ) );
+  m_WebServer.on( "/stats", HTTP_GET, std::bind( &ConfigServer::SendStats, this ) );
+#if MODS_SELFTEST_ROUTE
+  m_WebServer.on( "/selftest_mods", HTTP_GET, std::bind( &ConfigServer::SendModsSelfTest, this ) );
+#endif
+  m_WebServer.on( "/mods", HTTP_GET, std::bind( &ConfigServer::SendMods, this ) );
 
   m_WebServer.on( "/upload", HTTP_POST, std::bind( &ConfigServer::Send200Response, this ), std::bind( &ConfigServer::HandleFileUpload, this ) );
+  m_WebServer.on( "/upload_cues", HTTP_POST, std::bind( &ConfigServer::Send200Response, this ), std::bind( &ConfigServer::HandleCueFileUpload, this ) );
   m_WebServer.on( "/dmx_enable", HTTP_POST, std::bind( &ConfigServer::HandleDMXEnable, this ) );
   m_WebServer.on( "/dmx_disable", HTTP_POST, std::bind( &ConfigServer::HandleDMXDisable, this ) );
   m_WebServer.on( "/copy_artnet_enable", HTTP_POST, std::bind( &ConfigServer::HandleCopyArtnetToDMXEnable, this ) );
@@ -269,19 +453,46 @@ void ConfigServer::StartWebServer() {
   m_WebServer.on( "/setup_esp32pins", HTTP_POST, std::bind( &ConfigServer::HandleSetupESP32Pins, this ) );
   m_WebServer.on( "/setup_artnet2dmx", HTTP_POST, std::bind( &ConfigServer::HandleSetupArtnet2DMX, this ) );
   m_WebServer.on( "/setup_channelmods", HTTP_POST, std::bind( &ConfigServer::HandleSetupChannelMods, this ) );
+  m_WebServer.on( "/pixelmaps_add", HTTP_POST, std::bind( &ConfigServer::HandlePixelMapsAdd, this ) );
+  m_WebServer.on( "/setup_show", HTTP_POST, std::bind( &ConfigServer::HandleSetupShow, this ) );
+  m_WebServer.on( "/show_record_start", HTTP_POST, std::bind( &ConfigServer::HandleShowRecordStart, this ) );
+  m_WebServer.on( "/show_record_stop", HTTP_POST, std::bind( &ConfigServer::HandleShowRecordStop, this ) );
+  m_WebServer.on( "/show_play_once", HTTP_POST, std::bind( &ConfigServer::HandleShowPlayOnce, this ) );
+  m_WebServer.on( "/show_play_loop", HTTP_POST, std::bind( &ConfigServer::HandleShowPlayLoop, this ) );
+  m_WebServer.on( "/show_play_stop", HTTP_POST, std::bind( &ConfigServer::HandleShowPlayStop, this ) );
+  m_WebServer.on( "/setup_timecode", HTTP_POST, std::bind( &ConfigServer::HandleSetupTimecode, this ) );
+  m_WebServer.on( "/setup_trace", HTTP_POST, std::bind( &ConfigServer::HandleSetupTrace, this ) );
+  m_WebServer.on( "/setup_monitor", HTTP_POST, std::bind( &ConfigServer::HandleSetupMonitor, this ) );
+  m_WebServer.on( "/trace_freeze", HTTP_POST, std::bind( &ConfigServer::HandleTraceFreeze, this ) );
+  m_WebServer.on( "/trace_resume", HTTP_POST, std::bind( &ConfigServer::HandleTraceResume, this ) );
+  m_WebServer.on( "/mods_batch", HTTP_POST, std::bind( &ConfigServer::HandleModsBatch, this ) );
   
   m_WebServer.on( UriBraces("/setup_channelmodsfor/{}"), HTTP_POST, std::bind( &ConfigServer::HandleSetupChannelModsForChannel, this ) );
   m_WebServer.on( UriBraces("/mods_editfor/{}"), HTTP_POST, std::bind( &ConfigServer::HandleChannelModsEditFor, this ) );
   m_WebServer.on( UriBraces("/mods_removefor/{}"), HTTP_POST, std::bind( &ConfigServer::HandleChannelModsRemoveFor, this ) );
   m_WebServer.on( UriBraces("/mods_addfor/{}"), HTTP_POST, std::bind( &ConfigServer::HandleChannelModsAddFor, this ) );
   m_WebServer.on( UriBraces("/mods_delfor/{}/{}"), HTTP_POST, std::bind( &ConfigServer::HandleChannelModsDelFor, this ) );
+  m_WebServer.on( UriBraces("/pixelmaps_remove/{}"), HTTP_POST, std::bind( &ConfigServer::HandlePixelMapsRemove, this ) );
 
   m_WebServer.begin();
 }
 
 bool ConfigServer::Update() {
 
+  // Only traced when a request was handled, an idle handleClient() would fill the ring.
+  unsigned long request_start_us = micros();
   m_WebServer.handleClient();
+  if( m_ptr_TraceRing != nullptr && micros() - request_start_us >= TRACE_WEB_REQUEST_MIN_US ) {
+    m_ptr_TraceRing->RecordAt( request_start_us, TRACE_WEB_REQUEST_BEGIN, TRACE_TASK_LOOP, 0 );
+    m_ptr_TraceRing->Record( TRACE_WEB_REQUEST_END, TRACE_TASK_LOOP, 0 );
+  }
+
+  // Changes already running, written once controllers have stopped sending them.
+  if( m_settings_save_pending && (long)( millis() - m_settings_save_due_ms ) >= 0 ) {
+    m_settings_save_pending = false;
+    this->SettingsWriteAdapter();
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_INFO, "Remote config saved." );
+  }
 
   if( m_settings_changed ) {
     m_settings_changed = false;
@@ -295,6 +506,65 @@ const std::vector< ChannelMod >& ConfigServer::GetModsVector() const {
   return m_ChannelModsHandler.GetModsVector();
 }
 
+const std::vector< PixelMap >& ConfigServer::GetPixelMapsVector() const {
+  return m_pixel_maps;
+}
+
+void ConfigServer::SetShowControl( ShowRecorder* ptr_show_recorder, ShowPlayer* ptr_show_player ) {
+  m_ptr_ShowRecorder = ptr_show_recorder;
+  m_ptr_ShowPlayer   = ptr_show_player;
+}
+
+void ConfigServer::SetNodeStats( NodeStats* ptr_node_stats ) {
+  m_ptr_NodeStats = ptr_node_stats;
+}
+
+void ConfigServer::SetSequenceTracker( SequenceTracker* ptr_sequence_tracker ) {
+  m_ptr_SequenceTracker = ptr_sequence_tracker;
+}
+
+void ConfigServer::SetArtNetForwarder( ArtNetForwarder* ptr_artnet_forwarder ) {
+  m_ptr_ArtNetForwarder = ptr_artnet_forwarder;
+}
+
+void ConfigServer::SetPatchMatrix( PatchMatrix* ptr_patch_matrix ) {
+  m_ptr_PatchMatrix = ptr_patch_matrix;
+}
+
+void ConfigServer::SetPixelMapper( PixelMapper* ptr_pixel_mapper ) {
+  m_ptr_PixelMapper = ptr_pixel_mapper;
+}
+
+void ConfigServer::SetChannelModsOptimizer( ChannelModsOptimizer* ptr_channel_mods_optimizer ) {
+  m_ptr_ChannelModsOptimizer = ptr_channel_mods_optimizer;
+}
+
+void ConfigServer::SetTraceRing( TraceRing* ptr_trace_ring ) {
+  m_ptr_TraceRing = ptr_trace_ring;
+}
+
+void ConfigServer::SetChannelMonitor( ChannelMonitor* ptr_channel_monitor ) {
+  m_ptr_ChannelMonitor = ptr_channel_monitor;
+}
+
+void ConfigServer::SetArtNetRemote( ArtNetRemote* ptr_artnet_remote ) {
+  m_ptr_ArtNetRemote = ptr_artnet_remote;
+}
+
+void ConfigServer::SetCueEngine( CueEngine* ptr_cue_engine ) {
+  m_ptr_CueEngine = ptr_cue_engine;
+}
+
+void ConfigServer::SetLogger( Logger* ptr_logger ) {
+  m_ptr_Logger = ptr_logger;
+}
+
+void ConfigServer::Trace( int event, uint16_t arg ) {
+  if( m_ptr_TraceRing != nullptr ) {
+    m_ptr_TraceRing->Record( event, TRACE_TASK_LOOP, arg );
+  }
+}
+
 void ConfigServer::SendSetupMenuPage() {
   m_WebpageBuilder.StartPage();
   m_WebpageBuilder.AddTitle( "Artnet2DMX Setup Page" );
@@ -311,6 +581,20 @@ void ConfigServer::SendSetupMenuPage() {
   m_WebpageBuilder.AddButtonActionForm( "settings_artnet2dmx", "Art-Net 2 DMX" );
   m_WebpageBuilder.AddBreak( 2 );
   m_WebpageBuilder.AddButtonActionForm( "settings_channelmods", "Channel Mods" );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddButtonActionForm( "settings_pixelmaps", "Pixel Maps" );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddButtonActionForm( "settings_show", "Show Recorder" );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddButtonActionForm( "settings_timecode", "Timecode Cues" );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddButtonActionForm( "settings_trace", "Trace" );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddButtonActionForm( "log", "Log" );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddButtonActionForm( "monitor", "Monitor" );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddButtonActionForm( "stats", "Stats" );
 
   m_WebpageBuilder.AddBreak( 3 );
   m_WebpageBuilder.AddLabel( "note", "It's advisable to disable DMX output during setup." );
@@ -397,7 +681,7 @@ void ConfigServer::SendESP32PinsSetupPage() {
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "GPIO Transmit", "gpio_transmit", String( m_gpio_transmit ), "", true );
   m_WebpageBuilder.AddBreak( 2 );
-  m_WebpageBuilder.AddLabel( "gpio_receive", "GPIO - Receive : Ensure GPIO is not connected." );
+  m_WebpageBuilder.AddLabel( "gpio_receive", "GPIO - Receive : Connect to RO on the MAX485 for DMX input mode, otherwise ensure GPIO is not connected." );
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "GPIO Receive", "gpio_receive", String( m_gpio_receive ), "", true );
 
@@ -430,10 +714,14 @@ void ConfigServer::SendArtnet2DMXSetupPage() {
 
   m_WebpageBuilder.AddFormAction( "/setup_artnet2dmx", "POST" );
   m_WebpageBuilder.AddBreak( 2 );
-  m_WebpageBuilder.AddLabel( "source ip", "Source IP that will send Art-Net packets. Use 255.255.255.255 if any." );
+  m_WebpageBuilder.AddLabel( "source ip", "Source IPs that will send Art-Net packets, separated by commas. Use 255.255.255.255 if any." );
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "text", "source ip", "artnet_source_ip", String( m_artnet_source_ip ), "xxx.xxx.xxx.xxx", true );
   m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "merge mode", "Merge mode when more than one source sends the universe. HTP = highest channel value, LTP = latest source." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddSelector2Items( "artnet_merge_mode", "merge mode", "HTP", "LTP", m_artnet_merge_mode == MERGEMODE::HTP );
+  m_WebpageBuilder.AddBreak( 2 );
   m_WebpageBuilder.AddLabel( "Art-Net Universe", "Art-Net Universe : The Art-Net universe to translate into DMX. All other universes are ignored." );
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "Art-Net universe", "artnet_universe", String( m_artnet_universe ), "", true );
@@ -442,9 +730,69 @@ void ConfigServer::SendArtnet2DMXSetupPage() {
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "Art-Net timeout in ms", "artnet_timeout_ms", String( m_artnet_timeout_ms ), "", true );
   m_WebpageBuilder.AddBreak( 2 );
-  m_WebpageBuilder.AddLabel( "DMX update interval in ms", "DMX interval update in milliseconds.  Only change this if you know what you're doing." );
+  m_WebpageBuilder.AddLabel( "DMX update interval in ms", "DMX interval update in milliseconds.  Use 0 to send as fast as the frame length allows.  Only change this if you know what you're doing." );
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "DMX update interval in ms", "dmx_update_ms", String( m_dmx_update_interval_ms ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX mode", "DMX mode : Output Art-Net & sACN as DMX, or input DMX from a console & send it as Art-Net on the Art-Net universe." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddSelector2Items( "dmx_mode", "DMX mode", "Output", "Input", m_dmx_mode == DMXMODE::DMX_OUTPUT );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX input target IP", "DMX input target IP : Where DMX input is sent.  Leave empty to broadcast." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "DMX input target IP", "dmx_input_target_ip", m_dmx_input_target_ip, "", false );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX input keepalive in ms", "DMX input keepalive in ms : Unchanged DMX input is only resent at this interval." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "DMX input keepalive in ms", "dmx_input_keepalive_ms", String( m_dmx_input_keepalive_ms ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX minimum slots", "DMX minimum slots (24 - 512) : Frames stop at the highest channel in use, but are never shorter than this.  Use 512 for fixtures that need full frames." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "DMX minimum slots", "dmx_frame_slots_min", String( m_dmx_frame_slots_min ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX break in us", "DMX break in microseconds (minimum 92).  Default 176." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "DMX break in us", "dmx_break_us", String( m_dmx_break_us ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX MAB in us", "DMX mark after break in microseconds (minimum 12).  Default 12." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "DMX MAB in us", "dmx_mab_us", String( m_dmx_mab_us ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Art-Net short name", "Node name shown by Art-Net controllers (max 17 characters)." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "Art-Net short name", "artnet_short_name", m_artnet_short_name, "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Art-Net long name", "Node description shown by Art-Net controllers (max 63 characters)." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "Art-Net long name", "artnet_long_name", m_artnet_long_name, "", false );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "ArtPollReply", "ArtPollReply : Unicast to the controller (Art-Net 4), or broadcast for older Art-Net 3 controllers." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddSelector2Items( "artnet_pollreply", "ArtPollReply", "Unicast", "Broadcast", !m_artnet_pollreply_broadcast );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Remote config", "Remote config : ArtAddress, ArtCommand & ArtIpProg from the source IPs can change the universe, names, merge & IP." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddSelector2Items( "artnet_remote_config", "Remote config", "Enabled", "Disabled", m_artnet_remote_config );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "sACN", "sACN (E1.31) : Also receive sACN.  Uses the same source IPs, merge & channel mods as Art-Net." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddSelector2Items( "sacn_enabled", "sACN", "Disabled", "Enabled", !m_sacn_enabled );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "sACN universe", "sACN universe (1 - 63999) : Only the multicast group of this universe is joined." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "sACN universe", "sacn_universe", String( m_sacn_universe ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "receive buffer", "Network receive buffer in bytes.  Larger absorbs WiFi bursts, uses more RAM.  Use 0 for the network stack default." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "receive buffer", "network_receive_buffer_size", String( m_network_receive_buffer_size ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "patch", "Patch from other universes : Output channels taken from any received Art-Net universe, applied after the channel mods.  Comma separated output:universe:input:count, e.g. 1:2:1:96 puts channels 1-96 of universe 2 on output channels 1-96.  Up to 4 universes." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "patch", "patch_matrix", m_patch_matrix, "", false );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "forward targets", "Art-Net forwarding : Re-send the DMX output (after mods) as Art-Net.  Comma separated ip:universe:max fps:c, e.g. 192.168.1.50:2:30:c.  Universe defaults to the Art-Net universe, max fps 0 = every frame, c = only send changes.  Leave empty for no forwarding." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "forward targets", "artnet_forward_targets", m_artnet_forward_targets, "", false );
 
   // Submit button
   m_WebpageBuilder.AddBreak( 3 );
@@ -497,7 +845,7 @@ void ConfigServer::SendChannelModsSetupPage() {
   m_WebpageBuilder.AddFileDownloadLink( "config_mods.json", "Click to download config_mods.json" );
 
   m_WebpageBuilder.AddBreak( 2 );
-  m_WebpageBuilder.AddFileUpload();
+  m_WebpageBuilder.AddFileUpload( "/upload" );
 
   // Cancel button
   m_WebpageBuilder.AddBreak( 3 );
@@ -565,13 +913,13 @@ void ConfigServer::SendChannelModsForChannelSetupPage( int channel_number ) {
   int mod_position = 0;
 
   for( const ChannelMod& mod : m_ChannelModsHandler.GetModsVector() ) {
-    if( mod.m_channel == channel_number ) {
+    if( mod.m_channel == (unsigned int)channel_number ) {
       // Add mod type
       m_WebpageBuilder.m_html += "<select name=\"mod_type_" + String( mod.m_sequence ) + "\" id=\"Mod Type\">";
       for( int mod_type = 0; mod_type <= CHANNELMODTYPE::MAX; mod_type++ )
       {
         m_WebpageBuilder.m_html +=  "<option value=\"" + String( mod_type ) + "\"";
-        if( mod.m_mod_type == mod_type ) {
+        if( mod.m_mod_type == (unsigned int)mod_type ) {
           m_WebpageBuilder.m_html += " selected";
         }
         m_WebpageBuilder.m_html += ">" + String( ModTypeAsString( mod_type ) ) + "</option>";
@@ -610,132 +958,934 @@ void ConfigServer::SendChannelModsForChannelSetupPage( int channel_number ) {
 
 }
 
-void ConfigServer::SendModConfigFile() {
-  String filename = CONFIG_MODS;
-
-  if( LittleFS.exists( filename ) ) {
-    String filenameonly = filename;
-    int last_slash_position = filename.lastIndexOf( '/' );
-    if( last_slash_position != -1 ) {
-        filenameonly = filename.substring( last_slash_position + 1 );
-    } else {
-        filenameonly = filename;
-    }
-    File file = LittleFS.open( filename, "r" );
-    m_WebServer.sendHeader( "Content-Disposition", "attachment; filename=\"" + filenameonly + "\"" );
-    m_WebServer.streamFile( file, "application/octet-stream" );
-    file.close();
-
-    this->SendChannelModsSetupPage();
-  } else {
-    m_WebServer.send( 200, "text/plain", "Not found!" );
-    delay( 4000 );
-    Serial.printf("File not sent.\n");
-  }  
-}
+void ConfigServer::SendPixelMapsSetupPage() {
+  m_WebpageBuilder.StartPage();
+  m_WebpageBuilder.AddStandardViewportScale();
+  m_WebpageBuilder.AddTitle( "Pixel Maps Setup Page" );
+  m_WebpageBuilder.StartBody();
+  m_WebpageBuilder.StartCenter();
+  m_WebpageBuilder.AddHeading( "Pixel Maps Setup" );
+  m_WebpageBuilder.AddBreak( 3 );
 
-void ConfigServer::Send200Response() {
-  m_WebServer.send( 200 );
-}
+  m_WebpageBuilder.AddFormAction( "/pixelmaps_add", "POST" );
+  m_WebpageBuilder.AddLabel( "output_start", "First output channel (1 - 512)." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "output_start", "output_start", "1", "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "pixel_count", "Number of output pixels." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "pixel_count", "pixel_count", "1", "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "input_start", "First Art-Net channel (1 - 512)." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "input_start", "input_start", "1", "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "colour_order", "Colour order on the output : RGB, GRB, BGR, .. RGBW, GRBW, .. or W for one channel per pixel.  Art-Net pixels are always R, G, B (W)." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "colour_order", "colour_order", "RGB", "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "colour_plane", "Art-Net colour planes : 0 when Art-Net sends RGBRGB.., otherwise the number of channels from the first red to the first green (and green to blue) channel." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "colour_plane", "colour_plane", "0", "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "grouping", "Grouping : Output pixels that share one Art-Net pixel." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "grouping", "grouping", "1", "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "reverse", "Direction : Reversed puts the first Art-Net pixel on the last output pixel." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddSelector2Items( "reverse", "reverse", "Forward", "Reversed", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "zigzag_width", "Zig-zag : Pixels per row when every other row runs backwards, 0 = off." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "zigzag_width", "zigzag_width", "0", "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "repeat", "Repeat : The pixels are output this many times back to back." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "repeat", "repeat", "1", "", true );
 
-void ConfigServer::HandleResetAll() {
-  m_WebServer.send( 200, "text/plain", "Resetting everything to defaults - Reconnect to hotspot to setup WiFi." );
-  delay( 4000 );
-  this->ResetConfigToDefault();
-  this->SettingsSave();
-  this->ConnectToWiFi();
-}
+  // Submit button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButton( "submit", "ADD NEW" );
+  m_WebpageBuilder.EndFormAction();
 
-void ConfigServer::HandleResetWiFi() {
-  m_WebServer.send( 200, "text/plain", "Resetting to WiFi defaults - Reconnect to hotspot to setup WiFi." );
-  delay( 4000 );
-  this->ResetWiFiToDefault();
-  this->SettingsSave();
-  this->ConnectToWiFi();
-}
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddLabel( "note", "Pixel maps are saved in config_mods.json on the Channel Mods screen, & applied before the channel mods." );
 
-void ConfigServer::HandleResetESP32Pins() {
-  this->ResetESP32PinsToDefault();
-  this->SettingsSave();
-  this->SendESP32PinsSetupPage();
-}
+  // Cancel button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/", "RETURN TO MAIN MENU" );
 
-void ConfigServer::HandleResetArtnet2DMX() {
-  this->ResetArtnet2DMXToDefault();
-  this->SettingsSave();
-  this->SendArtnet2DMXSetupPage();
-}
+  // Reset button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/reset_pixelmaps", "RESET ALL PIXEL MAPS TO DEFAULT" );
 
-void ConfigServer::HandleResetChannelMods() {
-  this->ResetChannelModsToDefault();
-  this->SettingsSave();
-  this->SendChannelModsSetupPage();
-}
+  // Remove buttons for existing maps
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddGridStyle( "grid-container", 10 );
+  m_WebpageBuilder.AddFormAction( "/pixelmaps_remove", "POST" );
+  m_WebpageBuilder.StartDivClass( "grid-container" );
 
-void ConfigServer::HandleDMXEnable() {
-    m_dmx_enabled = true;
-    this->SettingsSave();
-    this->SendSetupMenuPage();
-}
+  m_WebpageBuilder.AddGridCellText( "Output" );
+  m_WebpageBuilder.AddGridCellText( "Pixels" );
+  m_WebpageBuilder.AddGridCellText( "Art-Net" );
+  m_WebpageBuilder.AddGridCellText( "Order" );
+  m_WebpageBuilder.AddGridCellText( "Plane" );
+  m_WebpageBuilder.AddGridCellText( "Group" );
+  m_WebpageBuilder.AddGridCellText( "Reverse" );
+  m_WebpageBuilder.AddGridCellText( "Zig-zag" );
+  m_WebpageBuilder.AddGridCellText( "Repeat" );
+  m_WebpageBuilder.AddGridCellText( "" );
 
-void ConfigServer::HandleDMXDisable() {
-    m_dmx_enabled = true;
-    this->SettingsSave();
-    this->SendSetupMenuPage();
-}
+  for( size_t i = 0; i < m_pixel_maps.size(); i++ ) {
+    const PixelMap& map = m_pixel_maps[ i ];
+    m_WebpageBuilder.AddGridCellText( String( map.m_output_start ) );
+    m_WebpageBuilder.AddGridCellText( String( map.m_pixel_count ) );
+    m_WebpageBuilder.AddGridCellText( String( map.m_input_start ) );
+    m_WebpageBuilder.AddGridCellText( String( map.m_colour_order ) );
+    m_WebpageBuilder.AddGridCellText( String( map.m_colour_plane ) );
+    m_WebpageBuilder.AddGridCellText( String( map.m_grouping ) );
+    m_WebpageBuilder.AddGridCellText( map.m_reverse ? "Yes" : "No" );
+    m_WebpageBuilder.AddGridCellText( String( map.m_zigzag_width ) );
+    m_WebpageBuilder.AddGridCellText( String( map.m_repeat ) );
+    m_WebpageBuilder.AddButtonAction( "/pixelmaps_remove/" + String( i ), "Remove" );
+  }
 
-void ConfigServer::HandleCopyArtnetToDMXEnable() {
-  m_channel_mods_copy_artnet_to_dmx = true;
-  this->SettingsSave();
-  this->SendChannelModsSetupPage();
-}
+  m_WebpageBuilder.EndFormAction();
+  m_WebpageBuilder.EndDiv();
+  m_WebpageBuilder.EndCenter();
+  m_WebpageBuilder.EndBody();
+  m_WebpageBuilder.EndPage();
 
-void ConfigServer::HandleCopyArtnetToDMXDisable() {
-  m_channel_mods_copy_artnet_to_dmx = false;
-  this->SettingsSave();
-  this->SendChannelModsSetupPage();
+  m_WebServer.send( 200, "text/html", m_WebpageBuilder.m_html );
 }
 
-void ConfigServer::HandleSetupWiFi() {  
-  String wifi_ssid_new   = "";
-  String wifi_pass_new   = "";
-  String wifi_ip_new     = "";
-  String wifi_subnet_new = "";
-
-  for( int i = 0; i < m_WebServer.args(); i++ ) {
-    if( m_WebServer.argName( i ) == "wifi_ssid" ) {
-      wifi_ssid_new = m_WebServer.arg( i );
-    } else if( m_WebServer.argName( i ) == "wifi_pass" ) {
-      wifi_pass_new = m_WebServer.arg( i );
-    } else if( m_WebServer.argName( i ) == "ip" ) {
-      wifi_ip_new = m_WebServer.arg( i );
-    } else if( m_WebServer.argName( i ) == "subnet" ) {
-      wifi_subnet_new = m_WebServer.arg( i );
-    }
-  }
+void ConfigServer::SendShowSetupPage() {
+  m_WebpageBuilder.StartPage();
+  m_WebpageBuilder.AddTitle( "Show Recorder Setup Page" );
+  m_WebpageBuilder.StartBody();
+  m_WebpageBuilder.StartCenter();
+  m_WebpageBuilder.AddHeading( "Show Recorder" );
+  m_WebpageBuilder.AddBreak( 2 );
 
-  if( wifi_ssid_new.length() > 0 && wifi_pass_new.length() > 0 ) {
-    m_wifi_ssid = wifi_ssid_new;
-    m_wifi_pass = wifi_pass_new;
-    m_wifi_ip   = wifi_ip_new;
-    if( m_wifi_ip.length() > 0 && wifi_subnet_new.length() == 0 ) {
-      m_wifi_subnet = "255.255.255.0";
+  if( m_ptr_ShowRecorder != nullptr && m_ptr_ShowPlayer != nullptr ) {
+    if( m_ptr_ShowRecorder->IsRecording() ) {
+      m_WebpageBuilder.AddText( "Recording : " + String( m_ptr_ShowRecorder->GetFrameCount() ) + " frames, " + String( m_ptr_ShowRecorder->GetBytesWritten() ) + " bytes written, " + String( m_ptr_ShowRecorder->GetOverflowCount() ) + " buffer overflows." );
+      m_WebpageBuilder.AddBreak( 2 );
+      m_WebpageBuilder.AddButtonActionFormPost( "show_record_stop", "STOP RECORDING" );
+    } else if( m_ptr_ShowPlayer->IsPlaying() ) {
+      m_WebpageBuilder.AddText( "Playing : " + String( m_ptr_ShowPlayer->GetPositionMs( millis() ) / 1000 ) + " seconds." );
+      m_WebpageBuilder.AddBreak( 2 );
+      m_WebpageBuilder.AddButtonActionFormPost( "show_play_stop", "STOP PLAYBACK" );
     } else {
-      m_wifi_subnet = wifi_subnet_new;
-    }
-
-    m_WebServer.send( 200, "text/plain", "Attempting to connect to WiFi. On failure hotspot will re-appear." );
-     
-    if( this->ConnectToWiFi() ) {
-      this->SettingsSave();
+      m_WebpageBuilder.AddText( "Stopped." );
+      m_WebpageBuilder.AddBreak( 2 );
+      m_WebpageBuilder.AddButtonActionFormPost( "show_record_start", "RECORD" );
+      m_WebpageBuilder.AddBreak( 1 );
+      m_WebpageBuilder.AddButtonActionFormPost( "show_play_once", "PLAY ONCE" );
+      m_WebpageBuilder.AddBreak( 1 );
+      m_WebpageBuilder.AddButtonActionFormPost( "show_play_loop", "PLAY LOOP" );
     }
-
-    Serial.printf( "Restarting WiFi\n" );
-    this->ConnectToWiFi();
   }
-}
 
-void ConfigServer::HandleSetupESP32Pins() {  
+  m_WebpageBuilder.AddFormAction( "/setup_show", "POST" );
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddLabel( "play_on_timeout", "Loop the recorded show when Art-Net times out, until Art-Net data returns." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "play_on_timeout", "play_on_timeout", m_show_play_on_timeout );
+
+  // Submit button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButton( "submit", "SUBMIT & SAVE" );
+  m_WebpageBuilder.EndFormAction();
+
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddFileDownloadLink( SHOW_FILE.substring( 1 ), "Click to download " + SHOW_FILE.substring( 1 ) );
+
+  // Cancel button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/", "RETURN TO MAIN MENU" );
+
+  // Reset button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/reset_show", "RESET SHOW SETTINGS TO DEFAULT" );
+
+  m_WebpageBuilder.EndCenter();
+  m_WebpageBuilder.EndBody();
+  m_WebpageBuilder.EndPage();
+
+  m_WebServer.send( 200, "text/html", m_WebpageBuilder.m_html );
+}
+
+void ConfigServer::SendTimecodeSetupPage() {
+  m_WebpageBuilder.StartPage();
+  m_WebpageBuilder.AddTitle( "Timecode Cues Setup Page" );
+  m_WebpageBuilder.StartBody();
+  m_WebpageBuilder.StartCenter();
+  m_WebpageBuilder.AddHeading( "Timecode Cues" );
+  m_WebpageBuilder.AddBreak( 2 );
+
+  if( m_ptr_CueEngine != nullptr && m_timecode_enabled ) {
+    if( m_ptr_CueEngine->GetCueCount() == 0 ) {
+      const char* ptr_error = m_ptr_CueEngine->GetLoadError();
+      m_WebpageBuilder.AddText( String( "No cues : " ) + ( ptr_error != nullptr ? ptr_error : "Empty cue list" ) + "." );
+    } else if( !m_ptr_CueEngine->HasTimecode() ) {
+      m_WebpageBuilder.AddText( String( m_ptr_CueEngine->GetCueCount() ) + " cues, waiting for ArtTimeCode." );
+    } else {
+      char timecode[ 12 ];
+      CueEngine::FormatTimecode( m_ptr_CueEngine->GetTimecodeMs( millis() ), CueEngine::TypeToFps( m_ptr_CueEngine->GetTimecodeType() ), timecode );
+      String state = m_ptr_CueEngine->IsTimecodeRunning( millis() ) ? "Running" : ( m_ptr_CueEngine->IsReleased() ? "Released" : "Held" );
+      String cue   = m_ptr_CueEngine->IsActive() ? "cue " + String( m_ptr_CueEngine->GetCurrentCue() + 1 ) + " of " + String( m_ptr_CueEngine->GetCueCount() ) : ( m_ptr_CueEngine->IsReleased() ? "output left to Art-Net" : "before the first cue" );
+      m_WebpageBuilder.AddText( state + " : " + String( timecode ) + ", " + cue + "." );
+    }
+  } else {
+    m_WebpageBuilder.AddText( "Disabled." );
+  }
+
+  m_WebpageBuilder.AddFormAction( "/setup_timecode", "POST" );
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddLabel( "timecode_enabled", "Run the cue list from ArtTimeCode.  While a cue runs it has the output, & holds it if the console drops out." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "timecode_enabled", "timecode_enabled", m_timecode_enabled );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "timecode_release_ms", "Release time in ms.  The output is left to Art-Net & sACN once the timecode has stopped this long.  Use 0 to hold the cue until the timecode runs again." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "Release time in ms", "timecode_release_ms", String( m_timecode_release_ms ), "", true );
+
+  // Submit button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButton( "submit", "SUBMIT & SAVE" );
+  m_WebpageBuilder.EndFormAction();
+
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddFileUpload( "/upload_cues" );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddFileDownloadLink( CUE_FILE.substring( 1 ), "Click to download " + CUE_FILE.substring( 1 ) );
+
+  // Cancel button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/", "RETURN TO MAIN MENU" );
+
+  // Reset button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/reset_timecode", "RESET TIMECODE SETTINGS TO DEFAULT" );
+
+  m_WebpageBuilder.EndCenter();
+  m_WebpageBuilder.EndBody();
+  m_WebpageBuilder.EndPage();
+
+  m_WebServer.send( 200, "text/html", m_WebpageBuilder.m_html );
+}
+
+void ConfigServer::SendTraceSetupPage() {
+  m_WebpageBuilder.StartPage();
+  m_WebpageBuilder.AddTitle( "Trace Setup Page" );
+  m_WebpageBuilder.StartBody();
+  m_WebpageBuilder.StartCenter();
+  m_WebpageBuilder.AddHeading( "Trace" );
+  m_WebpageBuilder.AddBreak( 2 );
+
+  if( m_ptr_TraceRing != nullptr ) {
+    String state = !m_ptr_TraceRing->IsEnabled() ? "Disabled" : m_ptr_TraceRing->IsFrozen() ? "Frozen" : "Recording";
+    m_WebpageBuilder.AddText( state + " : " + String( m_ptr_TraceRing->GetEventCount() ) + " events held, " + String( m_ptr_TraceRing->GetRecordedCount() ) + " recorded." );
+    m_WebpageBuilder.AddBreak( 2 );
+    if( m_ptr_TraceRing->IsFrozen() ) {
+      m_WebpageBuilder.AddButtonActionFormPost( "trace_resume", "RESUME" );
+    } else {
+      m_WebpageBuilder.AddButtonActionFormPost( "trace_freeze", "FREEZE" );
+    }
+    m_WebpageBuilder.AddBreak( 1 );
+    m_WebpageBuilder.AddButtonActionForm( "trace", "DOWNLOAD TRACE" );
+  }
+
+  m_WebpageBuilder.AddFormAction( "/setup_trace", "POST" );
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddLabel( "trace_enabled", "Record packet arrival, parsing, channel mods, frame output, web requests & flash writes.  Open the download in chrome://tracing or ui.perfetto.dev." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "trace_enabled", "trace_enabled", m_trace_enabled );
+
+  // Submit button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButton( "submit", "SUBMIT & SAVE" );
+  m_WebpageBuilder.EndFormAction();
+
+  // Cancel button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/", "RETURN TO MAIN MENU" );
+
+  // Reset button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/reset_trace", "RESET TRACE SETTINGS TO DEFAULT" );
+
+  m_WebpageBuilder.EndCenter();
+  m_WebpageBuilder.EndBody();
+  m_WebpageBuilder.EndPage();
+
+  m_WebServer.send( 200, "text/html", m_WebpageBuilder.m_html );
+}
+
+void ConfigServer::SendTrace() {
+  if( m_ptr_TraceRing == nullptr ) {
+    m_WebServer.send( 200, "text/plain", "Not found!" );
+    return;
+  }
+
+  // Frozen while it's read, so the events don't change under the export.
+  bool frozen = m_ptr_TraceRing->IsFrozen();
+  m_ptr_TraceRing->Freeze();
+
+  // Chrome trace-event format, streamed in chunks as the whole trace doesn't fit in RAM as one String.
+  m_WebServer.sendHeader( "Content-Disposition", "attachment; filename=\"trace.json\"" );
+  m_WebServer.setContentLength( CONTENT_LENGTH_UNKNOWN );
+  m_WebServer.send( 200, "application/json", "" );
+
+  char chunk[ 1024 ];
+  int  length = snprintf( chunk, sizeof( chunk ), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" );
+  for( int task = 0; task < TRACE_TASK_COUNT; task++ ) {
+    length += snprintf( &chunk[ length ], sizeof( chunk ) - length, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}", task > 0 ? "," : "", task, TraceTaskAsString( task ) );
+  }
+
+  // Times are from the earliest event.  Tasks record out of time order, so that isn't always the oldest one.
+  int      event_count = m_ptr_TraceRing->GetEventCount();
+  uint32_t start_us    = event_count > 0 ? m_ptr_TraceRing->GetEvent( 0 ).m_time_us : 0;
+  for( int i = 1; i < event_count; i++ ) {
+    if( (int32_t)( m_ptr_TraceRing->GetEvent( i ).m_time_us - start_us ) < 0 ) {
+      start_us = m_ptr_TraceRing->GetEvent( i ).m_time_us;
+    }
+  }
+
+  // Span ends whose begin was overwritten are left out.
+  int depth[ TRACE_TASK_COUNT ] = { 0 };
+  for( int i = 0; i < event_count; i++ ) {
+    const TraceEvent& event = m_ptr_TraceRing->GetEvent( i );
+    char phase = TraceEventPhase( event.m_event );
+    int  task  = event.m_task < TRACE_TASK_COUNT ? event.m_task : TRACE_TASK_LOOP;
+    if( phase == 'B' ) {
+      depth[ task ]++;
+    } else if( phase == 'E' ) {
+      if( depth[ task ] == 0 ) {
+        continue;
+      }
+      depth[ task ]--;
+    }
+
+    if( length > (int)sizeof( chunk ) - 160 ) {
+      m_WebServer.sendContent( chunk, length );
+      length = 0;
+    }
+    length += snprintf( &chunk[ length ], sizeof( chunk ) - length, ",{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%lu,\"pid\":1,\"tid\":%i,\"args\":{\"value\":%u}}",
+                        TraceEventAsString( event.m_event ), phase, phase == 'i' ? "\"s\":\"t\"," : "", (unsigned long)( event.m_time_us - start_us ), task, event.m_arg );
+  }
+  length += snprintf( &chunk[ length ], sizeof( chunk ) - length, "]}" );
+  m_WebServer.sendContent( chunk, length );
+  m_WebServer.sendContent( "" );
+
+  if( !frozen ) {
+    m_ptr_TraceRing->Resume();
+  }
+}
+
+void ConfigServer::SendMonitorPage() {
+  m_WebpageBuilder.StartPage();
+  m_WebpageBuilder.AddTitle( "Channel Monitor" );
+  m_WebpageBuilder.StartBody();
+  m_WebpageBuilder.StartCenter();
+  m_WebpageBuilder.AddHeading( "Monitor" );
+  m_WebpageBuilder.AddBreak( 2 );
+
+  if( m_ptr_ChannelMonitor != nullptr && m_monitor_rate_hz > 0 ) {
+    m_WebpageBuilder.AddChannelMonitor( MONITOR_WEBSOCKET_PORT );
+  } else {
+    m_WebpageBuilder.AddText( "The monitor is off." );
+  }
+
+  m_WebpageBuilder.AddFormAction( "/setup_monitor", "POST" );
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddLabel( "monitor_rate_hz", "Updates per second, 0 to " + String( MONITOR_RATE_HZ_MAX ) + ".  0 turns the monitor off.  Up to " + String( MONITOR_CLIENTS_MAX ) + " browsers, only changed channels are sent." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "monitor_rate_hz", "monitor_rate_hz", String( m_monitor_rate_hz ), "", true );
+
+  // Submit button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButton( "submit", "SUBMIT & SAVE" );
+  m_WebpageBuilder.EndFormAction();
+
+  // Cancel button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/", "RETURN TO MAIN MENU" );
+
+  // Reset button
+  m_WebpageBuilder.AddBreak( 3 );
+  m_WebpageBuilder.AddButtonActionForm( "/reset_monitor", "RESET MONITOR SETTINGS TO DEFAULT" );
+
+  m_WebpageBuilder.EndCenter();
+  m_WebpageBuilder.EndBody();
+  m_WebpageBuilder.EndPage();
+
+  m_WebServer.send( 200, "text/html", m_WebpageBuilder.m_html );
+}
+
+void ConfigServer::SendLog() {
+  if( m_ptr_Logger == nullptr ) {
+    m_WebServer.send( 200, "text/plain", "Not found!" );
+    return;
+  }
+
+  // e.g. /log?level=debug, until the next restart.
+  if( m_WebServer.hasArg( "level" ) ) {
+    for( int level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_DEBUG; level++ ) {
+      if( m_WebServer.arg( "level" ) == LogLevelAsString( level ) ) {
+        m_ptr_Logger->SetLevel( level );
+      }
+    }
+  }
+
+  String text = "Level " + String( LogLevelAsString( m_ptr_Logger->GetLevel() ) ) + ", " + String( m_ptr_Logger->GetMessageCount() ) + " messages, " +
+                String( m_ptr_Logger->GetSuppressedCount() ) + " suppressed, " + String( m_ptr_Logger->GetDroppedCount() ) + " not written to serial.\n\n";
+
+  LogEntry entry;
+  int entry_count = m_ptr_Logger->GetEntryCount();
+  for( int i = 0; i < entry_count; i++ ) {
+    m_ptr_Logger->GetEntry( i, entry );
+    text += String( entry.m_time_ms ) + " " + LogLevelAsString( entry.m_level ) + " : " + entry.m_message + "\n";
+  }
+
+  m_WebServer.send( 200, "text/plain", text );
+}
+
+void ConfigServer::SendDownloadFile() {
+  String filename = CONFIG_MODS;
+
+  if( ( "/" + m_WebServer.arg( "file" ) ) == SHOW_FILE ) {
+    filename = SHOW_FILE;
+  } else if( ( "/" + m_WebServer.arg( "file" ) ) == CUE_FILE ) {
+    filename = CUE_FILE;
+  }
+
+  if( LittleFS.exists( filename ) ) {
+    String filenameonly = filename;
+    int last_slash_position = filename.lastIndexOf( '/' );
+    if( last_slash_position != -1 ) {
+        filenameonly = filename.substring( last_slash_position + 1 );
+    } else {
+        filenameonly = filename;
+    }
+    File file = LittleFS.open( filename, "r" );
+    m_WebServer.sendHeader( "Content-Disposition", "attachment; filename=\"" + filenameonly + "\"" );
+    m_WebServer.streamFile( file, "application/octet-stream" );
+    file.close();
+
+    if( filename == CONFIG_MODS ) {
+      this->SendChannelModsSetupPage();
+    }
+  } else {
+    m_WebServer.send( 200, "text/plain", "Not found!" );
+    delay( 4000 );
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "File not sent." );
+  }  
+}
+
+void ConfigServer::SendStats() {
+  if( m_ptr_NodeStats == nullptr ) {
+    m_WebServer.send( 200, "text/plain", "Not found!" );
+    return;
+  }
+
+  // Before the document below takes its share.
+  uint32_t heap_free          = ESP.getFreeHeap();
+  uint32_t heap_free_min      = ESP.getMinFreeHeap();
+  uint32_t heap_largest_block = ESP.getMaxAllocHeap();
+
+  DynamicJsonDocument doc( 6144 );
+
+  JsonObject dmx_output = doc.createNestedObject( "dmx_output" );
+  dmx_output[ "frame_period_us" ] = m_ptr_NodeStats->m_dmx_frame_period_us;
+  dmx_output[ "slots" ]           = m_ptr_NodeStats->m_dmx_frame_slots;
+  dmx_output[ "frame_us" ]        = m_dmx_break_us + m_dmx_mab_us + ( m_ptr_NodeStats->m_dmx_frame_slots + 1 ) * DMX_SLOT_US;
+  dmx_output[ "refresh_hz" ]      = m_ptr_NodeStats->m_dmx_refresh_hz;
+  dmx_output[ "frames" ]          = m_ptr_NodeStats->m_dmx_frames;
+  dmx_output[ "frames_late" ]     = m_ptr_NodeStats->m_dmx_frames_late;
+  dmx_output[ "jitter_us_p50" ]   = m_ptr_NodeStats->m_dmx_jitter.GetPercentileUs( 500 );
+  dmx_output[ "jitter_us_p95" ]   = m_ptr_NodeStats->m_dmx_jitter.GetPercentileUs( 950 );
+  dmx_output[ "jitter_us_p99" ]   = m_ptr_NodeStats->m_dmx_jitter.GetPercentileUs( 990 );
+  dmx_output[ "jitter_us_max" ]   = m_ptr_NodeStats->m_dmx_jitter.GetMaxUs();
+
+  JsonObject dmx_input = doc.createNestedObject( "dmx_input" );
+  dmx_input[ "signal" ]           = m_ptr_NodeStats->m_dmx_input_signal;
+  dmx_input[ "frames" ]           = m_ptr_NodeStats->m_dmx_input_frames;
+  dmx_input[ "sent" ]             = m_ptr_NodeStats->m_dmx_input_sent;
+  dmx_input[ "suppressed" ]       = m_ptr_NodeStats->m_dmx_input_suppressed;
+  dmx_input[ "errors" ]           = m_ptr_NodeStats->m_dmx_input_errors;
+  dmx_input[ "other_start_code" ] = m_ptr_NodeStats->m_dmx_input_other_start_code;
+  dmx_input[ "send_failed" ]      = m_ptr_NodeStats->m_dmx_input_send_failed;
+  dmx_input[ "slots" ]            = m_ptr_NodeStats->m_dmx_input_slots;
+  dmx_input[ "latency_us_last" ]  = m_ptr_NodeStats->m_dmx_input_latency_us_last;
+  dmx_input[ "latency_us_max" ]   = m_ptr_NodeStats->m_dmx_input_latency_us_max;
+  if( m_ptr_NodeStats->m_dmx_input_sent > 0 ) {
+    dmx_input[ "latency_us_avg" ] = (unsigned long)( m_ptr_NodeStats->m_dmx_input_latency_us_total / m_ptr_NodeStats->m_dmx_input_sent );
+  }
+
+  JsonObject sync = doc.createNestedObject( "artsync" );
+  sync[ "active" ]          = m_ptr_NodeStats->m_sync_active;
+  sync[ "count" ]           = m_ptr_NodeStats->m_sync_count;
+  sync[ "latency_us_last" ] = m_ptr_NodeStats->m_sync_latency_us_last;
+  sync[ "latency_us_max" ]  = m_ptr_NodeStats->m_sync_latency_us_max;
+  if( m_ptr_NodeStats->m_sync_count > 0 ) {
+    sync[ "latency_us_avg" ] = (unsigned long)( m_ptr_NodeStats->m_sync_latency_us_total / m_ptr_NodeStats->m_sync_count );
+  }
+
+  JsonObject receive = doc.createNestedObject( "artnet_receive" );
+  receive[ "rejected_source" ]   = m_ptr_NodeStats->m_artnet_rejected_source;
+  receive[ "rejected_universe" ] = m_ptr_NodeStats->m_artnet_rejected_universe;
+  receive[ "bytes_not_copied" ]  = m_ptr_NodeStats->m_artnet_bytes_not_copied;
+  if( m_ptr_NodeStats->m_artnet_accepted_count > 0 && m_ptr_NodeStats->m_artnet_rejected_count > 0 ) {
+    // Each rejected packet saves the difference between receiving it whole & discarding it, estimated for
+    // foreign universes sent at 44 fps.
+    unsigned long accepted_ns = (unsigned long)( ( m_ptr_NodeStats->m_artnet_accepted_us_total * 1000 ) / m_ptr_NodeStats->m_artnet_accepted_count );
+    unsigned long rejected_ns = (unsigned long)( ( m_ptr_NodeStats->m_artnet_rejected_us_total * 1000 ) / m_ptr_NodeStats->m_artnet_rejected_count );
+    unsigned long saved_ns    = ( accepted_ns > rejected_ns ) ? accepted_ns - rejected_ns : 0;
+    receive[ "accepted_ns_avg" ]                 = accepted_ns;
+    receive[ "rejected_ns_avg" ]                 = rejected_ns;
+    receive[ "cpu_saved_us_per_s_10_universes" ] = ( saved_ns * 10 * 44 ) / 1000;
+    receive[ "cpu_saved_us_per_s_40_universes" ] = ( saved_ns * 40 * 44 ) / 1000;
+  }
+
+  if( m_ptr_ArtNetRemote != nullptr ) {
+    JsonObject remote = doc.createNestedObject( "artnet_remote" );
+    remote[ "enabled" ]       = m_artnet_remote_config;
+    remote[ "address" ]       = m_ptr_ArtNetRemote->GetAddressCount();
+    remote[ "command" ]       = m_ptr_ArtNetRemote->GetCommandCount();
+    remote[ "ipprog" ]        = m_ptr_ArtNetRemote->GetIpProgCount();
+    remote[ "rejected" ]      = m_ptr_ArtNetRemote->GetRejectedCount();
+    remote[ "ignored" ]       = m_ptr_ArtNetRemote->GetIgnoredCount();
+    remote[ "applied" ]       = m_ptr_ArtNetRemote->GetAppliedCount();
+    remote[ "apply_us_last" ] = m_ptr_ArtNetRemote->GetApplyUsLast();
+    remote[ "apply_us_max" ]  = m_ptr_ArtNetRemote->GetApplyUsMax();
+    remote[ "save_pending" ]  = m_settings_save_pending;
+    remote[ "indicator" ]     = IndicatorAsString( m_ptr_NodeStats->m_artnet_indicator );
+  }
+
+  JsonObject socket = doc.createNestedObject( "artnet_socket" );
+  socket[ "receive_buffer_size" ] = m_ptr_NodeStats->m_socket_receive_buffer_size;
+  socket[ "received" ]            = m_ptr_NodeStats->m_socket_received;
+  socket[ "batches" ]             = m_ptr_NodeStats->m_socket_batches;
+  socket[ "truncated" ]           = m_ptr_NodeStats->m_socket_truncated;
+  socket[ "discarded" ]           = m_ptr_NodeStats->m_socket_discarded;
+  if( m_ptr_NodeStats->m_socket_drops_available ) {
+    socket[ "drops" ]             = m_ptr_NodeStats->m_socket_drops;
+  }
+
+  JsonObject ring = doc.createNestedObject( "receive_ring" );
+  ring[ "slots" ]          = PACKET_RING_SLOTS;
+  ring[ "occupancy" ]      = m_ptr_NodeStats->m_ring_occupancy;
+  ring[ "occupancy_max" ]  = m_ptr_NodeStats->m_ring_occupancy_max;
+  ring[ "overruns" ]       = m_ptr_NodeStats->m_ring_overruns;
+  ring[ "latency_us_max" ] = m_ptr_NodeStats->m_ring_latency_us_max;
+  if( m_ptr_NodeStats->m_ring_dequeued > 0 ) {
+    ring[ "latency_us_avg" ] = (unsigned long)( m_ptr_NodeStats->m_ring_latency_us_total / m_ptr_NodeStats->m_ring_dequeued );
+  }
+
+  JsonObject sacn = doc.createNestedObject( "sacn" );
+  sacn[ "enabled" ]              = m_sacn_enabled;
+  sacn[ "packets" ]              = m_ptr_NodeStats->m_sacn_packets;
+  sacn[ "discarded_universe" ]   = m_ptr_NodeStats->m_sacn_discarded_universe;
+  sacn[ "discarded_priority" ]   = m_ptr_NodeStats->m_sacn_discarded_priority;
+  sacn[ "invalid" ]              = m_ptr_NodeStats->m_sacn_invalid;
+  sacn[ "stream_terminated" ]    = m_ptr_NodeStats->m_sacn_terminated;
+  sacn[ "sources" ]              = m_ptr_NodeStats->m_sacn_sources;
+  sacn[ "priority_active" ]      = m_ptr_NodeStats->m_sacn_priority_active;
+
+  JsonObject merge = doc.createNestedObject( "merge" );
+  merge[ "sources_active" ] = m_ptr_NodeStats->m_merge_sources_active;
+  merge[ "mode" ]           = ( m_artnet_merge_mode == MERGEMODE::LTP ) ? "LTP" : "HTP";
+  if( m_ptr_NodeStats->m_merge_exclusive_ip != 0 ) {
+    merge[ "exclusive_source_ip" ] = IPAddress( m_ptr_NodeStats->m_merge_exclusive_ip ).toString();
+  }
+  merge[ "us_last" ]        = m_ptr_NodeStats->m_merge_us_last;
+  merge[ "us_max" ]         = m_ptr_NodeStats->m_merge_us_max;
+  merge[ "benchmark_htp_2x512_ns" ] = m_ptr_NodeStats->m_merge_benchmark_ns;
+
+  // Per universe & source.  Lost points at the network, a node problem would show as no loss but missing output.
+  if( m_ptr_SequenceTracker != nullptr ) {
+    JsonArray sequence = doc.createNestedArray( "sequence" );
+    for( int i = 0; i < m_ptr_SequenceTracker->GetSourceCount(); i++ ) {
+      const SequenceSource& source = m_ptr_SequenceTracker->GetSource( i );
+      if( !source.m_in_use ) {
+        continue;
+      }
+      JsonObject obj      = sequence.createNestedObject();
+      obj[ "protocol" ]   = SequenceProtocolAsString( source.m_protocol );
+      obj[ "universe" ]   = source.m_universe;
+      obj[ "source_ip" ]  = IPAddress( source.m_source_ip ).toString();
+      obj[ "received" ]   = source.m_received;
+      obj[ "lost" ]       = source.m_lost;
+      obj[ "duplicates" ] = source.m_duplicates;
+      obj[ "reordered" ]  = source.m_reordered;
+    }
+  }
+
+  if( m_ptr_PatchMatrix != nullptr ) {
+    JsonObject patch = doc.createNestedObject( "patch" );
+    patch[ "channels" ]      = m_ptr_PatchMatrix->GetPatchedCount();
+    patch[ "apply_us_last" ] = m_ptr_PatchMatrix->GetApplyTimeUsLast();
+    patch[ "apply_us_max" ]  = m_ptr_PatchMatrix->GetApplyTimeUsMax();
+    JsonArray universes = patch.createNestedArray( "universes" );
+    for( int i = 0; i < m_ptr_PatchMatrix->GetUniverseCount(); i++ ) {
+      JsonObject obj    = universes.createNestedObject();
+      obj[ "universe" ] = m_ptr_PatchMatrix->GetUniverse( i );
+      obj[ "frames" ]   = m_ptr_PatchMatrix->GetFramesReceived( i );
+    }
+  }
+
+  JsonObject mods = doc.createNestedObject( "channel_mods" );
+  mods[ "optimized" ]     = m_ptr_NodeStats->m_mods_optimized;
+  mods[ "apply_us_last" ] = m_ptr_NodeStats->m_mods_us_last;
+  mods[ "apply_us_max" ]  = m_ptr_NodeStats->m_mods_us_max;
+  if( m_ptr_ChannelModsOptimizer != nullptr ) {
+    mods[ "configured" ]    = m_ptr_ChannelModsOptimizer->GetModsIn();
+    mods[ "running" ]       = m_ptr_ChannelModsOptimizer->GetModsOut();
+    mods[ "removed_nop" ]   = m_ptr_ChannelModsOptimizer->GetCount( MODS_REMOVED_NOP );
+    mods[ "removed_dead" ]  = m_ptr_ChannelModsOptimizer->GetCount( MODS_REMOVED_DEAD );
+    mods[ "folded" ]        = m_ptr_ChannelModsOptimizer->GetCount( MODS_FOLDED );
+    mods[ "merged" ]        = m_ptr_ChannelModsOptimizer->GetCount( MODS_MERGED );
+    mods[ "reordered" ]     = m_ptr_ChannelModsOptimizer->GetReordered();
+    mods[ "optimize_us" ]   = m_ptr_ChannelModsOptimizer->GetOptimizeTimeUs();
+    JsonArray report = mods.createNestedArray( "report" );
+    for( const ModsOptimizerEntry& entry : m_ptr_ChannelModsOptimizer->GetReport() ) {
+      JsonObject obj    = report.createNestedObject();
+      obj[ "sequence" ] = entry.m_sequence;
+      obj[ "channel" ]  = entry.m_channel;
+      obj[ "action" ]   = ModsOptimizerActionAsString( entry.m_action );
+    }
+  }
+
+  if( m_ptr_PixelMapper != nullptr ) {
+    JsonObject pixel_maps = doc.createNestedObject( "pixel_maps" );
+    pixel_maps[ "maps" ]          = m_ptr_PixelMapper->GetMapCount();
+    pixel_maps[ "channels" ]      = m_ptr_PixelMapper->GetMappedCount();
+    pixel_maps[ "apply_us_last" ] = m_ptr_PixelMapper->GetApplyTimeUsLast();
+    pixel_maps[ "apply_us_max" ]  = m_ptr_PixelMapper->GetApplyTimeUsMax();
+  }
+
+  JsonObject forward = doc.createNestedObject( "artnet_forward" );
+  forward[ "benchmark_4_targets_ns" ] = m_ptr_NodeStats->m_forward_benchmark_ns;
+  if( m_ptr_ArtNetForwarder != nullptr ) {
+    forward[ "send_us_max" ] = m_ptr_ArtNetForwarder->GetSendTimeUsMax();
+    JsonArray targets = forward.createNestedArray( "targets" );
+    for( int i = 0; i < m_ptr_ArtNetForwarder->GetTargetCount(); i++ ) {
+      const ArtNetForwardTarget& target = m_ptr_ArtNetForwarder->GetTarget( i );
+      JsonObject obj        = targets.createNestedObject();
+      obj[ "ip" ]           = IPAddress( target.m_ip ).toString();
+      obj[ "universe" ]     = target.m_universe;
+      obj[ "sent" ]         = target.m_sent;
+      obj[ "dropped_rate" ] = target.m_dropped_rate;
+      obj[ "unchanged" ]    = target.m_unchanged;
+      obj[ "send_failed" ]  = target.m_send_failed;
+    }
+  }
+
+  if( m_ptr_CueEngine != nullptr ) {
+    char timecode[ 12 ];
+    CueEngine::FormatTimecode( m_ptr_CueEngine->GetTimecodeMs( millis() ), CueEngine::TypeToFps( m_ptr_CueEngine->GetTimecodeType() ), timecode );
+    JsonObject cues = doc.createNestedObject( "timecode" );
+    cues[ "enabled" ]           = m_timecode_enabled;
+    cues[ "cues" ]              = m_ptr_CueEngine->GetCueCount();
+    cues[ "look_values" ]       = m_ptr_CueEngine->GetLookValueCount();
+    cues[ "timecode" ]          = timecode;
+    cues[ "running" ]           = m_ptr_CueEngine->IsTimecodeRunning( millis() );
+    cues[ "cue" ]               = m_ptr_CueEngine->GetCurrentCue() + 1;
+    cues[ "packets" ]           = m_ptr_CueEngine->GetTimecodeCount();
+    cues[ "cue_changes" ]       = m_ptr_CueEngine->GetCueChangeCount();
+    cues[ "jumps" ]             = m_ptr_CueEngine->GetJumpCount();
+    cues[ "holds" ]             = m_ptr_CueEngine->GetHoldCount();
+    cues[ "released" ]          = m_ptr_CueEngine->IsReleased();
+    cues[ "releases" ]          = m_ptr_CueEngine->GetReleaseCount();
+    cues[ "seeks" ]             = m_ptr_CueEngine->GetSeekCount();
+    cues[ "lookups" ]           = m_ptr_CueEngine->GetLookupCount();
+    cues[ "lookup_us_max" ]     = m_ptr_CueEngine->GetLookupUsMax();
+    cues[ "output_us_last" ]    = m_ptr_CueEngine->GetOutputLatencyUsLast();
+    cues[ "output_us_max" ]     = m_ptr_CueEngine->GetOutputLatencyUsMax();
+    cues[ "output_us_avg" ]     = m_ptr_CueEngine->GetOutputLatencyUsAvg();
+    cues[ "drift_ms_last" ]     = m_ptr_CueEngine->GetDriftMsLast();
+    cues[ "drift_ms_max" ]      = m_ptr_CueEngine->GetDriftMsMax();
+  }
+
+  if( m_ptr_Logger != nullptr ) {
+    JsonObject log = doc.createNestedObject( "log" );
+    log[ "level" ]      = LogLevelAsString( m_ptr_Logger->GetLevel() );
+    log[ "messages" ]   = m_ptr_Logger->GetMessageCount();
+    log[ "suppressed" ] = m_ptr_Logger->GetSuppressedCount();
+    log[ "dropped" ]    = m_ptr_Logger->GetDroppedCount();
+  }
+
+  JsonObject trace = doc.createNestedObject( "trace" );
+  trace[ "benchmark_record_ns" ] = m_ptr_NodeStats->m_trace_benchmark_ns;
+  if( m_ptr_TraceRing != nullptr ) {
+    trace[ "enabled" ]  = m_ptr_TraceRing->IsEnabled();
+    trace[ "frozen" ]   = m_ptr_TraceRing->IsFrozen();
+    trace[ "recorded" ] = m_ptr_TraceRing->GetRecordedCount();
+    trace[ "events" ]   = m_ptr_TraceRing->GetEventCount();
+  }
+
+  if( m_ptr_ChannelMonitor != nullptr ) {
+    JsonObject monitor = doc.createNestedObject( "monitor" );
+    monitor[ "rate_hz" ]          = m_ptr_ChannelMonitor->GetRate();
+    monitor[ "clients" ]          = m_ptr_ChannelMonitor->GetClientCount();
+    monitor[ "rejected" ]         = m_ptr_ChannelMonitor->GetRejectedCount();
+    monitor[ "captures" ]         = m_ptr_ChannelMonitor->GetCaptureCount();
+    monitor[ "messages" ]         = m_ptr_ChannelMonitor->GetMessageCount();
+    monitor[ "full_frames" ]      = m_ptr_ChannelMonitor->GetFullFrameCount();
+    monitor[ "bytes" ]            = m_ptr_ChannelMonitor->GetBytesSent();
+    monitor[ "send_failed" ]      = m_ptr_ChannelMonitor->GetSendFailedCount();
+    monitor[ "bytes_per_second" ] = m_ptr_ChannelMonitor->GetBytesPerSecond();
+    monitor[ "cpu_permille" ]     = m_ptr_ChannelMonitor->GetCpuPermille();
+    monitor[ "update_us_max" ]    = m_ptr_ChannelMonitor->GetUpdateUsMax();
+  }
+
+  JsonObject heap = doc.createNestedObject( "heap" );
+  heap[ "free" ]                 = heap_free;
+  heap[ "free_min" ]             = heap_free_min;
+  heap[ "largest_block" ]        = heap_largest_block;
+  heap[ "free_start" ]           = m_ptr_NodeStats->m_heap_free_start;
+  heap[ "change_since_start" ]   = (long)heap_free - (long)m_ptr_NodeStats->m_heap_free_start;
+  heap[ "allocations" ]          = AllocTracker::GetAllocationCount();
+  heap[ "frees" ]                = AllocTracker::GetFreeCount();
+  heap[ "live" ]                 = AllocTracker::GetLiveCount();
+  heap[ "live_max" ]             = AllocTracker::GetLiveCountMax();
+  heap[ "hot_path_allocations" ] = AllocTracker::GetHotPathAllocationCount();
+
+  String json;
+  serializeJson( doc, json );
+  m_WebServer.send( 200, "application/json", json );
+}
+
+#if MODS_SELFTEST_ROUTE
+void ConfigServer::SendModsSelfTest() {
+  // e.g. /selftest_mods?cases=1000&seed=1234, the same seed repeats the same mod lists.
+  int      cases = MODS_TEST_CASES_DEFAULT;
+  uint32_t seed  = esp_random();
+  if( m_WebServer.hasArg( "cases" ) ) {
+    cases = constrain( m_WebServer.arg( "cases" ).toInt(), 1, MODS_TEST_CASES_MAX );
+  }
+  if( m_WebServer.hasArg( "seed" ) ) {
+    seed = strtoul( m_WebServer.arg( "seed" ).c_str(), nullptr, 10 );
+  }
+
+  bool passed = m_ChannelModsTester.Run( cases, seed );
+  m_ChannelModsTester.Benchmark( m_ChannelModsHandler.GetModsVector(), m_channel_mods_copy_artnet_to_dmx );
+
+  DynamicJsonDocument doc( 4096 );
+  doc[ "seed" ]   = seed;
+  doc[ "cases" ]  = m_ChannelModsTester.GetCasesRun();
+  doc[ "passed" ] = passed;
+
+  if( !passed ) {
+    JsonObject failure = doc.createNestedObject( "failure" );
+    failure[ "engine" ]             = ModsEngineAsString( m_ChannelModsTester.GetFailureEngine() );
+    failure[ "frame_seed" ]         = m_ChannelModsTester.GetFailureCaseSeed();
+    failure[ "copy_artnet_to_dmx" ] = m_ChannelModsTester.GetFailureCopyArtnetToDMX();
+    failure[ "frame" ]              = m_ChannelModsTester.GetFailureFrame();
+    failure[ "channel" ]            = m_ChannelModsTester.GetFailureChannel();
+    failure[ "expected" ]           = m_ChannelModsTester.GetFailureExpected();
+    failure[ "result" ]             = m_ChannelModsTester.GetFailureResult();
+    failure[ "mods_before_shrink" ] = m_ChannelModsTester.GetFailureModsBeforeShrink();
+    JsonArray array_channelmods = failure.createNestedArray( "channel_mods" );
+    for( const ChannelMod& mod : m_ChannelModsTester.GetFailureMods() ) {
+      JsonObject obj     = array_channelmods.createNestedObject();
+      obj[ "sequence" ]  = mod.m_sequence;
+      obj[ "channel" ]   = mod.m_channel;
+      obj[ "mod_type" ]  = mod.m_mod_type;
+      obj[ "mod_value" ] = mod.m_mod_value;
+    }
+  }
+
+  // Timed on the configured mods.
+  JsonObject benchmark = doc.createNestedObject( "benchmark" );
+  unsigned long reference_us = m_ChannelModsTester.GetBenchmarkReferenceUs();
+  benchmark[ "mods" ]         = m_ChannelModsHandler.GetModsVector().size();
+  benchmark[ "frames" ]       = MODS_BENCHMARK_FRAMES;
+  benchmark[ "reference_us" ] = reference_us;
+  for( int engine = 0; engine < MODS_ENGINE_COUNT; engine++ ) {
+    unsigned long engine_us = m_ChannelModsTester.GetBenchmarkEngineUs( engine );
+    JsonObject obj = benchmark.createNestedObject( ModsEngineAsString( engine ) );
+    obj[ "mods_running" ] = m_ChannelModsTester.GetBenchmarkModsRunning( engine );
+    obj[ "us" ]           = engine_us;
+    obj[ "speedup" ]      = engine_us > 0 ? (float)reference_us / engine_us : 0;
+  }
+
+  String json;
+  serializeJson( doc, json );
+  m_WebServer.send( 200, "application/json", json );
+}
+#endif
+
+void ConfigServer::SendMods() {
+  DynamicJsonDocument doc( 32768 );
+  doc[ "revision" ]           = m_mods_revision;
+  doc[ "copy_artnet_to_dmx" ] = m_channel_mods_copy_artnet_to_dmx;
+  JsonArray array_channelmods = doc.createNestedArray( "channel_mods" );
+  for( const ChannelMod& mod : m_ChannelModsHandler.GetModsVector() ) {
+    JsonObject obj     = array_channelmods.createNestedObject();
+    obj[ "sequence" ]  = mod.m_sequence;
+    obj[ "channel" ]   = mod.m_channel;
+    obj[ "mod_type" ]  = mod.m_mod_type;
+    obj[ "mod_value" ] = mod.m_mod_value;
+  }
+
+  String json;
+  serializeJson( doc, json );
+  m_WebServer.send( 200, "application/json", json );
+}
+
+void ConfigServer::Send200Response() {
+  m_WebServer.send( 200 );
+}
+
+void ConfigServer::HandleResetAll() {
+  m_WebServer.send( 200, "text/plain", "Resetting everything to defaults - Reconnect to hotspot to setup WiFi." );
+  delay( 4000 );
+  this->ResetConfigToDefault();
+  this->SettingsSave();
+  this->ConnectToWiFi();
+}
+
+void ConfigServer::HandleResetWiFi() {
+  m_WebServer.send( 200, "text/plain", "Resetting to WiFi defaults - Reconnect to hotspot to setup WiFi." );
+  delay( 4000 );
+  this->ResetWiFiToDefault();
+  this->SettingsSave();
+  this->ConnectToWiFi();
+}
+
+void ConfigServer::HandleResetESP32Pins() {
+  this->ResetESP32PinsToDefault();
+  this->SettingsSave();
+  this->SendESP32PinsSetupPage();
+}
+
+void ConfigServer::HandleResetArtnet2DMX() {
+  this->ResetArtnet2DMXToDefault();
+  this->SettingsSave();
+  this->SendArtnet2DMXSetupPage();
+}
+
+void ConfigServer::HandleResetChannelMods() {
+  this->ResetChannelModsToDefault();
+  this->SettingsSave();
+  this->SendChannelModsSetupPage();
+}
+
+void ConfigServer::HandleResetShow() {
+  this->ResetShowToDefault();
+  this->SettingsSave();
+  this->SendShowSetupPage();
+}
+
+void ConfigServer::HandleResetTimecode() {
+  this->ResetTimecodeToDefault();
+  this->SettingsSave();
+  this->SendTimecodeSetupPage();
+}
+
+void ConfigServer::HandleResetTrace() {
+  this->ResetTraceToDefault();
+  this->SettingsSave();
+  this->SendTraceSetupPage();
+}
+
+void ConfigServer::HandleResetMonitor() {
+  this->ResetMonitorToDefault();
+  this->SettingsSave();
+  this->SendMonitorPage();
+}
+
+void ConfigServer::HandleResetStats() {
+  if( m_ptr_NodeStats != nullptr ) {
+    m_ptr_NodeStats->Reset();
+  }
+  if( m_ptr_SequenceTracker != nullptr ) {
+    m_ptr_SequenceTracker->ResetStats();
+  }
+  if( m_ptr_ArtNetForwarder != nullptr ) {
+    m_ptr_ArtNetForwarder->ResetStats();
+  }
+  if( m_ptr_ChannelMonitor != nullptr ) {
+    m_ptr_ChannelMonitor->ResetStats();
+  }
+  if( m_ptr_ArtNetRemote != nullptr ) {
+    m_ptr_ArtNetRemote->ResetStats();
+  }
+  if( m_ptr_CueEngine != nullptr ) {
+    m_ptr_CueEngine->ResetStats();
+  }
+  AllocTracker::ResetStats();
+  this->SendStats();
+}
+
+void ConfigServer::HandleDMXEnable() {
+    m_dmx_enabled = true;
+    this->SettingsSave();
+    this->SendSetupMenuPage();
+}
+
+void ConfigServer::HandleDMXDisable() {
+    m_dmx_enabled = true;
+    this->SettingsSave();
+    this->SendSetupMenuPage();
+}
+
+void ConfigServer::HandleCopyArtnetToDMXEnable() {
+  m_channel_mods_copy_artnet_to_dmx = true;
+  this->SettingsSave();
+  this->SendChannelModsSetupPage();
+}
+
+void ConfigServer::HandleCopyArtnetToDMXDisable() {
+  m_channel_mods_copy_artnet_to_dmx = false;
+  this->SettingsSave();
+  this->SendChannelModsSetupPage();
+}
+
+void ConfigServer::HandleSetupWiFi() {  
+  String wifi_ssid_new   = "";
+  String wifi_pass_new   = "";
+  String wifi_ip_new     = "";
+  String wifi_subnet_new = "";
+
+  for( int i = 0; i < m_WebServer.args(); i++ ) {
+    if( m_WebServer.argName( i ) == "wifi_ssid" ) {
+      wifi_ssid_new = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "wifi_pass" ) {
+      wifi_pass_new = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "ip" ) {
+      wifi_ip_new = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "subnet" ) {
+      wifi_subnet_new = m_WebServer.arg( i );
+    }
+  }
+
+  if( wifi_ssid_new.length() > 0 && wifi_pass_new.length() > 0 ) {
+    m_wifi_ssid = wifi_ssid_new;
+    m_wifi_pass = wifi_pass_new;
+    m_wifi_ip   = wifi_ip_new;
+    if( m_wifi_ip.length() > 0 && wifi_subnet_new.length() == 0 ) {
+      m_wifi_subnet = "255.255.255.0";
+    } else {
+      m_wifi_subnet = wifi_subnet_new;
+    }
+
+    m_WebServer.send( 200, "text/plain", "Attempting to connect to WiFi. On failure hotspot will re-appear." );
+     
+    if( this->ConnectToWiFi() ) {
+      this->SettingsSave();
+    }
+
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_INFO, "Restarting WiFi" );
+    this->ConnectToWiFi();
+  }
+}
+
+void ConfigServer::HandleSetupESP32Pins() {  
 
   for( int i = 0; i < m_WebServer.args(); i++ ) {
     if( m_WebServer.argName( i ) == "gpio_enable" ) {
@@ -755,12 +1905,44 @@ void ConfigServer::HandleSetupArtnet2DMX() {
   for( int i = 0; i < m_WebServer.args(); i++ ) {
     if( m_WebServer.argName( i ) == "artnet_source_ip" ) {
       m_artnet_source_ip = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "artnet_merge_mode" ) {
+      m_artnet_merge_mode = ( m_WebServer.arg( i ) == "LTP" ) ? MERGEMODE::LTP : MERGEMODE::HTP;
     } else if( m_WebServer.argName( i ) == "artnet_universe" ) {
       m_artnet_universe = m_WebServer.arg( i ).toInt();
     } else if( m_WebServer.argName( i ) == "dmx_update_ms" ) {
       m_dmx_update_interval_ms = m_WebServer.arg( i ).toInt();
+    } else if( m_WebServer.argName( i ) == "dmx_mode" ) {
+      m_dmx_mode = ( m_WebServer.arg( i ) == "Input" ) ? DMXMODE::DMX_INPUT : DMXMODE::DMX_OUTPUT;
+    } else if( m_WebServer.argName( i ) == "dmx_input_target_ip" ) {
+      m_dmx_input_target_ip = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "dmx_input_keepalive_ms" ) {
+      m_dmx_input_keepalive_ms = m_WebServer.arg( i ).toInt();
+    } else if( m_WebServer.argName( i ) == "dmx_frame_slots_min" ) {
+      m_dmx_frame_slots_min = constrain( m_WebServer.arg( i ).toInt(), DMX_FRAME_SLOTS_MIN, DMX_FRAME_SLOTS_MAX );
+    } else if( m_WebServer.argName( i ) == "dmx_break_us" ) {
+      m_dmx_break_us = constrain( m_WebServer.arg( i ).toInt(), DMX_BREAK_US_MIN, DMX_BREAK_US_MAX );
+    } else if( m_WebServer.argName( i ) == "dmx_mab_us" ) {
+      m_dmx_mab_us = constrain( m_WebServer.arg( i ).toInt(), DMX_MAB_US_MIN, DMX_MAB_US_MAX );
     } else if( m_WebServer.argName( i ) == "artnet_timeout_ms" ) {
       m_artnet_timeout_ms = m_WebServer.arg( i ).toInt();
+    } else if( m_WebServer.argName( i ) == "artnet_short_name" ) {
+      m_artnet_short_name = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "artnet_long_name" ) {
+      m_artnet_long_name = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "artnet_pollreply" ) {
+      m_artnet_pollreply_broadcast = ( m_WebServer.arg( i ) == "Broadcast" );
+    } else if( m_WebServer.argName( i ) == "artnet_remote_config" ) {
+      m_artnet_remote_config = ( m_WebServer.arg( i ) == "Enabled" );
+    } else if( m_WebServer.argName( i ) == "sacn_enabled" ) {
+      m_sacn_enabled = ( m_WebServer.arg( i ) == "Enabled" );
+    } else if( m_WebServer.argName( i ) == "patch_matrix" ) {
+      m_patch_matrix = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "artnet_forward_targets" ) {
+      m_artnet_forward_targets = m_WebServer.arg( i );
+    } else if( m_WebServer.argName( i ) == "network_receive_buffer_size" ) {
+      m_network_receive_buffer_size = m_WebServer.arg( i ).toInt();
+    } else if( m_WebServer.argName( i ) == "sacn_universe" ) {
+      m_sacn_universe = constrain( m_WebServer.arg( i ).toInt(), E131_UNIVERSE_MIN, E131_UNIVERSE_MAX );
     }
   }
 
@@ -822,6 +2004,201 @@ void ConfigServer::HandleChannelModsDelFor() {
   this->SendChannelModsForChannelSetupPage( channel );
 }
 
+void ConfigServer::HandleModsBatch() {
+  // {"revision": 12, "operations": [{"op": "add", "channel": 1, "mod_type": 1, "mod_value": 255}, {"op": "edit", "sequence": 20, "mod_value": 10}, ..]}
+  // The revision is optional, if given the batch is only applied to that revision of the mods.
+  String body = m_WebServer.arg( "plain" );
+  DynamicJsonDocument doc( 32768 );
+  if( deserializeJson( doc, body ) != DeserializationError::Ok ) {
+    m_WebServer.send( 400, "application/json", "{\"error\":\"invalid json\"}" );
+    return;
+  }
+
+  if( !doc[ "revision" ].isNull() && doc[ "revision" ].as<unsigned long>() != m_mods_revision ) {
+    String json = "{\"error\":\"revision changed\",\"revision\":" + String( m_mods_revision ) + "}";
+    m_WebServer.send( 409, "application/json", json );
+    return;
+  }
+
+  JsonArray array_operations = doc[ "operations" ];
+  if( array_operations.size() > MODS_BATCH_OPERATIONS_MAX ) {
+    m_WebServer.send( 400, "application/json", "{\"error\":\"too many operations\"}" );
+    return;
+  }
+
+  std::vector< ChannelModsBatchOp > operations;
+  operations.reserve( array_operations.size() );
+  for( const JsonObject& obj : array_operations ) {
+    ChannelModsBatchOp operation;
+    const char* op = obj[ "op" ] | "";
+    operation.m_op = -1;
+    for( int i = MODS_BATCH_ADD; i <= MODS_BATCH_CLEAR; i++ ) {
+      if( strcmp( op, ModsBatchOpAsString( i ) ) == 0 ) {
+        operation.m_op = i;
+      }
+    }
+    operation.m_sequence  = obj[ "sequence" ] | 0;
+    operation.m_channel   = obj[ "channel" ] | 0;
+    operation.m_mod_type  = obj[ "mod_type" ] | -1;
+    operation.m_mod_value = obj[ "mod_value" ] | -1;
+    operations.push_back( operation );
+  }
+
+  const char* error = "";
+  int failed = m_ChannelModsHandler.ApplyBatch( operations, &error );
+  if( failed >= 0 ) {
+    // Nothing was changed.
+    DynamicJsonDocument doc_error( 256 );
+    doc_error[ "error" ]     = error;
+    doc_error[ "operation" ] = failed;
+    String json;
+    serializeJson( doc_error, json );
+    m_WebServer.send( 400, "application/json", json );
+    return;
+  }
+
+  // One save & one restart for the whole batch.
+  LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_INFO, "Mods batch of %u operations applied.", (unsigned int)operations.size() );
+  this->SettingsSave();
+  this->SendMods();
+}
+
+void ConfigServer::HandleResetPixelMaps() {
+  this->ResetPixelMapsToDefault();
+  this->SettingsSave();
+  this->SendPixelMapsSetupPage();
+}
+
+void ConfigServer::HandlePixelMapsAdd() {
+  PixelMap map;
+  map.m_output_start = m_WebServer.arg( "output_start" ).toInt();
+  map.m_pixel_count  = m_WebServer.arg( "pixel_count" ).toInt();
+  map.m_input_start  = m_WebServer.arg( "input_start" ).toInt();
+  strlcpy( map.m_colour_order, m_WebServer.arg( "colour_order" ).c_str(), sizeof( map.m_colour_order ) );
+  map.m_colour_plane = m_WebServer.arg( "colour_plane" ).toInt();
+  map.m_grouping     = m_WebServer.arg( "grouping" ).toInt();
+  map.m_reverse      = ( m_WebServer.arg( "reverse" ) == "Reversed" );
+  map.m_zigzag_width = m_WebServer.arg( "zigzag_width" ).toInt();
+  map.m_repeat       = m_WebServer.arg( "repeat" ).toInt();
+
+  if( PixelMapper::IsValid( map ) && m_pixel_maps.size() < PIXEL_MAPS_MAX ) {
+    m_pixel_maps.push_back( map );
+    this->SettingsSave();
+  } else {
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "Pixel map not added, it's invalid or goes past channel 512." );
+  }
+  this->SendPixelMapsSetupPage();
+}
+
+void ConfigServer::HandlePixelMapsRemove() {
+  unsigned int map_index = m_WebServer.pathArg(0).toInt();
+
+  if( map_index < m_pixel_maps.size() ) {
+    m_pixel_maps.erase( m_pixel_maps.begin() + map_index );
+    this->SettingsSave();
+  }
+  this->SendPixelMapsSetupPage();
+}
+
+void ConfigServer::HandleSetupShow() {
+  for( int i = 0; i < m_WebServer.args(); i++ ) {
+    if( m_WebServer.argName( i ) == "play_on_timeout" ) {
+      m_show_play_on_timeout = ( m_WebServer.arg( i ) == "Enabled" );
+    }
+  }
+
+  this->SettingsSave();
+  this->SendShowSetupPage();
+}
+
+void ConfigServer::HandleShowRecordStart() {
+  if( m_ptr_ShowRecorder != nullptr && m_ptr_ShowPlayer != nullptr ) {
+    m_ptr_ShowPlayer->Stop();
+    m_ptr_ShowRecorder->Start( SHOW_FILE );
+  }
+  this->SendShowSetupPage();
+}
+
+void ConfigServer::HandleShowRecordStop() {
+  if( m_ptr_ShowRecorder != nullptr ) {
+    m_ptr_ShowRecorder->Stop();
+  }
+  this->SendShowSetupPage();
+}
+
+void ConfigServer::HandleShowPlayOnce() {
+  if( m_ptr_ShowRecorder != nullptr && m_ptr_ShowPlayer != nullptr && !m_ptr_ShowRecorder->IsRecording() ) {
+    m_ptr_ShowPlayer->Start( SHOW_FILE, false );
+  }
+  this->SendShowSetupPage();
+}
+
+void ConfigServer::HandleShowPlayLoop() {
+  if( m_ptr_ShowRecorder != nullptr && m_ptr_ShowPlayer != nullptr && !m_ptr_ShowRecorder->IsRecording() ) {
+    m_ptr_ShowPlayer->Start( SHOW_FILE, true );
+  }
+  this->SendShowSetupPage();
+}
+
+void ConfigServer::HandleShowPlayStop() {
+  if( m_ptr_ShowPlayer != nullptr ) {
+    m_ptr_ShowPlayer->Stop();
+  }
+  this->SendShowSetupPage();
+}
+
+void ConfigServer::HandleSetupTimecode() {
+  for( int i = 0; i < m_WebServer.args(); i++ ) {
+    if( m_WebServer.argName( i ) == "timecode_enabled" ) {
+      m_timecode_enabled = ( m_WebServer.arg( i ) == "Enabled" );
+    } else if( m_WebServer.argName( i ) == "timecode_release_ms" ) {
+      m_timecode_release_ms = m_WebServer.arg( i ).toInt();
+      if( m_timecode_release_ms < 0 ) {
+        m_timecode_release_ms = 0;
+      }
+    }
+  }
+
+  this->SettingsSave();
+  this->SendTimecodeSetupPage();
+}
+
+void ConfigServer::HandleSetupTrace() {
+  for( int i = 0; i < m_WebServer.args(); i++ ) {
+    if( m_WebServer.argName( i ) == "trace_enabled" ) {
+      m_trace_enabled = ( m_WebServer.arg( i ) == "Enabled" );
+    }
+  }
+
+  this->SettingsSave();
+  this->SendTraceSetupPage();
+}
+
+void ConfigServer::HandleSetupMonitor() {
+  for( int i = 0; i < m_WebServer.args(); i++ ) {
+    if( m_WebServer.argName( i ) == "monitor_rate_hz" ) {
+      m_monitor_rate_hz = constrain( m_WebServer.arg( i ).toInt(), 0, MONITOR_RATE_HZ_MAX );
+    }
+  }
+
+  this->SettingsSave();
+  this->SendMonitorPage();
+}
+
+void ConfigServer::HandleTraceFreeze() {
+  if( m_ptr_TraceRing != nullptr ) {
+    m_ptr_TraceRing->Freeze();
+  }
+  this->SendTraceSetupPage();
+}
+
+void ConfigServer::HandleTraceResume() {
+  if( m_ptr_TraceRing != nullptr ) {
+    m_ptr_TraceRing->Resume();
+  }
+  this->SendTraceSetupPage();
+}
+
 void ConfigServer::HandleWebServerDataOnNotFound() {
   // Unhandled
   m_WebServer.send( 200, "text/plain", "Not found!" );
@@ -836,13 +2213,15 @@ void ConfigServer::HandleFileUpload() {
       if( !filename.startsWith( "/" ) ) {
         filename = "/" + filename;
       }
-      Serial.printf( "File upload : Filename being received = '%s'\n", filename.c_str() );
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_INFO, "File upload : Filename being received = '%s'", filename.c_str() );
       m_file_being_uploaded = LittleFS.open( CONFIG_MODS, "w" ); //filename, "w" );
       break;
     }
     case UPLOAD_FILE_WRITE: {
       if( m_file_being_uploaded ) {
+        this->Trace( TRACE_FLASH_WRITE_BEGIN, 0 );
         m_file_being_uploaded.write( upload.buf, upload.currentSize );
+        this->Trace( TRACE_FLASH_WRITE_END, upload.currentSize );
       }
       break;
     }
@@ -858,14 +2237,55 @@ void ConfigServer::HandleFileUpload() {
       if( m_file_being_uploaded ) {
         m_file_being_uploaded.close();
         LittleFS.remove( CONFIG_MODS );
-        Serial.printf( "File upload : Aborted. Mod config file deleted.\n" );
+        LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "File upload : Aborted. Mod config file deleted." );
       }
       break;
     }
     default: {
-      Serial.printf( "File upload : Unknown status = %i\n", upload.status );
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "File upload : Unknown status = %i", upload.status );
       break;
     }
   }
 }
 
+
+void ConfigServer::HandleCueFileUpload() {
+  HTTPUpload& upload = m_WebServer.upload();
+
+  switch( upload.status ) {
+    case UPLOAD_FILE_START: {
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_INFO, "Cue file upload : Filename being received = '%s'", upload.filename.c_str() );
+      m_file_being_uploaded = LittleFS.open( CUE_FILE, "w" );
+      break;
+    }
+    case UPLOAD_FILE_WRITE: {
+      if( m_file_being_uploaded ) {
+        this->Trace( TRACE_FLASH_WRITE_BEGIN, 0 );
+        m_file_being_uploaded.write( upload.buf, upload.currentSize );
+        this->Trace( TRACE_FLASH_WRITE_END, upload.currentSize );
+      }
+      break;
+    }
+    case UPLOAD_FILE_END: {
+      if( m_file_being_uploaded ) {
+        m_file_being_uploaded.close();
+        // The engine loads the cue list on restart.
+        m_settings_changed = true;
+        this->SendTimecodeSetupPage();
+      }
+      break;
+    }
+    case UPLOAD_FILE_ABORTED: {
+      if( m_file_being_uploaded ) {
+        m_file_being_uploaded.close();
+        LittleFS.remove( CUE_FILE );
+        LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "Cue file upload : Aborted. Cue file deleted." );
+      }
+      break;
+    }
+    default: {
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_WARNING, "Cue file upload : Unknown status = %i", upload.status );
+      break;
+    }
+  }
+}
@@ -10,12 +10,52 @@
 #include "FS.h"
 #include "WebpageBuilder.h"
 #include "ChannelModsHandler.h"
+#include "ShowRecorder.h"
+#include "SourceMerger.h"
+#include "E131_Spec.h"
+#include "PacketRing.h"
+#include "ShowPlayer.h"
+#include "NodeStats.h"
+#include "SequenceTracker.h"
+#include "ArtNetForwarder.h"
+#include "PatchMatrix.h"
+#include "PixelMapper.h"
+#include "ChannelModsOptimizer.h"
+#include "ChannelModsTester.h"
+#include "TraceRing.h"
+#include "Logger.h"
+#include "AllocTracker.h"
+#include "ChannelMonitor.h"
+#include "ArtNetRemote.h"
+#include "CueEngine.h"
 
 const String HOTSPOT_SSID = "ESP32_ArtNet2DMX";
 const String HOTSPOT_PASS = "1234567890";  // Has to be minimum 10 digits?
 
 const String CONFIG_ADAPTER = "/config_adapter.json";
 const String CONFIG_MODS    = "/config_mods.json";
+const String SHOW_FILE      = "/show.a2ds";
+const String CUE_FILE       = "/cues.json";
+
+#define DMX_FRAME_SLOTS_MIN   24    // DMX512 minimum, at the shortest break & MAB a frame is then the minimum 1204us.
+#define DMX_FRAME_SLOTS_MAX   512
+#define DMX_BREAK_US_MIN      92
+#define DMX_BREAK_US_DEFAULT  176
+#define DMX_BREAK_US_MAX      10000
+#define DMX_MAB_US_MIN        12
+#define DMX_MAB_US_DEFAULT    12
+#define DMX_MAB_US_MAX        10000
+#define DMX_SLOT_US           44    // Start code & each slot, 11 bits at 250kbit/s.
+#define DMX_INPUT_KEEPALIVE_MS_DEFAULT  1000
+#define CONFIG_SAVE_DELAY_MS  2000  // SettingsSaveLater() writes once there have been no changes for this long.
+#ifndef MODS_SELFTEST_ROUTE
+#define MODS_SELFTEST_ROUTE   1     // /selftest_mods runs the mod differential test on the device, 0 leaves it out (test/ runs it on the host).
+#endif
+
+enum DMXMODE : int {
+  DMX_OUTPUT = 0,  // Art-Net & sACN to DMX.
+  DMX_INPUT  = 1,  // DMX from the receive GPIO to Art-Net.
+};
 
 class ConfigServer {
 public:
@@ -30,6 +70,8 @@ public:
   
   bool IsConnectedToWiFi();
 
+  const String& GetMACAddress() const;
+
   void StartWebServer();
 
   // Returns true if settings have changed.
@@ -44,20 +86,77 @@ public:
   // ESP32 settings
   int m_gpio_enable;       // Connect to DE & RE on MAX485.  Default = 21
   int m_gpio_transmit;     // Connected to DI on MAX485.  Default = 33
-  int m_gpio_receive;      // Ensure pin is not connected to anything.  Default = 38
+  int m_gpio_receive;      // Connected to RO on MAX485 for DMX input mode, otherwise not connected.  Default = 38
 
   // Artnet 2 DMX settings
-  String          m_artnet_source_ip;        // The IP that we're expecting data from.  Use 255.255.255.255 for any.
+  String          m_artnet_source_ip;        // The IPs that we're expecting data from, comma separated.  Use 255.255.255.255 for any.
+  int             m_artnet_merge_mode;       // MERGEMODE::HTP or MERGEMODE::LTP when more than one source sends the universe.
   int             m_artnet_universe;         // Universe to listen for, all other universes are ignored.  Default = 1
   unsigned long   m_artnet_timeout_ms;       // When no artnet data has been received by this amount of ms then turn off all dmx.  Default = 2000.  Use -1 for no timeout.
-  unsigned long   m_dmx_update_interval_ms;  // The interval between updating the dmx line in ms.  Default = 23
+  unsigned long   m_dmx_update_interval_ms;  // The interval between updating the dmx line in ms.  Default = 23.  Use 0 for as fast as the frame length allows.
   bool            m_dmx_enabled;             // Enable/Disable dmx output.
+  int             m_dmx_frame_slots_min;     // Frames are sent up to the highest slot in use, but never shorter than this.  Default = 24
+  int             m_dmx_break_us;            // Default = 176
+  int             m_dmx_mab_us;              // Mark after break.  Default = 12
+  int             m_dmx_mode;                // DMXMODE::DMX_OUTPUT or DMXMODE::DMX_INPUT.
+  String          m_dmx_input_target_ip;     // Where DMX input is sent as ArtDmx.  Empty for broadcast.
+  unsigned long   m_dmx_input_keepalive_ms;  // Unchanged DMX input is resent at this interval.  Default = 1000
+  String          m_artnet_short_name;       // Node name shown by Art-Net controllers.  Max 17 characters.
+  String          m_artnet_long_name;        // Node description shown by Art-Net controllers.  Max 63 characters.
+  bool            m_artnet_pollreply_broadcast; // Broadcast ArtPollReply for Art-Net 3 controllers, otherwise unicast to the controller.
+  bool            m_sacn_enabled;            // Also receive sACN (E1.31).
+  int             m_sacn_universe;           // sACN universe to listen for, 1 to 63999.  Default = 1
+  int             m_network_receive_buffer_size; // Socket receive buffer (SO_RCVBUF) in bytes, 0 = network stack default.
+  String          m_patch_matrix;            // Output channels from other universes, comma separated "output:universe:input:count".
+  String          m_artnet_forward_targets;  // Processed output re-sent as ArtDmx, comma separated "ip:universe:max fps:c" (c = only changes).
+  bool            m_artnet_remote_config;    // ArtAddress, ArtCommand & ArtIpProg from the source IPs change the config.
 
   // DMX channel mods
   bool m_channel_mods_copy_artnet_to_dmx;
 
+  // Show recorder & player
+  bool m_show_play_on_timeout;  // Loop the recorded show when Art-Net times out, until Art-Net data returns.
+
+  // Timecode cues
+  bool m_timecode_enabled;      // Run the cue list from ArtTimeCode.
+  int  m_timecode_release_ms;   // Output is left to Art-Net this long after the timecode stops, 0 = never.  Default = 10000
+
+  // Trace
+  bool m_trace_enabled;         // Record packet, frame, web & flash events into the trace ring.
+
+  // Channel monitor
+  int  m_monitor_rate_hz;       // Live monitor updates per second, 0 = off.  Default = 10
+
   const std::vector< ChannelMod >& GetModsVector() const;
 
+  // Pixel maps are stored with the channel mods & compiled by the engine on start.
+  const std::vector< PixelMap >& GetPixelMapsVector() const;
+
+  // The recorder & player are owned by the Art-Net to DMX engine, the webserver only controls them.
+  void SetShowControl( ShowRecorder* ptr_show_recorder, ShowPlayer* ptr_show_player );
+
+  // Stats are owned & updated by the Art-Net to DMX engine.
+  void SetNodeStats( NodeStats* ptr_node_stats );
+  void SetSequenceTracker( SequenceTracker* ptr_sequence_tracker );
+  void SetArtNetForwarder( ArtNetForwarder* ptr_artnet_forwarder );
+  void SetPatchMatrix( PatchMatrix* ptr_patch_matrix );
+  void SetPixelMapper( PixelMapper* ptr_pixel_mapper );
+  void SetChannelModsOptimizer( ChannelModsOptimizer* ptr_channel_mods_optimizer );
+  void SetTraceRing( TraceRing* ptr_trace_ring );
+  void SetChannelMonitor( ChannelMonitor* ptr_channel_monitor );
+  void SetArtNetRemote( ArtNetRemote* ptr_artnet_remote );
+  void SetCueEngine( CueEngine* ptr_cue_engine );
+
+  // For settings the engine has already applied while running, e.g. from ArtAddress.  Written without a restart
+  // once they have stopped changing for CONFIG_SAVE_DELAY_MS, so a controller repatching many nodes causes one write.
+  void SettingsSaveLater();
+
+  // For settings that need the engine restarted.
+  void SettingsSaveAndRestart();
+
+  // Set before Init(), so loading the settings can log.
+  void SetLogger( Logger* ptr_logger );
+
 
 private:
   void ResetConfigToDefault();
@@ -65,8 +164,15 @@ private:
   void ResetESP32PinsToDefault();
   void ResetArtnet2DMXToDefault();  
   void ResetChannelModsToDefault();
+  void ResetPixelMapsToDefault();
+  void ResetShowToDefault();
+  void ResetTimecodeToDefault();
+  void ResetTraceToDefault();
+  void ResetMonitorToDefault();
 
   void SettingsSave();
+  void SettingsWriteAdapter();
+  void SettingsWriteMods();
   bool SettingsLoad();
   
   void SendSetupMenuPage();
@@ -75,7 +181,19 @@ private:
   void SendArtnet2DMXSetupPage();
   void SendChannelModsSetupPage();
   void SendChannelModsForChannelSetupPage( int channel_number );
-  void SendModConfigFile();
+  void SendPixelMapsSetupPage();
+  void SendShowSetupPage();
+  void SendTimecodeSetupPage();
+  void SendTraceSetupPage();
+  void SendTrace();
+  void SendLog();
+  void SendMonitorPage();
+  void SendDownloadFile();
+  void SendStats();
+#if MODS_SELFTEST_ROUTE
+  void SendModsSelfTest();
+#endif
+  void SendMods();
   void Send200Response();
 
   void HandleResetAll();
@@ -83,6 +201,12 @@ private:
   void HandleResetESP32Pins();
   void HandleResetArtnet2DMX();
   void HandleResetChannelMods();
+  void HandleResetPixelMaps();
+  void HandleResetShow();
+  void HandleResetTimecode();
+  void HandleResetTrace();
+  void HandleResetMonitor();
+  void HandleResetStats();
 
   void HandleDMXEnable();
   void HandleDMXDisable();
@@ -98,18 +222,58 @@ private:
   void HandleChannelModsRemoveFor();
   void HandleChannelModsAddFor();
   void HandleChannelModsDelFor();
+  void HandleModsBatch();
+  void HandlePixelMapsAdd();
+  void HandlePixelMapsRemove();
+  void HandleSetupShow();
+  void HandleShowRecordStart();
+  void HandleShowRecordStop();
+  void HandleShowPlayOnce();
+  void HandleShowPlayLoop();
+  void HandleShowPlayStop();
+  void HandleSetupTimecode();
+  void HandleSetupTrace();
+  void HandleTraceFreeze();
+  void HandleTraceResume();
+  void HandleSetupMonitor();
+
+  // Records a trace event from loop(), if the engine has set the ring.
+  void Trace( int event, uint16_t arg );
 
   void HandleWebServerDataOnNotFound();
 
   void HandleFileUpload();
 
+  // The cue list, the engine loads it on restart.
+  void HandleCueFileUpload();
+
   WebServer          m_WebServer;
   WebpageBuilder     m_WebpageBuilder;
   String             m_mac_address;
   bool               m_settings_changed;
+  bool               m_settings_save_pending;
+  unsigned long      m_settings_save_due_ms;
+  unsigned long      m_mods_revision;     // Saved in config_mods.json & counted up by every save.
   bool               m_is_connected_to_wifi;
   File               m_file_being_uploaded;
   ChannelModsHandler m_ChannelModsHandler;
+#if MODS_SELFTEST_ROUTE
+  ChannelModsTester  m_ChannelModsTester;
+#endif
+  std::vector< PixelMap > m_pixel_maps;
+  ShowRecorder*      m_ptr_ShowRecorder;
+  ShowPlayer*        m_ptr_ShowPlayer;
+  NodeStats*         m_ptr_NodeStats;
+  SequenceTracker*   m_ptr_SequenceTracker;
+  ArtNetForwarder*   m_ptr_ArtNetForwarder;
+  PatchMatrix*       m_ptr_PatchMatrix;
+  PixelMapper*       m_ptr_PixelMapper;
+  ChannelModsOptimizer* m_ptr_ChannelModsOptimizer;
+  TraceRing*         m_ptr_TraceRing;
+  ChannelMonitor*    m_ptr_ChannelMonitor;
+  ArtNetRemote*      m_ptr_ArtNetRemote;
+  CueEngine*         m_ptr_CueEngine;
+  Logger*            m_ptr_Logger;
 };
 
 #endif
@@ -0,0 +1,474 @@
+#include <algorithm>
+#include "CueEngine.h"
+
+CueEngine::CueEngine() {
+  m_load_error = nullptr;
+  m_release_ms = CUE_RELEASE_MS_DEFAULT;
+  this->Clear();
+  this->ResetStats();
+}
+
+CueEngine::~CueEngine() {
+}
+
+void CueEngine::Clear() {
+  m_ShowPlayer.Stop();
+  m_cues.clear();
+  m_look_values.clear();
+
+  m_has_timecode         = false;
+  m_timecode_stopped     = false;
+  m_timecode_stopped_ms  = 0;
+  m_timecode_ms          = 0;
+  m_timecode_local_ms    = 0;
+  m_timecode_type        = ARTNET_TIMECODE_SMPTE;
+  m_timecode_received_us = 0;
+  m_output_received_us   = 0;
+  m_cue_current          = -1;
+  m_released             = false;
+  m_render_pending       = false;
+  m_fading               = false;
+  m_render_timecode_ms   = 0;
+  m_segment_synced       = false;
+  m_segment_position_ms  = 0;
+  m_hold_counted         = false;
+  memset( m_fade_from, 0, sizeof( m_fade_from ) );
+  memset( m_target, 0, sizeof( m_target ) );
+}
+
+bool CueEngine::Load( const String& filename, const String& show_filename ) {
+  this->Clear();
+  m_show_filename = show_filename;
+  m_load_error    = nullptr;
+
+  File file = LittleFS.open( filename, "r" );
+  if( !file ) {
+    m_load_error = "No cue file";
+    return false;
+  }
+  DynamicJsonDocument doc( CUE_FILE_JSON_SIZE );
+  DeserializationError error = deserializeJson( doc, file );
+  file.close();
+  if( error ) {
+    m_load_error = "Cue file is not valid JSON, or too big";
+    return false;
+  }
+
+  int fps = doc[ "fps" ] | CUE_FPS_DEFAULT;
+  JsonArray array_cues = doc[ "cues" ];
+  if( fps < 1 || fps > 30 ) {
+    m_load_error = "fps must be 1 to 30";
+  } else if( array_cues.size() > CUES_MAX ) {
+    m_load_error = "Too many cues";
+  }
+
+  m_cues.reserve( array_cues.size() );
+  for( const JsonObject& obj : array_cues ) {
+    if( m_load_error != nullptr ) {
+      break;
+    }
+    Cue cue;
+    memset( &cue, 0, sizeof( cue ) );
+    if( !CueEngine::ParseTimecode( obj[ "timecode" ] | "", fps, &cue.m_time_ms ) ) {
+      m_load_error = "Cue timecode is not hh:mm:ss:ff";
+      break;
+    }
+    long fade_ms  = obj[ "fade_ms" ] | 0L;
+    cue.m_fade_ms = constrain( fade_ms, 0L, (long)CUE_FADE_MS_MAX );
+
+    if( !obj[ "segment_ms" ].isNull() ) {
+      if( !LittleFS.exists( m_show_filename ) ) {
+        m_load_error = "Segment cues need a recorded show";
+        break;
+      }
+      cue.m_type       = CUETYPE::CUE_SEGMENT;
+      cue.m_segment_ms = obj[ "segment_ms" ] | 0UL;
+    } else {
+      cue.m_type       = CUETYPE::CUE_LOOK;
+      cue.m_look_first = m_look_values.size();
+      JsonObject channels = obj[ "channels" ];
+      for( JsonPair pair : channels ) {
+        int channel = atoi( pair.key().c_str() );
+        int value   = pair.value() | -1;
+        if( channel < 1 || channel > 512 || value < 0 || value > 255 ) {
+          m_load_error = "Look channels must be 1 to 512 & values 0 to 255";
+          break;
+        }
+        if( m_look_values.size() >= CUE_LOOK_VALUES_MAX ) {
+          m_load_error = "Too many look values";
+          break;
+        }
+        m_look_values.push_back( { (uint16_t)channel, (uint8_t)value } );
+      }
+      cue.m_look_count = m_look_values.size() - cue.m_look_first;
+    }
+    m_cues.push_back( cue );
+  }
+
+  if( m_load_error != nullptr ) {
+    this->Clear();
+    return false;
+  }
+
+  // Cues at the same timecode stay in file order, the last one is entered.
+  std::stable_sort( m_cues.begin(), m_cues.end(), []( const Cue& a, const Cue& b ) { return a.m_time_ms < b.m_time_ms; } );
+  return true;
+}
+
+const char* CueEngine::GetLoadError() const {
+  return m_load_error;
+}
+
+void CueEngine::SetReleaseMs( unsigned long release_ms ) {
+  m_release_ms = release_ms;
+}
+
+void CueEngine::HandleTimeCode( const ArtNetPacketTimeCode* ptr_packet, int packet_size_in_bytes, unsigned long received_us, unsigned long time_ms ) {
+  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_TIMECODE ) {
+    return;
+  }
+  int fps = CueEngine::TypeToFps( ptr_packet->m_Type );
+  if( ptr_packet->m_Frames >= fps || ptr_packet->m_Seconds > 59 || ptr_packet->m_Minutes > 59 || ptr_packet->m_Hours > 23 ) {
+    return;
+  }
+  uint32_t timecode_ms = CueEngine::TimecodeToMs( ptr_packet->m_Hours, ptr_packet->m_Minutes, ptr_packet->m_Seconds, ptr_packet->m_Frames, fps );
+
+  if( this->IsTimecodeRunning( time_ms ) ) {
+    long drift_ms = (long)this->GetTimecodeMs( time_ms ) - (long)timecode_ms;
+    if( labs( drift_ms ) > CUE_JUMP_MS ) {
+      m_jumps++;
+    } else {
+      m_drift_ms_last = drift_ms;
+      if( labs( drift_ms ) > labs( m_drift_ms_max ) ) {
+        m_drift_ms_max = drift_ms;
+      }
+    }
+  }
+
+  bool stopped = m_has_timecode && timecode_ms == m_timecode_ms;
+  if( stopped && !m_timecode_stopped ) {
+    m_timecode_stopped_ms = time_ms;
+  }
+  if( !stopped ) {
+    // Running again, the cues take the output back.
+    m_released = false;
+  }
+  m_timecode_stopped     = stopped;
+  m_timecode_ms          = timecode_ms;
+  m_timecode_local_ms    = time_ms;
+  m_timecode_type        = ptr_packet->m_Type;
+  m_timecode_received_us = received_us;
+  m_has_timecode         = true;
+  m_hold_counted         = false;
+  m_render_pending       = true;
+  m_timecode_count++;
+}
+
+bool CueEngine::IsActive() const {
+  return m_cue_current >= 0;
+}
+
+bool CueEngine::IsReleased() const {
+  return m_released;
+}
+
+bool CueEngine::Update( unsigned long time_ms, uint8_t* slots ) {
+  if( !m_has_timecode || m_cues.empty() ) {
+    return false;
+  }
+  if( !m_timecode_stopped && !m_hold_counted && !this->IsTimecodeRunning( time_ms ) ) {
+    m_hold_counted = true;
+    m_holds++;
+  }
+  if( m_released ) {
+    return false;
+  }
+  if( m_cue_current >= 0 && m_release_ms > 0 && !this->IsTimecodeRunning( time_ms ) && time_ms - this->GetTimecodeStoppedMs() >= m_release_ms ) {
+    // The console has stopped the timeline or gone, the last frame stays until Art-Net or sACN replaces it.
+    this->EnterCue( -1, slots );
+    m_released             = true;
+    m_render_pending       = false;
+    m_timecode_received_us = 0;
+    m_releases++;
+    return false;
+  }
+
+  uint32_t timecode_ms = this->GetTimecodeMs( time_ms );
+  int cue_index = this->FindCue( timecode_ms );
+  if( cue_index != m_cue_current ) {
+    this->EnterCue( cue_index, slots );
+  }
+  if( m_cue_current < 0 ) {
+    // Before the first cue, the output is left to Art-Net & sACN.
+    m_render_pending       = false;
+    m_timecode_received_us = 0;
+    return false;
+  }
+
+  const Cue& cue = m_cues[ m_cue_current ];
+  uint32_t cue_elapsed_ms = timecode_ms - cue.m_time_ms;
+  bool changed = m_render_pending;
+  if( cue.m_type == CUETYPE::CUE_SEGMENT ) {
+    changed |= this->ChaseSegment( cue, cue_elapsed_ms, time_ms );
+  }
+  bool fading = cue_elapsed_ms < cue.m_fade_ms;
+  if( ( fading && timecode_ms != m_render_timecode_ms ) || ( m_fading && !fading ) ) {
+    changed = true;
+  }
+  m_fading = fading;
+  if( !changed ) {
+    return false;
+  }
+
+  if( fading ) {
+    // Progress follows the timecode, so a fade that is jumped into starts part way.
+    int32_t progress = cue_elapsed_ms;
+    int32_t span     = cue.m_fade_ms;
+    for( int i = 0; i < 512; i++ ) {
+      slots[ i ] = m_fade_from[ i ] + ( ( (int32_t)m_target[ i ] - m_fade_from[ i ] ) * progress ) / span;
+    }
+  } else {
+    memcpy( slots, m_target, sizeof( m_target ) );
+  }
+  m_render_pending     = false;
+  m_render_timecode_ms = timecode_ms;
+
+  if( m_timecode_received_us != 0 ) {
+    m_output_received_us   = m_timecode_received_us;
+    m_timecode_received_us = 0;
+  }
+  return true;
+}
+
+void CueEngine::FrameOutput( unsigned long now_us ) {
+  if( m_output_received_us == 0 ) {
+    return;
+  }
+  unsigned long latency_us = now_us - m_output_received_us;
+  m_output_received_us = 0;
+
+  m_latency_count++;
+  m_latency_us_last   = latency_us;
+  m_latency_us_total += latency_us;
+  if( latency_us > m_latency_us_max ) {
+    m_latency_us_max = latency_us;
+  }
+}
+
+uint32_t CueEngine::GetTimecodeMs( unsigned long time_ms ) const {
+  if( !m_has_timecode || m_timecode_stopped ) {
+    return m_timecode_ms;
+  }
+  unsigned long elapsed_ms = time_ms - m_timecode_local_ms;
+  if( elapsed_ms > CUE_FREEWHEEL_MS ) {
+    elapsed_ms = CUE_FREEWHEEL_MS;
+  }
+  return m_timecode_ms + elapsed_ms;
+}
+
+unsigned long CueEngine::GetTimecodeStoppedMs() const {
+  if( m_timecode_stopped ) {
+    return m_timecode_stopped_ms;
+  }
+  return m_timecode_local_ms + CUE_FREEWHEEL_MS;
+}
+
+bool CueEngine::IsTimecodeRunning( unsigned long time_ms ) const {
+  return m_has_timecode && !m_timecode_stopped && time_ms - m_timecode_local_ms < CUE_FREEWHEEL_MS;
+}
+
+int CueEngine::FindCue( uint32_t timecode_ms ) {
+  // Still within the current cue, the usual case while chasing.
+  if( m_cue_current >= 0 && timecode_ms >= m_cues[ m_cue_current ].m_time_ms &&
+      ( m_cue_current + 1 == (int)m_cues.size() || timecode_ms < m_cues[ m_cue_current + 1 ].m_time_ms ) ) {
+    return m_cue_current;
+  }
+
+  unsigned long start_us = micros();
+  std::vector< Cue >::const_iterator it = std::upper_bound( m_cues.begin(), m_cues.end(), timecode_ms,
+    []( uint32_t time_ms, const Cue& cue ) { return time_ms < cue.m_time_ms; } );
+  int cue_index = (int)( it - m_cues.begin() ) - 1;
+
+  unsigned long lookup_us = micros() - start_us;
+  m_lookups++;
+  if( lookup_us > m_lookup_us_max ) {
+    m_lookup_us_max = lookup_us;
+  }
+  return cue_index;
+}
+
+void CueEngine::EnterCue( int cue_index, const uint8_t* slots ) {
+  m_cue_current    = cue_index;
+  m_render_pending = true;
+  m_fading         = false;
+  m_segment_synced = false;
+  m_cue_changes++;
+
+  // Fades start from whatever is being output, Art-Net or the last cue.
+  memcpy( m_fade_from, slots, sizeof( m_fade_from ) );
+  memset( m_target, 0, sizeof( m_target ) );
+
+  if( cue_index < 0 || m_cues[ cue_index ].m_type != CUETYPE::CUE_SEGMENT ) {
+    m_ShowPlayer.Stop();
+  }
+  if( cue_index < 0 ) {
+    return;
+  }
+
+  const Cue& cue = m_cues[ cue_index ];
+  if( cue.m_type == CUETYPE::CUE_LOOK ) {
+    for( int i = cue.m_look_first; i < cue.m_look_first + cue.m_look_count; i++ ) {
+      m_target[ m_look_values[ i ].m_channel - 1 ] = m_look_values[ i ].m_value;
+    }
+  }
+}
+
+bool CueEngine::ChaseSegment( const Cue& cue, uint32_t cue_elapsed_ms, unsigned long time_ms ) {
+  uint32_t position_ms = cue.m_segment_ms + cue_elapsed_ms;
+  if( position_ms + CUE_CHASE_TOLERANCE_MS < m_segment_position_ms ) {
+    // The timecode went back, the show may have ended & has to be started again.
+    m_segment_synced = false;
+  }
+  m_segment_position_ms = position_ms;
+
+  if( m_segment_synced ) {
+    if( !m_ShowPlayer.IsPlaying() ) {
+      // Past the end of the recording, its last frame holds.
+      return false;
+    }
+    if( !this->IsTimecodeRunning( time_ms ) ) {
+      // The show waits for the timecode, & is sought once it runs again.
+      return false;
+    }
+    long drift_ms = (long)m_ShowPlayer.GetPositionMs( time_ms ) - (long)position_ms;
+    if( labs( drift_ms ) <= CUE_CHASE_TOLERANCE_MS ) {
+      return m_ShowPlayer.Update( time_ms, m_target );
+    }
+  }
+
+  m_segment_synced = true;
+  m_seeks++;
+  if( !m_ShowPlayer.IsPlaying() && !m_ShowPlayer.Start( m_show_filename, false ) ) {
+    return false;
+  }
+  return m_ShowPlayer.Seek( position_ms, time_ms, m_target );
+}
+
+void CueEngine::ResetStats() {
+  m_timecode_count   = 0;
+  m_cue_changes      = 0;
+  m_seeks            = 0;
+  m_holds            = 0;
+  m_releases         = 0;
+  m_jumps            = 0;
+  m_lookups          = 0;
+  m_lookup_us_max    = 0;
+  m_latency_count    = 0;
+  m_latency_us_last  = 0;
+  m_latency_us_max   = 0;
+  m_latency_us_total = 0;
+  m_drift_ms_last    = 0;
+  m_drift_ms_max     = 0;
+}
+
+int CueEngine::GetCueCount() const {
+  return m_cues.size();
+}
+
+int CueEngine::GetLookValueCount() const {
+  return m_look_values.size();
+}
+
+int CueEngine::GetCurrentCue() const {
+  return m_cue_current;
+}
+
+int CueEngine::GetTimecodeType() const {
+  return m_timecode_type;
+}
+
+bool CueEngine::HasTimecode() const {
+  return m_has_timecode;
+}
+
+unsigned long CueEngine::GetTimecodeCount() const {
+  return m_timecode_count;
+}
+
+unsigned long CueEngine::GetCueChangeCount() const {
+  return m_cue_changes;
+}
+
+unsigned long CueEngine::GetSeekCount() const {
+  return m_seeks;
+}
+
+unsigned long CueEngine::GetHoldCount() const {
+  return m_holds;
+}
+
+unsigned long CueEngine::GetReleaseCount() const {
+  return m_releases;
+}
+
+unsigned long CueEngine::GetJumpCount() const {
+  return m_jumps;
+}
+
+unsigned long CueEngine::GetLookupCount() const {
+  return m_lookups;
+}
+
+unsigned long CueEngine::GetLookupUsMax() const {
+  return m_lookup_us_max;
+}
+
+unsigned long CueEngine::GetOutputLatencyUsLast() const {
+  return m_latency_us_last;
+}
+
+unsigned long CueEngine::GetOutputLatencyUsMax() const {
+  return m_latency_us_max;
+}
+
+unsigned long CueEngine::GetOutputLatencyUsAvg() const {
+  return ( m_latency_count > 0 ) ? m_latency_us_total / m_latency_count : 0;
+}
+
+long CueEngine::GetDriftMsLast() const {
+  return m_drift_ms_last;
+}
+
+long CueEngine::GetDriftMsMax() const {
+  return m_drift_ms_max;
+}
+
+int CueEngine::TypeToFps( int type ) {
+  switch( type ) {
+    case ARTNET_TIMECODE_FILM: return 24;
+    case ARTNET_TIMECODE_EBU:  return 25;
+    default:                   return 30;
+  }
+}
+
+uint32_t CueEngine::TimecodeToMs( int hours, int minutes, int seconds, int frames, int fps ) {
+  return ( ( hours * 60UL + minutes ) * 60UL + seconds ) * 1000UL + frames * 1000UL / fps;
+}
+
+bool CueEngine::ParseTimecode( const char* ptr_text, int fps, uint32_t* ptr_time_ms ) {
+  int  hours, minutes, seconds, frames;
+  char separator;
+  if( sscanf( ptr_text, "%d:%d:%d%c%d", &hours, &minutes, &seconds, &separator, &frames ) != 5 ||
+      ( separator != ':' && separator != ';' ) ||
+      hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || seconds < 0 || seconds > 59 || frames < 0 || frames >= fps ) {
+    return false;
+  }
+  *ptr_time_ms = CueEngine::TimecodeToMs( hours, minutes, seconds, frames, fps );
+  return true;
+}
+
+void CueEngine::FormatTimecode( uint32_t time_ms, int fps, char* ptr_text ) {
+  snprintf( ptr_text, 12, "%02u:%02u:%02u:%02u",
+            (unsigned int)( ( time_ms / 3600000UL ) % 24 ), (unsigned int)( ( time_ms / 60000UL ) % 60 ),
+            (unsigned int)( ( time_ms / 1000UL ) % 60 ), (unsigned int)( ( time_ms % 1000UL ) * fps / 1000UL ) );
+}
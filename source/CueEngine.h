@@ -0,0 +1,188 @@
+#ifndef _CUEENGINE_H_
+#define _CUEENGINE_H_
+
+#include <vector>
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+#include "FS.h"
+#include "ArtNet_Spec.h"
+#include "ShowPlayer.h"
+
+#define CUES_MAX                  256
+#define CUE_LOOK_VALUES_MAX       8192    // Channel values over all the looks of a cue list.
+#define CUE_FADE_MS_MAX           600000
+#define CUE_FPS_DEFAULT           30      // Frames of the cue timecodes, when the file doesn't say.
+#define CUE_FILE_JSON_SIZE        32768
+#define CUE_FREEWHEEL_MS          2000    // Timecode runs on from the local clock this long after the last ArtTimeCode, then holds.
+#define CUE_CHASE_TOLERANCE_MS    100     // A segment further than this from the timecode is sought again.
+#define CUE_JUMP_MS               1000    // ArtTimeCode further than this from the run on timecode is a jump, not drift.
+#define CUE_RELEASE_MS_DEFAULT    10000   // Output is left to Art-Net & sACN this long after the timecode stops, 0 = never.
+
+enum CUETYPE : int {
+  CUE_LOOK    = 0,   // Fixed channel values, channels that aren't listed are 0.
+  CUE_SEGMENT = 1,   // The recorded show, from a position that runs with the timecode.
+};
+
+inline const char* CueTypeAsString( int type ) {
+  switch( type ) {
+    case CUE_LOOK:    return "look";
+    case CUE_SEGMENT: return "segment";
+    default:          return "unknown";
+  }
+};
+
+struct Cue {
+  uint32_t m_time_ms;          // Timecode the cue is entered at, ms since 00:00:00:00.
+  uint32_t m_fade_ms;          // From the output when the cue was entered.
+  uint32_t m_segment_ms;       // CUE_SEGMENT, position in the show at m_time_ms.
+  uint16_t m_look_first;       // CUE_LOOK, index into the look values.
+  uint16_t m_look_count;
+  uint8_t  m_type;             // CUETYPE
+};
+
+struct CueLookValue {
+  uint16_t m_channel;          // 1 to 512.
+  uint8_t  m_value;
+};
+
+// Runs a cue list stored on LittleFS from ArtTimeCode, so the node keeps its timeline when the console drops out.
+// The cue list is sorted by timecode on Load(), & the cue for a timecode is found by binary search, so chasing
+// & jumping around the timeline cost O(log n) whatever the length of the list.  Between ArtTimeCode packets the
+// timecode runs on from the local clock, & holds CUE_FREEWHEEL_MS after the last one, so the output stays on the
+// current cue instead of going dark.  Once the timecode has been stopped for the release time the output is left to
+// Art-Net & sACN, until the timecode runs again.  Nothing allocates after Load().
+//
+// Cue file, cue timecodes are hh:mm:ss:ff at "fps":
+//   { "fps": 25, "cues": [
+//     { "timecode": "00:00:10:00", "fade_ms": 2000, "channels": { "1": 255, "2": 128 } },
+//     { "timecode": "00:01:00:00", "fade_ms": 500, "segment_ms": 0 } ] }
+class CueEngine {
+public:
+  CueEngine();
+
+  ~CueEngine();
+
+  // Stops & drops the cue list.
+  void Clear();
+
+  // Reads & sorts the cue list, segments play from show_filename.  On failure the cue list is empty, see GetLoadError().
+  bool Load( const String& filename, const String& show_filename );
+
+  const char* GetLoadError() const;
+
+  // Time the timecode has to be stopped before the output is released, 0 = the cue holds the output for good.
+  void SetReleaseMs( unsigned long release_ms );
+
+  // From the packet path.  Doesn't allocate.
+  void HandleTimeCode( const ArtNetPacketTimeCode* ptr_packet, int packet_size_in_bytes, unsigned long received_us, unsigned long time_ms );
+
+  // A cue is running & owns the output, false once released.
+  bool IsActive() const;
+
+  // The timecode stopped for the release time, cleared when it runs again.
+  bool IsReleased() const;
+
+  // loop() only.  Writes the output for the timecode into slots = 512 DMX slot values.  Returns true if written.
+  bool Update( unsigned long time_ms, uint8_t* slots );
+
+  // The frame written by Update() has been handed to the output, measures the time from its ArtTimeCode.
+  void FrameOutput( unsigned long now_us );
+
+  // Timecode in ms since 00:00:00:00, run on from the last ArtTimeCode.
+  uint32_t GetTimecodeMs( unsigned long time_ms ) const;
+
+  // False before the first ArtTimeCode, once held, or while the timecode is stopped.
+  bool IsTimecodeRunning( unsigned long time_ms ) const;
+
+  void ResetStats();
+
+  int           GetCueCount() const;
+  int           GetLookValueCount() const;
+  int           GetCurrentCue() const;          // -1 before the first cue.
+  int           GetTimecodeType() const;        // ARTNET_TIMECODE_*
+  bool          HasTimecode() const;
+  unsigned long GetTimecodeCount() const;
+  unsigned long GetCueChangeCount() const;
+  unsigned long GetSeekCount() const;           // Segments sought to follow the timecode.
+  unsigned long GetHoldCount() const;           // Timecode stopped arriving while running.
+  unsigned long GetReleaseCount() const;
+  unsigned long GetJumpCount() const;
+  unsigned long GetLookupCount() const;
+  unsigned long GetLookupUsMax() const;
+  unsigned long GetOutputLatencyUsLast() const; // ArtTimeCode received to its frame handed to the output.
+  unsigned long GetOutputLatencyUsMax() const;
+  unsigned long GetOutputLatencyUsAvg() const;
+  long          GetDriftMsLast() const;         // Timecode run on from the local clock, less the ArtTimeCode that arrived.
+  long          GetDriftMsMax() const;          // Furthest from 0.
+
+  // Frames per second of an ARTNET_TIMECODE_* type, drop frame counts as 30.
+  static int TypeToFps( int type );
+
+  static uint32_t TimecodeToMs( int hours, int minutes, int seconds, int frames, int fps );
+
+  // "hh:mm:ss:ff", returns false if it isn't a timecode.
+  static bool ParseTimecode( const char* ptr_text, int fps, uint32_t* ptr_time_ms );
+
+  // "hh:mm:ss:ff" into ptr_text, at least 12 characters.
+  static void FormatTimecode( uint32_t time_ms, int fps, char* ptr_text );
+
+private:
+  // Last cue at or before the timecode, -1 if none.
+  int FindCue( uint32_t timecode_ms );
+
+  // Starts the fade from the current output.
+  void EnterCue( int cue_index, const uint8_t* slots );
+
+  // millis() the timecode stopped running, from the last ArtTimeCode or the first repeat of it.
+  unsigned long GetTimecodeStoppedMs() const;
+
+  // Keeps the segment's show at the timecode, returns true if m_target changed.
+  bool ChaseSegment( const Cue& cue, uint32_t cue_elapsed_ms, unsigned long time_ms );
+
+  std::vector< Cue >          m_cues;
+  std::vector< CueLookValue > m_look_values;
+  String                      m_show_filename;
+  const char*                 m_load_error;
+  unsigned long               m_release_ms;
+
+  // Timecode
+  bool          m_has_timecode;
+  bool          m_timecode_stopped;      // The same timecode arrived again.
+  unsigned long m_timecode_stopped_ms;   // millis() of the first repeat.
+  uint32_t      m_timecode_ms;           // Last ArtTimeCode.
+  unsigned long m_timecode_local_ms;     // millis() when it arrived.
+  int           m_timecode_type;
+  unsigned long m_timecode_received_us;  // Not yet written by Update(), 0 if none.
+  unsigned long m_output_received_us;    // Written by Update(), not yet handed to the output, 0 if none.
+
+  // Output
+  int           m_cue_current;
+  bool          m_released;
+  bool          m_render_pending;
+  bool          m_fading;
+  uint32_t      m_render_timecode_ms;
+  uint8_t       m_fade_from[ 512 ];
+  uint8_t       m_target[ 512 ];
+  ShowPlayer    m_ShowPlayer;
+  bool          m_segment_synced;
+  uint32_t      m_segment_position_ms;
+
+  // Stats
+  unsigned long m_timecode_count;
+  unsigned long m_cue_changes;
+  unsigned long m_seeks;
+  unsigned long m_holds;
+  bool          m_hold_counted;
+  unsigned long m_releases;
+  unsigned long m_jumps;
+  unsigned long m_lookups;
+  unsigned long m_lookup_us_max;
+  unsigned long m_latency_count;
+  unsigned long m_latency_us_last;
+  unsigned long m_latency_us_max;
+  unsigned long m_latency_us_total;
+  long          m_drift_ms_last;
+  long          m_drift_ms_max;
+};
+
+#endif
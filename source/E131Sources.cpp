@@ -0,0 +1,118 @@
+#include "E131Sources.h"
+
+E131Sources::E131Sources() {
+  this->Clear();
+}
+
+E131Sources::~E131Sources() {
+}
+
+void E131Sources::Clear() {
+  memset( m_sources, 0, sizeof( m_sources ) );
+  m_priority_active = 0;
+}
+
+bool E131Sources::Accept( uint32_t source_ip, uint8_t priority, unsigned long time_ms ) {
+  if( priority > E131_PRIORITY_MAX ) {
+    priority = E131_PRIORITY_MAX;
+  }
+
+  E131Source* ptr_source = nullptr;
+  E131Source* ptr_free   = nullptr;
+  bool        changed    = false;
+
+  for( E131Source& source : m_sources ) {
+    if( source.m_in_use && time_ms - source.m_last_ms >= E131_NETWORK_DATA_LOSS_MS ) {
+      source.m_in_use  = false;
+      source.m_dropped = source.m_merging;
+      changed          = true;
+    }
+    if( source.m_in_use && source.m_source_ip == source_ip ) {
+      ptr_source = &source;
+    } else if( !source.m_in_use && !source.m_dropped && ptr_free == nullptr ) {
+      ptr_free = &source;
+    }
+  }
+
+  if( ptr_source == nullptr ) {
+    if( ptr_free == nullptr ) {
+      return false;
+    }
+    ptr_source = ptr_free;
+    ptr_source->m_in_use    = true;
+    ptr_source->m_source_ip = source_ip;
+    ptr_source->m_merging   = false;
+    changed                 = true;
+  }
+
+  if( ptr_source->m_priority != priority ) {
+    ptr_source->m_priority = priority;
+    changed                = true;
+  }
+  ptr_source->m_last_ms = time_ms;
+
+  if( changed ) {
+    this->UpdatePriority();
+  }
+
+  return ptr_source->m_merging;
+}
+
+void E131Sources::Terminate( uint32_t source_ip ) {
+  for( E131Source& source : m_sources ) {
+    if( source.m_in_use && source.m_source_ip == source_ip ) {
+      source.m_in_use  = false;
+      source.m_dropped = source.m_merging;
+      this->UpdatePriority();
+      return;
+    }
+  }
+}
+
+uint32_t E131Sources::PopDropped() {
+  for( E131Source& source : m_sources ) {
+    if( source.m_dropped ) {
+      source.m_dropped = false;
+      source.m_merging = false;
+      return source.m_source_ip;
+    }
+  }
+  return 0;
+}
+
+uint8_t E131Sources::GetPriorityActive() const {
+  return m_priority_active;
+}
+
+int E131Sources::GetSourceCount() const {
+  int count = 0;
+  for( const E131Source& source : m_sources ) {
+    if( source.m_in_use ) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void E131Sources::UpdatePriority() {
+  m_priority_active = 0;
+  for( const E131Source& source : m_sources ) {
+    if( source.m_in_use && source.m_priority > m_priority_active ) {
+      m_priority_active = source.m_priority;
+    }
+  }
+
+  for( E131Source& source : m_sources ) {
+    if( !source.m_in_use ) {
+      continue;
+    }
+    bool merging = source.m_priority == m_priority_active;
+    if( source.m_merging && !merging ) {
+      // Outranked, its last frame must leave the merge.
+      source.m_dropped = true;
+    } else if( merging ) {
+      source.m_dropped = false;
+    }
+    source.m_merging = merging;
+  }
+}
@@ -0,0 +1,48 @@
+#ifndef _E131SOURCES_H_
+#define _E131SOURCES_H_
+
+#include <Arduino.h>
+#include "E131_Spec.h"
+
+#define E131_SOURCES_MAX  8   // sACN sources tracked at the same time for the patched universe.
+
+struct E131Source {
+  bool          m_in_use;
+  uint32_t      m_source_ip;
+  uint8_t       m_priority;
+  unsigned long m_last_ms;
+  bool          m_merging;          // Taking part in the merge, i.e. at the active priority.
+  bool          m_dropped;          // Left the merge & not yet collected by PopDropped().
+};
+
+// Tracks sACN sources of one universe & decides which take part in the merge.  Only sources at the highest
+// priority are output, sources at the same priority are merged.
+class E131Sources {
+public:
+  E131Sources();
+
+  ~E131Sources();
+
+  void Clear();
+
+  // Returns false if the packet should be ignored because a higher priority source is active.
+  bool Accept( uint32_t source_ip, uint8_t priority, unsigned long time_ms );
+
+  // Source sent stream terminated.
+  void Terminate( uint32_t source_ip );
+
+  // Returns a source IP that has left the merge (timeout, terminated or outranked), 0 when there are none.
+  uint32_t PopDropped();
+
+  uint8_t GetPriorityActive() const;
+
+  int     GetSourceCount() const;
+
+private:
+  void    UpdatePriority();
+
+  E131Source m_sources[ E131_SOURCES_MAX ];
+  uint8_t    m_priority_active;
+};
+
+#endif
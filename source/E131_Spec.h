@@ -0,0 +1,74 @@
+#ifndef _E131_SPEC_H_
+#define _E131_SPEC_H_
+
+// Refer to ANSI E1.31 (Streaming ACN, sACN) for full specification.
+
+// This header only includes the E1.31 data packet;
+//    Root Layer
+//    Framing Layer
+//    DMP Layer (start code + up to 512 slots)
+// All multi byte fields are big endian (network order).
+
+#define E131_UDP_PORT                   5568
+#define E131_ACN_PACKET_IDENTIFIER      "ASC-E1.17\0\0\0"
+#define E131_ACN_PACKET_IDENTIFIER_SIZE 12
+#define E131_PREAMBLE_SIZE              0x0010
+#define E131_VECTOR_ROOT_DATA           0x00000004
+#define E131_VECTOR_FRAMING_DATA        0x00000002
+#define E131_VECTOR_DMP_SET_PROPERTY    0x02
+#define E131_DMP_ADDRESS_DATA_TYPE      0xA1
+#define E131_START_CODE_DMX             0x00
+
+#define E131_OPTION_PREVIEW_DATA        0x80  // Data for visualisers only, not to be output.
+#define E131_OPTION_STREAM_TERMINATED   0x40  // Source has stopped sending this universe.
+#define E131_OPTION_FORCE_SYNC          0x20
+
+#define E131_UNIVERSE_MIN               1
+#define E131_UNIVERSE_MAX               63999
+#define E131_PRIORITY_DEFAULT           100
+#define E131_PRIORITY_MAX               200
+#define E131_SOURCE_NAME_LENGTH         64
+#define E131_NETWORK_DATA_LOSS_MS       2500  // A source not seen for this long has stopped.
+
+#define E131_PACKET_HEADER_SIZE         126   // Root, framing & DMP layers up to and including the start code.
+#define E131_PACKET_MAXSIZE             638   // Header + 512 slots.
+
+// Multicast group for a universe is 239.255.UniverseHi.UniverseLo
+#define E131_MULTICAST_IP_1             239
+#define E131_MULTICAST_IP_2             255
+
+#pragma pack( push, 1 ) // Set packing alignment to 1 byte
+
+typedef struct E131PacketHeader
+{
+  // Root Layer
+  uint8_t  m_PreambleSize[ 2 ];         //   0: 0x0010
+  uint8_t  m_PostambleSize[ 2 ];        //   2: 0x0000
+  uint8_t  m_ACNPacketIdentifier[ 12 ]; //   4: "ASC-E1.17" followed by 3 zero bytes.
+  uint8_t  m_RootFlagsLength[ 2 ];      //  16: 0x7 flags in the top 4 bits, PDU length in the low 12.
+  uint8_t  m_RootVector[ 4 ];           //  18: E131_VECTOR_ROOT_DATA
+  uint8_t  m_CID[ 16 ];                 //  22: Unique ID of the source.
+
+  // Framing Layer
+  uint8_t  m_FramingFlagsLength[ 2 ];   //  38:
+  uint8_t  m_FramingVector[ 4 ];        //  40: E131_VECTOR_FRAMING_DATA
+  uint8_t  m_SourceName[ 64 ];          //  44: UTF-8, null terminated.
+  uint8_t  m_Priority;                  // 108: 0 to 200, highest priority source wins.
+  uint8_t  m_SyncAddress[ 2 ];          // 109:
+  uint8_t  m_Sequence;                  // 111:
+  uint8_t  m_Options;                   // 112: E131_OPTION_*
+  uint8_t  m_Universe[ 2 ];             // 113: 1 to 63999.
+
+  // DMP Layer
+  uint8_t  m_DMPFlagsLength[ 2 ];       // 115:
+  uint8_t  m_DMPVector;                 // 117: E131_VECTOR_DMP_SET_PROPERTY
+  uint8_t  m_AddressDataType;           // 118: E131_DMP_ADDRESS_DATA_TYPE
+  uint8_t  m_FirstPropertyAddress[ 2 ]; // 119: 0x0000
+  uint8_t  m_AddressIncrement[ 2 ];     // 121: 0x0001
+  uint8_t  m_PropertyValueCount[ 2 ];   // 123: Start code + number of slots.
+  uint8_t  m_StartCode;                 // 125: E131_START_CODE_DMX, others (0xDD per slot priority etc) are ignored.
+} __attribute__( ( packed ) ) E131PacketHeader;
+
+#pragma pack( pop ) // Restore original packing alignment
+
+#endif
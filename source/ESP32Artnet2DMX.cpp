@@ -4,10 +4,64 @@
 
 ESP32Artnet2DMX::ESP32Artnet2DMX() {
   memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
+  memset( m_dmx_output_buffer, 0, sizeof( m_dmx_output_buffer ) );
 
-  m_artnet_source_ipaddress_any.fromString( "255.255.255.255" );
+  m_is_started              = false;
+  m_show_playing_on_timeout = false;
+  m_poll_reply_pending      = false;
+  m_poll_reply_last_ms      = 0;
+  m_poll_reply_count        = 0;
+  m_indicator               = ARTNETINDICATOR::INDICATOR_NORMAL;
+  m_indicator_led_on        = false;
+  m_sync_active             = false;
+  m_sync_received_us        = 0;
+  m_receive_enabled         = false;
+  m_receive_busy            = false;
+  m_receive_task_handle     = nullptr;
+  m_receive_universe        = 0;
+  m_receive_rejected_source   = 0;
+  m_receive_rejected_universe = 0;
+  m_receive_bytes_not_copied  = 0;
+  m_receive_accepted_us       = 0;
+  m_receive_accepted_count    = 0;
+  m_receive_rejected_us       = 0;
+  m_receive_rejected_count    = 0;
+  m_ptr_FrameTimer          = &m_EspFrameTimer;
+  m_dmx_input_task_handle   = nullptr;
+  m_dmx_input_enabled       = false;
+  m_dmx_input_busy          = false;
+  m_dmx_input_mode          = false;
+  m_dmx_input_target_ip     = 0;
+  m_dmx_input_packet_sent   = 0;
+  m_dmx_input_length_sent   = 0;
+  m_dmx_input_sent_ms       = 0;
+  m_dmx_input_sequence      = 0;
+  m_forward_frame_pending   = false;
+  m_network_frame_pending   = false;
+  m_dmx_output_mux          = portMUX_INITIALIZER_UNLOCKED;
+  m_dmx_frame_pending       = false;
+  m_dmx_output_enabled      = false;
+  m_dmx_output_busy         = false;
+  m_sync_output             = false;
+  m_dmx_frame_period_us     = 0;
+  m_dmx_frame_last_us       = 0;
+  m_dmx_mods_slot_max       = 0;
+  m_dmx_frame_slots         = DMX_FRAME_SLOTS_MAX;
+  m_dmx_output_slots        = DMX_FRAME_SLOTS_MAX;
+  m_dmx_sync_slots          = DMX_FRAME_SLOTS_MAX;
+  m_dmx_frame_late_counted  = true;
+  m_dmx_rate_window_start_us = 0;
+  m_dmx_rate_window_frames  = 0;
 
-  m_is_started = false;
+  m_NodeStats.Reset();
+  m_NodeStats.m_merge_benchmark_ns         = 0;
+  m_NodeStats.m_forward_benchmark_ns       = 0;
+  m_NodeStats.m_trace_benchmark_ns         = 0;
+  m_NodeStats.m_heap_free_start            = 0;
+  m_NodeStats.m_socket_receive_buffer_size = 0;
+  m_NodeStats.m_dmx_frame_period_us        = 0;
+  m_NodeStats.m_dmx_frame_slots            = DMX_FRAME_SLOTS_MAX;
+  m_NodeStats.m_artnet_indicator           = ARTNETINDICATOR::INDICATOR_NORMAL;
 }
 
 ESP32Artnet2DMX::~ESP32Artnet2DMX() {
@@ -16,14 +70,49 @@ ESP32Artnet2DMX::~ESP32Artnet2DMX() {
 
 void ESP32Artnet2DMX::Init() {
 
+  // Everything logs through m_Logger, so Serial output never holds up loop().
+  m_Logger.Begin();
+  m_ConfigServer.SetLogger( &m_Logger );
+  m_ShowRecorder.SetLogger( &m_Logger );
+  m_ShowPlayer.SetLogger( &m_Logger );
+
   // Init must be called because class constructor is not called by default on global var.
   m_ConfigServer.Init();
 
+  m_ConfigServer.SetShowControl( &m_ShowRecorder, &m_ShowPlayer );
+  m_ConfigServer.SetNodeStats( &m_NodeStats );
+  m_ConfigServer.SetSequenceTracker( &m_SequenceTracker );
+  m_ConfigServer.SetArtNetForwarder( &m_ArtNetForwarder );
+  m_ConfigServer.SetPatchMatrix( &m_PatchMatrix );
+  m_ConfigServer.SetPixelMapper( &m_PixelMapper );
+  m_ConfigServer.SetChannelModsOptimizer( &m_ChannelModsOptimizer );
+  m_ConfigServer.SetTraceRing( &m_TraceRing );
+  m_ConfigServer.SetChannelMonitor( &m_ChannelMonitor );
+  m_ConfigServer.SetArtNetRemote( &m_ArtNetRemote );
+  m_ConfigServer.SetCueEngine( &m_CueEngine );
+
+  // Cost of the HTP merge for 2 sources x 512 channels on this device.
+  m_NodeStats.m_merge_benchmark_ns = m_SourceMerger.BenchmarkHTP( 1000 );
+
+  // Cost of forwarding a changed frame, without the network.
+  m_NodeStats.m_forward_benchmark_ns = m_ArtNetForwarder.Benchmark( 1000 );
+
+  // Cost of recording one trace event, what tracing adds to each point it records.
+  m_NodeStats.m_trace_benchmark_ns = m_TraceRing.Benchmark( 1000 );
+
+  // Network receive runs at a higher priority than loop(), & only moves datagrams into m_PacketRing.
+  // Created once here, so nothing is allocated on Start().
+  xTaskCreate( ESP32Artnet2DMX::ReceiveTask, "network_receive", NETWORK_RECEIVE_TASK_STACK, this, NETWORK_RECEIVE_TASK_PRIORITY, &m_receive_task_handle );
+
+  // Blocks on the DMX driver in input mode, idle otherwise.
+  xTaskCreate( ESP32Artnet2DMX::DMXInputTask, "dmx_input", DMX_INPUT_TASK_STACK, this, DMX_INPUT_TASK_PRIORITY, &m_dmx_input_task_handle );
+
   // Attempt to connect to WiFi.  On failure will create a hotspot.
   m_ConfigServer.ConnectToWiFi();
 
   // Startup the webserver.
   m_ConfigServer.StartWebServer();
+  m_ChannelMonitor.Begin();
 
   m_is_started = false;
 }
@@ -38,34 +127,164 @@ bool ESP32Artnet2DMX::Start() {
   dmx_driver_install( DMX_NUM_1, &config, personalities, personality_count );
 
   dmx_set_pin( DMX_NUM_1, m_ConfigServer.m_gpio_transmit, m_ConfigServer.m_gpio_receive, m_ConfigServer.m_gpio_enable );
+  dmx_set_break_len( DMX_NUM_1, m_ConfigServer.m_dmx_break_us );
+  dmx_set_mab_len( DMX_NUM_1, m_ConfigServer.m_dmx_mab_us );
 
-  if( !m_WiFiUDP.begin( ARTNET_UDP_PORT ) ) {
-    Serial.print("Failed to create Art-Net network socket on UDP port 6464\n");
+  // Mods only change with the config, which restarts the engine.
+  m_dmx_mods_slot_max = 0;
+  for( const ChannelMod& mod : m_ConfigServer.GetModsVector() ) {
+    if( mod.m_mod_type != CHANNELMODTYPE::NOTHING && (int)mod.m_channel > m_dmx_mods_slot_max && mod.m_channel <= DMX_FRAME_SLOTS_MAX ) {
+      m_dmx_mods_slot_max = mod.m_channel;
+    }
+  }
+  m_ChannelModsOptimizer.Optimize( m_ConfigServer.GetModsVector(), m_dmx_mods );
+  m_NodeStats.m_mods_optimized = ChannelModsOptimizer::Verify( m_ConfigServer.GetModsVector(), m_dmx_mods, MODS_OPTIMIZER_VERIFY_FRAMES );
+  if( !m_NodeStats.m_mods_optimized ) {
+    LOG_PRINTF( &m_Logger, LOG_LEVEL_WARNING, "Optimized channel mods differ from the config or can't be checked, running them as configured." );
+    m_dmx_mods = m_ConfigServer.GetModsVector();
+  }
+  LOG_PRINTF( &m_Logger, LOG_LEVEL_INFO, "Channel mods %i, running %i.", m_ChannelModsOptimizer.GetModsIn(), (int)m_dmx_mods.size() );
+
+  m_PixelMapper.Clear();
+  for( const PixelMap& map : m_ConfigServer.GetPixelMapsVector() ) {
+    m_PixelMapper.AddMap( map );
+  }
+  if( m_PixelMapper.GetHighestOutputChannel() > m_dmx_mods_slot_max ) {
+    m_dmx_mods_slot_max = m_PixelMapper.GetHighestOutputChannel();
+  }
+  this->ParsePatchMatrix();
+  m_network_frame_pending = false;
+  if( m_PatchMatrix.GetHighestOutputChannel() > m_dmx_mods_slot_max ) {
+    m_dmx_mods_slot_max = m_PatchMatrix.GetHighestOutputChannel();
+  }
+  this->UpdateDMXFrameSlots( 0 );
+
+  // Not cleared, so a trace can show what led up to a restart.
+  m_TraceRing.SetEnabled( m_ConfigServer.m_trace_enabled );
+
+  m_ChannelMonitor.SetRate( m_ConfigServer.m_monitor_rate_hz );
+
+  if( !m_ArtNetSocket.Begin( ARTNET_UDP_PORT, m_ConfigServer.m_network_receive_buffer_size ) ) {
+    LOG_PRINTF( &m_Logger, LOG_LEVEL_ERROR, "Failed to create Art-Net network socket on UDP port 6464" );
     return false;
   }
+  m_NodeStats.m_socket_receive_buffer_size = m_ArtNetSocket.GetReceiveBufferSize();
+
+  if( m_ConfigServer.m_sacn_enabled ) {
+    // Only the group of the patched universe is joined, so other multicast universes never reach the node.
+    IPAddress multicast_ipaddress( E131_MULTICAST_IP_1, E131_MULTICAST_IP_2, m_ConfigServer.m_sacn_universe >> 8, m_ConfigServer.m_sacn_universe & 0xFF );
+    if( !m_E131Socket.Begin( E131_UDP_PORT, m_ConfigServer.m_network_receive_buffer_size ) || !m_E131Socket.JoinMulticast( (uint32_t)multicast_ipaddress ) ) {
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_ERROR, "Failed to create sACN network socket on UDP port 5568" );
+    }
+  }
+  m_E131Sources.Clear();
 
   // Store expected source IP for artnet packets.
-  m_artnet_source_ipaddress.fromString( m_ConfigServer.m_artnet_source_ip );
+  this->ParseArtNetSourceIPs();
+
+  m_SourceMerger.Clear();
+  m_SourceMerger.SetMergeMode( m_ConfigServer.m_artnet_merge_mode );
+
+  // Config may have changed the universe, names or IP.
+  this->BuildArtPollReply();
+
+  m_SequenceTracker.Clear();
+
+  m_dmx_input_mode = ( m_ConfigServer.m_dmx_mode == DMXMODE::DMX_INPUT );
+
+  // The cue list is only read here, uploading a new one restarts the engine.
+  if( m_ConfigServer.m_timecode_enabled && !m_dmx_input_mode ) {
+    m_CueEngine.SetReleaseMs( m_ConfigServer.m_timecode_release_ms );
+    if( m_CueEngine.Load( CUE_FILE, SHOW_FILE ) ) {
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_INFO, "Timecode cues %i, look values %i.", m_CueEngine.GetCueCount(), m_CueEngine.GetLookValueCount() );
+    } else {
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_WARNING, "Timecode cues not loaded: %s.", m_CueEngine.GetLoadError() );
+    }
+  } else {
+    m_CueEngine.Clear();
+  }
+
+  this->ParseArtNetForwardTargets();
+  m_forward_frame_pending = false;
 
   m_dmx_update_time_next_ms = millis();
 
+  m_sync_active             = false;
+  m_NodeStats.m_sync_active = false;
+
   if( m_ConfigServer.m_artnet_timeout_ms == 0 ) {
     m_artnet_timeout_next_ms = 0;
   } else {
     m_artnet_timeout_next_ms = m_dmx_update_time_next_ms + m_ConfigServer.m_artnet_timeout_ms;
   }
 
+  // The receive task is idle, so the ring has no producer.
+  m_PacketRing.Clear();
+  m_receive_universe = m_ConfigServer.m_artnet_universe;
+  m_receive_enabled  = true;
+
+  if( m_dmx_input_mode && m_ConfigServer.m_dmx_enabled ) {
+    // Sent from its own socket on an ephemeral port, so the input task never shares a socket with receive.
+    if( !m_DMXInputSocket.Begin( 0, 0 ) ) {
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_ERROR, "Failed to create DMX input network socket" );
+    }
+    this->BuildDMXInputPackets();
+    m_dmx_input_enabled = true;
+  }
+
+  // Frames are started by the timer, so loop() stalls (web pages, flash writes) don't move the output.
+  if( m_ConfigServer.m_dmx_enabled && !m_dmx_input_mode ) {
+    m_dmx_frame_period_us = m_ConfigServer.m_dmx_update_interval_ms * 1000;
+    if( m_dmx_frame_period_us < DMX_FRAME_PERIOD_MIN_US ) {
+      m_dmx_frame_period_us = DMX_FRAME_PERIOD_MIN_US;
+    }
+    m_dmx_frame_late_counted = ( m_ConfigServer.m_dmx_update_interval_ms > 0 );
+    m_NodeStats.m_dmx_frame_period_us = m_dmx_frame_period_us;
+    m_dmx_rate_window_start_us = 0;
+    m_dmx_rate_window_frames   = 0;
+
+    m_sync_output        = false;
+    m_dmx_frame_last_us  = 0;
+    m_dmx_frame_pending  = true;
+    m_dmx_output_enabled = true;
+    if( !m_ptr_FrameTimer->Start( m_dmx_frame_period_us, ESP32Artnet2DMX::FrameTimerCallback, this ) ) {
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_ERROR, "Failed to start the DMX frame timer" );
+    }
+  }
+
+  // What the heap should stay at until the next Start(), see "heap" in the stats.
+  m_NodeStats.m_heap_free_start = ESP.getFreeHeap();
+
   m_is_started = true;
 
   return m_is_started;
 }
 
 void ESP32Artnet2DMX::Stop() {
+  // The timer callback & input task must be out of the driver before it's deleted.
+  m_dmx_output_enabled = false;
+  m_ptr_FrameTimer->Stop();
+  while( m_dmx_output_busy ) {
+    delay( 1 );
+  }
+  m_dmx_input_enabled = false;
+  while( m_dmx_input_busy ) {
+    delay( 1 );
+  }
+  m_DMXInputSocket.Stop();
+
   if( dmx_driver_is_installed( DMX_NUM_1 ) ) {
     dmx_driver_delete( DMX_NUM_1 ) ;
   }
 
-  m_WiFiUDP.stop();
+  // Wait for the receive task to leave the sockets before closing them.
+  m_receive_enabled = false;
+  while( m_receive_busy ) {
+    delay( 1 );
+  }
+
+  m_ArtNetSocket.Stop();
+  m_E131Socket.Stop();
 
   m_is_started = false;
   return;
@@ -75,6 +294,14 @@ bool ESP32Artnet2DMX::IsStarted() {
   return m_is_started;
 }
 
+void ESP32Artnet2DMX::SetFrameTimer( FrameTimer* ptr_frame_timer ) {
+  m_ptr_FrameTimer = ptr_frame_timer;
+}
+
+const NodeStats& ESP32Artnet2DMX::GetNodeStats() const {
+  return m_NodeStats;
+}
+
 void ESP32Artnet2DMX::Update() {
 
   if( m_ConfigServer.Update() ) {
@@ -83,76 +310,982 @@ void ESP32Artnet2DMX::Update() {
     this->Start();
   }
 
-  this->CheckForArtNetData();
+  // Nothing from here to the poll reply may allocate, apart from the Art-Net timeout starting a show.
+  AllocTracker::EnterHotPath();
+  this->CheckForNetworkData();
+  AllocTracker::LeaveHotPath();
+
+  // Timecode cues write directly into m_dmx_buffer, show playback started from the webpage has priority.
+  if( m_CueEngine.GetCueCount() > 0 && ( !m_ShowPlayer.IsPlaying() || m_show_playing_on_timeout ) ) {
+    if( m_CueEngine.Update( millis(), &m_dmx_buffer[ 1 ] ) ) {
+      this->UpdateDMXFrameSlots( DMX_FRAME_SLOTS_MAX );
+      m_dmx_frame_pending     = true;
+      m_forward_frame_pending = true;
+    }
+    if( m_CueEngine.IsActive() && m_show_playing_on_timeout ) {
+      m_ShowPlayer.Stop();
+      m_show_playing_on_timeout = false;
+    }
+  }
+
+  if( m_ShowPlayer.IsPlaying() ) {
+    m_ShowPlayer.Update( millis(), &m_dmx_buffer[ 1 ] );
+    this->UpdateDMXFrameSlots( DMX_FRAME_SLOTS_MAX );
+    m_dmx_frame_pending     = true;
+    m_forward_frame_pending = true;
+  } else {
+    m_show_playing_on_timeout = false;
+  }
+
+  if( m_sync_active && millis() - m_sync_last_ms >= ARTNET_SYNC_TIMEOUT_MS ) {
+    // ArtSync has stopped, back to immediate output.
+    m_sync_active             = false;
+    m_NodeStats.m_sync_active = false;
+  }
+
+  // Show playback & cues write directly into m_dmx_buffer & are never synced.
+  bool sync_output = m_sync_active && !m_ShowPlayer.IsPlaying() && !m_CueEngine.IsActive();
+  if( !sync_output && m_sync_output ) {
+    // Back to the timer, with the current frame.
+    m_dmx_frame_pending = true;
+  }
+  m_sync_output = sync_output;
+
+  AllocTracker::EnterHotPath();
+
+  // Once per output frame, however many universes arrived since the last one.
+  this->CompleteNetworkFrame();
+
+  if( sync_output ) {
+    if( millis() >= m_dmx_update_time_next_ms ) {
+      this->SendDMX();
+    }
+  } else if( m_dmx_frame_pending ) {
+    this->PublishDMXFrame();
+    m_CueEngine.FrameOutput( micros() );
+  }
+
+  // Forwarded frames are the processed output, sent from loop() like the poll replies.
+  if( m_ArtNetForwarder.GetTargetCount() > 0 ) {
+    if( m_forward_frame_pending ) {
+      m_forward_frame_pending = false;
+      m_ArtNetForwarder.SetFrame( &m_dmx_buffer[ 1 ], m_dmx_frame_slots );
+    }
+    m_ArtNetForwarder.Update( m_ArtNetSocket, millis() );
+  }
+
+  AllocTracker::LeaveHotPath();
 
-  // Target 23ms for sending updates.
-  if( millis() >= m_dmx_update_time_next_ms ) {
-    this->SendDMX();
+  // After the frame is out, names & forward targets are Strings.
+  if( m_ArtNetRemote.HasChanges() ) {
+    this->ApplyArtNetRemote();
   }
+  this->UpdateIndicator();
 
   if( ( m_artnet_timeout_next_ms != 0 ) && ( millis() >= m_artnet_timeout_next_ms ) ) {
-    m_artnet_timeout_next_ms = 0;
-    memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
-    this->SendDMX();
+    this->HandleArtNetTimeout();
+  }
+
+  // Replies are sent after DMX handling so polls never delay the output.
+  if( m_poll_reply_pending ) {
+    AllocTracker::EnterHotPath();
+    this->SendArtPollReply();
+    AllocTracker::LeaveHotPath();
+  }
+
+  // Show file writes happen here, away from Art-Net packet handling.
+  unsigned long show_bytes_written = m_ShowRecorder.GetBytesWritten();
+  unsigned long show_flush_us      = micros();
+  m_ShowRecorder.Flush();
+  if( m_ShowRecorder.GetBytesWritten() != show_bytes_written ) {
+    m_TraceRing.RecordAt( show_flush_us, TRACE_FLASH_WRITE_BEGIN, TRACE_TASK_LOOP, 0 );
+    m_TraceRing.Record( TRACE_FLASH_WRITE_END, TRACE_TASK_LOOP, m_ShowRecorder.GetBytesWritten() - show_bytes_written );
   }
+
+  // Last, the monitor only gets what time is left.
+  if( m_ChannelMonitor.IsCaptureDue( millis() ) ) {
+    this->CaptureMonitor();
+  }
+  m_ChannelMonitor.Update( millis() );
 }
 
-void ESP32Artnet2DMX::CheckForArtNetData() {
-  int packet_size_in_bytes = m_WiFiUDP.parsePacket();
+void ESP32Artnet2DMX::ApplyArtNetRemote() {
+  unsigned long start_us = micros();
+
+  const ArtNetRemoteChanges& changes = m_ArtNetRemote.GetChanges();
+  bool save    = false;
+  bool restart = false;
+
+  if( changes.m_universe >= 0 && changes.m_universe != m_ConfigServer.m_artnet_universe ) {
+    LOG_PRINTF( &m_Logger, LOG_LEVEL_INFO, "Remote config: universe %d to %d.", m_ConfigServer.m_artnet_universe, changes.m_universe );
+    m_ConfigServer.m_artnet_universe = changes.m_universe;
+    m_receive_universe               = changes.m_universe;
+    save = true;
+    if( m_dmx_input_mode ) {
+      // The input task sends from the packets built on Start().
+      restart = true;
+    } else {
+      // The last frame stays on the output until the new universe arrives.
+      m_SourceMerger.Clear();
+      m_SequenceTracker.Clear();
+      this->ParseArtNetForwardTargets();
+      m_forward_frame_pending = true;
+    }
+  }
 
-  if( packet_size_in_bytes == 0 ) {
+  if( changes.m_short_name[ 0 ] != 0 && m_ConfigServer.m_artnet_short_name != changes.m_short_name ) {
+    m_ConfigServer.m_artnet_short_name = changes.m_short_name;
+    save = true;
+  }
+  if( changes.m_long_name[ 0 ] != 0 && m_ConfigServer.m_artnet_long_name != changes.m_long_name ) {
+    m_ConfigServer.m_artnet_long_name = changes.m_long_name;
+    save = true;
+  }
+
+  if( changes.m_merge_mode >= 0 && changes.m_merge_mode != m_ConfigServer.m_artnet_merge_mode ) {
+    m_ConfigServer.m_artnet_merge_mode = changes.m_merge_mode;
+    m_SourceMerger.SetMergeMode( changes.m_merge_mode );
+    save = true;
+  }
+  if( changes.m_cancel_merge ) {
+    m_SourceMerger.CancelMerge();
+  }
+
+  if( changes.m_indicator >= 0 ) {
+    m_indicator                    = changes.m_indicator;
+    m_NodeStats.m_artnet_indicator = changes.m_indicator;
+  }
+
+  if( changes.m_clear_output && !m_dmx_input_mode ) {
+    memset( &m_dmx_buffer[ 1 ], 0, DMX_FRAME_SLOTS_MAX );
+    m_dmx_frame_pending     = true;
+    m_forward_frame_pending = true;
+  }
+
+  if( changes.m_ip_prog ) {
+    uint8_t command = changes.m_ip_prog_command;
+    if( command & ARTNET_IPPROG_ENABLE ) {
+      // The default is DHCP.
+      if( command & ( ARTNET_IPPROG_RESET | ARTNET_IPPROG_DHCP ) ) {
+        m_ConfigServer.m_wifi_ip     = "";
+        m_ConfigServer.m_wifi_subnet = "";
+      } else {
+        if( command & ARTNET_IPPROG_IP ) {
+          m_ConfigServer.m_wifi_ip = IPAddress( changes.m_ip_prog_ip[ 0 ], changes.m_ip_prog_ip[ 1 ], changes.m_ip_prog_ip[ 2 ], changes.m_ip_prog_ip[ 3 ] ).toString();
+        }
+        if( command & ARTNET_IPPROG_SUBNET ) {
+          m_ConfigServer.m_wifi_subnet = IPAddress( changes.m_ip_prog_subnet[ 0 ], changes.m_ip_prog_subnet[ 1 ], changes.m_ip_prog_subnet[ 2 ], changes.m_ip_prog_subnet[ 3 ] ).toString();
+        }
+        if( m_ConfigServer.m_wifi_ip.length() > 0 && m_ConfigServer.m_wifi_subnet.length() == 0 ) {
+          m_ConfigServer.m_wifi_subnet = "255.255.255.0";
+        }
+      }
+      // Changing the address now would drop the connection the controller is using.
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_INFO, "Remote config: IP %s, used from the next WiFi connect.", m_ConfigServer.m_wifi_ip.length() > 0 ? m_ConfigServer.m_wifi_ip.c_str() : "DHCP" );
+      save = true;
+    }
+    this->SendArtIpProgReply( changes.m_ip_prog_reply_ip );
+  }
+
+  if( restart ) {
+    m_ConfigServer.SettingsSaveAndRestart();
+  } else {
+    if( save ) {
+      m_ConfigServer.SettingsSaveLater();
+    }
+    this->BuildArtPollReply();
+  }
+
+  if( changes.m_poll_reply ) {
+    m_poll_reply_ipaddress = IPAddress( changes.m_poll_reply_ip );
+    m_poll_reply_pending   = true;
+  }
+
+  m_ArtNetRemote.Applied( micros() - start_us );
+}
+
+void ESP32Artnet2DMX::SendArtIpProgReply( uint32_t target_ip ) {
+  uint8_t buffer[ ARTNET_PACKET_PAYLOAD_START + sizeof( ArtNetPacketIpProgReply ) ];
+  memset( buffer, 0, sizeof( buffer ) );
+
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)&buffer[ 0 ];
+  memcpy( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) );
+  ptr_header->m_OpCode = ARTNET_OPCODE_IPPROGREPLY;
+
+  ArtNetPacketIpProgReply* ptr_reply = (ArtNetPacketIpProgReply*)&buffer[ ARTNET_PACKET_PAYLOAD_START ];
+  ptr_reply->m_ProtocolLo = ARTNET_VERSION;
+
+  // The saved address, which may not be in use until the next WiFi connect.
+  IPAddress ipaddress;
+  IPAddress subnet;
+  if( m_ConfigServer.m_wifi_ip.length() > 0 && ipaddress.fromString( m_ConfigServer.m_wifi_ip ) ) {
+    subnet.fromString( m_ConfigServer.m_wifi_subnet );
+  } else if( m_ConfigServer.IsConnectedToWiFi() ) {
+    ipaddress = WiFi.localIP();
+    subnet    = WiFi.subnetMask();
+    ptr_reply->m_Status = ARTNET_IPPROGREPLY_STATUS_DHCP;
+  } else {
+    ipaddress = WiFi.softAPIP();
+    subnet    = IPAddress( 255, 255, 255, 0 );
+  }
+  IPAddress gateway = WiFi.gatewayIP();
+
+  for( int i = 0; i < 4; i++ ) {
+    ptr_reply->m_ProgIp[ i ] = ipaddress[ i ];
+    ptr_reply->m_ProgSm[ i ] = subnet[ i ];
+    ptr_reply->m_ProgDg[ i ] = gateway[ i ];
+  }
+  ptr_reply->m_ProgPortHi = ARTNET_UDP_PORT >> 8;
+  ptr_reply->m_ProgPortLo = ARTNET_UDP_PORT & 0xFF;
+
+  m_ArtNetSocket.SendTo( target_ip, ARTNET_UDP_PORT, buffer, sizeof( buffer ) );
+}
+
+void ESP32Artnet2DMX::UpdateIndicator() {
+#ifdef LED_BUILTIN
+  // Never a pin the DMX port uses.
+  if( LED_BUILTIN == m_ConfigServer.m_gpio_enable || LED_BUILTIN == m_ConfigServer.m_gpio_transmit || LED_BUILTIN == m_ConfigServer.m_gpio_receive ) {
     return;
   }
+  bool led_on = ( m_indicator == ARTNETINDICATOR::INDICATOR_LOCATE ) && ( ( millis() / ARTNET_LOCATE_BLINK_MS ) & 1 );
+  if( led_on != m_indicator_led_on ) {
+    pinMode( LED_BUILTIN, OUTPUT );
+    digitalWrite( LED_BUILTIN, led_on ? HIGH : LOW );
+    m_indicator_led_on = led_on;
+  }
+#endif
+}
 
-  // Read data to clean out socket.
-  m_WiFiUDP.read( m_data_buffer, ARTNET_PACKET_MAXSIZE );
+void ESP32Artnet2DMX::HandleArtNetTimeout() {
+  if( m_CueEngine.IsActive() ) {
+    // The cue holds, the console dropping out is what the cues are for.
+    m_artnet_timeout_next_ms = millis() + m_ConfigServer.m_artnet_timeout_ms;
+    return;
+  }
+  m_artnet_timeout_next_ms  = 0;
+  m_sync_active             = false;
+  m_NodeStats.m_sync_active = false;
+  memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
 
-  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_HEADER ) {
-    // Ignore anything that's smaller than expected
-    if( packet_size_in_bytes != 0 ) {
-      Serial.printf( "Packet ignored with data length = %i\n", packet_size_in_bytes );
+  if( m_ConfigServer.m_show_play_on_timeout && !m_ShowPlayer.IsPlaying() && !m_ShowRecorder.IsRecording() ) {
+    m_show_playing_on_timeout = m_ShowPlayer.Start( SHOW_FILE, true );
+    if( m_show_playing_on_timeout ) {
+      m_ShowPlayer.Update( millis(), &m_dmx_buffer[ 1 ] );
     }
+  }
+
+  m_forward_frame_pending = true;
+  this->PublishDMXFrame();
+}
+
+void ESP32Artnet2DMX::CaptureMonitor() {
+  if( m_dmx_input_mode ) {
+    // The input task may be filling the other packet, a frame can mix with the next one.  Only for display.
+    const uint8_t* ptr_data = &m_dmx_input_packets[ m_dmx_input_packet_sent ][ ARTNET_PACKET_DMX_DATA_START ];
+    m_ChannelMonitor.Capture( ptr_data, m_dmx_input_length_sent, nullptr, 0, millis() );
     return;
   }
 
-  // Check source of packet here & discard if not from expected source.
-  if( m_artnet_source_ipaddress != m_artnet_source_ipaddress_any ) {
-    if( m_artnet_source_ipaddress != m_WiFiUDP.remoteIP() ) {
-      Serial.printf( "Packet ignored from unexpected source IP.\n" );
+  // loop() is the only writer of both buffers, the timer only reads them.
+  if( m_sync_output ) {
+    m_ChannelMonitor.Capture( m_SourceMerger.GetMerged(), m_SourceMerger.GetMergedLength(), &m_dmx_sync_buffer[ 1 ], m_dmx_sync_slots, millis() );
+  } else {
+    m_ChannelMonitor.Capture( m_SourceMerger.GetMerged(), m_SourceMerger.GetMergedLength(), &m_dmx_output_buffer[ 1 ], m_dmx_output_slots, millis() );
+  }
+}
+
+void ESP32Artnet2DMX::ReceiveTask( void* ptr_parameters ) {
+  ( (ESP32Artnet2DMX*)ptr_parameters )->ReceiveLoop();
+}
+
+void ESP32Artnet2DMX::ReceiveLoop() {
+  UdpSocket* ptr_sockets[] = { &m_ArtNetSocket, &m_E131Socket };
+
+  for( ;; ) {
+    // Busy is set before enabled is checked, so Stop() either sees busy or the task sees disabled.
+    m_receive_busy = true;
+    if( !m_receive_enabled ) {
+      m_receive_busy = false;
+      vTaskDelay( pdMS_TO_TICKS( NETWORK_RECEIVE_WAIT_MS ) );
+      continue;
+    }
+
+    if( UdpSocket::WaitForData( ptr_sockets, 2, NETWORK_RECEIVE_WAIT_MS ) ) {
+      AllocTracker::EnterHotPath();
+      this->ReceiveIntoRing( m_ArtNetSocket, PACKET_PROTOCOL_ARTNET );
+      this->ReceiveIntoRing( m_E131Socket, PACKET_PROTOCOL_E131 );
+      AllocTracker::LeaveHotPath();
+    }
+    m_receive_busy = false;
+  }
+}
+
+void ESP32Artnet2DMX::ReceiveIntoRing( UdpSocket& socket, int protocol ) {
+  if( !socket.IsOpen() ) {
+    return;
+  }
+
+  UdpDatagram* ptr_datagrams;
+  int slots_free = m_PacketRing.GetWriteSlots( &ptr_datagrams );
+
+  if( slots_free == 0 ) {
+    // Ring is full, loop() is behind.  Only loop() can free slots, so the frames already in the ring are kept &
+    // the one waiting on the socket, the newest, is lost.  Packets the header check rejects aren't counted.
+    uint8_t  header[ ARTNET_PACKET_HEADER_PEEK_SIZE ];
+    uint32_t source_ip;
+    int      header_size_in_bytes = socket.Peek( header, sizeof( header ), &source_ip );
+    if( header_size_in_bytes < 0 ) {
       return;
     }
+    if( protocol != PACKET_PROTOCOL_ARTNET || this->IsArtNetHeaderWanted( header, header_size_in_bytes, source_ip ) ) {
+      m_PacketRing.AddOverruns( 1 );
+    }
+    socket.Discard();
+    return;
   }
 
-  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)&m_data_buffer[ 0 ];
+  if( slots_free > NETWORK_RECEIVE_BATCH ) {
+    slots_free = NETWORK_RECEIVE_BATCH;
+  }
 
-  // Test for correct packet starting data
-  String art_net = String( (char*)ptr_header->m_ID );
-  if( !art_net.equals( ARTNET_HEADER_ID ) ) {
-    Serial.printf( "Header ID failed = %i\n", packet_size_in_bytes );
+  int datagram_count;
+  if( protocol == PACKET_PROTOCOL_ARTNET ) {
+    datagram_count = this->ReceiveArtNet( socket, ptr_datagrams, slots_free );
+  } else {
+    // sACN universes are multicast groups & only the used ones are joined, so the network stack drops the others.
+    datagram_count = socket.ReceiveBatch( ptr_datagrams, slots_free );
+  }
+  if( datagram_count > 0 ) {
+    for( int i = 0; i < datagram_count; i++ ) {
+      m_TraceRing.RecordAt( ptr_datagrams[ i ].m_received_us, TRACE_PACKET_ARRIVAL, TRACE_TASK_RECEIVE, ptr_datagrams[ i ].m_length );
+    }
+    m_PacketRing.Publish( datagram_count, protocol );
+  }
+}
+
+int ESP32Artnet2DMX::ReceiveArtNet( UdpSocket& socket, UdpDatagram* ptr_datagrams, int count ) {
+  // A socket can only peek at the datagram at its head.  A rejected one there is taken with a 1 byte receive, so
+  // on a shared network the data of other universes is mostly never copied into the ring.  A wanted one is
+  // received in one batch with the datagrams behind it, & those are checked from the copies, so a stream of
+  // wanted packets costs one peek per batch instead of one per datagram.
+  uint8_t header[ ARTNET_PACKET_HEADER_PEEK_SIZE ];
+  int     received = 0;
+
+  while( received < count ) {
+    unsigned long start_us = micros();
+    uint32_t      source_ip;
+    int           header_size_in_bytes = socket.Peek( header, sizeof( header ), &source_ip );
+    if( header_size_in_bytes < 0 ) {
+      break;
+    }
+
+    if( !this->IsArtNetHeaderWanted( header, header_size_in_bytes, source_ip ) ) {
+      socket.Discard();
+      const ArtNetPacketDMX* ptr_packet_dmx = (const ArtNetPacketDMX*)&header[ ARTNET_PACKET_PAYLOAD_START ];
+      int data_size_in_bytes = ptr_packet_dmx->m_Length | ptr_packet_dmx->m_LengthHi << 8;
+      m_receive_bytes_not_copied += ( data_size_in_bytes > 512 ) ? 512 : data_size_in_bytes;
+      m_receive_rejected_us      += micros() - start_us;
+      m_receive_rejected_count++;
+      continue;
+    }
+
+    UdpDatagram* ptr_batch = &ptr_datagrams[ received ];
+    int          batch     = socket.ReceiveBatch( ptr_batch, count - received );
+    if( batch == 0 ) {
+      break;
+    }
+
+    // The first was peeked.  Rejected ones behind it are swapped to the end, the slot is received into again.
+    int kept     = 1;
+    int dmx_kept = this->IsArtNetDMX( ptr_batch[ 0 ] ) ? 1 : 0;
+    for( int i = 1; i < batch; i++ ) {
+      int length = ( ptr_batch[ i ].m_length < ARTNET_PACKET_HEADER_PEEK_SIZE ) ? ptr_batch[ i ].m_length : ARTNET_PACKET_HEADER_PEEK_SIZE;
+      if( this->IsArtNetHeaderWanted( ptr_batch[ i ].m_ptr_buffer, length, ptr_batch[ i ].m_source_ip ) ) {
+        dmx_kept += this->IsArtNetDMX( ptr_batch[ i ] ) ? 1 : 0;
+        std::swap( ptr_batch[ kept++ ], ptr_batch[ i ] );
+      }
+    }
+
+    // The batch time is shared out over its datagrams.
+    unsigned long datagram_us = ( micros() - start_us ) / batch;
+    m_receive_accepted_us    += datagram_us * dmx_kept;
+    m_receive_accepted_count += dmx_kept;
+    m_receive_rejected_us    += datagram_us * ( batch - kept );
+    m_receive_rejected_count += batch - kept;
+    received += kept;
+  }
+
+  return received;
+}
+
+bool ESP32Artnet2DMX::IsArtNetDMX( const UdpDatagram& datagram ) {
+  return datagram.m_length >= ARTNET_PACKET_HEADER_PEEK_SIZE && ( (const ArtNetPacketHeader*)datagram.m_ptr_buffer )->m_OpCode == ARTNET_OPCODE_DMX;
+}
+
+bool ESP32Artnet2DMX::IsArtNetHeaderWanted( const uint8_t* ptr_header, int header_size_in_bytes, uint32_t source_ip ) {
+  if( header_size_in_bytes < ARTNET_PACKET_HEADER_PEEK_SIZE ) {
+    return true;
+  }
+
+  const ArtNetPacketHeader* ptr_packet_header = (const ArtNetPacketHeader*)ptr_header;
+  if( ptr_packet_header->m_OpCode != ARTNET_OPCODE_DMX || memcmp( ptr_packet_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_packet_header->m_ID ) ) != 0 ) {
+    return true;
+  }
+
+  // The source IPs & the patch are only changed by Start(), while the receive task is idle.
+  if( !this->IsArtNetSourceAllowed( IPAddress( source_ip ) ) ) {
+    m_receive_rejected_source++;
+    return false;
+  }
+
+  const ArtNetPacketDMX* ptr_packet_dmx = (const ArtNetPacketDMX*)&ptr_header[ ARTNET_PACKET_PAYLOAD_START ];
+  uint16_t universe_in = ptr_packet_dmx->m_SubUni | ptr_packet_dmx->m_Net << 8;
+  if( universe_in != m_receive_universe && m_PatchMatrix.FindUniverse( universe_in ) < 0 ) {
+    m_receive_rejected_universe++;
+    return false;
+  }
+
+  return true;
+}
+
+void ESP32Artnet2DMX::CollectReceiveStats() {
+  m_NodeStats.m_artnet_rejected_source   += m_receive_rejected_source.exchange( 0 );
+  m_NodeStats.m_artnet_rejected_universe += m_receive_rejected_universe.exchange( 0 );
+  m_NodeStats.m_artnet_bytes_not_copied  += m_receive_bytes_not_copied.exchange( 0 );
+  m_NodeStats.m_artnet_accepted_us_total += m_receive_accepted_us.exchange( 0 );
+  m_NodeStats.m_artnet_accepted_count    += m_receive_accepted_count.exchange( 0 );
+  m_NodeStats.m_artnet_rejected_us_total += m_receive_rejected_us.exchange( 0 );
+  m_NodeStats.m_artnet_rejected_count    += m_receive_rejected_count.exchange( 0 );
+}
+
+void ESP32Artnet2DMX::CheckForNetworkData() {
+  // Rejected datagrams never reach the ring, so these are taken even when it's empty.
+  this->CollectReceiveStats();
+
+  int occupancy = m_PacketRing.GetOccupancy();
+  if( occupancy == 0 ) {
+    return;
+  }
+  m_NodeStats.m_ring_occupancy = occupancy;
+  if( occupancy > m_NodeStats.m_ring_occupancy_max ) {
+    m_NodeStats.m_ring_occupancy_max = occupancy;
+  }
+
+  // Only what is in the ring now, so a flood can't hold up the DMX output.
+  for( int i = 0; i < occupancy; i++ ) {
+    int                protocol;
+    const UdpDatagram* ptr_datagram = m_PacketRing.Peek( &protocol );
+
+    unsigned long latency_us = micros() - ptr_datagram->m_received_us;
+    m_NodeStats.m_ring_dequeued++;
+    m_NodeStats.m_ring_latency_us_total += latency_us;
+    if( latency_us > m_NodeStats.m_ring_latency_us_max ) {
+      m_NodeStats.m_ring_latency_us_max = latency_us;
+    }
+
+    m_TraceRing.Record( TRACE_PARSE_BEGIN, TRACE_TASK_LOOP, protocol );
+    if( protocol == PACKET_PROTOCOL_ARTNET ) {
+      this->HandleArtNetPacket( *ptr_datagram );
+    } else {
+      this->HandleE131Packet( *ptr_datagram );
+    }
+    m_TraceRing.Record( TRACE_PARSE_END, TRACE_TASK_LOOP, protocol );
+
+    m_PacketRing.Release();
+  }
+
+  m_NodeStats.m_ring_overruns          = m_PacketRing.GetOverruns();
+  m_NodeStats.m_socket_received        = m_ArtNetSocket.GetReceivedCount();
+  m_NodeStats.m_socket_batches         = m_ArtNetSocket.GetBatchCount();
+  m_NodeStats.m_socket_truncated       = m_ArtNetSocket.GetTruncatedCount();
+  m_NodeStats.m_socket_discarded       = m_ArtNetSocket.GetDiscardedCount();
+  m_NodeStats.m_socket_drops_available = m_ArtNetSocket.GetDropCount( &m_NodeStats.m_socket_drops );
+}
+
+void ESP32Artnet2DMX::HandleArtNetPacket( const UdpDatagram& datagram ) {
+  int       packet_size_in_bytes = datagram.m_length;
+  IPAddress source_ipaddress( datagram.m_source_ip );
+
+  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_HEADER ) {
+    // Ignore anything that's smaller than expected
+    LOG_PRINTF( &m_Logger, LOG_LEVEL_WARNING, "Packet ignored with data length = %i", packet_size_in_bytes );
     return;
   }
 
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)&datagram.m_ptr_buffer[ 0 ];
+
+  // Test for correct packet starting data, ID includes the null terminator.
+  if( memcmp( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) ) != 0 ) {
+    LOG_PRINTF( &m_Logger, LOG_LEVEL_WARNING, "Header ID failed = %i", packet_size_in_bytes );
+    return;
+  }
+
+  // Everything is decided on the header & the Port-Address, the DMX data is only used once the packet is accepted.
   switch( ptr_header->m_OpCode ) {
     case ARTNET_OPCODE_DMX: {
-      this->HandleArtNetDMX( (ArtNetPacketDMX*)&m_data_buffer[ ARTNET_PACKET_PAYLOAD_START ] );
+      if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_DMX ) {
+        break;
+      }
+      // Check source of packet here & discard if not from expected source.  No print, on a shared network this happens for every packet.
+      if( !this->IsArtNetSourceAllowed( source_ipaddress ) ) {
+        m_NodeStats.m_artnet_rejected_source++;
+        break;
+      }
+      m_artnet_dmx_source_ipaddress = source_ipaddress;
+      this->HandleArtNetDMX( (ArtNetPacketDMX*)&datagram.m_ptr_buffer[ ARTNET_PACKET_PAYLOAD_START ], packet_size_in_bytes - ARTNET_PACKET_HEADER_PEEK_SIZE, source_ipaddress );
+      break;
+    }
+    case ARTNET_OPCODE_SYNC: {
+      // Only the controller sending the DMX data may sync the output, & ArtSync is ignored while merging.
+      if( packet_size_in_bytes >= ARTNET_PACKET_MINSIZE_SYNC && source_ipaddress == m_artnet_dmx_source_ipaddress && m_SourceMerger.GetActiveSourceCount() <= 1 ) {
+        this->HandleArtNetSync( datagram.m_received_us );
+      }
       break;
     }
     case ARTNET_OPCODE_POLL: {
+      // Any controller may discover the node, so no source IP check.
+      this->HandleArtNetPoll( (ArtNetPacketPoll*)&datagram.m_ptr_buffer[ ARTNET_PACKET_PAYLOAD_START ], packet_size_in_bytes, source_ipaddress );
       break;
     }
     case ARTNET_OPCODE_POLLREPLY: {
       break;
     }
+    case ARTNET_OPCODE_TIMECODE: {
+      // Only loaded while timecode is enabled.
+      if( m_CueEngine.GetCueCount() > 0 && this->IsArtNetSourceAllowed( source_ipaddress ) ) {
+        m_CueEngine.HandleTimeCode( (const ArtNetPacketTimeCode*)&datagram.m_ptr_buffer[ ARTNET_PACKET_PAYLOAD_START ], packet_size_in_bytes, datagram.m_received_us, millis() );
+      }
+      break;
+    }
+    case ARTNET_OPCODE_ADDRESS:
+    case ARTNET_OPCODE_COMMAND:
+    case ARTNET_OPCODE_IPPROG: {
+      // Only parsed here, the changes are applied between frames by ApplyArtNetRemote().
+      if( !m_ConfigServer.m_artnet_remote_config || !this->IsArtNetSourceAllowed( source_ipaddress ) ) {
+        m_ArtNetRemote.Reject();
+        break;
+      }
+      const uint8_t* ptr_payload = &datagram.m_ptr_buffer[ ARTNET_PACKET_PAYLOAD_START ];
+      if( ptr_header->m_OpCode == ARTNET_OPCODE_ADDRESS ) {
+        m_ArtNetRemote.HandleAddress( (const ArtNetPacketAddress*)ptr_payload, packet_size_in_bytes, m_ConfigServer.m_artnet_universe, m_dmx_input_mode, datagram.m_source_ip );
+      } else if( ptr_header->m_OpCode == ARTNET_OPCODE_COMMAND ) {
+        m_ArtNetRemote.HandleCommand( (const ArtNetPacketCommand*)ptr_payload, packet_size_in_bytes, datagram.m_source_ip );
+      } else {
+        m_ArtNetRemote.HandleIpProg( (const ArtNetPacketIpProg*)ptr_payload, packet_size_in_bytes, datagram.m_source_ip );
+      }
+      break;
+    }
     default: {
-      Serial.printf( "Unhandled OpCode %i\n", ptr_header->m_OpCode );
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_INFO, "Unhandled OpCode %i", ptr_header->m_OpCode );
       break;
     }
   }
 }
 
-void ESP32Artnet2DMX::HandleArtNetDMX( ArtNetPacketDMX* ptr_packet_artnet )
+void ESP32Artnet2DMX::HandleE131Packet( const UdpDatagram& datagram ) {
+  int packet_size_in_bytes = datagram.m_length;
+
+  // Decided on the header only, so packets for other universes are dropped before anything else is looked at.
+  if( packet_size_in_bytes < E131_PACKET_HEADER_SIZE ) {
+    m_NodeStats.m_sacn_invalid++;
+    return;
+  }
+  const E131PacketHeader& header = *(const E131PacketHeader*)datagram.m_ptr_buffer;
+
+  uint16_t universe_in = header.m_Universe[ 0 ] << 8 | header.m_Universe[ 1 ];
+  if( universe_in != m_ConfigServer.m_sacn_universe ) {
+    m_NodeStats.m_sacn_discarded_universe++;
+    return;
+  }
+  m_TraceRing.Record( TRACE_UNIVERSE_MATCH, TRACE_TASK_LOOP, universe_in );
+
+  if( !this->IsE131HeaderValid( header ) ) {
+    m_NodeStats.m_sacn_invalid++;
+    return;
+  }
+
+  if( !this->IsArtNetSourceAllowed( IPAddress( datagram.m_source_ip ) ) ) {
+    return;
+  }
+
+  // Set new network timeout
+  if( m_ConfigServer.m_artnet_timeout_ms != 0 ) {
+    m_artnet_timeout_next_ms = millis() + m_ConfigServer.m_artnet_timeout_ms;
+  }
+
+  uint32_t source_ip = datagram.m_source_ip;
+  bool     accepted  = false;
+
+  if( header.m_Options & E131_OPTION_STREAM_TERMINATED ) {
+    m_E131Sources.Terminate( source_ip );
+    m_NodeStats.m_sacn_terminated++;
+  } else if( ( header.m_Options & E131_OPTION_PREVIEW_DATA ) || header.m_StartCode != E131_START_CODE_DMX ) {
+    // Visualiser data & alternate start codes are not output.
+  } else {
+    accepted = m_E131Sources.Accept( source_ip, header.m_Priority, millis() );
+    if( !accepted ) {
+      m_NodeStats.m_sacn_discarded_priority++;
+    }
+  }
+
+  // Sources that timed out, terminated or were outranked leave the merge.
+  uint32_t dropped_ip;
+  while( ( dropped_ip = m_E131Sources.PopDropped() ) != 0 ) {
+    m_SourceMerger.Remove( dropped_ip );
+  }
+  m_NodeStats.m_sacn_sources         = m_E131Sources.GetSourceCount();
+  m_NodeStats.m_sacn_priority_active = m_E131Sources.GetPriorityActive();
+
+  if( !accepted || !m_SequenceTracker.Accept( SEQUENCEPROTOCOL::SEQUENCE_E131, universe_in, source_ip, header.m_Sequence, millis() ) ) {
+    return;
+  }
+
+  uint16_t number_of_channels = ( header.m_PropertyValueCount[ 0 ] << 8 | header.m_PropertyValueCount[ 1 ] ) - 1;
+  if( number_of_channels > packet_size_in_bytes - E131_PACKET_HEADER_SIZE ) {
+    number_of_channels = packet_size_in_bytes - E131_PACKET_HEADER_SIZE;
+  }
+  if( number_of_channels > 512 ) {
+    number_of_channels = 512;
+  }
+
+  m_NodeStats.m_sacn_packets++;
+
+  this->HandleDMXFrame( &datagram.m_ptr_buffer[ E131_PACKET_HEADER_SIZE ], number_of_channels, source_ip );
+}
+
+bool ESP32Artnet2DMX::IsE131HeaderValid( const E131PacketHeader& header ) {
+  uint16_t preamble_size    = header.m_PreambleSize[ 0 ] << 8 | header.m_PreambleSize[ 1 ];
+  uint32_t root_vector      = (uint32_t)header.m_RootVector[ 0 ] << 24 | header.m_RootVector[ 1 ] << 16 | header.m_RootVector[ 2 ] << 8 | header.m_RootVector[ 3 ];
+  uint32_t framing_vector   = (uint32_t)header.m_FramingVector[ 0 ] << 24 | header.m_FramingVector[ 1 ] << 16 | header.m_FramingVector[ 2 ] << 8 | header.m_FramingVector[ 3 ];
+  uint16_t value_count      = header.m_PropertyValueCount[ 0 ] << 8 | header.m_PropertyValueCount[ 1 ];
+
+  return preamble_size == E131_PREAMBLE_SIZE &&
+         memcmp( header.m_ACNPacketIdentifier, E131_ACN_PACKET_IDENTIFIER, E131_ACN_PACKET_IDENTIFIER_SIZE ) == 0 &&
+         root_vector == E131_VECTOR_ROOT_DATA &&
+         framing_vector == E131_VECTOR_FRAMING_DATA &&
+         header.m_DMPVector == E131_VECTOR_DMP_SET_PROPERTY &&
+         header.m_AddressDataType == E131_DMP_ADDRESS_DATA_TYPE &&
+         value_count >= 1;
+}
+
+void ESP32Artnet2DMX::ParseArtNetSourceIPs() {
+  // Comma or space separated list, 255.255.255.255 allows any source.
+  String source_ips = m_ConfigServer.m_artnet_source_ip;
+  source_ips.replace( ",", " " );
+  source_ips.trim();
+
+  m_artnet_source_ipaddress_count = 0;
+  m_artnet_source_any             = false;
+
+  unsigned int position = 0;
+  while( position < source_ips.length() && m_artnet_source_ipaddress_count < ARTNET_SOURCES_ALLOWED_MAX ) {
+    int position_end = source_ips.indexOf( ' ', position );
+    if( position_end == -1 ) {
+      position_end = source_ips.length();
+    }
+
+    String    source_ip = source_ips.substring( position, position_end );
+    IPAddress ipaddress;
+    if( source_ip.length() > 0 && ipaddress.fromString( source_ip ) ) {
+      if( ipaddress == IPAddress( 255, 255, 255, 255 ) ) {
+        m_artnet_source_any = true;
+      }
+      m_artnet_source_ipaddresses[ m_artnet_source_ipaddress_count++ ] = ipaddress;
+    }
+    position = position_end + 1;
+  }
+
+  if( m_artnet_source_ipaddress_count == 0 ) {
+    m_artnet_source_any = true;
+  }
+}
+
+void ESP32Artnet2DMX::ParsePatchMatrix() {
+  // Comma separated "output:universe:input:count".
+  m_PatchMatrix.Clear();
+
+  String patches = m_ConfigServer.m_patch_matrix;
+  patches.trim();
+
+  unsigned int position = 0;
+  while( position < patches.length() ) {
+    int position_end = patches.indexOf( ',', position );
+    if( position_end == -1 ) {
+      position_end = patches.length();
+    }
+    String patch = patches.substring( position, position_end );
+    patch.trim();
+    position = position_end + 1;
+
+    int values[ 4 ];
+    int value_count = 0;
+    int value_start = 0;
+    while( value_count < 4 ) {
+      int value_end = patch.indexOf( ':', value_start );
+      if( value_end == -1 ) {
+        values[ value_count++ ] = patch.substring( value_start ).toInt();
+        break;
+      }
+      values[ value_count++ ] = patch.substring( value_start, value_end ).toInt();
+      value_start = value_end + 1;
+    }
+
+    if( value_count != 4 || !m_PatchMatrix.AddPatch( values[ 0 ], values[ 1 ], values[ 2 ], values[ 3 ] ) ) {
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_WARNING, "Patch ignored : %s", patch.c_str() );
+    }
+  }
+}
+
+void ESP32Artnet2DMX::CompleteNetworkFrame() {
+  if( !m_network_frame_pending ) {
+    return;
+  }
+  m_network_frame_pending = false;
+
+  // Show playback & cues are the whole frame, & aren't recorded.
+  if( m_ShowPlayer.IsPlaying() || m_CueEngine.IsActive() ) {
+    return;
+  }
+
+  // Frame slots already cover the highest patched channel, see Start().
+  if( m_PatchMatrix.IsActive() ) {
+    m_PatchMatrix.Apply( &m_dmx_buffer[ 1 ] );
+    m_dmx_frame_pending     = true;
+    m_forward_frame_pending = true;
+  }
+
+  // The frame as it is output, patched universes included.
+  if( m_ShowRecorder.IsRecording() ) {
+    m_ShowRecorder.RecordFrame( &m_dmx_buffer[ 1 ], millis() );
+  }
+}
+
+void ESP32Artnet2DMX::ParseArtNetForwardTargets() {
+  // Comma separated "ip:universe:max fps:c", all but the ip are optional.
+  m_ArtNetForwarder.Clear();
+  if( m_dmx_input_mode ) {
+    // Nothing is output to forward.
+    return;
+  }
+
+  String targets = m_ConfigServer.m_artnet_forward_targets;
+  targets.trim();
+
+  unsigned int position = 0;
+  while( position < targets.length() ) {
+    int position_end = targets.indexOf( ',', position );
+    if( position_end == -1 ) {
+      position_end = targets.length();
+    }
+    String target = targets.substring( position, position_end );
+    target.trim();
+    position = position_end + 1;
+
+    String fields[ 4 ];
+    int    field_count = 0;
+    int    field_start = 0;
+    while( field_count < 4 ) {
+      int field_end = target.indexOf( ':', field_start );
+      if( field_end == -1 ) {
+        fields[ field_count++ ] = target.substring( field_start );
+        break;
+      }
+      fields[ field_count++ ] = target.substring( field_start, field_end );
+      field_start = field_end + 1;
+    }
+
+    IPAddress ipaddress;
+    if( !ipaddress.fromString( fields[ 0 ] ) ) {
+      continue;
+    }
+    int  universe    = ( field_count > 1 && fields[ 1 ].length() > 0 ) ? fields[ 1 ].toInt() : m_ConfigServer.m_artnet_universe;
+    int  max_fps     = ( field_count > 2 ) ? fields[ 2 ].toInt() : 0;
+    bool change_only = ( field_count > 3 ) && ( fields[ 3 ] == "c" );
+
+    if( !m_ArtNetForwarder.AddTarget( (uint32_t)ipaddress, universe, max_fps, change_only ) ) {
+      LOG_PRINTF( &m_Logger, LOG_LEVEL_WARNING, "Art-Net forwarding: only %d targets are supported", ARTNET_FORWARD_TARGETS_MAX );
+      break;
+    }
+  }
+}
+
+bool ESP32Artnet2DMX::IsArtNetSourceAllowed( const IPAddress& source_ipaddress ) {
+  if( m_artnet_source_any ) {
+    return true;
+  }
+  for( int i = 0; i < m_artnet_source_ipaddress_count; i++ ) {
+    if( m_artnet_source_ipaddresses[ i ] == source_ipaddress ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ESP32Artnet2DMX::HandleArtNetPoll( ArtNetPacketPoll* ptr_packet_poll, int packet_size_in_bytes, const IPAddress& source_ipaddress ) {
+  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_POLL ) {
+    return;
+  }
+
+  // Targeted mode, only reply if our Port-Address is within the range.
+  if( ( ptr_packet_poll->m_Flags & ARTNET_POLL_FLAG_TARGETED ) && packet_size_in_bytes >= ARTNET_PACKET_MINSIZE_POLL_TARGETED ) {
+    uint16_t port_address_top    = ptr_packet_poll->m_TargetPortAddressTopLo | ptr_packet_poll->m_TargetPortAddressTopHi << 8;
+    uint16_t port_address_bottom = ptr_packet_poll->m_TargetPortAddressBottomLo | ptr_packet_poll->m_TargetPortAddressBottomHi << 8;
+    if( m_ConfigServer.m_artnet_universe < port_address_bottom || m_ConfigServer.m_artnet_universe > port_address_top ) {
+      return;
+    }
+  }
+
+  // Rate limit controllers that poll too often.
+  IPAddress controller_ipaddress = source_ipaddress;
+  if( controller_ipaddress == m_poll_reply_last_ipaddress && millis() - m_poll_reply_last_ms < ARTNET_POLLREPLY_MIN_INTERVAL_MS ) {
+    return;
+  }
+
+  m_poll_reply_ipaddress = controller_ipaddress;
+  m_poll_reply_pending   = true;
+}
+
+void ESP32Artnet2DMX::BuildArtPollReply() {
+  memset( m_poll_reply_buffer, 0, sizeof( m_poll_reply_buffer ) );
+
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)&m_poll_reply_buffer[ 0 ];
+  memcpy( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) );
+  ptr_header->m_OpCode = ARTNET_OPCODE_POLLREPLY;
+
+  ArtNetPacketPollReply* ptr_reply = (ArtNetPacketPollReply*)&m_poll_reply_buffer[ ARTNET_PACKET_PAYLOAD_START ];
+
+  IPAddress ipaddress;
+  IPAddress subnet;
+  if( m_ConfigServer.IsConnectedToWiFi() ) {
+    ipaddress = WiFi.localIP();
+    subnet    = WiFi.subnetMask();
+  } else {
+    ipaddress = WiFi.softAPIP();
+    subnet    = IPAddress( 255, 255, 255, 0 );
+  }
+
+  for( int i = 0; i < 4; i++ ) {
+    ptr_reply->m_IPAddress[ i ] = ipaddress[ i ];
+    ptr_reply->m_BindIp[ i ]    = ipaddress[ i ];
+    m_poll_reply_broadcast_ipaddress[ i ] = ipaddress[ i ] | ~subnet[ i ];
+  }
+
+  uint16_t universe = m_ConfigServer.m_artnet_universe;
+
+  ptr_reply->m_Port        = ARTNET_UDP_PORT;
+  ptr_reply->m_VersInfoH   = ARTNET2DMX_FIRMWARE_VERSION >> 8;
+  ptr_reply->m_VersInfoL   = ARTNET2DMX_FIRMWARE_VERSION & 0xFF;
+  ptr_reply->m_NetSwitch   = ( universe >> 8 ) & 0x7F;
+  ptr_reply->m_SubSwitch   = ( universe >> 4 ) & 0x0F;
+  ptr_reply->m_OemHi       = ARTNET_OEM_UNKNOWN >> 8;
+  ptr_reply->m_Oem         = ARTNET_OEM_UNKNOWN & 0xFF;
+  ptr_reply->m_Status1     = ARTNET_STATUS1_PORTADDR_PANEL;
+  if( m_indicator == ARTNETINDICATOR::INDICATOR_MUTE ) {
+    ptr_reply->m_Status1  |= ARTNET_STATUS1_INDICATOR_MUTE;
+  } else if( m_indicator == ARTNETINDICATOR::INDICATOR_LOCATE ) {
+    ptr_reply->m_Status1  |= ARTNET_STATUS1_INDICATOR_LOCATE;
+  } else {
+    ptr_reply->m_Status1  |= ARTNET_STATUS1_INDICATOR_NORMAL;
+  }
+
+  strncpy( (char*)ptr_reply->m_PortName, m_ConfigServer.m_artnet_short_name.c_str(), ARTNET_SHORT_NAME_LENGTH - 1 );
+  strncpy( (char*)ptr_reply->m_LongName, m_ConfigServer.m_artnet_long_name.c_str(), ARTNET_LONG_NAME_LENGTH - 1 );
+  // Reply counter in "[0000]" is updated on each send.
+  bool dmx_input = ( m_ConfigServer.m_dmx_mode == DMXMODE::DMX_INPUT );
+  snprintf( (char*)ptr_reply->m_NodeReport, ARTNET_NODE_REPORT_LENGTH, "#0001 [0000] DMX %s %s", dmx_input ? "input" : "output", m_ConfigServer.m_dmx_enabled ? "enabled" : "disabled" );
+
+  // 1 DMX port, output or input.
+  ptr_reply->m_NumPortsLo       = 1;
+  if( dmx_input ) {
+    ptr_reply->m_PortTypes[ 0 ] = ARTNET_PORTTYPE_INPUT_DMX;
+    ptr_reply->m_GoodInput[ 0 ] = m_ConfigServer.m_dmx_enabled ? ARTNET_GOODINPUT_DATA : 0;
+    ptr_reply->m_SwIn[ 0 ]      = universe & 0x0F;
+  } else {
+    ptr_reply->m_PortTypes[ 0 ]   = ARTNET_PORTTYPE_OUTPUT_DMX;
+    ptr_reply->m_GoodOutputA[ 0 ] = m_ConfigServer.m_dmx_enabled ? ARTNET_GOODOUTPUTA_DATA : 0;
+    if( m_ConfigServer.m_artnet_merge_mode == MERGEMODE::LTP ) {
+      ptr_reply->m_GoodOutputA[ 0 ] |= ARTNET_GOODOUTPUTA_MERGE_LTP;
+    }
+    ptr_reply->m_GoodOutputB[ 0 ] = ARTNET_GOODOUTPUTB_RDM_DISABLED | ARTNET_GOODOUTPUTB_CONTINUOUS;
+    ptr_reply->m_SwOut[ 0 ]       = universe & 0x0F;
+  }
+  ptr_reply->m_Style            = ARTNET_STYLE_NODE;
+
+  unsigned int mac[ 6 ];
+  if( sscanf( m_ConfigServer.GetMACAddress().c_str(), "%x:%x:%x:%x:%x:%x", &mac[ 0 ], &mac[ 1 ], &mac[ 2 ], &mac[ 3 ], &mac[ 4 ], &mac[ 5 ] ) == 6 ) {
+    ptr_reply->m_MAC_1_Hi = mac[ 0 ];
+    ptr_reply->m_MAC_2    = mac[ 1 ];
+    ptr_reply->m_MAC_3    = mac[ 2 ];
+    ptr_reply->m_MAC_4    = mac[ 3 ];
+    ptr_reply->m_MAC_5    = mac[ 4 ];
+    ptr_reply->m_MAC_6_Lo = mac[ 5 ];
+  }
+
+  ptr_reply->m_BindIndex = 1;
+  ptr_reply->m_Status2   = ARTNET_STATUS2_WEB_CONFIG | ARTNET_STATUS2_DHCP_CAPABLE | ARTNET_STATUS2_PORTADDR_15BIT;
+  if( m_ConfigServer.IsConnectedToWiFi() && m_ConfigServer.m_wifi_ip.length() == 0 ) {
+    ptr_reply->m_Status2 |= ARTNET_STATUS2_DHCP_USED;
+  }
+
+  if( m_ConfigServer.m_dmx_update_interval_ms > 0 ) {
+    uint16_t refresh_rate = 1000 / m_ConfigServer.m_dmx_update_interval_ms;
+    ptr_reply->m_RefreshRateHi = refresh_rate >> 8;
+    ptr_reply->m_RefreshRateLo = refresh_rate & 0xFF;
+  }
+}
+
+void ESP32Artnet2DMX::SendArtPollReply() {
+  m_poll_reply_pending = false;
+
+  // Node report "#0001 [nnnn]" counter, characters 7 to 10.
+  ArtNetPacketPollReply* ptr_reply = (ArtNetPacketPollReply*)&m_poll_reply_buffer[ ARTNET_PACKET_PAYLOAD_START ];
+  m_poll_reply_count = ( m_poll_reply_count + 1 ) % 10000;
+  unsigned long count = m_poll_reply_count;
+  for( int i = 10; i >= 7; i-- ) {
+    ptr_reply->m_NodeReport[ i ] = '0' + ( count % 10 );
+    count /= 10;
+  }
+
+  if( !m_dmx_input_mode ) {
+    if( m_SourceMerger.GetActiveSourceCount() > 1 ) {
+      ptr_reply->m_GoodOutputA[ 0 ] |= ARTNET_GOODOUTPUTA_MERGING;
+    } else {
+      ptr_reply->m_GoodOutputA[ 0 ] &= ~ARTNET_GOODOUTPUTA_MERGING;
+    }
+  }
+
+  if( m_ConfigServer.m_artnet_pollreply_broadcast ) {
+    m_ArtNetSocket.SendTo( (uint32_t)m_poll_reply_broadcast_ipaddress, ARTNET_UDP_PORT, m_poll_reply_buffer, sizeof( m_poll_reply_buffer ) );
+  } else {
+    m_ArtNetSocket.SendTo( (uint32_t)m_poll_reply_ipaddress, ARTNET_UDP_PORT, m_poll_reply_buffer, sizeof( m_poll_reply_buffer ) );
+  }
+
+  m_poll_reply_last_ipaddress = m_poll_reply_ipaddress;
+  m_poll_reply_last_ms        = millis();
+}
+
+void ESP32Artnet2DMX::HandleArtNetSync( unsigned long received_us ) {
+  if( ( m_ShowPlayer.IsPlaying() && !m_show_playing_on_timeout ) || m_CueEngine.IsActive() ) {
+    return;
+  }
+
+  m_sync_active             = true;
+  m_sync_last_ms            = millis();
+  m_NodeStats.m_sync_active = true;
+  m_sync_output             = true;
+
+  // Latch the staged frame & output it now.
+  this->CompleteNetworkFrame();
+  memcpy( m_dmx_sync_buffer, m_dmx_buffer, sizeof( m_dmx_sync_buffer ) );
+  m_dmx_sync_slots = m_dmx_frame_slots;
+  if( m_ConfigServer.m_dmx_enabled ) {
+    m_sync_received_us = received_us;
+  }
+  this->SendDMX();
+}
+
+void ESP32Artnet2DMX::HandleArtNetDMX( ArtNetPacketDMX* ptr_packet_artnet, int data_size_in_bytes, const IPAddress& source_ipaddress )
 {
-  uint16_t protocol = ptr_packet_artnet->m_ProtocolLo | ptr_packet_artnet->m_ProtocolHi << 8;
   uint16_t universe_in = ptr_packet_artnet->m_SubUni | ptr_packet_artnet->m_Net << 8;
   uint16_t number_of_channels = ptr_packet_artnet->m_Length | ptr_packet_artnet->m_LengthHi << 8;
 /*
@@ -170,123 +1303,339 @@ void ESP32Artnet2DMX::HandleArtNetDMX( ArtNetPacketDMX* ptr_packet_artnet )
     m_artnet_timeout_next_ms = millis() + m_ConfigServer.m_artnet_timeout_ms;
   }
 
-  // Is this the universe we are looking for?
-  if( universe_in != m_ConfigServer.m_artnet_universe ) {
+  // Is this the universe we are looking for?  Other universes are only wanted by the patch.
+  int patch_universe_index = m_PatchMatrix.FindUniverse( universe_in );
+  if( universe_in != m_ConfigServer.m_artnet_universe && patch_universe_index < 0 ) {
+    m_NodeStats.m_artnet_rejected_universe++;
+    return;
+  }
+  m_TraceRing.Record( TRACE_UNIVERSE_MATCH, TRACE_TASK_LOOP, universe_in );
+
+  // Drop duplicates & packets that arrived after a newer one, otherwise an older frame replaces a newer one.
+  if( !m_SequenceTracker.Accept( SEQUENCEPROTOCOL::SEQUENCE_ARTNET, universe_in, (uint32_t)source_ipaddress, ptr_packet_artnet->m_Sequence, millis() ) ) {
     return;
   }
 
+  if( number_of_channels > data_size_in_bytes ) {
+    number_of_channels = data_size_in_bytes;
+  }
+  if( number_of_channels > 512 ) {
+    number_of_channels = 512;
+  }
+
+  if( patch_universe_index >= 0 ) {
+    // Last received wins, patched universes aren't merged.
+    m_PatchMatrix.StoreFrame( patch_universe_index, ptr_packet_artnet->m_Data, number_of_channels );
+    m_network_frame_pending = true;
+    if( universe_in != m_ConfigServer.m_artnet_universe ) {
+      return;
+    }
+  }
+
+  this->HandleDMXFrame( ptr_packet_artnet->m_Data, number_of_channels, (uint32_t)source_ipaddress );
+}
+
+void ESP32Artnet2DMX::HandleDMXFrame( const uint8_t* ptr_data, uint16_t number_of_channels, uint32_t source_ip )
+{
+  if( m_dmx_input_mode ) {
+    // The DMX port is an input, this may even be our own ArtDmx.
+    return;
+  }
+
+  if( m_ShowPlayer.IsPlaying() ) {
+    if( !m_show_playing_on_timeout ) {
+      // Show playback has been started from the webpage & has priority over Art-Net & sACN.
+      return;
+    }
+    // Art-Net has returned.
+    m_ShowPlayer.Stop();
+    m_show_playing_on_timeout = false;
+  }
+
+  if( m_CueEngine.IsActive() ) {
+    // Timecode cues have the output until the timecode goes back before the first cue, or is released.
+    return;
+  }
+
+  // Merge with any other sources sending this universe.
+  if( !m_SourceMerger.Update( source_ip, ptr_data, number_of_channels, millis() ) ) {
+    // Already merging the maximum number of sources, or the merge was cancelled for another source.
+    return;
+  }
+  m_NodeStats.m_merge_sources_active = m_SourceMerger.GetActiveSourceCount();
+  m_NodeStats.m_merge_exclusive_ip   = m_SourceMerger.GetExclusiveSource();
+  m_NodeStats.m_merge_us_last        = m_SourceMerger.GetMergeTimeUsLast();
+  m_NodeStats.m_merge_us_max         = m_SourceMerger.GetMergeTimeUsMax();
+
+  const uint8_t* ptr_artnet_data = m_SourceMerger.GetMerged();
+  number_of_channels = m_SourceMerger.GetMergedLength();
+  this->UpdateDMXFrameSlots( m_ConfigServer.m_channel_mods_copy_artnet_to_dmx ? number_of_channels : 0 );
+
   // Note: m_dmx_buffer[ 0 ] must be 0x00 which is DMX null start code.  Actual dmx channel data will start at m_dmx_buffer[ 1 ]
-  //       ptr_packet_artnet->m_Data[ 0 ] relates to first channel data, so the array needs to be adjusted.
+  //       ptr_artnet_data[ 0 ] relates to first channel data, so the array needs to be adjusted.
   if( m_ConfigServer.m_channel_mods_copy_artnet_to_dmx ) {
-    memcpy( &m_dmx_buffer[ 1 ], ptr_packet_artnet->m_Data, number_of_channels * sizeof( uint8_t ) );
+    memcpy( &m_dmx_buffer[ 1 ], ptr_artnet_data, number_of_channels * sizeof( uint8_t ) );
   } else {
     memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
   }
 
-  // Process any channel mods
-  for( const ChannelMod& mod : m_ConfigServer.GetModsVector() ) {
-    if( mod.m_channel < 513 ) {
-      switch( mod.m_mod_type ) {
-        case CHANNELMODTYPE::EQUALS_VALUE: {
-          m_dmx_buffer[ mod.m_channel ] = mod.m_mod_value;
-          break;
-        }
-        case CHANNELMODTYPE::ADD_VALUE: {
-          if( m_dmx_buffer[ mod.m_channel ] > 255 - mod.m_mod_value ) {
-            m_dmx_buffer[ mod.m_channel ] = 255;
-          } else {
-            m_dmx_buffer[ mod.m_channel ] += (uint8_t) mod.m_mod_value;
-          }
-          break;
-        }
-        case CHANNELMODTYPE::MINUS_VALUE: {
-          if( m_dmx_buffer[ mod.m_channel ] < mod.m_mod_value ) {
-            m_dmx_buffer[ mod.m_channel ] = 0;
-          } else {
-            m_dmx_buffer[ mod.m_channel ] -= (uint8_t) mod.m_mod_value;
-          }
-          break;
-        }
-        case CHANNELMODTYPE::COPY_FROM_CHANNEL: {
-          m_dmx_buffer[ mod.m_channel ] = m_dmx_buffer[ mod.m_mod_value ];
-          break;
-        }
-        case CHANNELMODTYPE::ADD_FROM_CHANNEL: {
-          if( m_dmx_buffer[ mod.m_channel ] > 255 - m_dmx_buffer[ mod.m_mod_value ] ) {
-            m_dmx_buffer[ mod.m_channel ] = 255;
-          } else {
-            m_dmx_buffer[ mod.m_channel ] += m_dmx_buffer[ mod.m_mod_value ];
-          }
-          break;
-        }
-        case CHANNELMODTYPE::MINUS_FROM_CHANNEL: {
-          if( m_dmx_buffer[ mod.m_channel ] < m_dmx_buffer[ mod.m_mod_value ] ) {
-            m_dmx_buffer[ mod.m_channel ] = 0;
-          } else {
-            m_dmx_buffer[ mod.m_channel ] -= m_dmx_buffer[ mod.m_mod_value ];
-          }
-          break;
-        }
-        case CHANNELMODTYPE::ABOVE_0_ADD_VALUE: {
-          if( m_dmx_buffer[ mod.m_channel ] > 0 ) {
-            if( m_dmx_buffer[ mod.m_channel ] > 255 - mod.m_mod_value ) {
-              m_dmx_buffer[ mod.m_channel ] = 255;
-            } else {
-              m_dmx_buffer[ mod.m_channel ] += (uint8_t) mod.m_mod_value;
-            }
-          }
-          break;
-        }
-        case CHANNELMODTYPE::ABOVE_0_MINUS_VALUE: {
-          if( m_dmx_buffer[ mod.m_channel ] > 0 ) {
-            if( m_dmx_buffer[ mod.m_channel ] < mod.m_mod_value ) {
-              m_dmx_buffer[ mod.m_channel ] = 0;
-            } else {
-              m_dmx_buffer[ mod.m_channel ] -= (uint8_t) mod.m_mod_value;
-            }
-          }
-          break;
-        }
-        case CHANNELMODTYPE::COPY_FROM_ARTNET: {
-          m_dmx_buffer[ mod.m_channel ] = ptr_packet_artnet->m_Data[ mod.m_mod_value - 1 ];
-          break;
-        }
-        case CHANNELMODTYPE::ADD_FROM_ARTNET: {
-          if( m_dmx_buffer[ mod.m_channel ] > 255 - ptr_packet_artnet->m_Data[ mod.m_mod_value - 1 ] ) {
-            m_dmx_buffer[ mod.m_channel ] = 255;
-          } else {
-            m_dmx_buffer[ mod.m_channel ] += ptr_packet_artnet->m_Data[ mod.m_mod_value - 1 ];
-          }
-          break;
-        }
-        case CHANNELMODTYPE::MINUS_FROM_ARTNET: {
-          if( m_dmx_buffer[ mod.m_channel ] < ptr_packet_artnet->m_Data[ mod.m_mod_value - 1 ] ) {
-            m_dmx_buffer[ mod.m_channel ] = 0;
-          } else {
-            m_dmx_buffer[ mod.m_channel ] -= ptr_packet_artnet->m_Data[ mod.m_mod_value - 1 ];
-          }
-          break;
-        }
-        case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET: {
-          if( m_dmx_buffer[ mod.m_channel ] == 0 ) {
-            m_dmx_buffer[ mod.m_channel ] = ptr_packet_artnet->m_Data[ mod.m_mod_value - 1 ];
-          }
-          break;
-        }
-      }
-    }
+  // Pixel maps, before the mods so a mod can still change a mapped channel.
+  if( m_PixelMapper.IsActive() ) {
+    m_PixelMapper.Apply( ptr_artnet_data, &m_dmx_buffer[ 1 ] );
   }
 
-  // DMX data will be sent on m_dmx_update_time_next_ms
+  // Process any channel mods, optimized on Start().
+  m_TraceRing.Record( TRACE_MODS_BEGIN, TRACE_TASK_LOOP, m_dmx_mods.size() );
+  unsigned long mods_start_us = micros();
+  ChannelModsHandler::ApplyMods( m_dmx_mods, m_dmx_buffer, ptr_artnet_data );
+  m_NodeStats.m_mods_us_last = micros() - mods_start_us;
+  m_TraceRing.Record( TRACE_MODS_END, TRACE_TASK_LOOP, m_dmx_mods.size() );
+  if( m_NodeStats.m_mods_us_last > m_NodeStats.m_mods_us_max ) {
+    m_NodeStats.m_mods_us_max = m_NodeStats.m_mods_us_last;
+  }
+
+  // Patched, recorded, published to the frame timer & forwarded from Update().
+  m_network_frame_pending = true;
+  m_dmx_frame_pending     = true;
+  m_forward_frame_pending = true;
 }
 
 void ESP32Artnet2DMX::SendDMX()
 {
-  if( !m_ConfigServer.m_dmx_enabled ) {
+  if( !m_ConfigServer.m_dmx_enabled || m_dmx_input_mode ) {
     return;
   }
-  dmx_write( DMX_NUM_1, m_dmx_buffer, DMX_PACKET_SIZE );
-  dmx_send_num( DMX_NUM_1, DMX_PACKET_SIZE );
-  dmx_wait_sent( DMX_NUM_1, DMX_TIMEOUT_TICK );
-  m_dmx_update_time_next_ms += m_ConfigServer.m_dmx_update_interval_ms;
+  // Only used while ArtSync drives the output.  m_sync_output is set, so a timer callback that started before it
+  // only has to leave the driver & the frame counters, it never waits.  Then its frame may still be on the line.
+  while( m_dmx_output_busy ) {
+  }
+  bool sent = dmx_wait_sent( DMX_NUM_1, DMX_TIMEOUT_TICK );
+  m_TraceRing.Record( TRACE_DMX_WAIT_SENT, TRACE_TASK_LOOP, sent );
+  dmx_write( DMX_NUM_1, m_dmx_sync_buffer, m_dmx_sync_slots + 1 );
+
+  if( m_sync_received_us != 0 ) {
+    unsigned long latency_us = micros() - m_sync_received_us;
+    m_sync_received_us = 0;
+
+    m_NodeStats.m_sync_count++;
+    m_NodeStats.m_sync_latency_us_last   = latency_us;
+    m_NodeStats.m_sync_latency_us_total += latency_us;
+    if( latency_us > m_NodeStats.m_sync_latency_us_max ) {
+      m_NodeStats.m_sync_latency_us_max = latency_us;
+    }
+  }
+
+  dmx_send_num( DMX_NUM_1, m_dmx_sync_slots + 1 );
+  m_TraceRing.Record( TRACE_DMX_SEND_NUM, TRACE_TASK_LOOP, m_dmx_sync_slots );
+  this->CountDMXFrame( m_ptr_FrameTimer->NowUs(), m_dmx_sync_slots );
+  sent = dmx_wait_sent( DMX_NUM_1, DMX_TIMEOUT_TICK );
+  m_TraceRing.Record( TRACE_DMX_WAIT_SENT, TRACE_TASK_LOOP, sent );
+
+  // ArtSync drives the output, only refresh if it's slow.
+  m_dmx_update_time_next_ms = millis() + ARTNET_SYNC_REFRESH_MS;
+}
+
+void ESP32Artnet2DMX::PublishDMXFrame() {
+  m_dmx_frame_pending = false;
+
+  portENTER_CRITICAL( &m_dmx_output_mux );
+  memcpy( m_dmx_output_buffer, m_dmx_buffer, m_dmx_frame_slots + 1 );
+  m_dmx_output_slots = m_dmx_frame_slots;
+  portEXIT_CRITICAL( &m_dmx_output_mux );
+
+  m_TraceRing.Record( TRACE_FRAME_HANDOFF, TRACE_TASK_LOOP, m_dmx_frame_slots );
+}
+
+void ESP32Artnet2DMX::UpdateDMXFrameSlots( int number_of_channels ) {
+  int slots = m_ConfigServer.m_dmx_frame_slots_min;
+  if( m_dmx_mods_slot_max > slots ) {
+    slots = m_dmx_mods_slot_max;
+  }
+  if( number_of_channels > slots ) {
+    slots = number_of_channels;
+  }
+  m_dmx_frame_slots = constrain( slots, DMX_FRAME_SLOTS_MIN, DMX_FRAME_SLOTS_MAX );
+}
+
+void ESP32Artnet2DMX::CountDMXFrame( uint64_t now_us, int slots ) {
+  m_NodeStats.m_dmx_frames++;
+  m_NodeStats.m_dmx_frame_slots = slots;
+
+  if( m_dmx_rate_window_start_us == 0 ) {
+    m_dmx_rate_window_start_us = now_us;
+    m_dmx_rate_window_frames   = 0;
+  }
+  m_dmx_rate_window_frames++;
+
+  uint64_t window_us = now_us - m_dmx_rate_window_start_us;
+  if( window_us >= DMX_REFRESH_WINDOW_US ) {
+    m_NodeStats.m_dmx_refresh_hz = m_dmx_rate_window_frames * 1000000.0f / window_us;
+    m_dmx_rate_window_start_us   = now_us;
+    m_dmx_rate_window_frames     = 0;
+  }
+}
+
+void ESP32Artnet2DMX::FrameTimerCallback( void* ptr_argument ) {
+  AllocTracker::EnterHotPath();
+  ( (ESP32Artnet2DMX*)ptr_argument )->OnFrameTimer();
+  AllocTracker::LeaveHotPath();
+}
+
+void ESP32Artnet2DMX::OnFrameTimer() {
+  // Busy before reading m_sync_output, SendDMX() sets it before reading busy, so only one of them sends.
+  m_dmx_output_busy = true;
+  if( !m_dmx_output_enabled || m_sync_output ) {
+    // Restart the interval when the timer takes over again.
+    m_dmx_frame_last_us = 0;
+    m_dmx_output_busy   = false;
+    return;
+  }
+
+  uint64_t now_us = m_ptr_FrameTimer->NowUs();
+  if( m_dmx_frame_last_us != 0 ) {
+    m_NodeStats.m_dmx_jitter.Record( (uint32_t)( now_us - m_dmx_frame_last_us ), m_dmx_frame_period_us );
+  }
+  m_dmx_frame_last_us = now_us;
+
+  // Never wait in the timer task, a frame still on the line means this one is skipped.
+  bool sent = dmx_wait_sent( DMX_NUM_1, 0 );
+  m_TraceRing.Record( TRACE_DMX_WAIT_SENT, TRACE_TASK_FRAME_TIMER, sent );
+  if( !sent ) {
+    if( m_dmx_frame_late_counted ) {
+      m_NodeStats.m_dmx_frames_late++;
+    }
+    m_dmx_output_busy = false;
+    return;
+  }
+
+  portENTER_CRITICAL( &m_dmx_output_mux );
+  int slots = m_dmx_output_slots;
+  memcpy( m_dmx_send_buffer, m_dmx_output_buffer, slots + 1 );
+  portEXIT_CRITICAL( &m_dmx_output_mux );
+
+  // Only the slots in use are sent, a short frame refreshes much faster than 513 slots.
+  dmx_write( DMX_NUM_1, m_dmx_send_buffer, slots + 1 );
+  dmx_send_num( DMX_NUM_1, slots + 1 );
+  m_TraceRing.Record( TRACE_DMX_SEND_NUM, TRACE_TASK_FRAME_TIMER, slots );
+  this->CountDMXFrame( now_us, slots );
+
+  m_dmx_output_busy = false;
+}
+
+void ESP32Artnet2DMX::DMXInputTask( void* ptr_parameters ) {
+  ( (ESP32Artnet2DMX*)ptr_parameters )->DMXInputLoop();
+}
+
+void ESP32Artnet2DMX::DMXInputLoop() {
+  for( ;; ) {
+    // Same handshake with Stop() as the receive task.
+    m_dmx_input_busy = true;
+    if( !m_dmx_input_enabled ) {
+      m_dmx_input_busy = false;
+      vTaskDelay( pdMS_TO_TICKS( NETWORK_RECEIVE_WAIT_MS ) );
+      continue;
+    }
+
+    this->ReceiveDMXInput();
+    m_dmx_input_busy = false;
+  }
+}
+
+void ESP32Artnet2DMX::BuildDMXInputPackets() {
+  uint16_t universe = m_ConfigServer.m_artnet_universe;
+
+  for( int i = 0; i < 2; i++ ) {
+    memset( m_dmx_input_packets[ i ], 0, ARTNET_PACKET_MAXSIZE );
+
+    ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)&m_dmx_input_packets[ i ][ 0 ];
+    memcpy( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) );
+    ptr_header->m_OpCode = ARTNET_OPCODE_DMX;
+
+    ArtNetPacketDMX* ptr_packet_dmx = (ArtNetPacketDMX*)&m_dmx_input_packets[ i ][ ARTNET_PACKET_PAYLOAD_START ];
+    ptr_packet_dmx->m_ProtocolLo = ARTNET_VERSION;
+    ptr_packet_dmx->m_SubUni     = universe & 0xFF;
+    ptr_packet_dmx->m_Net        = ( universe >> 8 ) & 0x7F;
+  }
+
+  // Empty or unparsable target = broadcast on the local subnet, worked out by BuildArtPollReply().
+  IPAddress target_ipaddress;
+  if( m_ConfigServer.m_dmx_input_target_ip.length() > 0 && target_ipaddress.fromString( m_ConfigServer.m_dmx_input_target_ip ) ) {
+    m_dmx_input_target_ip = (uint32_t)target_ipaddress;
+  } else {
+    m_dmx_input_target_ip = (uint32_t)m_poll_reply_broadcast_ipaddress;
+  }
+
+  m_dmx_input_packet_sent = 0;
+  m_dmx_input_length_sent = 0;
+  m_dmx_input_sent_ms     = 0;
+  m_dmx_input_sequence    = 0;
+}
+
+void ESP32Artnet2DMX::ReceiveDMXInput() {
+  dmx_packet_t packet;
+  if( dmx_receive( DMX_NUM_1, &packet, pdMS_TO_TICKS( DMX_INPUT_WAIT_MS ) ) == 0 ) {
+    m_NodeStats.m_dmx_input_signal = false;
+    return;
+  }
+  unsigned long received_us = micros();
+  m_NodeStats.m_dmx_input_signal = true;
+
+  if( packet.err != DMX_OK ) {
+    m_NodeStats.m_dmx_input_errors++;
+    return;
+  }
+  if( packet.sc != 0x00 || packet.is_rdm ) {
+    // Alternate start codes & RDM aren't DMX levels.
+    m_NodeStats.m_dmx_input_other_start_code++;
+    return;
+  }
+  m_NodeStats.m_dmx_input_frames++;
+
+  // Read into the packet not sent last, so the last one sent is what it's compared with.
+  int      packet_index   = 1 - m_dmx_input_packet_sent;
+  uint8_t* ptr_packet     = m_dmx_input_packets[ packet_index ];
+  uint8_t* ptr_data       = &ptr_packet[ ARTNET_PACKET_DMX_DATA_START ];
+  uint16_t slots          = ( packet.size > 1 ) ? packet.size - 1 : 0;
+  if( slots > 512 ) {
+    slots = 512;
+  }
+
+  // ArtDmx length must be even, 2 to 512.
+  uint16_t length = ( slots + 1 ) & ~1;
+  if( length < 2 ) {
+    length = 2;
+  }
+  dmx_read_offset( DMX_NUM_1, 1, ptr_data, slots );
+  memset( &ptr_data[ slots ], 0, length - slots );
+
+  bool changed = ( length != m_dmx_input_length_sent ) || ( memcmp( ptr_data, &m_dmx_input_packets[ m_dmx_input_packet_sent ][ ARTNET_PACKET_DMX_DATA_START ], length ) != 0 );
+  if( !changed && millis() - m_dmx_input_sent_ms < m_ConfigServer.m_dmx_input_keepalive_ms ) {
+    m_NodeStats.m_dmx_input_suppressed++;
+    return;
+  }
+
+  ArtNetPacketDMX* ptr_packet_dmx = (ArtNetPacketDMX*)&ptr_packet[ ARTNET_PACKET_PAYLOAD_START ];
+  m_dmx_input_sequence = ( m_dmx_input_sequence == 255 ) ? 1 : m_dmx_input_sequence + 1;
+  ptr_packet_dmx->m_Sequence = m_dmx_input_sequence;
+  ptr_packet_dmx->m_Physical = 0;
+  ptr_packet_dmx->m_LengthHi = length >> 8;
+  ptr_packet_dmx->m_Length   = length & 0xFF;
+
+  if( !m_DMXInputSocket.SendTo( m_dmx_input_target_ip, ARTNET_UDP_PORT, ptr_packet, ARTNET_PACKET_DMX_DATA_START + length ) ) {
+    m_NodeStats.m_dmx_input_send_failed++;
+    return;
+  }
+
+  m_dmx_input_packet_sent = packet_index;
+  m_dmx_input_length_sent = length;
+  m_dmx_input_sent_ms     = millis();
+
+  unsigned long latency_us = micros() - received_us;
+  m_NodeStats.m_dmx_input_sent++;
+  m_NodeStats.m_dmx_input_slots              = slots;
+  m_NodeStats.m_dmx_input_latency_us_last    = latency_us;
+  m_NodeStats.m_dmx_input_latency_us_total  += latency_us;
+  if( latency_us > m_NodeStats.m_dmx_input_latency_us_max ) {
+    m_NodeStats.m_dmx_input_latency_us_max = latency_us;
+  }
 }
@@ -11,6 +11,43 @@
 //
 #include "ConfigServer.h"
 #include "ArtNet_Spec.h"
+#include "ShowRecorder.h"
+#include "ShowPlayer.h"
+#include "SequenceTracker.h"
+#include "SourceMerger.h"
+#include "E131_Spec.h"
+#include "E131Sources.h"
+#include "UdpSocket.h"
+#include "PacketRing.h"
+#include "EspFrameTimer.h"
+#include "FrameJitter.h"
+#include "ArtNetForwarder.h"
+#include "PatchMatrix.h"
+#include "PixelMapper.h"
+#include "ChannelModsOptimizer.h"
+#include "TraceRing.h"
+#include "Logger.h"
+#include "AllocTracker.h"
+#include "ChannelMonitor.h"
+#include "ArtNetRemote.h"
+#include "CueEngine.h"
+
+#define ARTNET2DMX_FIRMWARE_VERSION         0x0001
+#define ARTNET_POLLREPLY_MIN_INTERVAL_MS    500   // Polls from the same controller within this time are ignored.
+#define ARTNET_SYNC_REFRESH_MS              1000  // Resend the synced frame if ArtSync is slower than this.
+#define ARTNET_SOURCES_ALLOWED_MAX          8     // Source IPs in the allow list.
+#define NETWORK_RECEIVE_BATCH               4     // Datagrams taken from a socket at a time.
+#define NETWORK_RECEIVE_WAIT_MS             20    // Receive task wakes up at least this often to check for Stop().
+#define NETWORK_RECEIVE_TASK_PRIORITY       10    // Above loop() (1), below the WiFi & lwIP tasks.
+#define NETWORK_RECEIVE_TASK_STACK          4096
+#define PACKET_PROTOCOL_ARTNET              0     // PacketRing tags.
+#define PACKET_PROTOCOL_E131                1
+#define DMX_FRAME_PERIOD_MIN_US             500   // Timer period for an update interval of 0, frames that are still sending are skipped.
+#define DMX_REFRESH_WINDOW_US               1000000 // Refresh rate is measured over this time.
+#define DMX_INPUT_WAIT_MS                   100   // Input task gives up waiting for a DMX frame after this, to check for Stop().
+#define DMX_INPUT_TASK_PRIORITY             9     // Below network receive.
+#define DMX_INPUT_TASK_STACK                4096
+#define ARTNET_LOCATE_BLINK_MS              250   // Built in LED on & off time while locate (identify) is on.
 
 class ESP32Artnet2DMX {
 public:
@@ -28,12 +65,102 @@ public:
 
   void Stop();
 
+  // Replaces the esp_timer, e.g. with a mock clock.  Must be set before Start().
+  void SetFrameTimer( FrameTimer* ptr_frame_timer );
+
+  // Counters the webserver shows on /stats.
+  const NodeStats& GetNodeStats() const;
+
 private:  
   void SendDMX();
 
-  void CheckForArtNetData();
+  static void FrameTimerCallback( void* ptr_argument );
+
+  // Runs in the esp_timer task, sends the last published frame.
+  void OnFrameTimer();
+
+  // Hands the frame to the timer.
+  void PublishDMXFrame();
+
+  // Highest slot written by the mods, the Art-Net length or the configured minimum.  A 24 slot frame is about
+  // 1.3ms on the wire instead of 22.7ms for 512, so small rigs refresh at several hundred Hz.
+  void UpdateDMXFrameSlots( int number_of_channels );
+
+  void CountDMXFrame( uint64_t now_us, int slots );
+
+  static void DMXInputTask( void* ptr_parameters );
+
+  void DMXInputLoop();
+
+  // Waits for one DMX frame & sends it as ArtDmx, unless unchanged & the keepalive isn't due.
+  void ReceiveDMXInput();
+
+  void BuildDMXInputPackets();
+
+  static void ReceiveTask( void* ptr_parameters );
+
+  void ReceiveLoop();
+
+  void ReceiveIntoRing( UdpSocket& socket, int protocol );
+
+  // Receives up to count wanted datagrams into ptr_datagrams, in batches that start at a peeked header.  Returns the
+  // number received.
+  int  ReceiveArtNet( UdpSocket& socket, UdpDatagram* ptr_datagrams, int count );
+
+  bool IsArtNetDMX( const UdpDatagram& datagram );
+
+  // Receive task.  ArtDmx from another source or for a universe that isn't used is rejected, anything else is left to loop().
+  bool IsArtNetHeaderWanted( const uint8_t* ptr_header, int header_size_in_bytes, uint32_t source_ip );
+
+  // Adds the receive task counters to m_NodeStats.
+  void CollectReceiveStats();
+
+  void CheckForNetworkData();
+
+  void HandleArtNetPacket( const UdpDatagram& datagram );
+
+  // data_size_in_bytes = bytes received after the ArtDmx header, m_Length may claim more.
+  void HandleArtNetDMX( ArtNetPacketDMX* ptr_packetdmx, int data_size_in_bytes, const IPAddress& source_ipaddress );
+
+  // Art-Net & sACN frames for the patched universe end up here.
+  void HandleDMXFrame( const uint8_t* ptr_data, uint16_t number_of_channels, uint32_t source_ip );
+
+  void HandleE131Packet( const UdpDatagram& datagram );
+
+  bool IsE131HeaderValid( const E131PacketHeader& header );
 
-  void HandleArtNetDMX( ArtNetPacketDMX* ptr_packetdmx );
+  void ParseArtNetSourceIPs();
+
+  bool IsArtNetSourceAllowed( const IPAddress& source_ipaddress );
+
+  void ParseArtNetForwardTargets();
+
+  void ParsePatchMatrix();
+
+  // Once a frame from the network is complete: applies the patch to m_dmx_buffer if any of its inputs changed, &
+  // records the output frame.
+  void CompleteNetworkFrame();
+
+  void HandleArtNetPoll( ArtNetPacketPoll* ptr_packet_poll, int packet_size_in_bytes, const IPAddress& source_ipaddress );
+
+  void HandleArtNetSync( unsigned long received_us );
+
+  // Applies what ArtAddress, ArtCommand & ArtIpProg asked for, from loop() between frames.
+  void ApplyArtNetRemote();
+
+  void SendArtIpProgReply( uint32_t target_ip );
+
+  // Blinks the built in LED while locate is on.
+  void UpdateIndicator();
+
+  void BuildArtPollReply();
+
+  void SendArtPollReply();
+
+  void HandleArtNetTimeout();
+
+  // Snapshot of the port's input & output for the live monitor, from loop().
+  void CaptureMonitor();
 
   bool          m_is_started;
   
@@ -41,17 +168,114 @@ private:
 
   unsigned long m_dmx_update_time_next_ms;
 
-  uint8_t       m_data_buffer[ ARTNET_PACKET_MAXSIZE ];
+  // Datagrams from the receive task.  Everything else in the engine is only used by loop().
+  PacketRing          m_PacketRing;
+  TaskHandle_t        m_receive_task_handle;
+  std::atomic< bool > m_receive_enabled;
+  std::atomic< bool > m_receive_busy;
+  std::atomic< uint16_t > m_receive_universe;   // m_artnet_universe, which ArtAddress changes while receiving.
+
+  // Counted by the receive task since loop() last took them.
+  std::atomic< unsigned long > m_receive_rejected_source;
+  std::atomic< unsigned long > m_receive_rejected_universe;
+  std::atomic< unsigned long > m_receive_bytes_not_copied;
+  std::atomic< unsigned long > m_receive_accepted_us;      // Peek & receive of accepted ArtDmx.
+  std::atomic< unsigned long > m_receive_accepted_count;
+  std::atomic< unsigned long > m_receive_rejected_us;      // Peek & discard of rejected ArtDmx.
+  std::atomic< unsigned long > m_receive_rejected_count;
+
+  // DMX input mode.  The input task reads each frame straight into the data of one of two prebuilt ArtDmx packets,
+  // & only sends it if it differs from the other (last sent) one.
+  TaskHandle_t        m_dmx_input_task_handle;
+  std::atomic< bool > m_dmx_input_enabled;
+  std::atomic< bool > m_dmx_input_busy;
+  bool                m_dmx_input_mode;
+  UdpSocket           m_DMXInputSocket;
+  uint32_t            m_dmx_input_target_ip;
+  uint8_t             m_dmx_input_packets[ 2 ][ ARTNET_PACKET_MAXSIZE ];
+  int                 m_dmx_input_packet_sent;
+  uint16_t            m_dmx_input_length_sent;
+  unsigned long       m_dmx_input_sent_ms;
+  uint8_t             m_dmx_input_sequence;
 
   uint8_t       m_dmx_buffer[ 513 ];
 
-  WiFiUDP       m_WiFiUDP;
+  // Frame output, timed by m_ptr_FrameTimer instead of loop().  loop() publishes m_dmx_buffer into
+  // m_dmx_output_buffer under m_dmx_output_mux & the timer callback sends it.
+  EspFrameTimer       m_EspFrameTimer;
+  FrameTimer*         m_ptr_FrameTimer;
+  portMUX_TYPE        m_dmx_output_mux;
+  uint8_t             m_dmx_output_buffer[ 513 ];
+  uint8_t             m_dmx_send_buffer[ 513 ];
+  int                 m_dmx_mods_slot_max;  // Highest channel any mod or the patch writes, set on Start().
+  int                 m_dmx_frame_slots;    // Slots in m_dmx_buffer that are sent, not counting the start code.
+  int                 m_dmx_output_slots;
+  int                 m_dmx_sync_slots;
+  bool                m_dmx_frame_late_counted; // Not when the interval is 0 & frames are sent back to back.
+  uint64_t            m_dmx_rate_window_start_us;
+  unsigned long       m_dmx_rate_window_frames;
+  bool                m_dmx_frame_pending;
+  std::atomic< bool > m_dmx_output_enabled;
+  std::atomic< bool > m_dmx_output_busy;
+  std::atomic< bool > m_sync_output;        // ArtSync drives the output from loop(), which then owns the driver & CountDMXFrame().
+  uint32_t            m_dmx_frame_period_us;
+  uint64_t            m_dmx_frame_last_us;
+
+  // ArtSync.  While active m_dmx_buffer is a staging buffer & the output is the frame latched on the last ArtSync.
+  uint8_t       m_dmx_sync_buffer[ 513 ];
+  bool          m_sync_active;
+  unsigned long m_sync_last_ms;
+  unsigned long m_sync_received_us;
+  IPAddress     m_artnet_dmx_source_ipaddress;
+
+  // ArtPollReply is built on start & only the reply counter changes per poll.
+  uint8_t       m_poll_reply_buffer[ ARTNET_PACKET_PAYLOAD_START + sizeof( ArtNetPacketPollReply ) ];
+  IPAddress     m_poll_reply_ipaddress;
+  IPAddress     m_poll_reply_broadcast_ipaddress;
+  IPAddress     m_poll_reply_last_ipaddress;
+  unsigned long m_poll_reply_last_ms;
+  unsigned long m_poll_reply_count;
+  bool          m_poll_reply_pending;
+
+  // Art-Net remote config
+  ArtNetRemote  m_ArtNetRemote;
+  int           m_indicator;            // ARTNETINDICATOR
+  bool          m_indicator_led_on;
+
+  UdpSocket     m_ArtNetSocket;
+  UdpSocket     m_E131Socket;
+  E131Sources   m_E131Sources;
 
   // Config
   ConfigServer  m_ConfigServer;
 
-  IPAddress     m_artnet_source_ipaddress;
-  IPAddress     m_artnet_source_ipaddress_any;
+  // Show recording & playback of the processed DMX output.
+  ShowRecorder  m_ShowRecorder;
+  ShowPlayer    m_ShowPlayer;
+  bool          m_show_playing_on_timeout;
+
+  // Cue list run from ArtTimeCode, loaded on Start().
+  CueEngine     m_CueEngine;
+
+  NodeStats       m_NodeStats;
+  SequenceTracker m_SequenceTracker;
+  SourceMerger    m_SourceMerger;
+  ArtNetForwarder m_ArtNetForwarder;
+  PatchMatrix     m_PatchMatrix;
+  PixelMapper     m_PixelMapper;
+  TraceRing       m_TraceRing;
+  Logger          m_Logger;
+  ChannelMonitor  m_ChannelMonitor;
+
+  // The channel mods that run, optimized from the config on Start().
+  ChannelModsOptimizer      m_ChannelModsOptimizer;
+  std::vector< ChannelMod > m_dmx_mods;
+  bool            m_network_frame_pending;
+  bool            m_forward_frame_pending;
+
+  IPAddress     m_artnet_source_ipaddresses[ ARTNET_SOURCES_ALLOWED_MAX ];
+  int           m_artnet_source_ipaddress_count;
+  bool          m_artnet_source_any;
 };
 
 #endif
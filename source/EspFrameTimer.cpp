@@ -0,0 +1,46 @@
+#include "EspFrameTimer.h"
+
+EspFrameTimer::EspFrameTimer() {
+  m_timer_handle = nullptr;
+}
+
+EspFrameTimer::~EspFrameTimer() {
+  this->Stop();
+}
+
+bool EspFrameTimer::Start( uint32_t period_us, Callback callback, void* ptr_argument ) {
+  this->Stop();
+
+  esp_timer_create_args_t timer_args = {};
+  timer_args.callback              = callback;
+  timer_args.arg                   = ptr_argument;
+  timer_args.dispatch_method       = ESP_TIMER_TASK;
+  timer_args.name                  = "dmx_frame";
+  timer_args.skip_unhandled_events = true;    // A late frame is not followed by a burst of catch up frames.
+
+  if( esp_timer_create( &timer_args, &m_timer_handle ) != ESP_OK ) {
+    m_timer_handle = nullptr;
+    return false;
+  }
+
+  if( esp_timer_start_periodic( m_timer_handle, period_us ) != ESP_OK ) {
+    esp_timer_delete( m_timer_handle );
+    m_timer_handle = nullptr;
+    return false;
+  }
+
+  return true;
+}
+
+void EspFrameTimer::Stop() {
+  if( m_timer_handle == nullptr ) {
+    return;
+  }
+  esp_timer_stop( m_timer_handle );
+  esp_timer_delete( m_timer_handle );
+  m_timer_handle = nullptr;
+}
+
+uint64_t EspFrameTimer::NowUs() {
+  return esp_timer_get_time();
+}
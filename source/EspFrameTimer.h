@@ -0,0 +1,24 @@
+#ifndef _ESPFRAMETIMER_H_
+#define _ESPFRAMETIMER_H_
+
+#include <esp_timer.h>
+#include "FrameTimer.h"
+
+// esp_timer (64-bit hardware timer, microsecond resolution).  Callbacks run in the esp_timer task, not in loop().
+class EspFrameTimer : public FrameTimer {
+public:
+  EspFrameTimer();
+
+  ~EspFrameTimer();
+
+  bool     Start( uint32_t period_us, Callback callback, void* ptr_argument ) override;
+
+  void     Stop() override;
+
+  uint64_t NowUs() override;
+
+private:
+  esp_timer_handle_t m_timer_handle;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include "FrameJitter.h"
+
+FrameJitter::FrameJitter() {
+  this->Clear();
+}
+
+void FrameJitter::Clear() {
+  memset( m_bins, 0, sizeof( m_bins ) );
+  m_count  = 0;
+  m_max_us = 0;
+}
+
+void FrameJitter::Record( uint32_t interval_us, uint32_t period_us ) {
+  uint32_t jitter_us = ( interval_us > period_us ) ? interval_us - period_us : period_us - interval_us;
+
+  uint32_t bin = jitter_us / FRAME_JITTER_BIN_US;
+  if( bin >= FRAME_JITTER_BINS ) {
+    bin = FRAME_JITTER_BINS - 1;
+  }
+  m_bins[ bin ]++;
+  m_count++;
+
+  if( jitter_us > m_max_us ) {
+    m_max_us = jitter_us;
+  }
+}
+
+uint32_t FrameJitter::GetPercentileUs( int per_mille ) const {
+  if( m_count == 0 ) {
+    return 0;
+  }
+
+  unsigned long target = ( (unsigned long long)m_count * per_mille + 999 ) / 1000;
+  unsigned long seen   = 0;
+  for( int i = 0; i < FRAME_JITTER_BINS; i++ ) {
+    seen += m_bins[ i ];
+    if( seen >= target ) {
+      uint32_t bin_edge_us = ( i + 1 ) * FRAME_JITTER_BIN_US;
+      return ( bin_edge_us < m_max_us ) ? bin_edge_us : m_max_us;
+    }
+  }
+  return m_max_us;
+}
+
+uint32_t FrameJitter::GetMaxUs() const {
+  return m_max_us;
+}
+
+unsigned long FrameJitter::GetCount() const {
+  return m_count;
+}
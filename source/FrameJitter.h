@@ -0,0 +1,32 @@
+#ifndef _FRAMEJITTER_H_
+#define _FRAMEJITTER_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define FRAME_JITTER_BIN_US  20
+#define FRAME_JITTER_BINS    250    // Up to 5 ms, anything later counts in the last bin.
+
+// Histogram of how far each frame started from its scheduled interval, for percentiles without storing every frame.
+class FrameJitter {
+public:
+  FrameJitter();
+
+  void          Clear();
+
+  void          Record( uint32_t interval_us, uint32_t period_us );
+
+  // per_mille = 500 for the median, 990 for the 99th percentile.  Upper edge of the bin (at most the max), in us.
+  uint32_t      GetPercentileUs( int per_mille ) const;
+
+  uint32_t      GetMaxUs() const;
+
+  unsigned long GetCount() const;
+
+private:
+  uint32_t      m_bins[ FRAME_JITTER_BINS ];
+  unsigned long m_count;
+  uint32_t      m_max_us;
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef _FRAMETIMER_H_
+#define _FRAMETIMER_H_
+
+#include <stdint.h>
+
+// Periodic clock that starts each DMX frame.  The engine only uses this interface, so the scheduling can be
+// driven by a mock clock instead of the hardware timer.  EspFrameTimer.h has the hardware timer.
+class FrameTimer {
+public:
+  typedef void ( *Callback )( void* ptr_argument );
+
+  virtual ~FrameTimer() {}
+
+  virtual bool     Start( uint32_t period_us, Callback callback, void* ptr_argument ) = 0;
+
+  virtual void     Stop() = 0;
+
+  virtual uint64_t NowUs() = 0;
+};
+
+#endif
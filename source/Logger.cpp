@@ -0,0 +1,130 @@
+#include <stdarg.h>
+#include "Logger.h"
+
+Logger::Logger() {
+  m_mux               = portMUX_INITIALIZER_UNLOCKED;
+  m_write_index       = 0;
+  m_drain_index       = 0;
+  m_level             = LOG_LEVEL_DEFAULT;
+  m_suppressed        = 0;
+  m_dropped           = 0;
+  m_drain_task_handle = nullptr;
+}
+
+Logger::~Logger() {
+}
+
+void Logger::Begin() {
+  if( m_drain_task_handle == nullptr ) {
+    xTaskCreate( Logger::DrainTask, "log_drain", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, &m_drain_task_handle );
+  }
+}
+
+void Logger::Printf( LogSite& site, int level, const char* format, ... ) {
+  if( level > m_level ) {
+    return;
+  }
+
+  unsigned long now_ms = millis();
+  if( now_ms - site.m_window_start_ms >= LOG_SITE_WINDOW_MS ) {
+    site.m_window_start_ms = now_ms;
+    site.m_window_count    = 0;
+  }
+  if( site.m_window_count >= LOG_SITE_BURST ) {
+    site.m_suppressed++;
+    m_suppressed++;
+    return;
+  }
+  site.m_window_count++;
+
+  // Formatted outside the lock, which only covers the copy into the ring.
+  char    message[ LOG_MESSAGE_LENGTH ];
+  va_list arguments;
+  va_start( arguments, format );
+  int length = vsnprintf( message, sizeof( message ), format, arguments );
+  va_end( arguments );
+  if( length < 0 ) {
+    return;
+  }
+  if( site.m_suppressed > 0 && length < (int)sizeof( message ) ) {
+    snprintf( &message[ length ], sizeof( message ) - length, " (%lu suppressed)", site.m_suppressed );
+    site.m_suppressed = 0;
+  }
+
+  portENTER_CRITICAL( &m_mux );
+  LogEntry& entry = m_entries[ m_write_index & ( LOG_ENTRIES - 1 ) ];
+  entry.m_time_ms = now_ms;
+  entry.m_level   = level;
+  memcpy( entry.m_message, message, sizeof( entry.m_message ) );
+  m_write_index++;
+  portEXIT_CRITICAL( &m_mux );
+}
+
+void Logger::SetLevel( int level ) {
+  m_level = constrain( level, LOG_LEVEL_ERROR, LOG_LEVEL_DEBUG );
+}
+
+int Logger::GetLevel() const {
+  return m_level;
+}
+
+int Logger::GetEntryCount() {
+  portENTER_CRITICAL( &m_mux );
+  uint32_t write_index = m_write_index;
+  portEXIT_CRITICAL( &m_mux );
+  return write_index < LOG_ENTRIES ? write_index : LOG_ENTRIES;
+}
+
+void Logger::GetEntry( int index, LogEntry& entry ) {
+  portENTER_CRITICAL( &m_mux );
+  uint32_t oldest = m_write_index < LOG_ENTRIES ? 0 : m_write_index - LOG_ENTRIES;
+  entry = m_entries[ ( oldest + index ) & ( LOG_ENTRIES - 1 ) ];
+  portEXIT_CRITICAL( &m_mux );
+}
+
+unsigned long Logger::GetMessageCount() const {
+  return m_write_index;
+}
+
+unsigned long Logger::GetSuppressedCount() const {
+  return m_suppressed;
+}
+
+unsigned long Logger::GetDroppedCount() const {
+  return m_dropped;
+}
+
+void Logger::DrainTask( void* ptr_parameters ) {
+  ( (Logger*)ptr_parameters )->DrainLoop();
+}
+
+void Logger::DrainLoop() {
+  LogEntry entry;
+  for( ;; ) {
+    for( ;; ) {
+      portENTER_CRITICAL( &m_mux );
+      bool pending = ( m_drain_index != m_write_index );
+      if( pending ) {
+        if( m_write_index - m_drain_index > LOG_ENTRIES ) {
+          // Lapped by the writers, the oldest are gone.
+          m_dropped     += m_write_index - m_drain_index - LOG_ENTRIES;
+          m_drain_index  = m_write_index - LOG_ENTRIES;
+        }
+        entry = m_entries[ m_drain_index & ( LOG_ENTRIES - 1 ) ];
+        m_drain_index++;
+      }
+      portEXIT_CRITICAL( &m_mux );
+
+      if( !pending ) {
+        break;
+      }
+      // Only this task waits on the UART.  Formatted here, Serial.printf() allocates for lines over 64 bytes.
+      char line[ LOG_MESSAGE_LENGTH + 32 ];
+      int  length = snprintf( line, sizeof( line ), "%lu %s : %s\n", entry.m_time_ms, LogLevelAsString( entry.m_level ), entry.m_message );
+      if( length > 0 ) {
+        Serial.write( (const uint8_t*)line, length < (int)sizeof( line ) ? length : sizeof( line ) - 1 );
+      }
+    }
+    vTaskDelay( pdMS_TO_TICKS( LOG_DRAIN_INTERVAL_MS ) );
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef _LOGGER_H_
+#define _LOGGER_H_
+
+#include <Arduino.h>
+
+#define LOG_ENTRIES              64    // Must be a power of 2.  Also what the log page shows.
+#define LOG_MESSAGE_LENGTH       96    // Longer messages are cut.
+#define LOG_SITE_BURST           5     // Messages a call site may log per window, the rest are counted.
+#define LOG_SITE_WINDOW_MS       1000
+#define LOG_DRAIN_INTERVAL_MS    20
+#define LOG_TASK_PRIORITY        1     // Same as loop(), time sliced with it, below network receive & DMX input.
+#define LOG_TASK_STACK           3072
+#define LOG_LEVEL_DEFAULT        LOG_LEVEL_INFO
+
+enum LOGLEVEL : int {
+  LOG_LEVEL_ERROR   = 0,
+  LOG_LEVEL_WARNING = 1,
+  LOG_LEVEL_INFO    = 2,
+  LOG_LEVEL_DEBUG   = 3,
+};
+
+inline const char* LogLevelAsString( int level ) {
+  switch( level ) {
+    case LOG_LEVEL_ERROR:   return "error";
+    case LOG_LEVEL_WARNING: return "warning";
+    case LOG_LEVEL_INFO:    return "info";
+    case LOG_LEVEL_DEBUG:   return "debug";
+    default:                return "unknown";
+  }
+};
+
+// Rate limit state of one place in the code that logs, see LOG_PRINTF.
+struct LogSite {
+  unsigned long m_window_start_ms;
+  int           m_window_count;
+  unsigned long m_suppressed;
+};
+
+struct LogEntry {
+  unsigned long m_time_ms;
+  int           m_level;
+  char          m_message[ LOG_MESSAGE_LENGTH ];
+};
+
+// Logs through ptr_logger (may be nullptr), each use having its own rate limit.
+#define LOG_PRINTF( ptr_logger, level, ... ) do { static LogSite log_site = { 0, 0, 0 }; if( ( ptr_logger ) != nullptr ) { ( ptr_logger )->Printf( log_site, level, __VA_ARGS__ ); } } while( 0 )
+
+// Messages are formatted into a fixed ring & written to Serial by a low priority task, so logging never waits
+// on the UART.  A call site logging more than LOG_SITE_BURST messages a window is suppressed for the rest of it,
+// its next message says how many were left out.  The ring also holds the recent messages for the log page.
+class Logger {
+public:
+  Logger();
+
+  ~Logger();
+
+  // Starts the drain task.  Messages logged before are kept until it runs.
+  void Begin();
+
+  // Any task.
+  void Printf( LogSite& site, int level, const char* format, ... ) __attribute__( ( format( printf, 4, 5 ) ) );
+
+  void SetLevel( int level );
+  int  GetLevel() const;
+
+  // Messages held, oldest first.  Copies the entry, as it may be overwritten at any time.
+  int  GetEntryCount();
+  void GetEntry( int index, LogEntry& entry );
+
+  unsigned long GetMessageCount() const;
+  unsigned long GetSuppressedCount() const;
+  unsigned long GetDroppedCount() const;   // Overwritten before the drain task wrote them to Serial.
+
+private:
+  static void DrainTask( void* ptr_parameters );
+
+  void DrainLoop();
+
+  LogEntry      m_entries[ LOG_ENTRIES ];
+  portMUX_TYPE  m_mux;
+  uint32_t      m_write_index;   // Free running, slot = index % LOG_ENTRIES.
+  uint32_t      m_drain_index;
+  int           m_level;
+  unsigned long m_suppressed;
+  unsigned long m_dropped;
+  TaskHandle_t  m_drain_task_handle;
+};
+
+#endif
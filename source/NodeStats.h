@@ -0,0 +1,151 @@
+#ifndef _NODESTATS_H_
+#define _NODESTATS_H_
+
+#include "FrameJitter.h"
+
+// Runtime counters filled in by the Art-Net to DMX engine & shown by the webserver on /stats.
+struct NodeStats {
+  // DMX output, frames started by the frame timer.
+  uint32_t      m_dmx_frame_period_us;      // Set on Start(), not reset.
+  int           m_dmx_frame_slots;          // Slots in the last frame sent, not counting the start code.
+  float         m_dmx_refresh_hz;           // Frames sent per second, measured over DMX_REFRESH_WINDOW_US.
+  unsigned long m_dmx_frames;
+  unsigned long m_dmx_frames_late;          // Skipped because the previous frame was still being sent.
+  FrameJitter   m_dmx_jitter;               // Frame start to frame start, against m_dmx_frame_period_us.
+
+  // DMX input mode, DMX to ArtDmx.
+  bool          m_dmx_input_signal;         // A DMX frame arrived within DMX_INPUT_WAIT_MS.
+  unsigned long m_dmx_input_frames;
+  unsigned long m_dmx_input_sent;
+  unsigned long m_dmx_input_suppressed;     // Unchanged & the keepalive wasn't due.
+  unsigned long m_dmx_input_errors;         // Framing, overflow & other receive errors from the driver.
+  unsigned long m_dmx_input_other_start_code; // RDM & alternate start codes, not sent.
+  unsigned long m_dmx_input_send_failed;
+  int           m_dmx_input_slots;
+  unsigned long m_dmx_input_latency_us_last;  // Frame received to ArtDmx sent.
+  unsigned long m_dmx_input_latency_us_max;
+  unsigned long long m_dmx_input_latency_us_total;
+
+  // ArtSync
+  bool          m_sync_active;
+  unsigned long m_sync_count;
+  unsigned long m_sync_latency_us_last;   // ArtSync received to dmx_send_num.
+  unsigned long m_sync_latency_us_max;
+  unsigned long long m_sync_latency_us_total;
+
+  // Art-Net receive, ArtDmx dropped by the receive task on the header, without copying the data.
+  unsigned long m_artnet_rejected_source;
+  unsigned long m_artnet_rejected_universe;
+  unsigned long long m_artnet_bytes_not_copied;
+  unsigned long long m_artnet_accepted_us_total;  // Peek & receive of accepted ArtDmx.
+  unsigned long m_artnet_accepted_count;
+  unsigned long long m_artnet_rejected_us_total;  // Peek & discard of rejected ArtDmx.
+  unsigned long m_artnet_rejected_count;
+
+  // Art-Net socket
+  int           m_socket_receive_buffer_size;
+  unsigned long m_socket_received;
+  unsigned long m_socket_batches;
+  unsigned long m_socket_truncated;
+  unsigned long m_socket_discarded;         // Taken off with a 1 byte receive after the header was rejected.
+  bool          m_socket_drops_available;
+  unsigned long m_socket_drops;             // Dropped by the network stack, receive buffer full.
+
+  // Receive task to loop() ring
+  int           m_ring_occupancy;           // Datagrams waiting when loop() last took them.
+  int           m_ring_occupancy_max;
+  unsigned long m_ring_overruns;            // Wanted packets lost because the ring was full, the newest is lost, since Start().
+  unsigned long m_ring_dequeued;
+  unsigned long m_ring_latency_us_max;      // Received to handled.
+  unsigned long long m_ring_latency_us_total;
+
+  // sACN
+  unsigned long m_sacn_packets;
+  unsigned long m_sacn_discarded_universe;  // Not the patched universe, dropped on the header.
+  unsigned long m_sacn_discarded_priority;  // A higher priority source is active.
+  unsigned long m_sacn_invalid;
+  unsigned long m_sacn_terminated;
+  int           m_sacn_sources;
+  int           m_sacn_priority_active;
+
+  // Channel mods
+  bool          m_mods_optimized;           // The optimized mods gave the same output on the random frames checked on Start().
+  unsigned long m_mods_us_last;
+  unsigned long m_mods_us_max;
+
+  // Source merging
+  int           m_merge_sources_active;
+  uint32_t      m_merge_exclusive_ip;     // The only source after an ArtAddress cancel merge, 0 = merging.
+  unsigned long m_merge_us_last;
+  unsigned long m_merge_us_max;
+  unsigned long m_merge_benchmark_ns;     // HTP merge of 2 sources x 512 channels, measured once on startup & not reset.
+
+  // Art-Net remote config
+  int           m_artnet_indicator;       // ARTNETINDICATOR, set by ArtAddress & ArtCommand.
+
+  // Art-Net forwarding
+  unsigned long m_forward_benchmark_ns;   // Changed 512 channel frame prepared for 4 targets, measured once on startup & not reset.
+
+  // Trace ring
+  unsigned long m_trace_benchmark_ns;     // One trace event recorded, measured once on startup & not reset.
+
+  // Heap
+  uint32_t      m_heap_free_start;        // Free heap at the end of Start(), not reset.
+
+  void Reset() {
+    m_dmx_frames               = 0;
+    m_dmx_frames_late          = 0;
+    m_dmx_refresh_hz           = 0;
+    m_dmx_jitter.Clear();
+    m_dmx_input_signal         = false;
+    m_dmx_input_frames         = 0;
+    m_dmx_input_sent           = 0;
+    m_dmx_input_suppressed     = 0;
+    m_dmx_input_errors         = 0;
+    m_dmx_input_other_start_code = 0;
+    m_dmx_input_send_failed    = 0;
+    m_dmx_input_slots          = 0;
+    m_dmx_input_latency_us_last = 0;
+    m_dmx_input_latency_us_max = 0;
+    m_dmx_input_latency_us_total = 0;
+    m_sync_active              = false;
+    m_sync_count               = 0;
+    m_sync_latency_us_last     = 0;
+    m_sync_latency_us_max      = 0;
+    m_sync_latency_us_total    = 0;
+    m_artnet_rejected_source   = 0;
+    m_artnet_rejected_universe = 0;
+    m_artnet_bytes_not_copied  = 0;
+    m_artnet_accepted_us_total = 0;
+    m_artnet_accepted_count    = 0;
+    m_artnet_rejected_us_total = 0;
+    m_artnet_rejected_count    = 0;
+    m_socket_received          = 0;
+    m_socket_batches           = 0;
+    m_socket_truncated         = 0;
+    m_socket_discarded         = 0;
+    m_socket_drops_available   = false;
+    m_socket_drops             = 0;
+    m_ring_occupancy           = 0;
+    m_ring_occupancy_max       = 0;
+    m_ring_overruns            = 0;
+    m_ring_dequeued            = 0;
+    m_ring_latency_us_max      = 0;
+    m_ring_latency_us_total    = 0;
+    m_sacn_packets             = 0;
+    m_sacn_discarded_universe  = 0;
+    m_sacn_discarded_priority  = 0;
+    m_sacn_invalid             = 0;
+    m_sacn_terminated          = 0;
+    m_sacn_sources             = 0;
+    m_sacn_priority_active     = 0;
+    m_mods_us_last             = 0;
+    m_mods_us_max              = 0;
+    m_merge_sources_active     = 0;
+    m_merge_exclusive_ip       = 0;
+    m_merge_us_last            = 0;
+    m_merge_us_max             = 0;
+  }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include "PacketRing.h"
+
+PacketRing::PacketRing() {
+  for( int i = 0; i < PACKET_RING_SLOTS; i++ ) {
+    m_datagrams[ i ].m_ptr_buffer  = m_buffers[ i ];
+    m_datagrams[ i ].m_buffer_size = PACKET_RING_SLOT_SIZE;
+  }
+  this->Clear();
+}
+
+PacketRing::~PacketRing() {
+}
+
+void PacketRing::Clear() {
+  m_write_index.store( 0 );
+  m_read_index.store( 0 );
+  m_overruns.store( 0 );
+}
+
+int PacketRing::GetWriteSlots( UdpDatagram** ptr_ptr_datagrams ) {
+  uint32_t write_index = m_write_index.load( std::memory_order_relaxed );
+  uint32_t read_index  = m_read_index.load( std::memory_order_acquire );
+
+  int free_slots = PACKET_RING_SLOTS - (int)( write_index - read_index );
+  int slot       = write_index & ( PACKET_RING_SLOTS - 1 );
+
+  // Stop at the end of the array, the caller receives into the slots as one array.
+  if( free_slots > PACKET_RING_SLOTS - slot ) {
+    free_slots = PACKET_RING_SLOTS - slot;
+  }
+
+  *ptr_ptr_datagrams = &m_datagrams[ slot ];
+  return free_slots;
+}
+
+void PacketRing::Publish( int count, int tag ) {
+  uint32_t write_index = m_write_index.load( std::memory_order_relaxed );
+
+  for( int i = 0; i < count; i++ ) {
+    m_tags[ ( write_index + i ) & ( PACKET_RING_SLOTS - 1 ) ] = tag;
+  }
+
+  // Slot contents are visible to the consumer before the new write index.
+  m_write_index.store( write_index + count, std::memory_order_release );
+}
+
+void PacketRing::AddOverruns( int count ) {
+  m_overruns.fetch_add( count, std::memory_order_relaxed );
+}
+
+const UdpDatagram* PacketRing::Peek( int* ptr_tag ) {
+  uint32_t read_index  = m_read_index.load( std::memory_order_relaxed );
+  uint32_t write_index = m_write_index.load( std::memory_order_acquire );
+
+  if( read_index == write_index ) {
+    return nullptr;
+  }
+
+  int slot = read_index & ( PACKET_RING_SLOTS - 1 );
+  *ptr_tag = m_tags[ slot ];
+  return &m_datagrams[ slot ];
+}
+
+void PacketRing::Release() {
+  // The slot is only handed back to the producer once the consumer is done with it.
+  m_read_index.store( m_read_index.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+}
+
+int PacketRing::GetOccupancy() const {
+  return (int)( m_write_index.load( std::memory_order_acquire ) - m_read_index.load( std::memory_order_acquire ) );
+}
+
+unsigned long PacketRing::GetOverruns() const {
+  return m_overruns.load( std::memory_order_relaxed );
+}
@@ -0,0 +1,53 @@
+#ifndef _PACKETRING_H_
+#define _PACKETRING_H_
+
+#include <stdint.h>
+#include <atomic>
+#include "UdpSocket.h"
+#include "E131_Spec.h"
+
+#define PACKET_RING_SLOTS      16                    // Must be a power of 2.
+#define PACKET_RING_SLOT_SIZE  E131_PACKET_MAXSIZE   // Largest Art-Net (530) or sACN (638) packet.
+
+// Lock-free single producer / single consumer ring of received datagrams.  The slot buffers are part of the
+// ring, so nothing is allocated after construction.  The producer (network receive task) receives straight into
+// free slots, the consumer (loop) handles & releases them in order.
+class PacketRing {
+public:
+  PacketRing();
+
+  ~PacketRing();
+
+  // Only when neither side is running.
+  void Clear();
+
+  // Producer.  Returns the number of free slots that follow each other in memory from the write position, & the first of them.
+  int  GetWriteSlots( UdpDatagram** ptr_ptr_datagrams );
+
+  // Producer.  Hands count slots from GetWriteSlots() to the consumer, all tagged with tag.
+  void Publish( int count, int tag );
+
+  // Producer.  Datagrams lost because the ring was full.
+  void AddOverruns( int count );
+
+  // Consumer.  Oldest datagram, nullptr if empty.
+  const UdpDatagram* Peek( int* ptr_tag );
+
+  // Consumer.  Frees the slot returned by Peek().
+  void Release();
+
+  int           GetOccupancy() const;
+  unsigned long GetOverruns() const;
+
+private:
+  UdpDatagram                m_datagrams[ PACKET_RING_SLOTS ];
+  int                        m_tags[ PACKET_RING_SLOTS ];
+  uint8_t                    m_buffers[ PACKET_RING_SLOTS ][ PACKET_RING_SLOT_SIZE ];
+
+  // Free running counters, slot = index % PACKET_RING_SLOTS.
+  std::atomic< uint32_t >      m_write_index;
+  std::atomic< uint32_t >      m_read_index;
+  std::atomic< unsigned long > m_overruns;
+};
+
+#endif
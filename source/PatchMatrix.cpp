@@ -0,0 +1,119 @@
+#include "PatchMatrix.h"
+
+PatchMatrix::PatchMatrix() {
+  this->Clear();
+}
+
+PatchMatrix::~PatchMatrix() {
+}
+
+void PatchMatrix::Clear() {
+  memset( m_inputs, 0, sizeof( m_inputs ) );
+  memset( m_frames_received, 0, sizeof( m_frames_received ) );
+  memset( m_gather_entry, 0xFF, sizeof( m_gather_entry ) );
+  m_universe_count         = 0;
+  m_gather_count           = 0;
+  m_highest_output_channel = 0;
+  m_apply_time_us_last     = 0;
+  m_apply_time_us_max      = 0;
+}
+
+bool PatchMatrix::AddPatch( uint16_t output_channel, uint16_t universe, uint16_t input_channel, uint16_t count ) {
+  if( output_channel < 1 || input_channel < 1 || count < 1 ) {
+    return false;
+  }
+  if( output_channel + count - 1 > PATCH_CHANNELS_MAX || input_channel + count - 1 > PATCH_CHANNELS_MAX ) {
+    return false;
+  }
+
+  int universe_index = this->FindUniverse( universe );
+  if( universe_index < 0 ) {
+    if( m_universe_count >= PATCH_UNIVERSES_MAX ) {
+      return false;
+    }
+    universe_index = m_universe_count++;
+    m_universes[ universe_index ] = universe;
+  }
+
+  for( uint16_t i = 0; i < count; i++ ) {
+    uint16_t output = output_channel - 1 + i;
+    uint16_t input  = universe_index * PATCH_CHANNELS_MAX + input_channel - 1 + i;
+
+    int entry = m_gather_entry[ output ];
+    if( entry < 0 ) {
+      entry = m_gather_count++;
+      m_gather_entry[ output ] = entry;
+    }
+    m_gather_output[ entry ] = output;
+    m_gather_input[ entry ]  = input;
+  }
+
+  if( output_channel + count - 1 > m_highest_output_channel ) {
+    m_highest_output_channel = output_channel + count - 1;
+  }
+  return true;
+}
+
+bool PatchMatrix::IsActive() const {
+  return m_gather_count > 0;
+}
+
+int PatchMatrix::FindUniverse( uint16_t universe ) const {
+  for( int i = 0; i < m_universe_count; i++ ) {
+    if( m_universes[ i ] == universe ) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void PatchMatrix::StoreFrame( int universe_index, const uint8_t* ptr_data, uint16_t length ) {
+  if( length > PATCH_CHANNELS_MAX ) {
+    length = PATCH_CHANNELS_MAX;
+  }
+  uint8_t* ptr_input = &m_inputs[ universe_index * PATCH_CHANNELS_MAX ];
+  memcpy( ptr_input, ptr_data, length );
+  memset( &ptr_input[ length ], 0, PATCH_CHANNELS_MAX - length );
+  m_frames_received[ universe_index ]++;
+}
+
+void PatchMatrix::Apply( uint8_t* ptr_output ) {
+  unsigned long start_us = micros();
+
+  for( int i = 0; i < m_gather_count; i++ ) {
+    ptr_output[ m_gather_output[ i ] ] = m_inputs[ m_gather_input[ i ] ];
+  }
+
+  m_apply_time_us_last = micros() - start_us;
+  if( m_apply_time_us_last > m_apply_time_us_max ) {
+    m_apply_time_us_max = m_apply_time_us_last;
+  }
+}
+
+int PatchMatrix::GetUniverseCount() const {
+  return m_universe_count;
+}
+
+uint16_t PatchMatrix::GetUniverse( int universe_index ) const {
+  return m_universes[ universe_index ];
+}
+
+unsigned long PatchMatrix::GetFramesReceived( int universe_index ) const {
+  return m_frames_received[ universe_index ];
+}
+
+int PatchMatrix::GetPatchedCount() const {
+  return m_gather_count;
+}
+
+uint16_t PatchMatrix::GetHighestOutputChannel() const {
+  return m_highest_output_channel;
+}
+
+unsigned long PatchMatrix::GetApplyTimeUsLast() const {
+  return m_apply_time_us_last;
+}
+
+unsigned long PatchMatrix::GetApplyTimeUsMax() const {
+  return m_apply_time_us_max;
+}
@@ -0,0 +1,60 @@
+#ifndef _PATCHMATRIX_H_
+#define _PATCHMATRIX_H_
+
+#include <Arduino.h>
+
+#define PATCH_UNIVERSES_MAX   4     // Received universes the patch can take channels from.
+#define PATCH_CHANNELS_MAX    512
+
+// Output channels patched from any channel of any subscribed universe.  The patch is compiled into a gather
+// table of (output, input) pairs, so Apply() is one pass with no lookups.
+class PatchMatrix {
+public:
+  PatchMatrix();
+
+  ~PatchMatrix();
+
+  void Clear();
+
+  // Channels are 1 to 512.  Returns false if the universe can't be subscribed or the range is outside the frame.
+  bool AddPatch( uint16_t output_channel, uint16_t universe, uint16_t input_channel, uint16_t count );
+
+  bool IsActive() const;
+
+  // Index of the subscribed universe, -1 if it isn't.
+  int  FindUniverse( uint16_t universe ) const;
+
+  // Last frame of a subscribed universe, channels past length are 0.
+  void StoreFrame( int universe_index, const uint8_t* ptr_data, uint16_t length );
+
+  // ptr_output[ 0 ] is channel 1.
+  void Apply( uint8_t* ptr_output );
+
+  int           GetUniverseCount() const;
+  uint16_t      GetUniverse( int universe_index ) const;
+  unsigned long GetFramesReceived( int universe_index ) const;
+  int           GetPatchedCount() const;
+  uint16_t      GetHighestOutputChannel() const;
+  unsigned long GetApplyTimeUsLast() const;
+  unsigned long GetApplyTimeUsMax() const;
+
+private:
+  uint16_t      m_universes[ PATCH_UNIVERSES_MAX ];
+  unsigned long m_frames_received[ PATCH_UNIVERSES_MAX ];
+  int           m_universe_count;
+
+  // All subscribed universes back to back, so a gather entry is a single index.
+  uint8_t       m_inputs[ PATCH_UNIVERSES_MAX * PATCH_CHANNELS_MAX ];
+
+  // Gather table.  A later patch of the same output channel replaces the earlier one.
+  uint16_t      m_gather_output[ PATCH_CHANNELS_MAX ];
+  uint16_t      m_gather_input[ PATCH_CHANNELS_MAX ];
+  int           m_gather_count;
+  int16_t       m_gather_entry[ PATCH_CHANNELS_MAX ];   // Entry of each output channel, -1 if not patched.  Only used by AddPatch().
+  uint16_t      m_highest_output_channel;
+
+  unsigned long m_apply_time_us_last;
+  unsigned long m_apply_time_us_max;
+};
+
+#endif
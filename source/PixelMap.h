@@ -0,0 +1,58 @@
+#ifndef _PIXELMAP_H_
+#define _PIXELMAP_H_
+
+#include <string.h>
+
+#define PIXEL_MAP_ORDER_LENGTH  5     // Colour order string including the terminator, e.g. "RGBW".
+#define PIXEL_MAPS_MAX          32
+
+// A run of pixels on the output taking their colours from Art-Net pixels.  Art-Net pixels are always R, G, B (W),
+// the colour order is the order of the components on the output.
+struct PixelMap {
+  unsigned int m_output_start;   // First output channel, 1 to 512.
+  unsigned int m_pixel_count;    // Output pixels, for one repeat.
+  unsigned int m_input_start;    // First Art-Net channel, 1 to 512.
+  char         m_colour_order[ PIXEL_MAP_ORDER_LENGTH ];  // e.g. "GRB".  "W" is one channel per pixel.
+  unsigned int m_colour_plane;   // 0 = Art-Net pixels are RGBRGB.., otherwise the channels from the R to the G to the B plane.
+  unsigned int m_grouping;       // Output pixels sharing one Art-Net pixel.  Default = 1
+  bool         m_reverse;        // Last output pixel takes the first Art-Net pixel.
+  unsigned int m_zigzag_width;   // Pixels per row, every other row runs backwards.  0 = off.
+  unsigned int m_repeat;         // The map is output this many times back to back.  Default = 1
+};
+
+// Index of the component in an Art-Net pixel, -1 if it isn't one.
+inline int PixelColourComponent( char component ) {
+  switch( component ) {
+    case 'R': return 0;
+    case 'G': return 1;
+    case 'B': return 2;
+    case 'W': return 3;
+    default:  return -1;
+  }
+}
+
+// Channels per pixel, 0 if the colour order isn't valid.
+inline unsigned int PixelColourOrderChannels( const char* colour_order ) {
+  unsigned int length = strlen( colour_order );
+  if( length == 1 ) {
+    return colour_order[ 0 ] == 'W' ? 1 : 0;
+  }
+  if( length != 3 && length != 4 ) {
+    return 0;
+  }
+  bool seen[ 4 ] = { false, false, false, false };
+  for( unsigned int i = 0; i < length; i++ ) {
+    int component = PixelColourComponent( colour_order[ i ] );
+    if( component < 0 ) {
+      return 0;
+    }
+    if( seen[ component ] || component >= (int)length ) {
+      // RGB orders can't use W, RGBW orders need all 4.
+      return 0;
+    }
+    seen[ component ] = true;
+  }
+  return length;
+}
+
+#endif
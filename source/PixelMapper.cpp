@@ -0,0 +1,140 @@
+#include "PixelMapper.h"
+
+PixelMapper::PixelMapper() {
+  this->Clear();
+}
+
+PixelMapper::~PixelMapper() {
+}
+
+void PixelMapper::Clear() {
+  memset( m_gather_entry, 0xFF, sizeof( m_gather_entry ) );
+  m_map_count              = 0;
+  m_gather_count           = 0;
+  m_highest_output_channel = 0;
+  m_apply_time_us_last     = 0;
+  m_apply_time_us_max      = 0;
+}
+
+bool PixelMapper::IsValid( const PixelMap& map ) {
+  unsigned int channels_per_pixel = PixelColourOrderChannels( map.m_colour_order );
+  if( channels_per_pixel == 0 || map.m_pixel_count < 1 || map.m_grouping < 1 || map.m_repeat < 1 ) {
+    return false;
+  }
+  if( map.m_output_start < 1 || map.m_input_start < 1 ) {
+    return false;
+  }
+  // Fields come from toInt() & the config file, a negative one is a huge unsigned one.  Nothing valid is above 512,
+  // & with all of them at most 512 the sums below fit in 64 bits.
+  if( map.m_output_start > PIXEL_MAP_CHANNELS_MAX || map.m_input_start > PIXEL_MAP_CHANNELS_MAX ||
+      map.m_pixel_count > PIXEL_MAP_CHANNELS_MAX || map.m_repeat > PIXEL_MAP_CHANNELS_MAX || map.m_grouping > PIXEL_MAP_CHANNELS_MAX ||
+      map.m_zigzag_width > PIXEL_MAP_CHANNELS_MAX || map.m_colour_plane > PIXEL_MAP_CHANNELS_MAX ) {
+    return false;
+  }
+
+  // Reverse & zig-zag only reorder the pixels, so the last Art-Net pixel & component bound the input.
+  uint64_t output_last      = map.m_output_start - 1 + (uint64_t)map.m_repeat * map.m_pixel_count * channels_per_pixel;
+  uint64_t input_pixel_last = ( map.m_pixel_count - 1 ) / map.m_grouping;
+  uint64_t component_last   = channels_per_pixel - 1;
+  uint64_t input_last;
+  if( map.m_colour_plane > 0 ) {
+    input_last = map.m_input_start + input_pixel_last + component_last * map.m_colour_plane;
+  } else {
+    input_last = map.m_input_start + input_pixel_last * channels_per_pixel + component_last;
+  }
+  return output_last <= PIXEL_MAP_CHANNELS_MAX && input_last <= PIXEL_MAP_CHANNELS_MAX;
+}
+
+bool PixelMapper::AddMap( const PixelMap& map ) {
+  if( !PixelMapper::IsValid( map ) ) {
+    return false;
+  }
+
+  unsigned int channels_per_pixel = PixelColourOrderChannels( map.m_colour_order );
+  unsigned int components[ 4 ];
+  for( unsigned int c = 0; c < channels_per_pixel; c++ ) {
+    // A single channel map takes the first channel of each Art-Net pixel.
+    components[ c ] = channels_per_pixel == 1 ? 0 : PixelColourComponent( map.m_colour_order[ c ] );
+  }
+
+  unsigned int output = map.m_output_start - 1;
+  for( unsigned int repeat = 0; repeat < map.m_repeat; repeat++ ) {
+    for( unsigned int pixel = 0; pixel < map.m_pixel_count; pixel++ ) {
+      unsigned int position = pixel;
+      if( map.m_zigzag_width > 0 ) {
+        unsigned int row = pixel / map.m_zigzag_width;
+        if( row % 2 == 1 ) {
+          // The last row can be short.
+          unsigned int row_start  = row * map.m_zigzag_width;
+          unsigned int row_length = min( map.m_zigzag_width, map.m_pixel_count - row_start );
+          position = row_start + row_length - 1 - ( pixel - row_start );
+        }
+      }
+      if( map.m_reverse ) {
+        position = map.m_pixel_count - 1 - position;
+      }
+      unsigned int input_pixel = position / map.m_grouping;
+
+      for( unsigned int c = 0; c < channels_per_pixel; c++ ) {
+        unsigned int input = map.m_input_start - 1;
+        if( map.m_colour_plane > 0 ) {
+          input += input_pixel + components[ c ] * map.m_colour_plane;
+        } else {
+          input += input_pixel * channels_per_pixel + components[ c ];
+        }
+
+        int entry = m_gather_entry[ output ];
+        if( entry < 0 ) {
+          entry = m_gather_count++;
+          m_gather_entry[ output ] = entry;
+        }
+        m_gather_output[ entry ] = output;
+        m_gather_input[ entry ]  = input;
+        output++;
+      }
+    }
+  }
+
+  if( output > m_highest_output_channel ) {
+    m_highest_output_channel = output;
+  }
+  m_map_count++;
+  return true;
+}
+
+bool PixelMapper::IsActive() const {
+  return m_gather_count > 0;
+}
+
+void PixelMapper::Apply( const uint8_t* ptr_input, uint8_t* ptr_output ) {
+  unsigned long start_us = micros();
+
+  for( int i = 0; i < m_gather_count; i++ ) {
+    ptr_output[ m_gather_output[ i ] ] = ptr_input[ m_gather_input[ i ] ];
+  }
+
+  m_apply_time_us_last = micros() - start_us;
+  if( m_apply_time_us_last > m_apply_time_us_max ) {
+    m_apply_time_us_max = m_apply_time_us_last;
+  }
+}
+
+int PixelMapper::GetMapCount() const {
+  return m_map_count;
+}
+
+int PixelMapper::GetMappedCount() const {
+  return m_gather_count;
+}
+
+uint16_t PixelMapper::GetHighestOutputChannel() const {
+  return m_highest_output_channel;
+}
+
+unsigned long PixelMapper::GetApplyTimeUsLast() const {
+  return m_apply_time_us_last;
+}
+
+unsigned long PixelMapper::GetApplyTimeUsMax() const {
+  return m_apply_time_us_max;
+}
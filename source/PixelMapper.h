@@ -0,0 +1,49 @@
+#ifndef _PIXELMAPPER_H_
+#define _PIXELMAPPER_H_
+
+#include <Arduino.h>
+#include "PixelMap.h"
+
+#define PIXEL_MAP_CHANNELS_MAX  512
+
+// Pixel maps compiled into a gather table of (output, input) pairs, so Apply() is one pass over the mapped
+// channels whatever the grouping, reverse, zig-zag & repeat of the maps.
+class PixelMapper {
+public:
+  PixelMapper();
+
+  ~PixelMapper();
+
+  void Clear();
+
+  // Returns false if the map is invalid or goes past channel 512 on the input or the output.
+  bool AddMap( const PixelMap& map );
+
+  static bool IsValid( const PixelMap& map );
+
+  bool IsActive() const;
+
+  // ptr_input[ 0 ] & ptr_output[ 0 ] are channel 1, the input must be 512 channels.
+  void Apply( const uint8_t* ptr_input, uint8_t* ptr_output );
+
+  int           GetMapCount() const;
+  int           GetMappedCount() const;
+  uint16_t      GetHighestOutputChannel() const;
+  unsigned long GetApplyTimeUsLast() const;
+  unsigned long GetApplyTimeUsMax() const;
+
+private:
+  int           m_map_count;
+
+  // Gather table.  A later map of the same output channel replaces the earlier one.
+  uint16_t      m_gather_output[ PIXEL_MAP_CHANNELS_MAX ];
+  uint16_t      m_gather_input[ PIXEL_MAP_CHANNELS_MAX ];
+  int           m_gather_count;
+  int16_t       m_gather_entry[ PIXEL_MAP_CHANNELS_MAX ];   // Entry of each output channel, -1 if not mapped.  Only used by AddMap().
+  uint16_t      m_highest_output_channel;
+
+  unsigned long m_apply_time_us_last;
+  unsigned long m_apply_time_us_max;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "SequenceTracker.h"
+
+SequenceTracker::SequenceTracker() {
+  this->Clear();
+}
+
+SequenceTracker::~SequenceTracker() {
+}
+
+void SequenceTracker::Clear() {
+  memset( m_sources, 0, sizeof( m_sources ) );
+}
+
+void SequenceTracker::ResetStats() {
+  for( SequenceSource& source : m_sources ) {
+    source.m_received   = 0;
+    source.m_lost       = 0;
+    source.m_duplicates = 0;
+    source.m_reordered  = 0;
+  }
+}
+
+bool SequenceTracker::Accept( int protocol, uint16_t universe, uint32_t source_ip, uint8_t sequence, unsigned long time_ms ) {
+  SequenceSource* ptr_source = this->FindOrAddSource( protocol, universe, source_ip, time_ms );
+
+  bool first   = !ptr_source->m_has_sequence;
+  bool restart = ( time_ms - ptr_source->m_last_ms >= SEQUENCE_SOURCE_TIMEOUT_MS );
+  ptr_source->m_has_sequence = true;
+  ptr_source->m_last_ms = time_ms;
+  ptr_source->m_received++;
+
+  int difference;
+  if( protocol == SEQUENCEPROTOCOL::SEQUENCE_E131 ) {
+    if( first || restart ) {
+      ptr_source->m_sequence_last = sequence;
+      return true;
+    }
+    // Every value is a sequence number, the difference is modulo 256 folded to -128 to 127.
+    difference = (int8_t)( sequence - ptr_source->m_sequence_last );
+  } else {
+    if( sequence == 0 || ptr_source->m_sequence_last == 0 || first || restart ) {
+      // Sequence disabled, or nothing to compare with.
+      ptr_source->m_sequence_last = sequence;
+      return true;
+    }
+    // Sequence runs 1 to 255 then wraps to 1, so the difference is taken modulo 255 & folded to -127 to 127.
+    difference = ( (int)sequence - (int)ptr_source->m_sequence_last + 255 ) % 255;
+    if( difference > 127 ) {
+      difference -= 255;
+    }
+  }
+
+  if( difference == 0 ) {
+    ptr_source->m_duplicates++;
+    return false;
+  }
+
+  if( difference < 0 && difference > -SEQUENCE_LATE_WINDOW ) {
+    ptr_source->m_reordered++;
+    return false;
+  }
+
+  if( difference > 1 ) {
+    ptr_source->m_lost += difference - 1;
+  }
+
+  ptr_source->m_sequence_last = sequence;
+  return true;
+}
+
+int SequenceTracker::GetSourceCount() const {
+  return SEQUENCE_SOURCES_MAX;
+}
+
+const SequenceSource& SequenceTracker::GetSource( int index ) const {
+  return m_sources[ index ];
+}
+
+SequenceSource* SequenceTracker::FindOrAddSource( int protocol, uint16_t universe, uint32_t source_ip, unsigned long time_ms ) {
+  SequenceSource* ptr_oldest = &m_sources[ 0 ];
+
+  for( SequenceSource& source : m_sources ) {
+    if( source.m_in_use && source.m_protocol == protocol && source.m_universe == universe && source.m_source_ip == source_ip ) {
+      return &source;
+    }
+    if( !ptr_oldest->m_in_use ) {
+      continue;
+    }
+    if( !source.m_in_use || time_ms - source.m_last_ms > time_ms - ptr_oldest->m_last_ms ) {
+      ptr_oldest = &source;
+    }
+  }
+
+  // Replace a free entry, or the one not seen for the longest time.
+  memset( ptr_oldest, 0, sizeof( SequenceSource ) );
+  ptr_oldest->m_in_use    = true;
+  ptr_oldest->m_protocol  = protocol;
+  ptr_oldest->m_universe  = universe;
+  ptr_oldest->m_source_ip = source_ip;
+  ptr_oldest->m_last_ms   = time_ms;
+
+  return ptr_oldest;
+}
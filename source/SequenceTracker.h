@@ -0,0 +1,64 @@
+#ifndef _SEQUENCETRACKER_H_
+#define _SEQUENCETRACKER_H_
+
+#include <Arduino.h>
+
+#define SEQUENCE_SOURCES_MAX        8     // Universe & source IP pairs tracked at the same time.
+#define SEQUENCE_LATE_WINDOW        20    // Packets up to this many sequence numbers behind are late & dropped.  Further back is a source restart.
+#define SEQUENCE_SOURCE_TIMEOUT_MS  2000  // A source not seen for this long starts again from any sequence.
+
+enum SEQUENCEPROTOCOL : int {
+  SEQUENCE_ARTNET = 0,   // 1 to 255 then back to 1, 0 = disabled by the source.
+  SEQUENCE_E131   = 1,   // 0 to 255 then back to 0, always on.
+};
+
+inline const char* SequenceProtocolAsString( int protocol ) {
+  switch( protocol ) {
+    case SEQUENCE_ARTNET: return "artnet";
+    case SEQUENCE_E131:   return "sacn";
+    default:              return "unknown";
+  }
+};
+
+struct SequenceSource {
+  bool          m_in_use;
+  int           m_protocol;           // SEQUENCEPROTOCOL, a source sending both is tracked twice.
+  uint16_t      m_universe;
+  uint32_t      m_source_ip;
+  bool          m_has_sequence;       // m_sequence_last is set.
+  uint8_t       m_sequence_last;      // Art-Net 0 = sequence disabled by the source.
+  unsigned long m_last_ms;
+
+  // Stats
+  unsigned long m_received;
+  unsigned long m_lost;               // Sequence numbers skipped, packets that never arrived (or arrive later).
+  unsigned long m_duplicates;         // Same sequence number as the last packet, dropped.
+  unsigned long m_reordered;          // Older than the last packet, dropped.
+};
+
+// Tracks the sequence number per protocol, universe & source, following each spec's wraparound.  Art-Net runs 1 to 255
+// with 0 = disabled, E1.31 runs 0 to 255 & drops a packet that is 0 to 19 behind the last (E1.31 6.7.2).
+class SequenceTracker {
+public:
+  SequenceTracker();
+
+  ~SequenceTracker();
+
+  void Clear();
+
+  void ResetStats();
+
+  // Returns false if the packet is a duplicate or arrived after a newer packet & should be dropped.
+  bool Accept( int protocol, uint16_t universe, uint32_t source_ip, uint8_t sequence, unsigned long time_ms );
+
+  int  GetSourceCount() const;
+
+  const SequenceSource& GetSource( int index ) const;
+
+private:
+  SequenceSource* FindOrAddSource( int protocol, uint16_t universe, uint32_t source_ip, unsigned long time_ms );
+
+  SequenceSource m_sources[ SEQUENCE_SOURCES_MAX ];
+};
+
+#endif
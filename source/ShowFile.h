@@ -0,0 +1,58 @@
+#ifndef _SHOWFILE_H_
+#define _SHOWFILE_H_
+
+// Show file format used by the show recorder & player.
+//
+// All values are little endian.
+//
+//   File header (16 bytes)
+//   Frame records, each being;
+//     Frame header (7 bytes)
+//     Frame data   (m_Length bytes)
+//
+// Frame types;
+//   Keyframe : Data is the full frame, one byte per slot starting from slot 1.
+//   Delta    : Data is a list of runs of changed slots since the previous frame.
+//              Each run is a ShowFileRun (3 bytes) followed by m_Count slot values.
+//
+// A keyframe is written at least every m_KeyframeIntervalMs so the player can seek
+// without decoding the whole file.
+
+#define SHOWFILE_ID                      "A2DS"
+#define SHOWFILE_VERSION                 1
+#define SHOWFILE_SLOTS_MAX               512
+#define SHOWFILE_KEYFRAME_INTERVAL_MS    1000
+#define SHOWFILE_FRAME_KEY               0x4B   // 'K'
+#define SHOWFILE_FRAME_DELTA             0x44   // 'D'
+#define SHOWFILE_RUN_GAP_MERGE           3      // Unchanged slots between changes that are cheaper to store than a new run header.
+
+#pragma pack( push, 1 ) // Set packing alignment to 1 byte
+
+typedef struct ShowFileHeader
+{
+  uint8_t  m_ID[ 4 ];             // "A2DS"
+  uint8_t  m_Version;             // SHOWFILE_VERSION
+  uint8_t  m_Reserved;
+  uint16_t m_Slots;               // Number of slots in a keyframe.
+  uint16_t m_KeyframeIntervalMs;  // Maximum time between keyframes.
+  uint8_t  m_Reserved2[ 6 ];
+} __attribute__( ( packed ) ) ShowFileHeader;
+
+typedef struct ShowFileFrameHeader
+{
+  uint8_t  m_Type;                // SHOWFILE_FRAME_KEY or SHOWFILE_FRAME_DELTA
+  uint32_t m_TimeMs;              // Time since start of recording.
+  uint16_t m_Length;              // Number of data bytes following this header.
+} __attribute__( ( packed ) ) ShowFileFrameHeader;
+
+typedef struct ShowFileRun
+{
+  uint16_t m_Slot;                // First slot of the run, 1 to 512.
+  uint8_t  m_Count;               // Number of slot values following, 1 to 255.
+} __attribute__( ( packed ) ) ShowFileRun;
+
+#pragma pack( pop ) // Restore original packing alignment
+
+#define SHOWFILE_RECORD_MAXSIZE  ( sizeof( ShowFileFrameHeader ) + SHOWFILE_SLOTS_MAX )
+
+#endif
@@ -0,0 +1,185 @@
+#include "ShowPlayer.h"
+
+ShowPlayer::ShowPlayer() {
+  m_ptr_Logger        = nullptr;
+  m_is_playing        = false;
+  m_loop              = false;
+  m_has_frame_pending = false;
+}
+
+ShowPlayer::~ShowPlayer() {
+  this->Stop();
+}
+
+bool ShowPlayer::Start( const String& filename, bool loop ) {
+  if( m_is_playing ) {
+    this->Stop();
+  }
+
+  if( !LittleFS.exists( filename ) ) {
+    return false;
+  }
+
+  m_file = LittleFS.open( filename, "r" );
+  if( !m_file ) {
+    return false;
+  }
+
+  ShowFileHeader header;
+  if( m_file.read( (uint8_t*)&header, sizeof( header ) ) != sizeof( header ) ||
+      memcmp( header.m_ID, SHOWFILE_ID, sizeof( header.m_ID ) ) != 0 ||
+      header.m_Version != SHOWFILE_VERSION ) {
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_ERROR, "Show player : '%s' is not a show file", filename.c_str() );
+    m_file.close();
+    return false;
+  }
+
+  m_loop               = loop;
+  m_has_frame_pending  = false;
+  m_frame_last_time_ms = 0;
+  m_start_ms           = millis();
+  m_is_playing         = true;
+
+  return true;
+}
+
+void ShowPlayer::Stop() {
+  if( !m_is_playing ) {
+    return;
+  }
+  m_file.close();
+  m_is_playing = false;
+}
+
+bool ShowPlayer::IsPlaying() {
+  return m_is_playing;
+}
+
+bool ShowPlayer::Update( unsigned long time_ms, uint8_t* slots ) {
+  bool slots_changed = false;
+
+  while( m_is_playing ) {
+    if( !m_has_frame_pending && !this->ReadFrameHeader() ) {
+      // End of recording.  A recording without any length can't be looped.
+      if( !m_loop || m_frame_last_time_ms == 0 || !this->Rewind() || !this->ReadFrameHeader() ) {
+        this->Stop();
+        break;
+      }
+      m_start_ms          += m_frame_last_time_ms;
+      m_frame_last_time_ms = 0;
+    }
+
+    if( m_frame_pending.m_TimeMs > time_ms - m_start_ms ) {
+      // Not due yet.
+      break;
+    }
+
+    if( !this->ApplyFrame( slots ) ) {
+      LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_ERROR, "Show player : Corrupt frame, playback stopped." );
+      this->Stop();
+      break;
+    }
+    slots_changed = true;
+  }
+
+  return slots_changed;
+}
+
+bool ShowPlayer::Seek( unsigned long position_ms, unsigned long time_ms, uint8_t* slots ) {
+  if( !m_is_playing || !this->Rewind() ) {
+    return false;
+  }
+
+  // Find the last keyframe at or before the position by only reading frame headers.
+  size_t keyframe_position = 0;
+  while( this->ReadFrameHeader() && m_frame_pending.m_TimeMs <= position_ms ) {
+    if( m_frame_pending.m_Type == SHOWFILE_FRAME_KEY ) {
+      keyframe_position = m_file.position() - sizeof( ShowFileFrameHeader );
+    }
+    m_file.seek( m_frame_pending.m_Length, SeekCur );
+    m_has_frame_pending = false;
+  }
+
+  if( keyframe_position == 0 ) {
+    this->Rewind();
+  } else {
+    m_file.seek( keyframe_position, SeekSet );
+    m_has_frame_pending = false;
+  }
+
+  // Decode from the keyframe up to the position.
+  while( this->ReadFrameHeader() && m_frame_pending.m_TimeMs <= position_ms ) {
+    if( !this->ApplyFrame( slots ) ) {
+      this->Stop();
+      return false;
+    }
+  }
+
+  m_start_ms = time_ms - position_ms;
+
+  return true;
+}
+
+unsigned long ShowPlayer::GetPositionMs( unsigned long time_ms ) {
+  if( !m_is_playing ) {
+    return 0;
+  }
+  return time_ms - m_start_ms;
+}
+
+void ShowPlayer::SetLogger( Logger* ptr_logger ) {
+  m_ptr_Logger = ptr_logger;
+}
+
+bool ShowPlayer::ReadFrameHeader() {
+  if( m_file.read( (uint8_t*)&m_frame_pending, sizeof( m_frame_pending ) ) != sizeof( m_frame_pending ) ) {
+    m_has_frame_pending = false;
+    return false;
+  }
+  m_has_frame_pending = true;
+  return true;
+}
+
+bool ShowPlayer::ApplyFrame( uint8_t* slots ) {
+  size_t bytes_remaining = m_frame_pending.m_Length;
+
+  if( m_frame_pending.m_Type == SHOWFILE_FRAME_KEY ) {
+    size_t length = bytes_remaining < SHOWFILE_SLOTS_MAX ? bytes_remaining : SHOWFILE_SLOTS_MAX;
+    if( m_file.read( slots, length ) != length ) {
+      return false;
+    }
+    bytes_remaining -= length;
+  } else if( m_frame_pending.m_Type == SHOWFILE_FRAME_DELTA ) {
+    while( bytes_remaining >= sizeof( ShowFileRun ) ) {
+      ShowFileRun run;
+      if( m_file.read( (uint8_t*)&run, sizeof( run ) ) != sizeof( run ) ) {
+        return false;
+      }
+      bytes_remaining -= sizeof( run );
+
+      if( run.m_Slot < 1 || run.m_Slot + run.m_Count - 1 > SHOWFILE_SLOTS_MAX || run.m_Count > bytes_remaining ) {
+        return false;
+      }
+      if( m_file.read( &slots[ run.m_Slot - 1 ], run.m_Count ) != run.m_Count ) {
+        return false;
+      }
+      bytes_remaining -= run.m_Count;
+    }
+  } else {
+    return false;
+  }
+
+  if( bytes_remaining > 0 ) {
+    m_file.seek( bytes_remaining, SeekCur );
+  }
+
+  m_frame_last_time_ms = m_frame_pending.m_TimeMs;
+  m_has_frame_pending  = false;
+
+  return true;
+}
+
+bool ShowPlayer::Rewind() {
+  m_has_frame_pending = false;
+  return m_file.seek( sizeof( ShowFileHeader ), SeekSet );
+}
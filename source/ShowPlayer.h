@@ -0,0 +1,48 @@
+#ifndef _SHOWPLAYER_H_
+#define _SHOWPLAYER_H_
+
+#include <LittleFS.h>
+#include "FS.h"
+#include "ShowFile.h"
+#include "Logger.h"
+
+// Streams a show file recorded by ShowRecorder.  Frames are read directly from file into
+// the slot buffer, so memory use does not depend on the length of the recording.
+class ShowPlayer {
+public:
+  ShowPlayer();
+
+  ~ShowPlayer();
+
+  bool Start( const String& filename, bool loop );
+
+  void Stop();
+
+  bool IsPlaying();
+
+  // Applies all frames due at time_ms.  slots = 512 DMX slot values.  Returns true if slots changed.
+  bool Update( unsigned long time_ms, uint8_t* slots );
+
+  // Jumps to position_ms within the recording using the nearest keyframe before it.
+  bool Seek( unsigned long position_ms, unsigned long time_ms, uint8_t* slots );
+
+  unsigned long GetPositionMs( unsigned long time_ms );
+
+  void SetLogger( Logger* ptr_logger );
+
+private:
+  bool ReadFrameHeader();
+  bool ApplyFrame( uint8_t* slots );
+  bool Rewind();
+
+  Logger*             m_ptr_Logger;
+  File                m_file;
+  bool                m_is_playing;
+  bool                m_loop;
+  bool                m_has_frame_pending;
+  unsigned long       m_start_ms;
+  uint32_t            m_frame_last_time_ms;
+  ShowFileFrameHeader m_frame_pending;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include "ShowRecorder.h"
+
+ShowRecorder::ShowRecorder() {
+  m_ptr_Logger     = nullptr;
+  m_is_recording   = false;
+  m_frame_count    = 0;
+  m_bytes_written  = 0;
+  m_overflow_count = 0;
+  m_write_head     = 0;
+  m_write_tail     = 0;
+  m_write_used     = 0;
+}
+
+ShowRecorder::~ShowRecorder() {
+  this->Stop();
+}
+
+bool ShowRecorder::Start( const String& filename ) {
+  if( m_is_recording ) {
+    this->Stop();
+  }
+
+  m_file = LittleFS.open( filename, "w" );
+  if( !m_file ) {
+    LOG_PRINTF( m_ptr_Logger, LOG_LEVEL_ERROR, "Show recorder : Failed to create '%s'", filename.c_str() );
+    return false;
+  }
+
+  ShowFileHeader header;
+  memset( &header, 0, sizeof( header ) );
+  memcpy( header.m_ID, SHOWFILE_ID, sizeof( header.m_ID ) );
+  header.m_Version            = SHOWFILE_VERSION;
+  header.m_Slots              = SHOWFILE_SLOTS_MAX;
+  header.m_KeyframeIntervalMs = SHOWFILE_KEYFRAME_INTERVAL_MS;
+  m_file.write( (const uint8_t*)&header, sizeof( header ) );
+
+  memset( m_frame_previous, 0, sizeof( m_frame_previous ) );
+  m_write_head        = 0;
+  m_write_tail        = 0;
+  m_write_used        = 0;
+  m_frame_count       = 0;
+  m_bytes_written     = sizeof( header );
+  m_overflow_count    = 0;
+  m_keyframe_required = true;
+  m_start_ms          = millis();
+  m_keyframe_last_ms  = m_start_ms;
+  m_is_recording      = true;
+
+  return true;
+}
+
+void ShowRecorder::Stop() {
+  if( !m_is_recording ) {
+    return;
+  }
+
+  // End marker, an empty delta so the player knows the length of the recording when looping.
+  ShowFileFrameHeader* ptr_frame_header = (ShowFileFrameHeader*)m_record;
+  ptr_frame_header->m_Type   = SHOWFILE_FRAME_DELTA;
+  ptr_frame_header->m_TimeMs = millis() - m_start_ms;
+  ptr_frame_header->m_Length = 0;
+  this->BufferWrite( m_record, sizeof( ShowFileFrameHeader ) );
+
+  this->FlushBytes( SHOWRECORDER_BUFFER_SIZE );
+  m_file.close();
+  m_is_recording = false;
+}
+
+bool ShowRecorder::IsRecording() {
+  return m_is_recording;
+}
+
+void ShowRecorder::RecordFrame( const uint8_t* slots, unsigned long time_ms ) {
+  if( !m_is_recording ) {
+    return;
+  }
+
+  if( time_ms - m_keyframe_last_ms >= SHOWFILE_KEYFRAME_INTERVAL_MS ) {
+    m_keyframe_required = true;
+  }
+
+  size_t record_size = this->EncodeFrame( slots, time_ms - m_start_ms );
+  if( record_size == 0 ) {
+    // Nothing changed.
+    return;
+  }
+
+  if( !this->BufferWrite( m_record, record_size ) ) {
+    // File writes can't keep up.  Next frame must be a keyframe so the file stays consistent.
+    m_overflow_count++;
+    m_keyframe_required = true;
+    return;
+  }
+
+  if( ( (ShowFileFrameHeader*)m_record )->m_Type == SHOWFILE_FRAME_KEY ) {
+    m_keyframe_required = false;
+    m_keyframe_last_ms  = time_ms;
+  }
+
+  memcpy( m_frame_previous, slots, SHOWFILE_SLOTS_MAX );
+  m_frame_count++;
+}
+
+void ShowRecorder::Flush() {
+  if( !m_is_recording ) {
+    return;
+  }
+  this->FlushBytes( SHOWRECORDER_FLUSH_CHUNK );
+}
+
+unsigned long ShowRecorder::GetFrameCount() {
+  return m_frame_count;
+}
+
+unsigned long ShowRecorder::GetBytesWritten() {
+  return m_bytes_written;
+}
+
+unsigned long ShowRecorder::GetOverflowCount() {
+  return m_overflow_count;
+}
+
+void ShowRecorder::SetLogger( Logger* ptr_logger ) {
+  m_ptr_Logger = ptr_logger;
+}
+
+size_t ShowRecorder::EncodeFrame( const uint8_t* slots, uint32_t time_ms ) {
+  ShowFileFrameHeader* ptr_frame_header = (ShowFileFrameHeader*)m_record;
+  uint8_t*             ptr_data         = &m_record[ sizeof( ShowFileFrameHeader ) ];
+  size_t               data_length      = 0;
+
+  ptr_frame_header->m_TimeMs = time_ms;
+
+  if( !m_keyframe_required ) {
+    // Delta, build runs of changed slots.
+    ShowFileRun* ptr_run = nullptr;
+    int          slot_changed_last = -SHOWFILE_RUN_GAP_MERGE - 2;
+
+    for( int i = 0; i < SHOWFILE_SLOTS_MAX; i++ ) {
+      if( slots[ i ] == m_frame_previous[ i ] ) {
+        continue;
+      }
+
+      int  gap    = i - slot_changed_last - 1;
+      bool extend = ( ptr_run != nullptr && gap <= SHOWFILE_RUN_GAP_MERGE && ptr_run->m_Count + gap + 1 <= 255 );
+      size_t data_needed = extend ? gap + 1 : sizeof( ShowFileRun ) + 1;
+
+      if( data_length + data_needed > SHOWFILE_SLOTS_MAX ) {
+        // Larger than a keyframe.
+        data_length = SHOWFILE_SLOTS_MAX + 1;
+        break;
+      }
+
+      if( extend ) {
+        // Extend current run over the unchanged gap.
+        memcpy( &ptr_data[ data_length ], &slots[ slot_changed_last + 1 ], gap + 1 );
+        ptr_run->m_Count += gap + 1;
+      } else {
+        ptr_run = (ShowFileRun*)&ptr_data[ data_length ];
+        ptr_run->m_Slot  = i + 1;
+        ptr_run->m_Count = 1;
+        ptr_data[ data_length + sizeof( ShowFileRun ) ] = slots[ i ];
+      }
+      data_length      += data_needed;
+      slot_changed_last = i;
+    }
+
+    if( data_length == 0 ) {
+      return 0;
+    }
+
+    if( data_length <= SHOWFILE_SLOTS_MAX ) {
+      ptr_frame_header->m_Type   = SHOWFILE_FRAME_DELTA;
+      ptr_frame_header->m_Length = data_length;
+      return sizeof( ShowFileFrameHeader ) + data_length;
+    }
+  }
+
+  // Keyframe
+  ptr_frame_header->m_Type   = SHOWFILE_FRAME_KEY;
+  ptr_frame_header->m_Length = SHOWFILE_SLOTS_MAX;
+  memcpy( ptr_data, slots, SHOWFILE_SLOTS_MAX );
+
+  return sizeof( ShowFileFrameHeader ) + SHOWFILE_SLOTS_MAX;
+}
+
+bool ShowRecorder::BufferWrite( const uint8_t* data, size_t length ) {
+  if( SHOWRECORDER_BUFFER_SIZE - m_write_used < length ) {
+    return false;
+  }
+
+  size_t length_to_end = SHOWRECORDER_BUFFER_SIZE - m_write_head;
+  if( length <= length_to_end ) {
+    memcpy( &m_write_buffer[ m_write_head ], data, length );
+  } else {
+    memcpy( &m_write_buffer[ m_write_head ], data, length_to_end );
+    memcpy( m_write_buffer, &data[ length_to_end ], length - length_to_end );
+  }
+
+  m_write_head  = ( m_write_head + length ) % SHOWRECORDER_BUFFER_SIZE;
+  m_write_used += length;
+
+  return true;
+}
+
+void ShowRecorder::FlushBytes( size_t max_bytes ) {
+  while( m_write_used > 0 && max_bytes > 0 ) {
+    // Write the contiguous part up to the end of the ring.
+    size_t length = SHOWRECORDER_BUFFER_SIZE - m_write_tail;
+    if( length > m_write_used ) {
+      length = m_write_used;
+    }
+    if( length > max_bytes ) {
+      length = max_bytes;
+    }
+
+    m_file.write( &m_write_buffer[ m_write_tail ], length );
+
+    m_write_tail     = ( m_write_tail + length ) % SHOWRECORDER_BUFFER_SIZE;
+    m_write_used    -= length;
+    m_bytes_written += length;
+    max_bytes       -= length;
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef _SHOWRECORDER_H_
+#define _SHOWRECORDER_H_
+
+#include <LittleFS.h>
+#include "FS.h"
+#include "ShowFile.h"
+#include "Logger.h"
+
+#define SHOWRECORDER_BUFFER_SIZE  8192  // Encoded frames waiting to be written to file.
+#define SHOWRECORDER_FLUSH_CHUNK  1024  // Max bytes written to file per Flush() call.
+
+class ShowRecorder {
+public:
+  ShowRecorder();
+
+  ~ShowRecorder();
+
+  bool Start( const String& filename );
+
+  void Stop();
+
+  bool IsRecording();
+
+  // Encodes the frame into the write buffer only, no file access.  slots = 512 DMX slot values.
+  void RecordFrame( const uint8_t* slots, unsigned long time_ms );
+
+  // Writes buffered frames to file.  Call from the main loop outside of frame handling.
+  void Flush();
+
+  unsigned long GetFrameCount();
+  unsigned long GetBytesWritten();
+  unsigned long GetOverflowCount();
+
+  void SetLogger( Logger* ptr_logger );
+
+private:
+  size_t EncodeFrame( const uint8_t* slots, uint32_t time_ms );
+  bool   BufferWrite( const uint8_t* data, size_t length );
+  void   FlushBytes( size_t max_bytes );
+
+  Logger*       m_ptr_Logger;
+  File          m_file;
+  bool          m_is_recording;
+  bool          m_keyframe_required;
+  unsigned long m_start_ms;
+  unsigned long m_keyframe_last_ms;
+  unsigned long m_frame_count;
+  unsigned long m_bytes_written;
+  unsigned long m_overflow_count;
+
+  uint8_t       m_frame_previous[ SHOWFILE_SLOTS_MAX ];
+  uint8_t       m_record[ SHOWFILE_RECORD_MAXSIZE ];
+
+  // Ring buffer between RecordFrame() & Flush()
+  uint8_t       m_write_buffer[ SHOWRECORDER_BUFFER_SIZE ];
+  size_t        m_write_head;
+  size_t        m_write_tail;
+  size_t        m_write_used;
+};
+
+#endif
@@ -0,0 +1,212 @@
+#include "SourceMerger.h"
+
+SourceMerger::SourceMerger() {
+  m_merge_mode = MERGEMODE::HTP;
+  this->Clear();
+}
+
+SourceMerger::~SourceMerger() {
+}
+
+void SourceMerger::Clear() {
+  memset( m_sources, 0, sizeof( m_sources ) );
+  memset( m_merged, 0, sizeof( m_merged ) );
+  m_ptr_merged          = m_merged;
+  m_merged_length       = 0;
+  m_cancel_pending      = false;
+  m_exclusive_ip        = 0;
+  m_exclusive_last_ms   = 0;
+  m_active_source_count = 0;
+  m_merge_time_us_last  = 0;
+  m_merge_time_us_max   = 0;
+}
+
+void SourceMerger::SetMergeMode( int merge_mode ) {
+  m_merge_mode = merge_mode;
+}
+
+bool SourceMerger::Update( uint32_t source_ip, const uint8_t* data, uint16_t length, unsigned long time_ms ) {
+  if( m_cancel_pending ) {
+    m_cancel_pending = false;
+    m_exclusive_ip   = source_ip;
+    for( MergeSource& source : m_sources ) {
+      if( source.m_source_ip != source_ip ) {
+        source.m_in_use = false;
+      }
+    }
+  }
+  if( m_exclusive_ip != 0 ) {
+    if( source_ip == m_exclusive_ip ) {
+      m_exclusive_last_ms = time_ms;
+    } else if( time_ms - m_exclusive_last_ms < MERGE_SOURCE_TIMEOUT_MS ) {
+      return false;
+    } else {
+      // Timed out, back to merging.
+      m_exclusive_ip = 0;
+    }
+  }
+
+  MergeSource* ptr_source = this->FindOrAddSource( source_ip, time_ms );
+  if( ptr_source == nullptr ) {
+    return false;
+  }
+
+  if( length > MERGE_CHANNELS_MAX ) {
+    length = MERGE_CHANNELS_MAX;
+  }
+
+  // Channels not sent by this source count as 0.
+  memcpy( ptr_source->m_data, data, length );
+  memset( &ptr_source->m_data[ length ], 0, MERGE_CHANNELS_MAX - length );
+  ptr_source->m_length  = length;
+  ptr_source->m_last_ms = time_ms;
+
+  this->Merge( ptr_source );
+
+  return true;
+}
+
+MergeSource* SourceMerger::FindOrAddSource( uint32_t source_ip, unsigned long time_ms ) {
+  MergeSource* ptr_source = nullptr;
+  MergeSource* ptr_free   = nullptr;
+
+  for( MergeSource& source : m_sources ) {
+    if( source.m_in_use && time_ms - source.m_last_ms >= MERGE_SOURCE_TIMEOUT_MS ) {
+      source.m_in_use = false;
+    }
+    if( source.m_in_use && source.m_source_ip == source_ip ) {
+      ptr_source = &source;
+    } else if( !source.m_in_use && ptr_free == nullptr ) {
+      ptr_free = &source;
+    }
+  }
+
+  if( ptr_source == nullptr && ptr_free != nullptr ) {
+    ptr_source = ptr_free;
+    ptr_source->m_in_use    = true;
+    ptr_source->m_source_ip = source_ip;
+    ptr_source->m_length    = 0;
+    ptr_source->m_last_ms   = time_ms;
+  }
+
+  return ptr_source;
+}
+
+void SourceMerger::Remove( uint32_t source_ip ) {
+  for( MergeSource& source : m_sources ) {
+    if( source.m_in_use && source.m_source_ip == source_ip ) {
+      source.m_in_use = false;
+      m_active_source_count--;
+      return;
+    }
+  }
+}
+
+void SourceMerger::CancelMerge() {
+  m_cancel_pending = true;
+}
+
+uint32_t SourceMerger::GetExclusiveSource() const {
+  return m_exclusive_ip;
+}
+
+const uint8_t* SourceMerger::GetMerged() const {
+  return m_ptr_merged;
+}
+
+uint16_t SourceMerger::GetMergedLength() const {
+  return m_merged_length;
+}
+
+int SourceMerger::GetActiveSourceCount() const {
+  return m_active_source_count;
+}
+
+unsigned long SourceMerger::GetMergeTimeUsLast() const {
+  return m_merge_time_us_last;
+}
+
+unsigned long SourceMerger::GetMergeTimeUsMax() const {
+  return m_merge_time_us_max;
+}
+
+void SourceMerger::Merge( MergeSource* ptr_latest ) {
+  unsigned long start_us = micros();
+
+  m_active_source_count = 0;
+  m_merged_length       = 0;
+
+  if( m_merge_mode == MERGEMODE::LTP ) {
+    for( const MergeSource& source : m_sources ) {
+      if( source.m_in_use ) {
+        m_active_source_count++;
+      }
+    }
+    m_ptr_merged    = ptr_latest->m_data;
+    m_merged_length = ptr_latest->m_length;
+  } else {
+    const MergeSource* ptr_first = nullptr;
+    for( const MergeSource& source : m_sources ) {
+      if( !source.m_in_use ) {
+        continue;
+      }
+      m_active_source_count++;
+      if( source.m_length > m_merged_length ) {
+        m_merged_length = source.m_length;
+      }
+      if( ptr_first == nullptr ) {
+        ptr_first = &source;
+      } else {
+        if( m_active_source_count == 2 ) {
+          memcpy( m_merged, ptr_first->m_data, MERGE_CHANNELS_MAX );
+        }
+        MergeHTP( m_merged, source.m_data, MERGE_CHANNELS_MAX );
+      }
+    }
+
+    // A single source is used directly without a copy.
+    m_ptr_merged = ( m_active_source_count == 1 ) ? ptr_first->m_data : m_merged;
+  }
+
+  m_merge_time_us_last = micros() - start_us;
+  if( m_merge_time_us_last > m_merge_time_us_max ) {
+    m_merge_time_us_max = m_merge_time_us_last;
+  }
+}
+
+void SourceMerger::MergeHTP( uint8_t* ptr_destination, const uint8_t* ptr_source, size_t length ) {
+  uint32_t*       ptr_a = (uint32_t*)ptr_destination;
+  const uint32_t* ptr_b = (const uint32_t*)ptr_source;
+
+  for( size_t i = 0; i < length / 4; i++ ) {
+    uint32_t a = ptr_a[ i ];
+    uint32_t b = ptr_b[ i ];
+
+    // Per byte, high bit set where a >= b.  The low 7 bits are compared with a subtract that can't borrow across bytes,
+    // the high bit decides when the high bits differ.
+    uint32_t low_compare   = ( a | 0x80808080 ) - ( b & 0x7F7F7F7F );
+    uint32_t a_ge_b        = ( ( a & ~b ) | ( ~( a ^ b ) & low_compare ) ) & 0x80808080;
+    uint32_t mask          = ( a_ge_b >> 7 ) * 0xFF;
+
+    ptr_a[ i ] = ( a & mask ) | ( b & ~mask );
+  }
+}
+
+unsigned long SourceMerger::BenchmarkHTP( int iterations ) {
+  // Uses the source buffers as scratch, so only run before any data is received.
+  for( int i = 0; i < MERGE_CHANNELS_MAX; i++ ) {
+    m_sources[ 0 ].m_data[ i ] = i;
+    m_sources[ 1 ].m_data[ i ] = 255 - i;
+  }
+
+  unsigned long start_us = micros();
+  for( int i = 0; i < iterations; i++ ) {
+    memcpy( m_merged, m_sources[ 0 ].m_data, MERGE_CHANNELS_MAX );
+    MergeHTP( m_merged, m_sources[ 1 ].m_data, MERGE_CHANNELS_MAX );
+  }
+  unsigned long elapsed_us = micros() - start_us;
+
+  this->Clear();
+
+  return ( elapsed_us * 1000UL ) / iterations;
+}
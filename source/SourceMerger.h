@@ -0,0 +1,76 @@
+#ifndef _SOURCEMERGER_H_
+#define _SOURCEMERGER_H_
+
+#include <Arduino.h>
+
+#define MERGE_SOURCES_MAX        4      // Sources merged into one universe, any more are ignored.
+#define MERGE_SOURCE_TIMEOUT_MS  10000  // Art-Net spec, a source not seen for 10 seconds is dropped from the merge.
+#define MERGE_CHANNELS_MAX       512
+
+enum MERGEMODE : int {
+  HTP = 0,  // Highest takes precedence, per channel.
+  LTP = 1,  // Latest takes precedence, the last received source.
+};
+
+struct MergeSource {
+  bool          m_in_use;
+  uint32_t      m_source_ip;
+  unsigned long m_last_ms;
+  uint16_t      m_length;
+  uint8_t       m_data[ MERGE_CHANNELS_MAX ] __attribute__( ( aligned( 4 ) ) );
+};
+
+// Keeps the last frame of each source for one universe & merges them.
+class SourceMerger {
+public:
+  SourceMerger();
+
+  ~SourceMerger();
+
+  void Clear();
+
+  void SetMergeMode( int merge_mode );
+
+  // Stores the frame from the source & merges all active sources.  Returns false if the source was ignored because there are already MERGE_SOURCES_MAX sources,
+  // or another source has the universe after CancelMerge().
+  bool Update( uint32_t source_ip, const uint8_t* data, uint16_t length, unsigned long time_ms );
+
+  // Drops the source from the merge, e.g. sACN stream terminated.  Takes effect on the next Update().
+  void Remove( uint32_t source_ip );
+
+  // ArtAddress cancel merge.  The next source to Update() becomes the only one, the others are ignored until it times out.
+  void CancelMerge();
+
+  // The source that has the universe after CancelMerge(), 0 if none.
+  uint32_t       GetExclusiveSource() const;
+
+  const uint8_t* GetMerged() const;
+  uint16_t       GetMergedLength() const;
+  int            GetActiveSourceCount() const;
+  unsigned long  GetMergeTimeUsLast() const;
+  unsigned long  GetMergeTimeUsMax() const;
+
+  // Times an HTP merge of 2 sources x 512 channels.  Returns nanoseconds per merge.
+  unsigned long  BenchmarkHTP( int iterations );
+
+  // Per channel max of 4 channels at a time.  Buffers must be 4 byte aligned & length a multiple of 4.
+  static void    MergeHTP( uint8_t* ptr_destination, const uint8_t* ptr_source, size_t length );
+
+private:
+  MergeSource* FindOrAddSource( uint32_t source_ip, unsigned long time_ms );
+  void         Merge( MergeSource* ptr_latest );
+
+  MergeSource    m_sources[ MERGE_SOURCES_MAX ];
+  uint8_t        m_merged[ MERGE_CHANNELS_MAX ] __attribute__( ( aligned( 4 ) ) );
+  const uint8_t* m_ptr_merged;
+  uint16_t       m_merged_length;
+  int            m_merge_mode;
+  bool           m_cancel_pending;
+  uint32_t       m_exclusive_ip;
+  unsigned long  m_exclusive_last_ms;
+  int            m_active_source_count;
+  unsigned long  m_merge_time_us_last;
+  unsigned long  m_merge_time_us_max;
+};
+
+#endif
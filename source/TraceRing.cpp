@@ -0,0 +1,97 @@
+#include "TraceRing.h"
+
+TraceRing::TraceRing() {
+  m_enabled = false;
+  m_frozen  = false;
+  this->Clear();
+  this->UpdateRecording();
+}
+
+TraceRing::~TraceRing() {
+}
+
+void TraceRing::Record( int event, int task, uint16_t arg ) {
+  if( !m_recording.load( std::memory_order_relaxed ) ) {
+    return;
+  }
+  this->RecordAt( micros(), event, task, arg );
+}
+
+void TraceRing::RecordAt( uint32_t time_us, int event, int task, uint16_t arg ) {
+  if( !m_recording.load( std::memory_order_relaxed ) ) {
+    return;
+  }
+  // Each producer owns the slot it took, so tasks preempting each other never write the same event.
+  TraceEvent& trace_event = m_events[ m_write_index.fetch_add( 1, std::memory_order_relaxed ) & ( TRACE_RING_EVENTS - 1 ) ];
+  trace_event.m_time_us = time_us;
+  trace_event.m_event   = event;
+  trace_event.m_task    = task;
+  trace_event.m_arg     = arg;
+}
+
+void TraceRing::SetEnabled( bool enabled ) {
+  m_enabled = enabled;
+  this->UpdateRecording();
+}
+
+void TraceRing::Freeze() {
+  m_frozen = true;
+  this->UpdateRecording();
+}
+
+void TraceRing::Resume() {
+  m_frozen = false;
+  this->UpdateRecording();
+}
+
+void TraceRing::Clear() {
+  m_write_index = 0;
+}
+
+uint32_t TraceRing::Benchmark( int iterations ) {
+  bool enabled = m_enabled;
+  bool frozen  = m_frozen;
+  m_enabled = true;
+  m_frozen  = false;
+  this->UpdateRecording();
+
+  unsigned long start_us = micros();
+  for( int i = 0; i < iterations; i++ ) {
+    this->Record( TRACE_PACKET_ARRIVAL, TRACE_TASK_LOOP, i );
+  }
+  unsigned long elapsed_us = micros() - start_us;
+
+  m_enabled = enabled;
+  m_frozen  = frozen;
+  this->UpdateRecording();
+  this->Clear();
+
+  return iterations > 0 ? elapsed_us * 1000 / iterations : 0;
+}
+
+bool TraceRing::IsEnabled() const {
+  return m_enabled;
+}
+
+bool TraceRing::IsFrozen() const {
+  return m_frozen;
+}
+
+unsigned long TraceRing::GetRecordedCount() const {
+  return m_write_index.load();
+}
+
+int TraceRing::GetEventCount() const {
+  uint32_t write_index = m_write_index.load();
+  return write_index < TRACE_RING_EVENTS ? write_index : TRACE_RING_EVENTS;
+}
+
+const TraceEvent& TraceRing::GetEvent( int index ) const {
+  uint32_t write_index = m_write_index.load();
+  uint32_t oldest      = write_index - this->GetEventCount();
+  return m_events[ ( oldest + index ) & ( TRACE_RING_EVENTS - 1 ) ];
+}
+
+void TraceRing::UpdateRecording() {
+  m_recording = m_enabled && !m_frozen;
+}
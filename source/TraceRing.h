@@ -0,0 +1,126 @@
+#ifndef _TRACERING_H_
+#define _TRACERING_H_
+
+#include <Arduino.h>
+#include <atomic>
+
+#define TRACE_RING_EVENTS          2048  // Must be a power of 2.  8 bytes each, a few seconds of a busy show.
+#define TRACE_WEB_REQUEST_MIN_US   200   // handleClient() without a request returns well within this.
+
+enum TRACEEVENT : int {
+  TRACE_PACKET_ARRIVAL     = 0,   // Datagram received by the network task, arg = length.
+  TRACE_PARSE_BEGIN        = 1,   // Datagram taken from the ring, arg = PacketRing tag.
+  TRACE_PARSE_END          = 2,
+  TRACE_UNIVERSE_MATCH     = 3,   // Accepted for output or the patch, arg = universe.
+  TRACE_MODS_BEGIN         = 4,   // arg = mods running.
+  TRACE_MODS_END           = 5,
+  TRACE_FRAME_HANDOFF      = 6,   // Frame published to the output, arg = slots.
+  TRACE_DMX_SEND_NUM       = 7,   // dmx_send_num() returned, arg = slots.
+  TRACE_DMX_WAIT_SENT      = 8,   // dmx_wait_sent() returned, arg = 1 if the line was free.
+  TRACE_WEB_REQUEST_BEGIN  = 9,
+  TRACE_WEB_REQUEST_END    = 10,
+  TRACE_FLASH_WRITE_BEGIN  = 11,
+  TRACE_FLASH_WRITE_END    = 12,  // arg = bytes.
+  TRACE_EVENT_COUNT        = 13,
+};
+
+enum TRACETASK : int {
+  TRACE_TASK_RECEIVE     = 0,
+  TRACE_TASK_LOOP        = 1,
+  TRACE_TASK_FRAME_TIMER = 2,
+  TRACE_TASK_COUNT       = 3,
+};
+
+inline const char* TraceEventAsString( int event ) {
+  switch( event ) {
+    case TRACE_PACKET_ARRIVAL:    return "packet arrival";
+    case TRACE_PARSE_BEGIN:
+    case TRACE_PARSE_END:         return "parse";
+    case TRACE_UNIVERSE_MATCH:    return "universe match";
+    case TRACE_MODS_BEGIN:
+    case TRACE_MODS_END:          return "channel mods";
+    case TRACE_FRAME_HANDOFF:     return "frame handoff";
+    case TRACE_DMX_SEND_NUM:      return "dmx_send_num";
+    case TRACE_DMX_WAIT_SENT:     return "dmx_wait_sent";
+    case TRACE_WEB_REQUEST_BEGIN:
+    case TRACE_WEB_REQUEST_END:   return "web request";
+    case TRACE_FLASH_WRITE_BEGIN:
+    case TRACE_FLASH_WRITE_END:   return "flash write";
+    default:                      return "unknown";
+  }
+};
+
+// Chrome trace-event phase, 'B' & 'E' for the two ends of a span, 'i' for an instant.
+inline char TraceEventPhase( int event ) {
+  switch( event ) {
+    case TRACE_PARSE_BEGIN:
+    case TRACE_MODS_BEGIN:
+    case TRACE_WEB_REQUEST_BEGIN:
+    case TRACE_FLASH_WRITE_BEGIN: return 'B';
+    case TRACE_PARSE_END:
+    case TRACE_MODS_END:
+    case TRACE_WEB_REQUEST_END:
+    case TRACE_FLASH_WRITE_END:   return 'E';
+    default:                      return 'i';
+  }
+};
+
+inline const char* TraceTaskAsString( int task ) {
+  switch( task ) {
+    case TRACE_TASK_RECEIVE:     return "network receive";
+    case TRACE_TASK_LOOP:        return "loop";
+    case TRACE_TASK_FRAME_TIMER: return "frame timer";
+    default:                     return "unknown";
+  }
+};
+
+struct TraceEvent {
+  uint32_t m_time_us;
+  uint8_t  m_event;   // TRACEEVENT
+  uint8_t  m_task;    // TRACETASK
+  uint16_t m_arg;
+};
+
+// Fixed size ring of timestamped events from the receive task, loop() & the frame timer.  Recording is a flag
+// check, an atomic index increment & one 8 byte store, so it can stay on during a show.  The oldest events are
+// overwritten until the ring is frozen, which keeps what led up to a glitch for the download.
+class TraceRing {
+public:
+  TraceRing();
+
+  ~TraceRing();
+
+  // Any task.
+  void Record( int event, int task, uint16_t arg );
+
+  // Any task, for events timed before they are recorded, e.g. a datagram's receive time.
+  void RecordAt( uint32_t time_us, int event, int task, uint16_t arg );
+
+  // loop() only.
+  void SetEnabled( bool enabled );
+  void Freeze();
+  void Resume();
+  void Clear();
+
+  // Cost of one Record(), in ns.  Clears the ring.
+  uint32_t Benchmark( int iterations );
+
+  bool          IsEnabled() const;
+  bool          IsFrozen() const;
+  unsigned long GetRecordedCount() const;
+
+  // Events held, oldest first.  Only while frozen, otherwise events are being overwritten.
+  int               GetEventCount() const;
+  const TraceEvent& GetEvent( int index ) const;
+
+private:
+  void UpdateRecording();
+
+  TraceEvent                   m_events[ TRACE_RING_EVENTS ];
+  std::atomic< uint32_t >      m_write_index;   // Free running, slot = index % TRACE_RING_EVENTS.
+  std::atomic< bool >          m_recording;     // Enabled & not frozen.
+  bool                         m_enabled;
+  bool                         m_frozen;
+};
+
+#endif
@@ -0,0 +1,357 @@
+#include "UdpSocket.h"
+
+#include <string.h>
+
+#if defined( __linux__ )
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#else
+#include <Arduino.h>
+#include <lwip/sockets.h>
+#include <lwip/stats.h>
+#endif
+
+UdpSocket::UdpSocket() {
+  m_socket              = -1;
+  m_receive_buffer_size = 0;
+  m_received_count      = 0;
+  m_truncated_count     = 0;
+  m_batch_count         = 0;
+  m_discarded_count     = 0;
+  m_drop_count          = 0;
+  m_drop_count_start    = 0;
+}
+
+UdpSocket::~UdpSocket() {
+  this->Stop();
+}
+
+bool UdpSocket::Begin( uint16_t port, int receive_buffer_size ) {
+  this->Stop();
+
+  m_socket = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+  if( m_socket < 0 ) {
+    return false;
+  }
+
+  int enable = 1;
+  setsockopt( m_socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof( enable ) );
+  setsockopt( m_socket, SOL_SOCKET, SO_BROADCAST, &enable, sizeof( enable ) );
+#if defined( __linux__ )
+  // Kernel drop counter is passed with each datagram.
+  setsockopt( m_socket, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof( enable ) );
+#endif
+
+  // The size granted is read back below, lwIP ignores this without LWIP_SO_RCVBUF.
+  if( receive_buffer_size > 0 ) {
+    setsockopt( m_socket, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size, sizeof( receive_buffer_size ) );
+  }
+
+  struct sockaddr_in address;
+  memset( &address, 0, sizeof( address ) );
+  address.sin_family      = AF_INET;
+  address.sin_port        = htons( port );
+  address.sin_addr.s_addr = htonl( INADDR_ANY );
+
+  if( bind( m_socket, (struct sockaddr*)&address, sizeof( address ) ) != 0 ) {
+    this->Stop();
+    return false;
+  }
+
+  fcntl( m_socket, F_SETFL, fcntl( m_socket, F_GETFL, 0 ) | O_NONBLOCK );
+
+  socklen_t option_length = sizeof( m_receive_buffer_size );
+  if( getsockopt( m_socket, SOL_SOCKET, SO_RCVBUF, &m_receive_buffer_size, &option_length ) != 0 ) {
+    m_receive_buffer_size = 0;
+  }
+
+  m_received_count  = 0;
+  m_truncated_count = 0;
+  m_batch_count     = 0;
+  m_discarded_count = 0;
+  m_drop_count      = 0;
+#if !defined( __linux__ ) && LWIP_STATS && UDP_STATS
+  m_drop_count_start = lwip_stats.udp.drop;
+#endif
+
+  return true;
+}
+
+bool UdpSocket::JoinMulticast( uint32_t multicast_ip ) {
+  if( m_socket < 0 ) {
+    return false;
+  }
+
+  struct ip_mreq request;
+  memset( &request, 0, sizeof( request ) );
+  request.imr_multiaddr.s_addr = multicast_ip;
+  request.imr_interface.s_addr = htonl( INADDR_ANY );
+
+  return setsockopt( m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, sizeof( request ) ) == 0;
+}
+
+void UdpSocket::Stop() {
+  if( m_socket < 0 ) {
+    return;
+  }
+  close( m_socket );
+  m_socket = -1;
+}
+
+bool UdpSocket::IsOpen() const {
+  return m_socket >= 0;
+}
+
+#if defined( __linux__ )
+
+int UdpSocket::ReceiveBatch( UdpDatagram* ptr_datagrams, int count ) {
+  if( m_socket < 0 ) {
+    return 0;
+  }
+  if( count > UDP_SOCKET_BATCH_MAX ) {
+    count = UDP_SOCKET_BATCH_MAX;
+  }
+
+  struct mmsghdr     messages[ UDP_SOCKET_BATCH_MAX ];
+  struct iovec       buffers[ UDP_SOCKET_BATCH_MAX ];
+  struct sockaddr_in addresses[ UDP_SOCKET_BATCH_MAX ];
+  uint8_t            controls[ UDP_SOCKET_BATCH_MAX ][ CMSG_SPACE( sizeof( uint32_t ) ) ];
+
+  memset( messages, 0, sizeof( messages[ 0 ] ) * count );
+  for( int i = 0; i < count; i++ ) {
+    buffers[ i ].iov_base = ptr_datagrams[ i ].m_ptr_buffer;
+    buffers[ i ].iov_len  = ptr_datagrams[ i ].m_buffer_size;
+    messages[ i ].msg_hdr.msg_name       = &addresses[ i ];
+    messages[ i ].msg_hdr.msg_namelen    = sizeof( addresses[ i ] );
+    messages[ i ].msg_hdr.msg_iov        = &buffers[ i ];
+    messages[ i ].msg_hdr.msg_iovlen     = 1;
+    messages[ i ].msg_hdr.msg_control    = controls[ i ];
+    messages[ i ].msg_hdr.msg_controllen = sizeof( controls[ i ] );
+  }
+
+  int received = recvmmsg( m_socket, messages, count, MSG_DONTWAIT, nullptr );
+  if( received <= 0 ) {
+    return 0;
+  }
+
+  unsigned long received_us = TimeUs();
+
+  for( int i = 0; i < received; i++ ) {
+    UdpDatagram& datagram = ptr_datagrams[ i ];
+    datagram.m_length      = messages[ i ].msg_len;
+    datagram.m_truncated   = ( messages[ i ].msg_hdr.msg_flags & MSG_TRUNC ) != 0;
+    datagram.m_source_ip   = addresses[ i ].sin_addr.s_addr;
+    datagram.m_source_port = ntohs( addresses[ i ].sin_port );
+    datagram.m_received_us = received_us;
+
+    for( struct cmsghdr* ptr_control = CMSG_FIRSTHDR( &messages[ i ].msg_hdr ); ptr_control != nullptr; ptr_control = CMSG_NXTHDR( &messages[ i ].msg_hdr, ptr_control ) ) {
+      if( ptr_control->cmsg_level == SOL_SOCKET && ptr_control->cmsg_type == SO_RXQ_OVFL ) {
+        uint32_t drop_count;
+        memcpy( &drop_count, CMSG_DATA( ptr_control ), sizeof( drop_count ) );
+        m_drop_count = drop_count;
+      }
+    }
+
+    if( datagram.m_truncated ) {
+      m_truncated_count++;
+    }
+  }
+
+  m_received_count += received;
+  m_batch_count++;
+
+  return received;
+}
+
+#else
+
+int UdpSocket::ReceiveBatch( UdpDatagram* ptr_datagrams, int count ) {
+  if( m_socket < 0 ) {
+    return 0;
+  }
+  if( count > UDP_SOCKET_BATCH_MAX ) {
+    count = UDP_SOCKET_BATCH_MAX;
+  }
+
+  // lwIP has no recvmmsg, but each recvmsg() copies the datagram once from the pbuf into the buffer.
+  int received = 0;
+  while( received < count ) {
+    UdpDatagram&       datagram = ptr_datagrams[ received ];
+    struct sockaddr_in address;
+    struct iovec       buffer;
+    struct msghdr      message;
+
+    buffer.iov_base = datagram.m_ptr_buffer;
+    buffer.iov_len  = datagram.m_buffer_size;
+    memset( &message, 0, sizeof( message ) );
+    message.msg_name    = &address;
+    message.msg_namelen = sizeof( address );
+    message.msg_iov     = &buffer;
+    message.msg_iovlen  = 1;
+
+    int length = recvmsg( m_socket, &message, MSG_DONTWAIT );
+    if( length < 0 ) {
+      break;
+    }
+
+    datagram.m_length      = length;
+    datagram.m_truncated   = ( message.msg_flags & MSG_TRUNC ) != 0;
+    datagram.m_source_ip   = address.sin_addr.s_addr;
+    datagram.m_source_port = ntohs( address.sin_port );
+    datagram.m_received_us = TimeUs();
+
+    if( datagram.m_truncated ) {
+      m_truncated_count++;
+    }
+    received++;
+  }
+
+  if( received > 0 ) {
+    m_received_count += received;
+    m_batch_count++;
+  }
+
+  return received;
+}
+
+#endif
+
+int UdpSocket::Peek( uint8_t* ptr_buffer, size_t buffer_size, uint32_t* ptr_source_ip ) {
+  if( m_socket < 0 ) {
+    return -1;
+  }
+
+  struct sockaddr_in address;
+  socklen_t          address_length = sizeof( address );
+
+  int length = recvfrom( m_socket, ptr_buffer, buffer_size, MSG_PEEK | MSG_DONTWAIT, (struct sockaddr*)&address, &address_length );
+  if( length < 0 ) {
+    return -1;
+  }
+
+  *ptr_source_ip = address.sin_addr.s_addr;
+  return length;
+}
+
+void UdpSocket::Discard() {
+  if( m_socket < 0 ) {
+    return;
+  }
+
+  uint8_t byte;
+  if( recv( m_socket, &byte, 1, MSG_DONTWAIT ) >= 0 ) {
+    m_discarded_count++;
+  }
+}
+
+bool UdpSocket::WaitForData( UdpSocket** ptr_sockets, int count, int timeout_ms ) {
+  fd_set read_set;
+  FD_ZERO( &read_set );
+
+  int socket_max = -1;
+  for( int i = 0; i < count; i++ ) {
+    if( ptr_sockets[ i ]->m_socket >= 0 ) {
+      FD_SET( ptr_sockets[ i ]->m_socket, &read_set );
+      if( ptr_sockets[ i ]->m_socket > socket_max ) {
+        socket_max = ptr_sockets[ i ]->m_socket;
+      }
+    }
+  }
+  if( socket_max < 0 ) {
+    return false;
+  }
+
+  struct timeval timeout;
+  timeout.tv_sec  = timeout_ms / 1000;
+  timeout.tv_usec = ( timeout_ms % 1000 ) * 1000;
+
+  return select( socket_max + 1, &read_set, nullptr, nullptr, &timeout ) > 0;
+}
+
+bool UdpSocket::SendTo( uint32_t ip, uint16_t port, const uint8_t* data, size_t length ) {
+  if( m_socket < 0 ) {
+    return false;
+  }
+
+  struct sockaddr_in address;
+  memset( &address, 0, sizeof( address ) );
+  address.sin_family      = AF_INET;
+  address.sin_port        = htons( port );
+  address.sin_addr.s_addr = ip;
+
+  return sendto( m_socket, data, length, 0, (struct sockaddr*)&address, sizeof( address ) ) == (int)length;
+}
+
+bool UdpSocket::SendTo( uint32_t ip, uint16_t port, const uint8_t* header, size_t header_length, const uint8_t* data, size_t length ) {
+  if( m_socket < 0 ) {
+    return false;
+  }
+
+  struct sockaddr_in address;
+  memset( &address, 0, sizeof( address ) );
+  address.sin_family      = AF_INET;
+  address.sin_port        = htons( port );
+  address.sin_addr.s_addr = ip;
+
+  struct iovec buffers[ 2 ];
+  buffers[ 0 ].iov_base = (void*)header;
+  buffers[ 0 ].iov_len  = header_length;
+  buffers[ 1 ].iov_base = (void*)data;
+  buffers[ 1 ].iov_len  = length;
+
+  struct msghdr message;
+  memset( &message, 0, sizeof( message ) );
+  message.msg_name    = &address;
+  message.msg_namelen = sizeof( address );
+  message.msg_iov     = buffers;
+  message.msg_iovlen  = 2;
+
+  return sendmsg( m_socket, &message, 0 ) == (int)( header_length + length );
+}
+
+int UdpSocket::GetReceiveBufferSize() const {
+  return m_receive_buffer_size;
+}
+
+unsigned long UdpSocket::GetReceivedCount() const {
+  return m_received_count;
+}
+
+unsigned long UdpSocket::GetTruncatedCount() const {
+  return m_truncated_count;
+}
+
+unsigned long UdpSocket::GetBatchCount() const {
+  return m_batch_count;
+}
+
+unsigned long UdpSocket::GetDiscardedCount() const {
+  return m_discarded_count;
+}
+
+bool UdpSocket::GetDropCount( unsigned long* ptr_drop_count ) const {
+#if defined( __linux__ )
+  *ptr_drop_count = m_drop_count;
+  return true;
+#elif LWIP_STATS && UDP_STATS
+  *ptr_drop_count = lwip_stats.udp.drop - m_drop_count_start;
+  return true;
+#else
+  *ptr_drop_count = 0;
+  return false;
+#endif
+}
+
+unsigned long UdpSocket::TimeUs() {
+#if defined( __linux__ )
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (unsigned long)now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+#else
+  return micros();
+#endif
+}
@@ -0,0 +1,79 @@
+#ifndef _UDPSOCKET_H_
+#define _UDPSOCKET_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define UDP_SOCKET_BATCH_MAX  8     // Most datagrams taken by one ReceiveBatch().
+
+// One datagram of a batch.  m_ptr_buffer & m_buffer_size are set by the caller, the rest by ReceiveBatch().
+struct UdpDatagram {
+  uint8_t*      m_ptr_buffer;       // Staging buffer the datagram is received straight into.
+  size_t        m_buffer_size;
+  int           m_length;           // Bytes received into m_ptr_buffer.
+  bool          m_truncated;        // Datagram was larger than m_buffer_size, the rest is lost.
+  uint32_t      m_source_ip;        // Network order, same as (uint32_t)IPAddress.
+  uint16_t      m_source_port;
+  unsigned long m_received_us;
+};
+
+// Non-blocking UDP socket on the BSD socket API.  Datagrams are received in batches straight into the caller's
+// buffers, without the extra buffer & copy of WiFiUDP.  Uses lwIP on the ESP32 & recvmmsg() on Linux.
+class UdpSocket {
+public:
+  UdpSocket();
+
+  ~UdpSocket();
+
+  // receive_buffer_size = SO_RCVBUF in bytes, 0 keeps the stack default.
+  bool Begin( uint16_t port, int receive_buffer_size );
+
+  // multicast_ip in network order.
+  bool JoinMulticast( uint32_t multicast_ip );
+
+  void Stop();
+
+  bool IsOpen() const;
+
+  // Returns the number of datagrams received, 0 if none are waiting.
+  int  ReceiveBatch( UdpDatagram* ptr_datagrams, int count );
+
+  // Copies up to buffer_size bytes from the start of the next datagram & leaves it waiting.  Returns the bytes
+  // copied, -1 if none is waiting.
+  int  Peek( uint8_t* ptr_buffer, size_t buffer_size, uint32_t* ptr_source_ip );
+
+  // Takes the next datagram with a 1 byte receive, the stack frees the rest without copying it.
+  void Discard();
+
+  // Blocks until any of the open sockets has a datagram waiting, or timeout_ms.  Returns false on timeout.
+  static bool WaitForData( UdpSocket** ptr_sockets, int count, int timeout_ms );
+
+  bool SendTo( uint32_t ip, uint16_t port, const uint8_t* data, size_t length );
+
+  // Sends header & data as one datagram, without copying them into one buffer first.
+  bool SendTo( uint32_t ip, uint16_t port, const uint8_t* header, size_t header_length, const uint8_t* data, size_t length );
+
+  int           GetReceiveBufferSize() const;   // As granted by the stack.
+  unsigned long GetReceivedCount() const;
+  unsigned long GetTruncatedCount() const;
+  unsigned long GetBatchCount() const;          // ReceiveBatch() calls that returned datagrams.
+  unsigned long GetDiscardedCount() const;
+
+  // Datagrams dropped by the stack because the receive buffer was full.  On lwIP this is the UDP drop counter
+  // of the whole stack, & only available with LWIP_STATS.  Returns false if not available.
+  bool          GetDropCount( unsigned long* ptr_drop_count ) const;
+
+private:
+  static unsigned long TimeUs();
+
+  int           m_socket;
+  int           m_receive_buffer_size;
+  unsigned long m_received_count;
+  unsigned long m_truncated_count;
+  unsigned long m_batch_count;
+  unsigned long m_discarded_count;
+  unsigned long m_drop_count;
+  unsigned long m_drop_count_start;
+};
+
+#endif
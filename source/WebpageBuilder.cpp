@@ -211,6 +211,28 @@ void WebpageBuilder::AddFileDownloadLink( const String& filename, const String&
   m_html += "<li><a href=\"/download?file=" + filename + "\">" + text + "</a></li>";
 }
 
-void WebpageBuilder::AddFileUpload() {
-  m_html += "<form action='/upload' method='post' enctype='multipart/form-data'><input type='file' name='file'><input type='submit' value='Upload'></form>";
+void WebpageBuilder::AddFileUpload( const String& action ) {
+  m_html += "<form action='" + action + "' method='post' enctype='multipart/form-data'><input type='file' name='file'><input type='submit' value='Upload'></form>";
+}
+
+void WebpageBuilder::AddChannelMonitor( int websocket_port ) {
+  m_html += "<style>.monitor {display: grid; grid-template-columns: repeat(16, 1fr); gap: 1px; font-family: monospace; font-size: 12px;}";
+  m_html += ".monitor > div {background-color: #f2f2f2; text-align: center; padding: 2px;}</style>";
+  m_html += "<button onclick=\"monitorShow('both')\">BOTH</button> <button onclick=\"monitorShow('input')\">INPUT</button> <button onclick=\"monitorShow('output')\">OUTPUT</button>";
+  m_html += "<p id='monitor_status'>Connecting</p>";
+  m_html += "<h3>Input</h3><div id='monitor_0' class='monitor'></div><h3>Output</h3><div id='monitor_1' class='monitor'></div>";
+  m_html += "<script>";
+  m_html += "var cells = [ [], [] ], updates = 0, bytes = 0;";
+  m_html += "for( var s = 0; s < 2; s++ ) { var grid = document.getElementById( 'monitor_' + s ); for( var i = 0; i < 512; i++ ) { var cell = document.createElement( 'div' ); cell.title = 'Channel ' + ( i + 1 ); cell.textContent = '-'; grid.appendChild( cell ); cells[ s ].push( cell ); } }";
+  m_html += "function monitorClear() { for( var s = 0; s < 2; s++ ) { for( var i = 0; i < 512; i++ ) { cells[ s ][ i ].textContent = '-'; } } }";
+  m_html += "var ws = new WebSocket( 'ws://' + location.hostname + ':" + String( websocket_port ) + "/' ); ws.binaryType = 'arraybuffer';";
+  // Messages are described in ChannelMonitor.h.
+  m_html += "ws.onmessage = function( e ) { var v = new DataView( e.data ), p = 3; updates++; bytes += e.data.byteLength;";
+  m_html += " while( p + 6 <= v.byteLength ) { var s = v.getUint8( p ), full = v.getUint8( p + 1 ) & 1, length = v.getUint16( p + 2, true ), runs = v.getUint16( p + 4, true ); p += 6;";
+  m_html += "  if( full ) { for( var i = 0; i < 512; i++ ) { cells[ s ][ i ].textContent = ( i < length ) ? '0' : '-'; } }";
+  m_html += "  for( var r = 0; r < runs; r++ ) { var first = v.getUint16( p, true ), count = v.getUint16( p + 2, true ); p += 4; for( var i = 0; i < count; i++ ) { cells[ s ][ first + i ].textContent = v.getUint8( p + i ); } p += count; } } };";
+  m_html += "ws.onclose = function() { document.getElementById( 'monitor_status' ).textContent = 'Disconnected, the monitor may be off or in use by too many browsers.'; updates = -1; };";
+  m_html += "setInterval( function() { if( updates >= 0 ) { document.getElementById( 'monitor_status' ).textContent = updates + ' updates/s, ' + bytes + ' bytes/s'; updates = 0; bytes = 0; } }, 1000 );";
+  m_html += "function monitorShow( streams ) { monitorClear(); ws.send( streams ); }";
+  m_html += "</script>";
 }
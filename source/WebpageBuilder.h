@@ -80,7 +80,10 @@ public:
 
   void AddFileDownloadLink( const String& filename, const String& text );
 
-  void AddFileUpload();
+  void AddFileUpload( const String& action );
+
+  // Input & output grids of 512 channels, updated from the channel monitor's WebSocket.
+  void AddChannelMonitor( int websocket_port );
 
   String m_html;
 
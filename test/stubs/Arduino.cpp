@@ -0,0 +1,172 @@
+#include <Arduino.h>
+#include <ctype.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <time.h>
+
+HardwareSerial Serial;
+EspClass       ESP;
+
+static std::atomic< bool >     s_clock_set( false );
+static std::atomic< uint64_t > s_clock_us( 0 );
+
+static uint64_t ClockUs() {
+  if( s_clock_set.load() ) {
+    return s_clock_us.load();
+  }
+  // Same clock as UdpSocket::TimeUs() on Linux, so datagram times compare with micros().
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (uint64_t)now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+void HostClockSet( uint64_t time_us ) {
+  s_clock_us.store( time_us );
+  s_clock_set.store( true );
+}
+
+unsigned long millis() {
+  return ClockUs() / 1000;
+}
+
+unsigned long micros() {
+  return ClockUs();
+}
+
+void delay( unsigned long ms ) {
+  std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+}
+
+void delayMicroseconds( unsigned int us ) {
+  std::this_thread::sleep_for( std::chrono::microseconds( us ) );
+}
+
+// Fixed seed, so a failing run repeats.
+static std::mt19937 s_generator( 1 );
+
+uint32_t esp_random() {
+  return s_generator();
+}
+
+long random( long max ) {
+  return max > 0 ? (long)( s_generator() % max ) : 0;
+}
+
+long random( long min, long max ) {
+  return max > min ? min + random( max - min ) : min;
+}
+
+void randomSeed( unsigned long seed ) {
+  s_generator.seed( seed );
+}
+
+size_t strlcpy( char* ptr_destination, const char* ptr_source, size_t size ) {
+  size_t length = strlen( ptr_source );
+  if( size > 0 ) {
+    size_t copy = ( length < size - 1 ) ? length : size - 1;
+    memcpy( ptr_destination, ptr_source, copy );
+    ptr_destination[ copy ] = 0;
+  }
+  return length;
+}
+
+int xTaskCreate( void ( *ptr_task )( void* ), const char*, uint32_t, void* ptr_parameters, unsigned int, TaskHandle_t* ptr_handle ) {
+  // Tasks never return, the thread ends with the process.
+  std::thread task( ptr_task, ptr_parameters );
+  if( ptr_handle != nullptr ) {
+    *ptr_handle = (TaskHandle_t)(uintptr_t)task.native_handle();
+  }
+  task.detach();
+  return 1;
+}
+
+void vTaskDelay( TickType_t ticks ) {
+  std::this_thread::sleep_for( std::chrono::milliseconds( ticks ) );
+}
+
+// String
+
+bool String::endsWith( const String& other ) const {
+  return m_text.size() >= other.m_text.size() && m_text.compare( m_text.size() - other.m_text.size(), other.m_text.size(), other.m_text ) == 0;
+}
+
+String String::substring( unsigned int start ) const {
+  return start < m_text.size() ? String( m_text.substr( start ) ) : String();
+}
+
+String String::substring( unsigned int start, unsigned int end ) const {
+  if( end > m_text.size() ) {
+    end = m_text.size();
+  }
+  return start < end ? String( m_text.substr( start, end - start ) ) : String();
+}
+
+void String::trim() {
+  size_t start = m_text.find_first_not_of( " \t\r\n" );
+  if( start == std::string::npos ) {
+    m_text.clear();
+    return;
+  }
+  m_text = m_text.substr( start, m_text.find_last_not_of( " \t\r\n" ) - start + 1 );
+}
+
+void String::replace( const String& from, const String& to ) {
+  if( from.m_text.empty() ) {
+    return;
+  }
+  size_t position = 0;
+  while( ( position = m_text.find( from.m_text, position ) ) != std::string::npos ) {
+    m_text.replace( position, from.m_text.size(), to.m_text );
+    position += to.m_text.size();
+  }
+}
+
+void String::toUpperCase() {
+  for( char& c : m_text ) {
+    c = toupper( (unsigned char)c );
+  }
+}
+
+void String::toCharArray( char* ptr_buffer, unsigned int size ) const {
+  strlcpy( ptr_buffer, m_text.c_str(), size );
+}
+
+std::string String::FromNumber( long long value, int base ) {
+  if( base != HEX ) {
+    return std::to_string( value );
+  }
+  char text[ 24 ];
+  snprintf( text, sizeof( text ), "%llx", (unsigned long long)value );
+  return text;
+}
+
+std::string String::FromFloat( double value, unsigned int decimals ) {
+  char text[ 64 ];
+  snprintf( text, sizeof( text ), "%.*f", (int)decimals, value );
+  return text;
+}
+
+// IPAddress
+
+bool IPAddress::fromString( const char* ptr_text ) {
+  unsigned int bytes[ 4 ];
+  char         end;
+  if( sscanf( ptr_text, "%u.%u.%u.%u%c", &bytes[ 0 ], &bytes[ 1 ], &bytes[ 2 ], &bytes[ 3 ], &end ) != 4 ) {
+    return false;
+  }
+  for( int i = 0; i < 4; i++ ) {
+    if( bytes[ i ] > 255 ) {
+      return false;
+    }
+    m_bytes[ i ] = bytes[ i ];
+  }
+  return true;
+}
+
+String IPAddress::toString() const {
+  char text[ 16 ];
+  snprintf( text, sizeof( text ), "%u.%u.%u.%u", m_bytes[ 0 ], m_bytes[ 1 ], m_bytes[ 2 ], m_bytes[ 3 ] );
+  return String( text );
+}
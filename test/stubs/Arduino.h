@@ -0,0 +1,205 @@
+#ifndef _ARDUINO_STUB_H_
+#define _ARDUINO_STUB_H_
+
+// The parts of the Arduino core & ESP-IDF the host tests build against.  Time comes from the host's monotonic
+// clock, the same clock UdpSocket stamps datagrams with, unless a test sets it with HostClockSet().  FreeRTOS
+// tasks are host threads.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#define IRAM_ATTR
+#define HEX  16
+#define DEC  10
+
+#define constrain( amount, low, high ) ( ( amount ) < ( low ) ? ( low ) : ( ( amount ) > ( high ) ? ( high ) : ( amount ) ) )
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+
+class String {
+public:
+  String() {}
+  String( const char* ptr_text ) : m_text( ptr_text != nullptr ? ptr_text : "" ) {}
+  String( const std::string& text ) : m_text( text ) {}
+  String( char c ) : m_text( 1, c ) {}
+  String( int value, int base = DEC ) : m_text( FromNumber( value, base ) ) {}
+  String( unsigned int value, int base = DEC ) : m_text( FromNumber( value, base ) ) {}
+  String( long value, int base = DEC ) : m_text( FromNumber( value, base ) ) {}
+  String( unsigned long value, int base = DEC ) : m_text( FromNumber( value, base ) ) {}
+  String( long long value ) : m_text( std::to_string( value ) ) {}
+  String( unsigned long long value ) : m_text( std::to_string( value ) ) {}
+  String( float value, unsigned int decimals = 2 ) : m_text( FromFloat( value, decimals ) ) {}
+  String( double value, unsigned int decimals = 2 ) : m_text( FromFloat( value, decimals ) ) {}
+
+  String& operator+=( const String& other ) { m_text += other.m_text; return *this; }
+  String& operator+=( const char* ptr_text ) { m_text += ptr_text; return *this; }
+  String& operator+=( char c ) { m_text += c; return *this; }
+  String& operator+=( int value ) { m_text += std::to_string( value ); return *this; }
+  String& operator+=( unsigned int value ) { m_text += std::to_string( value ); return *this; }
+  String& operator+=( long value ) { m_text += std::to_string( value ); return *this; }
+  String& operator+=( unsigned long value ) { m_text += std::to_string( value ); return *this; }
+
+  bool operator==( const String& other ) const { return m_text == other.m_text; }
+  bool operator==( const char* ptr_text ) const { return m_text == ptr_text; }
+  bool operator!=( const String& other ) const { return m_text != other.m_text; }
+  bool operator!=( const char* ptr_text ) const { return m_text != ptr_text; }
+  char operator[]( unsigned int index ) const { return index < m_text.size() ? m_text[ index ] : 0; }
+
+  unsigned int length() const { return m_text.size(); }
+  const char*  c_str() const { return m_text.c_str(); }
+  bool         isEmpty() const { return m_text.empty(); }
+  bool         equals( const String& other ) const { return m_text == other.m_text; }
+  bool         startsWith( const String& other ) const { return m_text.compare( 0, other.m_text.size(), other.m_text ) == 0; }
+  bool         endsWith( const String& other ) const;
+  String       substring( unsigned int start ) const;
+  String       substring( unsigned int start, unsigned int end ) const;
+  int          indexOf( char c, unsigned int start = 0 ) const { return Position( m_text.find( c, start ) ); }
+  int          indexOf( const String& other, unsigned int start = 0 ) const { return Position( m_text.find( other.m_text, start ) ); }
+  int          lastIndexOf( char c ) const { return Position( m_text.rfind( c ) ); }
+  long         toInt() const { return atol( m_text.c_str() ); }
+  float        toFloat() const { return atof( m_text.c_str() ); }
+  void         trim();
+  void         replace( const String& from, const String& to );
+  void         reserve( unsigned int size ) { m_text.reserve( size ); }
+  void         toUpperCase();
+  void         getBytes( unsigned char* ptr_buffer, unsigned int size ) const { this->toCharArray( (char*)ptr_buffer, size ); }
+  void         toCharArray( char* ptr_buffer, unsigned int size ) const;
+
+private:
+  static std::string FromNumber( long long value, int base );
+  static std::string FromFloat( double value, unsigned int decimals );
+  static int         Position( size_t position ) { return position == std::string::npos ? -1 : (int)position; }
+
+  std::string m_text;
+};
+
+inline String operator+( const String& left, const String& right ) { String result( left ); result += right; return result; }
+inline String operator+( const String& left, const char* right ) { String result( left ); result += right; return result; }
+inline String operator+( const char* left, const String& right ) { String result( left ); result += right; return result; }
+inline String operator+( const String& left, char right ) { String result( left ); result += right; return result; }
+inline String operator+( const String& left, int right ) { String result( left ); result += right; return result; }
+inline String operator+( const String& left, unsigned int right ) { String result( left ); result += right; return result; }
+inline String operator+( const String& left, long right ) { String result( left ); result += right; return result; }
+inline String operator+( const String& left, unsigned long right ) { String result( left ); result += right; return result; }
+
+// Network order, same as the ESP32 core: ( (uint32_t)ip ) bytes are a.b.c.d in memory.
+class IPAddress {
+public:
+  IPAddress() { memset( m_bytes, 0, sizeof( m_bytes ) ); }
+  IPAddress( uint8_t a, uint8_t b, uint8_t c, uint8_t d ) { m_bytes[ 0 ] = a; m_bytes[ 1 ] = b; m_bytes[ 2 ] = c; m_bytes[ 3 ] = d; }
+  IPAddress( uint32_t address ) { memcpy( m_bytes, &address, sizeof( m_bytes ) ); }
+
+  bool    fromString( const char* ptr_text );
+  bool    fromString( const String& text ) { return this->fromString( text.c_str() ); }
+  String  toString() const;
+
+  operator uint32_t() const { uint32_t address; memcpy( &address, m_bytes, sizeof( address ) ); return address; }
+  bool     operator==( const IPAddress& other ) const { return memcmp( m_bytes, other.m_bytes, sizeof( m_bytes ) ) == 0; }
+  bool     operator!=( const IPAddress& other ) const { return !( *this == other ); }
+  uint8_t  operator[]( int index ) const { return m_bytes[ index ]; }
+  uint8_t& operator[]( int index ) { return m_bytes[ index ]; }
+
+private:
+  uint8_t m_bytes[ 4 ];
+};
+
+// Output is dropped, the host tests print their own results.
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write( uint8_t ) { return 1; }
+  virtual size_t write( const uint8_t*, size_t size ) { return size; }
+  size_t write( const char* ptr_text ) { return strlen( ptr_text ); }
+  size_t print( const String& text ) { return text.length(); }
+  size_t print( const char* ptr_text ) { return strlen( ptr_text ); }
+  size_t print( const IPAddress& ) { return 0; }
+  size_t print( int, int = DEC ) { return 0; }
+  size_t println( const String& text ) { return text.length() + 1; }
+  size_t println( const char* ptr_text ) { return strlen( ptr_text ) + 1; }
+  size_t println( const IPAddress& ) { return 0; }
+  size_t println() { return 1; }
+  size_t printf( const char*, ... ) __attribute__( ( format( printf, 2, 3 ) ) ) { return 0; }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+};
+
+class HardwareSerial : public Stream {
+public:
+  void   begin( unsigned long ) {}
+  size_t availableForWrite() { return 1024; }
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return 200000; }
+  uint32_t getMinFreeHeap() { return 200000; }
+  uint32_t getMaxAllocHeap() { return 100000; }
+  uint32_t getHeapSize() { return 300000; }
+};
+
+extern EspClass ESP;
+
+unsigned long millis();
+
+unsigned long micros();
+
+void delay( unsigned long ms );
+
+void delayMicroseconds( unsigned int us );
+
+uint32_t esp_random();
+
+long random( long max );
+
+long random( long min, long max );
+
+void randomSeed( unsigned long seed );
+
+size_t strlcpy( char* ptr_destination, const char* ptr_source, size_t size );
+
+// Host only.  From the first call millis() & micros() return the time set here, & only move when it's set again.
+void HostClockSet( uint64_t time_us );
+
+// FreeRTOS, 1 tick = 1 ms.  A task is a detached host thread.
+typedef void*        TaskHandle_t;
+typedef uint32_t     TickType_t;
+
+#define pdMS_TO_TICKS( ms ) ( (TickType_t)( ms ) )
+
+int  xTaskCreate( void ( *ptr_task )( void* ), const char* ptr_name, uint32_t stack_size, void* ptr_parameters, unsigned int priority, TaskHandle_t* ptr_handle );
+
+void vTaskDelay( TickType_t ticks );
+
+// Spinlock, as on a dual core ESP32.
+typedef struct {
+  int m_locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED portMUX_TYPE{ 0 }
+
+inline void portENTER_CRITICAL( portMUX_TYPE* ptr_mux ) {
+  while( __atomic_exchange_n( &ptr_mux->m_locked, 1, __ATOMIC_ACQUIRE ) ) {
+  }
+}
+
+inline void portEXIT_CRITICAL( portMUX_TYPE* ptr_mux ) {
+  __atomic_store_n( &ptr_mux->m_locked, 0, __ATOMIC_RELEASE );
+}
+
+#endif
@@ -0,0 +1,272 @@
+#include <ArduinoJson.h>
+
+#define JSON_NESTING_MAX  32
+
+JsonVariant JsonVariant::operator[]( const char* ptr_key ) const {
+  if( m_ptr_node == nullptr || m_ptr_node->m_type != JsonNode::JSON_OBJECT ) {
+    return JsonVariant();
+  }
+  for( size_t i = 0; i < m_ptr_node->m_keys.size(); i++ ) {
+    if( m_ptr_node->m_keys[ i ] == ptr_key ) {
+      return JsonVariant( &m_ptr_node->m_elements[ i ] );
+    }
+  }
+  return JsonVariant();
+}
+
+JsonVariant JsonVariant::operator[]( int index ) const {
+  if( m_ptr_node == nullptr || m_ptr_node->m_type != JsonNode::JSON_ARRAY || index < 0 || index >= (int)m_ptr_node->m_elements.size() ) {
+    return JsonVariant();
+  }
+  return JsonVariant( &m_ptr_node->m_elements[ index ] );
+}
+
+size_t JsonVariant::size() const {
+  if( m_ptr_node == nullptr || ( m_ptr_node->m_type != JsonNode::JSON_ARRAY && m_ptr_node->m_type != JsonNode::JSON_OBJECT ) ) {
+    return 0;
+  }
+  return m_ptr_node->m_elements.size();
+}
+
+String JsonConverter< String >::From( const JsonNode* ptr_node ) {
+  if( ptr_node == nullptr ) {
+    return String( "null" );
+  }
+  switch( ptr_node->m_type ) {
+    case JsonNode::JSON_STRING:  return String( ptr_node->m_string );
+    case JsonNode::JSON_BOOL:    return String( ptr_node->m_bool ? "true" : "false" );
+    case JsonNode::JSON_INTEGER: return String( ptr_node->m_integer );
+    case JsonNode::JSON_FLOAT:   return String( ptr_node->m_float, 6U );
+    case JsonNode::JSON_ARRAY:   return String( "[]" );
+    case JsonNode::JSON_OBJECT:  return String( "{}" );
+    default:                     return String( "null" );
+  }
+}
+
+const char* DeserializationError::c_str() const {
+  switch( m_code ) {
+    case Ok:              return "Ok";
+    case EmptyInput:      return "EmptyInput";
+    case IncompleteInput: return "IncompleteInput";
+    case InvalidInput:    return "InvalidInput";
+    case NoMemory:        return "NoMemory";
+    case TooDeep:         return "TooDeep";
+  }
+  return "";
+}
+
+// Recursive descent over the whole input, as strict as ArduinoJson about structure but without its comment &
+// single quote extensions, which the config files don't use.
+class JsonParser {
+public:
+  JsonParser( const char* ptr_input, size_t length ) : m_ptr_input( ptr_input ), m_end( ptr_input + length ) {}
+
+  DeserializationError::Code Parse( JsonNode* ptr_node ) {
+    this->SkipSpace();
+    if( m_ptr_input == m_end ) {
+      return DeserializationError::EmptyInput;
+    }
+    return this->ParseValue( ptr_node, 0 );
+  }
+
+private:
+  void SkipSpace() {
+    while( m_ptr_input < m_end && ( *m_ptr_input == ' ' || *m_ptr_input == '\t' || *m_ptr_input == '\r' || *m_ptr_input == '\n' ) ) {
+      m_ptr_input++;
+    }
+  }
+
+  bool Accept( const char* ptr_word ) {
+    size_t length = strlen( ptr_word );
+    if( (size_t)( m_end - m_ptr_input ) < length || memcmp( m_ptr_input, ptr_word, length ) != 0 ) {
+      return false;
+    }
+    m_ptr_input += length;
+    return true;
+  }
+
+  DeserializationError::Code ParseValue( JsonNode* ptr_node, int depth ) {
+    if( m_ptr_input == m_end ) {
+      return DeserializationError::IncompleteInput;
+    }
+    switch( *m_ptr_input ) {
+      case '{': return depth < JSON_NESTING_MAX ? this->ParseObject( ptr_node, depth + 1 ) : DeserializationError::TooDeep;
+      case '[': return depth < JSON_NESTING_MAX ? this->ParseArray( ptr_node, depth + 1 ) : DeserializationError::TooDeep;
+      case '"':
+        ptr_node->m_type = JsonNode::JSON_STRING;
+        return this->ParseString( &ptr_node->m_string );
+      case 't':
+      case 'f':
+        ptr_node->m_type = JsonNode::JSON_BOOL;
+        ptr_node->m_bool = ( *m_ptr_input == 't' );
+        return this->Accept( ptr_node->m_bool ? "true" : "false" ) ? DeserializationError::Ok : DeserializationError::InvalidInput;
+      case 'n':
+        ptr_node->m_type = JsonNode::JSON_NULL;
+        return this->Accept( "null" ) ? DeserializationError::Ok : DeserializationError::InvalidInput;
+      default:
+        return this->ParseNumber( ptr_node );
+    }
+  }
+
+  DeserializationError::Code ParseObject( JsonNode* ptr_node, int depth ) {
+    ptr_node->m_type = JsonNode::JSON_OBJECT;
+    m_ptr_input++;
+    this->SkipSpace();
+    if( this->Accept( "}" ) ) {
+      return DeserializationError::Ok;
+    }
+    while( true ) {
+      std::string key;
+      this->SkipSpace();
+      if( m_ptr_input == m_end || *m_ptr_input != '"' ) {
+        return m_ptr_input == m_end ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+      }
+      DeserializationError::Code code = this->ParseString( &key );
+      if( code != DeserializationError::Ok ) {
+        return code;
+      }
+      this->SkipSpace();
+      if( !this->Accept( ":" ) ) {
+        return DeserializationError::InvalidInput;
+      }
+      this->SkipSpace();
+      ptr_node->m_keys.push_back( key );
+      ptr_node->m_elements.emplace_back();
+      code = this->ParseValue( &ptr_node->m_elements.back(), depth );
+      if( code != DeserializationError::Ok ) {
+        return code;
+      }
+      this->SkipSpace();
+      if( this->Accept( "}" ) ) {
+        return DeserializationError::Ok;
+      }
+      if( !this->Accept( "," ) ) {
+        return m_ptr_input == m_end ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+      }
+    }
+  }
+
+  DeserializationError::Code ParseArray( JsonNode* ptr_node, int depth ) {
+    ptr_node->m_type = JsonNode::JSON_ARRAY;
+    m_ptr_input++;
+    this->SkipSpace();
+    if( this->Accept( "]" ) ) {
+      return DeserializationError::Ok;
+    }
+    while( true ) {
+      this->SkipSpace();
+      ptr_node->m_elements.emplace_back();
+      DeserializationError::Code code = this->ParseValue( &ptr_node->m_elements.back(), depth );
+      if( code != DeserializationError::Ok ) {
+        return code;
+      }
+      this->SkipSpace();
+      if( this->Accept( "]" ) ) {
+        return DeserializationError::Ok;
+      }
+      if( !this->Accept( "," ) ) {
+        return m_ptr_input == m_end ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+      }
+    }
+  }
+
+  DeserializationError::Code ParseString( std::string* ptr_text ) {
+    m_ptr_input++;
+    while( m_ptr_input < m_end && *m_ptr_input != '"' ) {
+      char c = *m_ptr_input++;
+      if( c != '\\' ) {
+        *ptr_text += c;
+        continue;
+      }
+      if( m_ptr_input == m_end ) {
+        return DeserializationError::IncompleteInput;
+      }
+      c = *m_ptr_input++;
+      switch( c ) {
+        case 'b': *ptr_text += '\b'; break;
+        case 'f': *ptr_text += '\f'; break;
+        case 'n': *ptr_text += '\n'; break;
+        case 'r': *ptr_text += '\r'; break;
+        case 't': *ptr_text += '\t'; break;
+        case 'u': {
+          // Basic multilingual plane only, as UTF-8.
+          unsigned int code_point;
+          if( m_end - m_ptr_input < 4 || sscanf( std::string( m_ptr_input, 4 ).c_str(), "%4x", &code_point ) != 1 ) {
+            return DeserializationError::InvalidInput;
+          }
+          m_ptr_input += 4;
+          if( code_point < 0x80 ) {
+            *ptr_text += (char)code_point;
+          } else if( code_point < 0x800 ) {
+            *ptr_text += (char)( 0xC0 | ( code_point >> 6 ) );
+            *ptr_text += (char)( 0x80 | ( code_point & 0x3F ) );
+          } else {
+            *ptr_text += (char)( 0xE0 | ( code_point >> 12 ) );
+            *ptr_text += (char)( 0x80 | ( ( code_point >> 6 ) & 0x3F ) );
+            *ptr_text += (char)( 0x80 | ( code_point & 0x3F ) );
+          }
+          break;
+        }
+        default: *ptr_text += c; break;
+      }
+    }
+    if( m_ptr_input == m_end ) {
+      return DeserializationError::IncompleteInput;
+    }
+    m_ptr_input++;
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code ParseNumber( JsonNode* ptr_node ) {
+    const char* ptr_start = m_ptr_input;
+    bool        is_float  = false;
+    while( m_ptr_input < m_end && strchr( "+-0123456789.eE", *m_ptr_input ) != nullptr ) {
+      is_float |= ( *m_ptr_input == '.' || *m_ptr_input == 'e' || *m_ptr_input == 'E' );
+      m_ptr_input++;
+    }
+    if( m_ptr_input == ptr_start ) {
+      return DeserializationError::InvalidInput;
+    }
+
+    std::string text( ptr_start, m_ptr_input - ptr_start );
+    char*       ptr_parsed_end;
+    if( is_float ) {
+      ptr_node->m_type  = JsonNode::JSON_FLOAT;
+      ptr_node->m_float = strtod( text.c_str(), &ptr_parsed_end );
+    } else {
+      ptr_node->m_type    = JsonNode::JSON_INTEGER;
+      ptr_node->m_integer = strtoll( text.c_str(), &ptr_parsed_end, 10 );
+    }
+    return ( *ptr_parsed_end == 0 ) ? DeserializationError::Ok : DeserializationError::InvalidInput;
+  }
+
+  const char* m_ptr_input;
+  const char* m_end;
+};
+
+DeserializationError deserializeJson( JsonDocument& doc, const char* ptr_input, size_t length ) {
+  doc.clear();
+  JsonParser                 parser( ptr_input, length );
+  DeserializationError::Code code = parser.Parse( doc.GetRoot() );
+  if( code != DeserializationError::Ok ) {
+    doc.clear();
+  }
+  return DeserializationError( code );
+}
+
+DeserializationError deserializeJson( JsonDocument& doc, const char* ptr_input ) {
+  return deserializeJson( doc, ptr_input, strlen( ptr_input ) );
+}
+
+DeserializationError deserializeJson( JsonDocument& doc, const String& input ) {
+  return deserializeJson( doc, input.c_str(), input.length() );
+}
+
+DeserializationError deserializeJson( JsonDocument& doc, Stream& input ) {
+  std::string text;
+  int         c;
+  while( ( c = input.read() ) >= 0 ) {
+    text += (char)c;
+  }
+  return deserializeJson( doc, text.c_str(), text.size() );
+}
@@ -0,0 +1,259 @@
+#ifndef _ARDUINOJSON_STUB_H_
+#define _ARDUINOJSON_STUB_H_
+
+#include <Arduino.h>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "FS.h"
+
+// Enough of ArduinoJson 6 to read the config & cue files: deserializeJson() parses into a tree, & variants are
+// views into it with the library's conversions & "|" defaults.  Writing is not needed by the host tests, so
+// assignments & the createNested*() / add() / serializeJson() calls compile & do nothing.
+
+struct JsonNode {
+  enum Type { JSON_NULL, JSON_BOOL, JSON_INTEGER, JSON_FLOAT, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+
+  Type                       m_type    = JSON_NULL;
+  bool                       m_bool    = false;
+  long long                  m_integer = 0;
+  double                     m_float   = 0;
+  std::string                m_string;
+  std::vector< JsonNode >    m_elements;    // Array elements, or object values in the order of m_keys.
+  std::vector< std::string > m_keys;
+};
+
+template< typename T, typename Enable = void > struct JsonConverter;
+
+class JsonObject;
+class JsonArray;
+
+class JsonVariant {
+public:
+  JsonVariant() : m_ptr_node( nullptr ) {}
+  explicit JsonVariant( const JsonNode* ptr_node ) : m_ptr_node( ptr_node ) {}
+
+  template< typename T > JsonVariant& operator=( const T& value ) { return *this; }
+  JsonVariant operator[]( const char* ptr_key ) const;
+  JsonVariant operator[]( const String& key ) const { return ( *this )[ key.c_str() ]; }
+  JsonVariant operator[]( int index ) const;
+
+  template< typename T > T    as() const { return JsonConverter< T >::From( m_ptr_node ); }
+  template< typename T > bool is() const { return JsonConverter< T >::Is( m_ptr_node ); }
+  template< typename T > operator T() const { return this->as< T >(); }
+  bool   isNull() const { return m_ptr_node == nullptr || m_ptr_node->m_type == JsonNode::JSON_NULL; }
+  size_t size() const;
+
+  JsonArray  createNestedArray( const char* ptr_key = nullptr ) const;
+  JsonObject createNestedObject( const char* ptr_key = nullptr ) const;
+  template< typename T > T    to() const;
+  template< typename T > bool add( const T& value ) { return true; }
+  JsonVariant add() { return JsonVariant(); }
+  template< typename T > T    add() const;
+
+  const JsonNode* GetNode() const { return m_ptr_node; }
+
+protected:
+  const JsonNode* m_ptr_node;
+};
+
+class JsonString {
+public:
+  explicit JsonString( const char* ptr_text ) : m_ptr_text( ptr_text ) {}
+  const char* c_str() const { return m_ptr_text; }
+
+private:
+  const char* m_ptr_text;
+};
+
+class JsonPair {
+public:
+  JsonPair( const std::string* ptr_key, const JsonNode* ptr_value ) : m_ptr_key( ptr_key ), m_ptr_value( ptr_value ) {}
+  JsonString  key() const { return JsonString( m_ptr_key->c_str() ); }
+  JsonVariant value() const { return JsonVariant( m_ptr_value ); }
+
+private:
+  const std::string* m_ptr_key;
+  const JsonNode*    m_ptr_value;
+};
+
+// Iterates an array or object node, yielding T for each element.
+template< typename T > class JsonIterator {
+public:
+  JsonIterator( const JsonNode* ptr_node, size_t index ) : m_ptr_node( ptr_node ), m_index( index ) {}
+  T             operator*() const;
+  JsonIterator& operator++() { m_index++; return *this; }
+  bool          operator!=( const JsonIterator& other ) const { return m_index != other.m_index; }
+
+private:
+  const JsonNode* m_ptr_node;
+  size_t          m_index;
+};
+
+class JsonObject : public JsonVariant {
+public:
+  JsonObject() {}
+  explicit JsonObject( const JsonNode* ptr_node ) : JsonVariant( ptr_node ) {}
+
+  template< typename T > JsonObject& operator=( const T& value ) { return *this; }
+  JsonIterator< JsonPair > begin() const { return JsonIterator< JsonPair >( m_ptr_node, 0 ); }
+  JsonIterator< JsonPair > end() const { return JsonIterator< JsonPair >( m_ptr_node, this->size() ); }
+};
+
+class JsonArray : public JsonVariant {
+public:
+  JsonArray() {}
+  explicit JsonArray( const JsonNode* ptr_node ) : JsonVariant( ptr_node ) {}
+
+  JsonIterator< JsonObject > begin() const { return JsonIterator< JsonObject >( m_ptr_node, 0 ); }
+  JsonIterator< JsonObject > end() const { return JsonIterator< JsonObject >( m_ptr_node, this->size() ); }
+};
+
+template<> inline JsonPair JsonIterator< JsonPair >::operator*() const {
+  return JsonPair( &m_ptr_node->m_keys[ m_index ], &m_ptr_node->m_elements[ m_index ] );
+}
+
+template<> inline JsonObject JsonIterator< JsonObject >::operator*() const {
+  const JsonNode& element = m_ptr_node->m_elements[ m_index ];
+  return JsonObject( element.m_type == JsonNode::JSON_OBJECT ? &element : nullptr );
+}
+
+inline JsonArray  JsonVariant::createNestedArray( const char* ptr_key ) const { return JsonArray(); }
+inline JsonObject JsonVariant::createNestedObject( const char* ptr_key ) const { return JsonObject(); }
+template< typename T > T JsonVariant::to() const { return T(); }
+template< typename T > T JsonVariant::add() const { return T(); }
+
+// Conversions, as ArduinoJson 6 does them: a missing or mismatched value reads as 0, false or nullptr, & is<T>()
+// only holds for the exact kind of value.
+
+template< typename T >
+struct JsonConverter< T, typename std::enable_if< ( std::is_integral< T >::value || std::is_enum< T >::value ) && !std::is_same< T, bool >::value >::type > {
+  static T From( const JsonNode* ptr_node ) {
+    if( ptr_node == nullptr ) {
+      return (T)0;
+    }
+    switch( ptr_node->m_type ) {
+      case JsonNode::JSON_INTEGER: return (T)ptr_node->m_integer;
+      case JsonNode::JSON_FLOAT:   return (T)(long long)ptr_node->m_float;
+      case JsonNode::JSON_BOOL:    return (T)ptr_node->m_bool;
+      default:                     return (T)0;
+    }
+  }
+  static bool Is( const JsonNode* ptr_node ) { return ptr_node != nullptr && ptr_node->m_type == JsonNode::JSON_INTEGER; }
+};
+
+template< typename T > struct JsonConverter< T, typename std::enable_if< std::is_floating_point< T >::value >::type > {
+  static T From( const JsonNode* ptr_node ) {
+    if( ptr_node == nullptr ) {
+      return 0;
+    }
+    switch( ptr_node->m_type ) {
+      case JsonNode::JSON_INTEGER: return (T)ptr_node->m_integer;
+      case JsonNode::JSON_FLOAT:   return (T)ptr_node->m_float;
+      case JsonNode::JSON_BOOL:    return (T)ptr_node->m_bool;
+      default:                     return 0;
+    }
+  }
+  static bool Is( const JsonNode* ptr_node ) {
+    return ptr_node != nullptr && ( ptr_node->m_type == JsonNode::JSON_INTEGER || ptr_node->m_type == JsonNode::JSON_FLOAT );
+  }
+};
+
+template<> struct JsonConverter< bool > {
+  static bool From( const JsonNode* ptr_node ) {
+    if( ptr_node == nullptr ) {
+      return false;
+    }
+    switch( ptr_node->m_type ) {
+      case JsonNode::JSON_BOOL:    return ptr_node->m_bool;
+      case JsonNode::JSON_INTEGER: return ptr_node->m_integer != 0;
+      case JsonNode::JSON_FLOAT:   return ptr_node->m_float != 0;
+      default:                     return false;
+    }
+  }
+  static bool Is( const JsonNode* ptr_node ) { return ptr_node != nullptr && ptr_node->m_type == JsonNode::JSON_BOOL; }
+};
+
+template<> struct JsonConverter< const char* > {
+  static const char* From( const JsonNode* ptr_node ) {
+    return ( ptr_node != nullptr && ptr_node->m_type == JsonNode::JSON_STRING ) ? ptr_node->m_string.c_str() : nullptr;
+  }
+  static bool Is( const JsonNode* ptr_node ) { return ptr_node != nullptr && ptr_node->m_type == JsonNode::JSON_STRING; }
+};
+
+// Anything but a string is serialized, so a missing value reads as "null".
+template<> struct JsonConverter< String > {
+  static String From( const JsonNode* ptr_node );
+  static bool   Is( const JsonNode* ptr_node ) { return ptr_node != nullptr && ptr_node->m_type == JsonNode::JSON_STRING; }
+};
+
+template<> struct JsonConverter< JsonVariant > {
+  static JsonVariant From( const JsonNode* ptr_node ) { return JsonVariant( ptr_node ); }
+  static bool        Is( const JsonNode* ptr_node ) { return true; }
+};
+
+template<> struct JsonConverter< JsonObject > {
+  static JsonObject From( const JsonNode* ptr_node ) { return JsonObject( Is( ptr_node ) ? ptr_node : nullptr ); }
+  static bool       Is( const JsonNode* ptr_node ) { return ptr_node != nullptr && ptr_node->m_type == JsonNode::JSON_OBJECT; }
+};
+
+template<> struct JsonConverter< JsonArray > {
+  static JsonArray From( const JsonNode* ptr_node ) { return JsonArray( Is( ptr_node ) ? ptr_node : nullptr ); }
+  static bool      Is( const JsonNode* ptr_node ) { return ptr_node != nullptr && ptr_node->m_type == JsonNode::JSON_ARRAY; }
+};
+
+// Owns the tree, copies share it.
+class JsonDocument : public JsonVariant {
+public:
+  JsonDocument() { this->clear(); }
+  void clear() {
+    m_ptr_root = std::make_shared< JsonNode >();
+    m_ptr_node = m_ptr_root.get();
+  }
+  bool overflowed() const { return false; }
+
+  // Host only.  Root the parser fills in.
+  JsonNode* GetRoot() { return m_ptr_root.get(); }
+
+private:
+  std::shared_ptr< JsonNode > m_ptr_root;
+};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+  DynamicJsonDocument( size_t capacity ) {}
+};
+
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+  DeserializationError( Code code = Ok ) : m_code( code ) {}
+  explicit operator bool() const { return m_code != Ok; }
+  const char* c_str() const;
+  Code        code() const { return m_code; }
+  bool        operator==( Code code ) const { return m_code == code; }
+  bool        operator!=( Code code ) const { return m_code != code; }
+
+private:
+  Code m_code;
+};
+
+DeserializationError deserializeJson( JsonDocument& doc, const char* ptr_input, size_t length );
+
+DeserializationError deserializeJson( JsonDocument& doc, const char* ptr_input );
+
+DeserializationError deserializeJson( JsonDocument& doc, const String& input );
+
+DeserializationError deserializeJson( JsonDocument& doc, Stream& input );
+
+template< typename D, typename S > size_t serializeJson( const D& doc, S& output ) { return 0; }
+template< typename D > size_t serializeJson( const D& doc, char* ptr_output, size_t size ) { return 0; }
+template< typename D > size_t measureJson( const D& doc ) { return 0; }
+
+// The default unless the value is of its type.
+template< typename T > T operator|( const JsonVariant& variant, T default_value ) {
+  return variant.is< T >() ? variant.as< T >() : default_value;
+}
+
+#endif
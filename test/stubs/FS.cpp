@@ -0,0 +1,111 @@
+#include <fstream>
+#include <sstream>
+#include "LittleFS.h"
+
+LittleFSFS LittleFS;
+
+size_t File::write( const uint8_t* ptr_buffer, size_t size ) {
+  if( m_ptr_data == nullptr ) {
+    return 0;
+  }
+  std::string& content = m_ptr_data->m_content;
+  if( m_position + size > content.size() ) {
+    content.resize( m_position + size );
+  }
+  memcpy( &content[ m_position ], ptr_buffer, size );
+  m_position += size;
+  return size;
+}
+
+int File::available() {
+  return (int)( this->size() - m_position );
+}
+
+int File::read() {
+  uint8_t value;
+  return this->read( &value, 1 ) == 1 ? value : -1;
+}
+
+int File::peek() {
+  return m_position < this->size() ? (uint8_t)m_ptr_data->m_content[ m_position ] : -1;
+}
+
+size_t File::read( uint8_t* ptr_buffer, size_t size ) {
+  size_t left = this->size() - m_position;
+  if( size > left ) {
+    size = left;
+  }
+  if( size > 0 ) {
+    memcpy( ptr_buffer, &m_ptr_data->m_content[ m_position ], size );
+    m_position += size;
+  }
+  return size;
+}
+
+bool File::seek( uint32_t position, SeekMode mode ) {
+  size_t target = ( mode == SeekCur ) ? m_position + position : ( mode == SeekEnd ) ? this->size() + position : position;
+  if( m_ptr_data == nullptr || target > this->size() ) {
+    return false;
+  }
+  m_position = target;
+  return true;
+}
+
+bool LittleFSFS::exists( const String& path ) {
+  return this->open( path, "r" );
+}
+
+bool LittleFSFS::remove( const String& path ) {
+  bool existed = this->exists( path );
+  m_written.erase( path.c_str() );
+  m_removed.insert( path.c_str() );
+  return existed;
+}
+
+bool LittleFSFS::rename( const String& from, const String& to ) {
+  File file = this->open( from, "r" );
+  if( !file ) {
+    return false;
+  }
+  auto ptr_data    = std::make_shared< HostFileData >();
+  ptr_data->m_name = to.c_str();
+  ptr_data->m_content.resize( file.size() );
+  file.read( (uint8_t*)&ptr_data->m_content[ 0 ], file.size() );
+  this->remove( from );
+  m_written[ to.c_str() ] = ptr_data;
+  m_removed.erase( to.c_str() );
+  return true;
+}
+
+File LittleFSFS::open( const String& path, const char* ptr_mode ) {
+  std::string name = path.c_str();
+
+  if( ptr_mode[ 0 ] == 'w' || ptr_mode[ 0 ] == 'a' ) {
+    auto& ptr_data = m_written[ name ];
+    if( ptr_data == nullptr || ptr_mode[ 0 ] == 'w' ) {
+      ptr_data         = std::make_shared< HostFileData >();
+      ptr_data->m_name = name;
+    }
+    m_removed.erase( name );
+    return File( ptr_data, ptr_data->m_content.size() );
+  }
+
+  auto written = m_written.find( name );
+  if( written != m_written.end() ) {
+    return File( written->second, 0 );
+  }
+  if( m_root.empty() || m_removed.count( name ) != 0 ) {
+    return File();
+  }
+
+  std::ifstream host_file( m_root + name, std::ios::binary );
+  if( !host_file ) {
+    return File();
+  }
+  std::stringstream content;
+  content << host_file.rdbuf();
+  auto ptr_data       = std::make_shared< HostFileData >();
+  ptr_data->m_name    = name;
+  ptr_data->m_content = content.str();
+  return File( ptr_data, 0 );
+}
@@ -0,0 +1,51 @@
+#ifndef _FS_STUB_H_
+#define _FS_STUB_H_
+
+#include <Arduino.h>
+#include <memory>
+
+enum SeekMode {
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2,
+};
+
+// Contents of a file, shared by every File opened on it.
+struct HostFileData {
+  std::string m_name;
+  std::string m_content;
+};
+
+// A handle, copies refer to the same open file.
+class File : public Stream {
+public:
+  File() : m_position( 0 ) {}
+  File( std::shared_ptr< HostFileData > ptr_data, size_t position ) : m_ptr_data( ptr_data ), m_position( position ) {}
+
+  operator bool() const { return m_ptr_data != nullptr; }
+
+  size_t write( uint8_t value ) override { return this->write( &value, 1 ); }
+  size_t write( const uint8_t* ptr_buffer, size_t size ) override;
+  int    available() override;
+  int    read() override;
+  int    peek() override;
+  size_t read( uint8_t* ptr_buffer, size_t size );
+  bool   seek( uint32_t position, SeekMode mode = SeekSet );
+  size_t position() const { return m_position; }
+  size_t size() const { return m_ptr_data != nullptr ? m_ptr_data->m_content.size() : 0; }
+  void   close() { m_ptr_data.reset(); }
+  void   flush() {}
+  const char* name() const { return m_ptr_data != nullptr ? m_ptr_data->m_name.c_str() : ""; }
+  bool   isDirectory() { return false; }
+  File   openNextFile() { return File(); }
+
+private:
+  std::shared_ptr< HostFileData > m_ptr_data;
+  size_t                          m_position;
+};
+
+namespace fs {
+  class FS {};
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef _LITTLEFS_STUB_H_
+#define _LITTLEFS_STUB_H_
+
+#include <map>
+#include <set>
+#include "FS.h"
+
+// Reads files from a host directory, e.g. a replay corpus.  Writes stay in memory & are read back from there,
+// so a test never changes its input files.
+class LittleFSFS {
+public:
+  bool   begin( bool format_on_fail = false ) { return true; }
+  bool   exists( const String& path );
+  bool   remove( const String& path );
+  bool   rename( const String& from, const String& to );
+  File   open( const String& path, const char* ptr_mode = "r" );
+  size_t totalBytes() { return 1 << 20; }
+  size_t usedBytes() { return 0; }
+
+  // Host only.  Directory the paths are relative to.
+  void   SetHostRoot( const char* ptr_directory ) { m_root = ptr_directory; }
+
+private:
+  std::string                                               m_root;
+  std::map< std::string, std::shared_ptr< HostFileData > > m_written;
+  std::set< std::string >                                   m_removed;
+};
+
+extern LittleFSFS LittleFS;
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef _PRINT_STUB_H_
+#define _PRINT_STUB_H_
+
+#include <Arduino.h>
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef _WEBSERVER_STUB_H_
+#define _WEBSERVER_STUB_H_
+
+#include <Arduino.h>
+#include <functional>
+#include "FS.h"
+
+// Routes are taken & never called, the host tests don't serve web pages.
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_POST, HTTP_PUT, HTTP_DELETE };
+
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define CONTENT_LENGTH_UNKNOWN ( (size_t)-1 )
+
+struct HTTPUpload {
+  int    status;
+  String filename;
+  uint8_t buf[ 1436 ];
+  size_t currentSize;
+  size_t totalSize;
+};
+
+class Uri {
+public:
+  Uri( const char* ptr_uri ) {}
+  Uri( const String& uri ) {}
+};
+
+class WebServer {
+public:
+  typedef std::function< void( void ) > THandlerFunction;
+
+  WebServer( int port = 80 ) {}
+
+  void   on( const Uri& uri, HTTPMethod method, THandlerFunction handler ) {}
+  void   on( const Uri& uri, HTTPMethod method, THandlerFunction handler, THandlerFunction upload_handler ) {}
+  void   onNotFound( THandlerFunction handler ) {}
+  void   begin() {}
+  void   handleClient() {}
+  void   send( int code, const char* ptr_content_type = "", const String& content = String() ) {}
+  void   send( int code, const String& content_type, const String& content ) {}
+  void   send_P( int code, const char* ptr_content_type, const char* ptr_content ) {}
+  void   send_P( int code, const char* ptr_content_type, const char* ptr_content, size_t length ) {}
+  void   sendContent( const String& content ) {}
+  void   sendContent( const char* ptr_content, size_t length ) {}
+  void   setContentLength( size_t length ) {}
+  void   sendHeader( const String& name, const String& value, bool first = false ) {}
+  template< typename T > size_t streamFile( T& file, const String& content_type ) { return 0; }
+  int    args() { return 0; }
+  String arg( int index ) { return String(); }
+  String arg( const String& name ) { return String(); }
+  String argName( int index ) { return String(); }
+  bool   hasArg( const String& name ) { return false; }
+  String pathArg( int index ) { return String(); }
+  String uri() { return String(); }
+  HTTPUpload& upload() { return m_upload; }
+
+private:
+  HTTPUpload m_upload;
+};
+
+#endif
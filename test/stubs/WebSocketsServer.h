@@ -0,0 +1,29 @@
+#ifndef _WEBSOCKETSSERVER_STUB_H_
+#define _WEBSOCKETSSERVER_STUB_H_
+
+#include <Arduino.h>
+#include <functional>
+
+#define WEBSOCKETS_SERVER_CLIENT_MAX  5
+#define WEBSOCKETS_MAX_HEADER_SIZE    14
+
+typedef enum { WStype_ERROR, WStype_DISCONNECTED, WStype_CONNECTED, WStype_TEXT, WStype_BIN } WStype_t;
+
+// No clients ever connect.
+class WebSocketsServer {
+public:
+  typedef std::function< void( uint8_t num, WStype_t type, uint8_t* payload, size_t length ) > WebSocketServerEvent;
+
+  WebSocketsServer( uint16_t port, const String& origin = "", const String& protocol = "arduino" ) {}
+
+  void    begin() {}
+  void    close() {}
+  void    loop() {}
+  void    onEvent( WebSocketServerEvent event ) {}
+  bool    sendBIN( uint8_t num, uint8_t* payload, size_t length, bool header_to_payload = false ) { return true; }
+  bool    sendTXT( uint8_t num, const char* payload, size_t length = 0, bool header_to_payload = false ) { return true; }
+  void    disconnect( uint8_t num ) {}
+  uint8_t connectedClients( bool ping = false ) { return 0; }
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef _WIFI_STUB_H_
+#define _WIFI_STUB_H_
+
+#include <Arduino.h>
+
+#define WL_CONNECTED  3
+#define WIFI_STA      1
+#define WIFI_AP       2
+
+// Never connects, so the node starts its access point on 192.168.1.1.
+class WiFiClass {
+public:
+  void      begin() {}
+  void      begin( const String& ssid, const String& pass ) {}
+  void      disconnect() {}
+  String    macAddress() { return String( "02:00:00:00:00:01" ); }
+  uint8_t*  macAddress( uint8_t* ptr_mac ) { static const uint8_t mac[ 6 ] = { 2, 0, 0, 0, 0, 1 }; memcpy( ptr_mac, mac, 6 ); return ptr_mac; }
+  int       status() { return 0; }
+  void      mode( int mode ) {}
+  int       getMode() { return WIFI_AP; }
+  void      config( IPAddress ip, IPAddress gateway, IPAddress subnet ) {}
+  void      softAP( const String& ssid, const String& pass ) {}
+  void      softAPConfig( IPAddress ip, IPAddress gateway, IPAddress subnet ) {}
+  IPAddress localIP() { return IPAddress(); }
+  IPAddress softAPIP() { return IPAddress( 192, 168, 1, 1 ); }
+  IPAddress subnetMask() { return IPAddress( 255, 255, 255, 0 ); }
+  IPAddress gatewayIP() { return IPAddress(); }
+  IPAddress broadcastIP() { return IPAddress(); }
+};
+
+extern WiFiClass WiFi;
+
+#endif
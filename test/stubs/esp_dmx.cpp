@@ -0,0 +1,124 @@
+#include <esp_dmx.h>
+#include <mutex>
+
+// Sends come from the frame timer, reads from the test thread.
+static std::mutex    s_mutex;
+static bool          s_installed    = false;
+static uint8_t       s_buffer[ DMX_PACKET_SIZE ];
+static uint8_t       s_sent[ DMX_PACKET_SIZE ];
+static size_t        s_sent_size    = 0;
+static unsigned long s_sent_count   = 0;
+static uint32_t      s_break_us     = 176;
+static uint32_t      s_mab_us       = 12;
+static uint32_t      s_line_us      = 0;
+static uint64_t      s_line_free_us = 0;
+
+bool dmx_driver_install( dmx_port_t dmx_num, dmx_config_t* ptr_config, dmx_personality_t* ptr_personalities, int personality_count ) {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  memset( s_buffer, 0, sizeof( s_buffer ) );
+  s_sent_size    = 0;
+  s_sent_count   = 0;
+  s_line_free_us = 0;
+  s_installed    = true;
+  return true;
+}
+
+bool dmx_driver_delete( dmx_port_t dmx_num ) {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  s_installed = false;
+  return true;
+}
+
+bool dmx_driver_is_installed( dmx_port_t dmx_num ) {
+  return s_installed;
+}
+
+bool dmx_set_pin( dmx_port_t dmx_num, int tx_pin, int rx_pin, int rts_pin ) {
+  return true;
+}
+
+size_t dmx_write( dmx_port_t dmx_num, const void* ptr_source, size_t size ) {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  size = std::min( size, sizeof( s_buffer ) );
+  memcpy( s_buffer, ptr_source, size );
+  return size;
+}
+
+size_t dmx_read( dmx_port_t dmx_num, void* ptr_destination, size_t size ) {
+  return dmx_read_offset( dmx_num, 0, ptr_destination, size );
+}
+
+size_t dmx_read_offset( dmx_port_t dmx_num, size_t offset, void* ptr_destination, size_t size ) {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  if( offset >= sizeof( s_buffer ) ) {
+    return 0;
+  }
+  size = std::min( size, sizeof( s_buffer ) - offset );
+  memcpy( ptr_destination, &s_buffer[ offset ], size );
+  return size;
+}
+
+size_t dmx_send_num( dmx_port_t dmx_num, size_t size ) {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  s_sent_size = std::min( size, sizeof( s_buffer ) );
+  memcpy( s_sent, s_buffer, s_sent_size );
+  s_sent_count++;
+  s_line_free_us = micros() + s_line_us;
+  return s_sent_size;
+}
+
+size_t dmx_send( dmx_port_t dmx_num ) {
+  return dmx_send_num( dmx_num, DMX_PACKET_SIZE );
+}
+
+bool dmx_wait_sent( dmx_port_t dmx_num, TickType_t wait_ticks ) {
+  // Waiting on a virtual clock would never end, so any wait is long enough.
+  std::lock_guard< std::mutex > lock( s_mutex );
+  return wait_ticks > 0 || micros() >= s_line_free_us;
+}
+
+size_t dmx_receive( dmx_port_t dmx_num, dmx_packet_t* ptr_packet, TickType_t wait_ticks ) {
+  return dmx_receive_num( dmx_num, ptr_packet, DMX_PACKET_SIZE, wait_ticks );
+}
+
+size_t dmx_receive_num( dmx_port_t dmx_num, dmx_packet_t* ptr_packet, size_t size, TickType_t wait_ticks ) {
+  vTaskDelay( wait_ticks );
+  if( ptr_packet != nullptr ) {
+    memset( ptr_packet, 0, sizeof( *ptr_packet ) );
+  }
+  return 0;
+}
+
+bool dmx_set_break_len( dmx_port_t dmx_num, uint32_t break_us ) {
+  s_break_us = break_us;
+  return true;
+}
+
+bool dmx_set_mab_len( dmx_port_t dmx_num, uint32_t mab_us ) {
+  s_mab_us = mab_us;
+  return true;
+}
+
+uint32_t dmx_get_break_len( dmx_port_t dmx_num ) {
+  return s_break_us;
+}
+
+uint32_t dmx_get_mab_len( dmx_port_t dmx_num ) {
+  return s_mab_us;
+}
+
+unsigned long HostDmxGetSentCount() {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  return s_sent_count;
+}
+
+void HostDmxSetLineUs( uint32_t line_us ) {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  s_line_us = line_us;
+}
+
+const uint8_t* HostDmxGetSentFrame( size_t* ptr_size ) {
+  std::lock_guard< std::mutex > lock( s_mutex );
+  *ptr_size = s_sent_size;
+  return s_sent;
+}
@@ -0,0 +1,59 @@
+#ifndef _ESP_DMX_STUB_H_
+#define _ESP_DMX_STUB_H_
+
+#include <Arduino.h>
+
+// A driver with no UART: dmx_write() fills the driver's buffer & dmx_send_num() counts the frame & latches its
+// slots, so a host test can read back what the node put on the wire.  A frame is on the line for the time set
+// with HostDmxSetLineUs(), 0 unless a test sets it.  Nothing is ever received.
+
+typedef int dmx_port_t;
+
+#define DMX_NUM_1         1
+#define DMX_PACKET_SIZE   513
+#define DMX_TIMEOUT_TICK  100
+#define DMX_OK            0
+
+typedef struct {
+  int interrupt_flags;
+} dmx_config_t;
+
+#define DMX_CONFIG_DEFAULT { 0 }
+
+typedef struct {
+  int         footprint;
+  const char* description;
+} dmx_personality_t;
+
+typedef struct {
+  int    err;
+  int    sc;
+  size_t size;
+  bool   is_rdm;
+} dmx_packet_t;
+
+bool     dmx_driver_install( dmx_port_t dmx_num, dmx_config_t* ptr_config, dmx_personality_t* ptr_personalities, int personality_count );
+bool     dmx_driver_delete( dmx_port_t dmx_num );
+bool     dmx_driver_is_installed( dmx_port_t dmx_num );
+bool     dmx_set_pin( dmx_port_t dmx_num, int tx_pin, int rx_pin, int rts_pin );
+size_t   dmx_write( dmx_port_t dmx_num, const void* ptr_source, size_t size );
+size_t   dmx_read( dmx_port_t dmx_num, void* ptr_destination, size_t size );
+size_t   dmx_read_offset( dmx_port_t dmx_num, size_t offset, void* ptr_destination, size_t size );
+size_t   dmx_send_num( dmx_port_t dmx_num, size_t size );
+size_t   dmx_send( dmx_port_t dmx_num );
+bool     dmx_wait_sent( dmx_port_t dmx_num, TickType_t wait_ticks );
+size_t   dmx_receive( dmx_port_t dmx_num, dmx_packet_t* ptr_packet, TickType_t wait_ticks );
+size_t   dmx_receive_num( dmx_port_t dmx_num, dmx_packet_t* ptr_packet, size_t size, TickType_t wait_ticks );
+bool     dmx_set_break_len( dmx_port_t dmx_num, uint32_t break_us );
+bool     dmx_set_mab_len( dmx_port_t dmx_num, uint32_t mab_us );
+uint32_t dmx_get_break_len( dmx_port_t dmx_num );
+uint32_t dmx_get_mab_len( dmx_port_t dmx_num );
+
+// Host only.  Frames sent since the driver was installed, & the slots of the last one, start code first.
+unsigned long  HostDmxGetSentCount();
+const uint8_t* HostDmxGetSentFrame( size_t* ptr_size );
+
+// Host only.  dmx_wait_sent() without a wait fails until this long after dmx_send_num().
+void           HostDmxSetLineUs( uint32_t line_us );
+
+#endif
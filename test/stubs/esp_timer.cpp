@@ -0,0 +1,29 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// Timers are created but never fire.
+struct esp_timer {
+  esp_timer_create_args_t m_args;
+};
+
+esp_err_t esp_timer_create( const esp_timer_create_args_t* ptr_args, esp_timer_handle_t* ptr_handle ) {
+  *ptr_handle = new esp_timer{ *ptr_args };
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic( esp_timer_handle_t handle, uint64_t period_us ) {
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop( esp_timer_handle_t handle ) {
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete( esp_timer_handle_t handle ) {
+  delete handle;
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+  return micros();
+}
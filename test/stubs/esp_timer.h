@@ -0,0 +1,34 @@
+#ifndef _ESP_TIMER_STUB_H_
+#define _ESP_TIMER_STUB_H_
+
+#include <stdint.h>
+
+// Only links, the host tests drive frames with their own FrameTimer.
+
+typedef int esp_err_t;
+
+#ifndef ESP_OK
+#define ESP_OK    0
+#define ESP_FAIL  -1
+#endif
+
+typedef struct esp_timer* esp_timer_handle_t;
+typedef void ( *esp_timer_cb_t )( void* ptr_argument );
+
+typedef enum { ESP_TIMER_TASK } esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t       callback;
+  void*                arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char*          name;
+  bool                 skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create( const esp_timer_create_args_t* ptr_args, esp_timer_handle_t* ptr_handle );
+esp_err_t esp_timer_start_periodic( esp_timer_handle_t handle, uint64_t period_us );
+esp_err_t esp_timer_stop( esp_timer_handle_t handle );
+esp_err_t esp_timer_delete( esp_timer_handle_t handle );
+int64_t   esp_timer_get_time();
+
+#endif
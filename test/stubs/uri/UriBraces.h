@@ -0,0 +1,11 @@
+#ifndef _URIBRACES_STUB_H_
+#define _URIBRACES_STUB_H_
+
+#include "../WebServer.h"
+
+class UriBraces : public Uri {
+public:
+  UriBraces( const char* ptr_uri ) : Uri( ptr_uri ) {}
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include "ChannelModsTester.h"
+
+// Differential test of the mod engines against ChannelModsReference(), the same test as /selftest_mods on the node.
+
+#define TEST_CASES   2000
+#define TEST_SEEDS   4
+
+// Breaks the handler on 'Add value' 7, so the shrinker has something to find.
+class BrokenModsTester : public ChannelModsTester {
+protected:
+  void RunEngine( int engine, const std::vector< ChannelMod >& program, bool copy_artnet_to_dmx, uint16_t number_of_channels, uint8_t* ptr_dmx_buffer ) override {
+    ChannelModsTester::RunEngine( engine, program, copy_artnet_to_dmx, number_of_channels, ptr_dmx_buffer );
+    if( engine != MODS_ENGINE_HANDLER ) {
+      return;
+    }
+    for( const ChannelMod& mod : program ) {
+      if( mod.m_mod_type == CHANNELMODTYPE::ADD_VALUE && mod.m_mod_value == 7 && mod.m_channel >= 1 && mod.m_channel <= 512 ) {
+        ptr_dmx_buffer[ mod.m_channel ] ^= 0x80;
+      }
+    }
+  }
+};
+
+static void PrintFailure( const ChannelModsTester& tester ) {
+  printf( "  engine %s, frame seed %u, copy %d, frame %d, channel %d, expected %d, result %d, %d mods shrunk to %d\n",
+          ModsEngineAsString( tester.GetFailureEngine() ), tester.GetFailureCaseSeed(), tester.GetFailureCopyArtnetToDMX(),
+          tester.GetFailureFrame(), tester.GetFailureChannel(), tester.GetFailureExpected(), tester.GetFailureResult(),
+          tester.GetFailureModsBeforeShrink(), (int)tester.GetFailureMods().size() );
+  for( const ChannelMod& mod : tester.GetFailureMods() ) {
+    printf( "    sequence %u, channel %u, %s %u\n", mod.m_sequence, mod.m_channel, ModTypeAsString( mod.m_mod_type ), mod.m_mod_value );
+  }
+}
+
+static bool TestEngines() {
+  static ChannelModsTester tester;
+  bool passed = true;
+
+  for( uint32_t seed = 1; seed <= TEST_SEEDS; seed++ ) {
+    if( !tester.Run( TEST_CASES, seed * 7919 ) ) {
+      printf( "FAIL engines, seed %u, case %d\n", seed * 7919, tester.GetCasesRun() );
+      PrintFailure( tester );
+      passed = false;
+    }
+  }
+  return passed;
+}
+
+static bool TestShrinker() {
+  static BrokenModsTester tester;
+
+  if( tester.Run( TEST_CASES, 1 ) ) {
+    printf( "FAIL shrinker, the broken engine passed\n" );
+    return false;
+  }
+
+  // A single 'Add value' 7 is enough to fail, everything else has to go.
+  const std::vector< ChannelMod >& mods = tester.GetFailureMods();
+  if( tester.GetFailureEngine() != MODS_ENGINE_HANDLER || mods.size() != 1 || mods[ 0 ].m_mod_type != CHANNELMODTYPE::ADD_VALUE || mods[ 0 ].m_mod_value != 7 ) {
+    printf( "FAIL shrinker\n" );
+    PrintFailure( tester );
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  bool passed = true;
+  passed &= TestEngines();
+  passed &= TestShrinker();
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
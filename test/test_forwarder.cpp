@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include "ArtNetForwarder.h"
+#include "UdpSocket.h"
+
+// Forwarding throughput over loopback: ArtNetForwarder sends every frame to ARTNET_FORWARD_TARGETS_MAX targets on
+// 127.0.0.1 through the Linux UdpSocket, & a second socket on the Art-Net port receives them.  Every ArtDmx is
+// checked for its universe, sequence, length & data, then frames & datagrams per second are printed.
+
+#define TEST_FRAMES      20000
+#define TEST_WAIT_LOOPS  1000    // Empty receives before a datagram counts as lost.
+
+struct ReceivedTarget {
+  unsigned long m_received;
+  uint8_t       m_sequence;
+};
+
+// Checks one ArtDmx against the frame it was sent from.
+static bool CheckArtDmx( const UdpDatagram& datagram, const uint8_t* frame, ReceivedTarget* received ) {
+  const ArtNetPacketHeader* ptr_header     = (const ArtNetPacketHeader*)datagram.m_ptr_buffer;
+  const ArtNetPacketDMX*    ptr_packet_dmx = (const ArtNetPacketDMX*)&datagram.m_ptr_buffer[ ARTNET_PACKET_PAYLOAD_START ];
+
+  if( datagram.m_length != ARTNET_PACKET_DMX_DATA_START + 512 || memcmp( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) ) != 0
+   || ptr_header->m_OpCode != ARTNET_OPCODE_DMX ) {
+    printf( "FAIL not an ArtDmx, %d bytes\n", datagram.m_length );
+    return false;
+  }
+
+  int universe = ( ptr_packet_dmx->m_Net << 8 ) | ptr_packet_dmx->m_SubUni;
+  if( universe >= ARTNET_FORWARD_TARGETS_MAX ) {
+    printf( "FAIL universe %d\n", universe );
+    return false;
+  }
+
+  ReceivedTarget& target   = received[ universe ];
+  uint8_t         sequence = ( target.m_sequence == 255 ) ? 1 : target.m_sequence + 1;
+  if( ptr_packet_dmx->m_Sequence != sequence || ( ( ptr_packet_dmx->m_LengthHi << 8 ) | ptr_packet_dmx->m_Length ) != 512 ) {
+    printf( "FAIL universe %d sequence %d, expected %d\n", universe, ptr_packet_dmx->m_Sequence, sequence );
+    return false;
+  }
+  if( memcmp( &datagram.m_ptr_buffer[ ARTNET_PACKET_DMX_DATA_START ], frame, 512 ) != 0 ) {
+    printf( "FAIL universe %d data differs from the frame\n", universe );
+    return false;
+  }
+  target.m_sequence = sequence;
+  target.m_received++;
+  return true;
+}
+
+int main() {
+  static ArtNetForwarder forwarder;
+  static uint8_t         buffers[ UDP_SOCKET_BATCH_MAX ][ ARTNET_PACKET_DMX_DATA_START + 512 + 1 ];
+  UdpDatagram            datagrams[ UDP_SOCKET_BATCH_MAX ];
+  ReceivedTarget         received[ ARTNET_FORWARD_TARGETS_MAX ] = {};
+  uint8_t                frame[ 512 ];
+  UdpSocket              send_socket;
+  UdpSocket              receive_socket;
+
+  // Without the socket, as the firmware reports it at boot.
+  unsigned long benchmark_ns = forwarder.Benchmark( 10000 );
+
+  if( !send_socket.Begin( 0, 0 ) || !receive_socket.Begin( ARTNET_UDP_PORT, 1 << 20 ) ) {
+    printf( "FAIL no sockets on port %d\n", ARTNET_UDP_PORT );
+    printf( "FAILED\n" );
+    return 1;
+  }
+
+  for( int i = 0; i < ARTNET_FORWARD_TARGETS_MAX; i++ ) {
+    forwarder.AddTarget( htonl( INADDR_LOOPBACK ), i, 0, false );
+  }
+  for( int i = 0; i < UDP_SOCKET_BATCH_MAX; i++ ) {
+    datagrams[ i ].m_ptr_buffer  = buffers[ i ];
+    datagrams[ i ].m_buffer_size = sizeof( buffers[ i ] );
+  }
+
+  bool                     passed   = true;
+  unsigned long            expected = 0;
+  unsigned long            total    = 0;
+  std::chrono::nanoseconds update_time( 0 );
+  auto                     start = std::chrono::steady_clock::now();
+
+  for( int frame_index = 0; frame_index < TEST_FRAMES && passed; frame_index++ ) {
+    for( int i = 0; i < 512; i++ ) {
+      frame[ i ] = (uint8_t)( frame_index + i * 7 );
+    }
+
+    auto update_start = std::chrono::steady_clock::now();
+    forwarder.SetFrame( frame, sizeof( frame ) );
+    forwarder.Update( send_socket, frame_index );
+    update_time += std::chrono::steady_clock::now() - update_start;
+    expected    += ARTNET_FORWARD_TARGETS_MAX;
+
+    // Loopback queues the datagrams before SendTo() returns, the wait only covers a busy machine.
+    for( int wait = 0; total < expected && wait < TEST_WAIT_LOOPS && passed; ) {
+      int count = receive_socket.ReceiveBatch( datagrams, UDP_SOCKET_BATCH_MAX );
+      if( count == 0 ) {
+        wait++;
+        continue;
+      }
+      for( int i = 0; i < count && passed; i++ ) {
+        passed = CheckArtDmx( datagrams[ i ], frame, received );
+      }
+      total += count;
+    }
+    if( passed && total != expected ) {
+      printf( "FAIL frame %d, %lu of %lu datagrams received\n", frame_index, total, expected );
+      passed = false;
+    }
+  }
+
+  double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+  for( int i = 0; i < forwarder.GetTargetCount() && passed; i++ ) {
+    const ArtNetForwardTarget& target = forwarder.GetTarget( i );
+    if( target.m_sent != TEST_FRAMES || target.m_send_failed != 0 || target.m_dropped_rate != 0 || received[ i ].m_received != TEST_FRAMES ) {
+      printf( "FAIL universe %d, sent %lu, failed %lu, dropped %lu, received %lu\n", i, target.m_sent, target.m_send_failed,
+              target.m_dropped_rate, received[ i ].m_received );
+      passed = false;
+    }
+  }
+
+  printf( "%d frames to %d targets in %.3f s, %.0f frames/s, %.0f datagrams/s, %.1f MB/s\n", TEST_FRAMES, ARTNET_FORWARD_TARGETS_MAX,
+          seconds, TEST_FRAMES / seconds, total / seconds, total * ( ARTNET_PACKET_DMX_DATA_START + 512 ) / seconds / 1e6 );
+  printf( "SetFrame() & Update() %.0f ns per frame, %lu ns without the socket, slowest send %lu us\n",
+          (double)update_time.count() / TEST_FRAMES, benchmark_ns, forwarder.GetSendTimeUsMax() );
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <thread>
+#include <LittleFS.h>
+#include <esp_dmx.h>
+#include "ESP32Artnet2DMX.h"
+#include "FrameTimer.h"
+#include "UdpSocket.h"
+
+// Frame scheduling of the engine on a mock clock: MockFrameTimer is the engine's FrameTimer & fires its
+// OnFrameTimer() the way esp_timer does with skip_unhandled_events, each frame started late by a chosen delay.
+// The frames sent & late, the FrameJitter percentiles in GetNodeStats() & what reached the DMX driver stub are
+// then known exactly.  One case per run, as the stats are only reset from the webserver.
+//
+//   test_frame_timer <config directory> <case>
+//
+// The config directory has the node's config_adapter.json & config_mods.json, with a 23 ms update interval.
+
+#define TEST_PERIOD_US   23000                 // dmx_update_interval_ms of the config.
+#define TEST_START_US    1000000000ULL         // Virtual time the engine starts at.
+#define TEST_UNIVERSE    1
+#define TEST_WAIT_MS     2000                  // Wall clock time a datagram may take to reach the engine.
+
+typedef uint32_t ( *DelayFunction )( int frame );
+
+class MockFrameTimer : public FrameTimer {
+public:
+  MockFrameTimer() {
+    m_running = false;
+  }
+
+  bool Start( uint32_t period_us, Callback callback, void* ptr_argument ) override {
+    m_period_us    = period_us;
+    m_callback     = callback;
+    m_ptr_argument = ptr_argument;
+    m_next_us      = micros() + period_us;
+    m_running      = true;
+    return true;
+  }
+
+  void Stop() override {
+    m_running = false;
+  }
+
+  uint64_t NowUs() override {
+    return micros();
+  }
+
+  // Runs frames until until_us, frame n is started delay( n ) late.
+  void Run( uint64_t until_us, DelayFunction delay ) {
+    int frame = 0;
+    while( m_running && m_next_us <= until_us ) {
+      HostClockSet( m_next_us + delay( frame++ ) );
+      m_callback( m_ptr_argument );
+
+      // Frames missed while the callback was late are skipped, not caught up.
+      m_next_us += m_period_us;
+      while( m_next_us < micros() ) {
+        m_next_us += m_period_us;
+      }
+    }
+    HostClockSet( until_us );
+  }
+
+private:
+  bool     m_running;
+  uint32_t m_period_us;
+  uint64_t m_next_us;
+  Callback m_callback;
+  void*    m_ptr_argument;
+};
+
+static uint32_t NoDelay( int frame ) {
+  return 0;
+}
+
+static uint32_t EveryTenthLate( int frame ) {
+  return ( frame % 10 == 9 ) ? 100 : 0;
+}
+
+static uint32_t OneFrameMissed( int frame ) {
+  // Frame 5 is held up past the start of frame 6, which is skipped.
+  return ( frame == 5 ) ? TEST_PERIOD_US + 300 : 0;
+}
+
+static uint32_t FarOff( int frame ) {
+  return ( frame == 3 ) ? 7000 : 0;
+}
+
+struct FrameTimerCase {
+  const char*   m_ptr_name;
+  DelayFunction m_delay;
+  uint32_t      m_line_us;           // Each frame is on the line this long.
+  int           m_periods;           // Run for this many periods.
+  unsigned long m_frames;
+  unsigned long m_frames_late;
+  unsigned long m_jitter_count;
+  uint32_t      m_p50_us;
+  uint32_t      m_p99_us;
+  uint32_t      m_max_us;
+};
+
+static const FrameTimerCase s_cases[] = {
+  // Percentiles are the upper edge of the FRAME_JITTER_BIN_US bin, at most the max.
+  { "on_time",          NoDelay,        0,                      1000, 1000, 0,   999,  0,  0,    0 },
+  { "every_tenth_late", EveryTenthLate, 0,                      1000, 1000, 0,   999,  20, 100,  100 },
+  { "one_frame_missed", OneFrameMissed, 0,                      100,  99,   0,   98,   20, 5000, TEST_PERIOD_US + 300 },
+  { "beyond_the_bins",  FarOff,         0,                      100,  100,  0,   99,   20, 5000, 7000 },
+  // Still on the line at the next start, so every other frame is skipped & counted late.
+  { "line_busy",        NoDelay,        TEST_PERIOD_US * 3 / 2, 1000, 500,  500, 999,  0,  0,    0 },
+};
+
+// Sends one Art-Net packet to the engine from loopback, then runs loop() until it has been handled.
+static bool SendArtNet( ESP32Artnet2DMX* ptr_engine, UdpSocket* ptr_socket, const uint8_t* ptr_packet, size_t length ) {
+  const NodeStats& stats   = ptr_engine->GetNodeStats();
+  unsigned long    handled = stats.m_ring_dequeued;
+  if( !ptr_socket->SendTo( htonl( INADDR_LOOPBACK ), ARTNET_UDP_PORT, ptr_packet, length ) ) {
+    printf( "FAIL sending %d bytes\n", (int)length );
+    return false;
+  }
+
+  auto wait_start = std::chrono::steady_clock::now();
+  while( stats.m_ring_dequeued == handled ) {
+    if( std::chrono::steady_clock::now() - wait_start > std::chrono::milliseconds( TEST_WAIT_MS ) ) {
+      printf( "FAIL the packet never reached the engine\n" );
+      return false;
+    }
+    std::this_thread::yield();
+    ptr_engine->Update();
+  }
+  return true;
+}
+
+static bool TestCase( ESP32Artnet2DMX* ptr_engine, MockFrameTimer* ptr_timer, const FrameTimerCase& test_case ) {
+  HostDmxSetLineUs( test_case.m_line_us );
+  unsigned long sent_start = HostDmxGetSentCount();
+  ptr_timer->Run( TEST_START_US + (uint64_t)test_case.m_periods * TEST_PERIOD_US, test_case.m_delay );
+
+  // Stopped, time moves on without frames.
+  ptr_engine->Stop();
+  ptr_timer->Run( TEST_START_US + (uint64_t)( test_case.m_periods + 10 ) * TEST_PERIOD_US, NoDelay );
+
+  const NodeStats&   stats  = ptr_engine->GetNodeStats();
+  const FrameJitter& jitter = stats.m_dmx_jitter;
+  bool passed = stats.m_dmx_frames == test_case.m_frames
+             && HostDmxGetSentCount() - sent_start == test_case.m_frames
+             && stats.m_dmx_frames_late == test_case.m_frames_late
+             && jitter.GetCount() == test_case.m_jitter_count
+             && jitter.GetPercentileUs( 500 ) == test_case.m_p50_us
+             && jitter.GetPercentileUs( 990 ) == test_case.m_p99_us
+             && jitter.GetMaxUs() == test_case.m_max_us;
+  if( !passed ) {
+    printf( "FAIL %s, %lu frames, %lu sent, %lu late, jitter count %lu, p50 %u, p99 %u, max %u us\n", test_case.m_ptr_name,
+            stats.m_dmx_frames, HostDmxGetSentCount() - sent_start, stats.m_dmx_frames_late, jitter.GetCount(),
+            jitter.GetPercentileUs( 500 ), jitter.GetPercentileUs( 990 ), jitter.GetMaxUs() );
+  }
+  return passed;
+}
+
+static size_t BuildArtDmx( uint8_t* ptr_packet, const uint8_t* ptr_data, int length ) {
+  memset( ptr_packet, 0, ARTNET_PACKET_MAXSIZE );
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)ptr_packet;
+  memcpy( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) );
+  ptr_header->m_OpCode = ARTNET_OPCODE_DMX;
+
+  ArtNetPacketDMX* ptr_packet_dmx = (ArtNetPacketDMX*)&ptr_packet[ ARTNET_PACKET_PAYLOAD_START ];
+  ptr_packet_dmx->m_ProtocolLo = ARTNET_VERSION;
+  ptr_packet_dmx->m_Sequence   = 1;
+  ptr_packet_dmx->m_SubUni     = TEST_UNIVERSE & 0xFF;
+  ptr_packet_dmx->m_Net        = TEST_UNIVERSE >> 8;
+  ptr_packet_dmx->m_LengthHi   = length >> 8;
+  ptr_packet_dmx->m_Length     = length & 0xFF;
+  memcpy( ptr_packet_dmx->m_Data, ptr_data, length );
+  return ARTNET_PACKET_DMX_DATA_START + length;
+}
+
+// An ArtDmx published by loop() goes out from the timer, only the slots in use, start code first.
+static bool TestFrameCopy( ESP32Artnet2DMX* ptr_engine, MockFrameTimer* ptr_timer, UdpSocket* ptr_socket ) {
+  static const uint8_t data[] = { 10, 20, 30, 40 };
+  uint8_t              packet[ ARTNET_PACKET_MAXSIZE ];
+  size_t               length = BuildArtDmx( packet, data, sizeof( data ) );
+  if( !SendArtNet( ptr_engine, ptr_socket, packet, length ) ) {
+    return false;
+  }
+  ptr_timer->Run( TEST_START_US + 2 * TEST_PERIOD_US, NoDelay );
+
+  const NodeStats& stats = ptr_engine->GetNodeStats();
+  size_t           size;
+  const uint8_t*   ptr_frame = HostDmxGetSentFrame( &size );
+  bool passed = stats.m_dmx_frames == 2
+             && size == (size_t)stats.m_dmx_frame_slots + 1
+             && stats.m_dmx_frame_slots >= DMX_FRAME_SLOTS_MIN && stats.m_dmx_frame_slots < DMX_FRAME_SLOTS_MAX
+             && ptr_frame[ 0 ] == 0
+             && memcmp( &ptr_frame[ 1 ], data, sizeof( data ) ) == 0;
+  for( size_t i = 1 + sizeof( data ); i < size && passed; i++ ) {
+    passed = ( ptr_frame[ i ] == 0 );
+  }
+  if( !passed ) {
+    printf( "FAIL frame_copy, %lu frames, %d slots, %d bytes sent, first slots %d %d %d %d %d\n", stats.m_dmx_frames,
+            stats.m_dmx_frame_slots, (int)size, ptr_frame[ 0 ], ptr_frame[ 1 ], ptr_frame[ 2 ], ptr_frame[ 3 ], ptr_frame[ 4 ] );
+  }
+  ptr_engine->Stop();
+  return passed;
+}
+
+// ArtSync hands the output to loop(): the latched frame is sent at once & the timer stands down.  Only the source
+// of the ArtDmx may sync.
+static bool TestSync( ESP32Artnet2DMX* ptr_engine, MockFrameTimer* ptr_timer, UdpSocket* ptr_socket ) {
+  static const uint8_t data[] = { 10, 20, 30, 40 };
+  uint8_t              packet[ ARTNET_PACKET_MAXSIZE ];
+  size_t               length = BuildArtDmx( packet, data, sizeof( data ) );
+  if( !SendArtNet( ptr_engine, ptr_socket, packet, length ) ) {
+    return false;
+  }
+  ptr_timer->Run( TEST_START_US + 10 * TEST_PERIOD_US, NoDelay );
+
+  memset( packet, 0, ARTNET_PACKET_MAXSIZE );
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)packet;
+  memcpy( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) );
+  ptr_header->m_OpCode = ARTNET_OPCODE_SYNC;
+  ArtNetPacketSync* ptr_packet_sync = (ArtNetPacketSync*)&packet[ ARTNET_PACKET_PAYLOAD_START ];
+  ptr_packet_sync->m_ProtocolLo = ARTNET_VERSION;
+  if( !SendArtNet( ptr_engine, ptr_socket, packet, ARTNET_PACKET_PAYLOAD_START + sizeof( ArtNetPacketSync ) ) ) {
+    return false;
+  }
+  ptr_timer->Run( TEST_START_US + 100 * TEST_PERIOD_US, NoDelay );
+
+  const NodeStats& stats = ptr_engine->GetNodeStats();
+  bool passed = stats.m_dmx_frames == 11 && HostDmxGetSentCount() == 11 && stats.m_sync_count == 1 && stats.m_dmx_frames_late == 0;
+  if( !passed ) {
+    printf( "FAIL sync, %lu frames, %lu sent, %lu syncs, %lu late\n", stats.m_dmx_frames, HostDmxGetSentCount(), stats.m_sync_count,
+            stats.m_dmx_frames_late );
+  }
+  ptr_engine->Stop();
+  return passed;
+}
+
+int main( int argc, char** argv ) {
+  if( argc != 3 ) {
+    printf( "test_frame_timer <config directory> <case>\n" );
+    return 1;
+  }
+  std::string case_name = argv[ 2 ];
+
+  // Not deleted, the receive & logger tasks are threads that end with the process.
+  LittleFS.SetHostRoot( argv[ 1 ] );
+  MockFrameTimer*  ptr_timer  = new MockFrameTimer();
+  ESP32Artnet2DMX* ptr_engine = new ESP32Artnet2DMX();
+  ptr_engine->SetFrameTimer( ptr_timer );
+  ptr_engine->Init();
+
+  // Benchmarks in Init() need a running clock, from here time only moves with the timer.
+  HostClockSet( TEST_START_US );
+  ptr_engine->Update();
+
+  UdpSocket socket;
+  bool      passed = ptr_engine->IsStarted() && socket.Begin( 0, 0 );
+  if( !passed ) {
+    printf( "FAIL the engine didn't start\n" );
+  } else if( case_name == "frame_copy" ) {
+    passed = TestFrameCopy( ptr_engine, ptr_timer, &socket );
+  } else if( case_name == "sync" ) {
+    passed = TestSync( ptr_engine, ptr_timer, &socket );
+  } else {
+    const FrameTimerCase* ptr_case = nullptr;
+    for( const FrameTimerCase& test_case : s_cases ) {
+      if( case_name == test_case.m_ptr_name ) {
+        ptr_case = &test_case;
+      }
+    }
+    if( ptr_case == nullptr ) {
+      printf( "FAIL no case %s\n", case_name.c_str() );
+      passed = false;
+    } else {
+      passed = TestCase( ptr_engine, ptr_timer, *ptr_case );
+    }
+  }
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <stdio.h>
+#include "ChannelModsOptimizer.h"
+#include "ChannelModsHandler.h"
+
+// Randomized differential test of ChannelModsOptimizer: the optimized list has to give the same output as the
+// configured one through ChannelModsHandler::ApplyMods(), for any DMX & Art-Net data.  The lists are built to hit
+// each rewrite: constants to fold, overwritten mods, add & minus chains to merge & cross channel reads to reorder.
+
+#define TEST_LISTS         20000
+#define TEST_FRAMES        8
+#define TEST_MODS_MAX      40
+#define TEST_VALUE_MAX     600   // Values above 512 read past the buffers ..
+#define TEST_PADDING       128   // .. into this, which is the same for both lists.
+
+static uint32_t s_random_state = 1;
+
+static uint32_t NextRandom() {
+  // xorshift32, so a failing list repeats.
+  s_random_state ^= s_random_state << 13;
+  s_random_state ^= s_random_state >> 17;
+  s_random_state ^= s_random_state << 5;
+  return s_random_state;
+}
+
+static uint8_t RandomValue() {
+  uint32_t random = NextRandom();
+  switch( random & 3 ) {
+    case 0:  return 0;
+    case 1:  return 255;
+    default: return random >> 8;
+  }
+}
+
+static ChannelMod RandomMod( unsigned int window_start, bool opaque ) {
+  ChannelMod mod;
+  mod.m_channel  = ( NextRandom() % 32 == 0 ) ? 512 + NextRandom() % 3 : window_start + NextRandom() % 6;
+  mod.m_mod_type = NextRandom() % ( CHANNELMODTYPE::MAX + 1 );
+
+  uint32_t random = NextRandom();
+  switch( random % 8 ) {
+    case 0:  mod.m_mod_value = 0;   break;
+    case 1:  mod.m_mod_value = 255; break;
+    case 2:  mod.m_mod_value = 1 + ( random >> 8 ) % 255; break;
+    case 3:  mod.m_mod_value = mod.m_channel; break;
+    case 4:  mod.m_mod_value = opaque ? 256 + ( random >> 8 ) % ( TEST_VALUE_MAX - 255 ) : 256 + ( random >> 8 ) % 257; break;
+    default: mod.m_mod_value = window_start + ( random >> 8 ) % 6; break;
+  }
+  if( !opaque && mod.m_mod_value == 0 && mod.m_mod_type >= CHANNELMODTYPE::COPY_FROM_ARTNET ) {
+    mod.m_mod_value = 1;
+  }
+  return mod;
+}
+
+static void RandomList( std::vector< ChannelMod >& mods, bool opaque ) {
+  // A small window of channels, so the mods read & write each other.
+  unsigned int window_start = 1 + NextRandom() % 507;
+  int          count        = NextRandom() % ( TEST_MODS_MAX + 1 );
+
+  mods.clear();
+  for( int i = 0; i < count; i++ ) {
+    ChannelMod mod = RandomMod( window_start, opaque );
+    if( i > 0 && NextRandom() % 4 == 0 ) {
+      // Same channel & type as the previous mod, a chain to merge or a value to overwrite.
+      mod.m_channel  = mods.back().m_channel;
+      mod.m_mod_type = mods.back().m_mod_type;
+    }
+    mod.m_sequence = ( i + 1 ) * 10;
+    mods.push_back( mod );
+  }
+}
+
+// Same rule as the optimizer: the mod reads outside the DMX or Art-Net data.
+static bool ReadsPastData( const ChannelMod& mod ) {
+  if( mod.m_channel > 512 ) {
+    return false;
+  }
+  switch( mod.m_mod_type ) {
+    case CHANNELMODTYPE::COPY_FROM_CHANNEL:
+    case CHANNELMODTYPE::ADD_FROM_CHANNEL:
+    case CHANNELMODTYPE::MINUS_FROM_CHANNEL:
+      return mod.m_mod_value > 512;
+    case CHANNELMODTYPE::COPY_FROM_ARTNET:
+    case CHANNELMODTYPE::ADD_FROM_ARTNET:
+    case CHANNELMODTYPE::MINUS_FROM_ARTNET:
+    case CHANNELMODTYPE::IF_0_ADD_FROM_ARTNET:
+      return mod.m_mod_value < 1 || mod.m_mod_value > 512;
+    default:
+      return false;
+  }
+}
+
+static void PrintList( const char* ptr_name, const std::vector< ChannelMod >& mods ) {
+  printf( "  %s\n", ptr_name );
+  for( const ChannelMod& mod : mods ) {
+    printf( "    sequence %u, channel %u, %s %u\n", mod.m_sequence, mod.m_channel, ModTypeAsString( mod.m_mod_type ), mod.m_mod_value );
+  }
+}
+
+// Runs both lists on the same random frames, returns the first channel that differs, -1 if none.
+static int FirstDifference( const std::vector< ChannelMod >& mods, const std::vector< ChannelMod >& optimized ) {
+  static uint8_t artnet[ 1 + 512 + TEST_PADDING ];
+  static uint8_t dmx[ 513 + TEST_PADDING ];
+  static uint8_t dmx_optimized[ 513 + TEST_PADDING ];
+
+  for( int frame = 0; frame < TEST_FRAMES; frame++ ) {
+    for( int i = 0; i < (int)sizeof( artnet ); i++ ) {
+      artnet[ i ] = RandomValue();
+    }
+    for( int i = 0; i < (int)sizeof( dmx ); i++ ) {
+      dmx[ i ] = RandomValue();
+    }
+    memcpy( dmx_optimized, dmx, sizeof( dmx ) );
+
+    // Art-Net data starts at artnet[ 1 ], so a value of 0 reads artnet[ 0 ] in both.
+    ChannelModsHandler::ApplyMods( mods, dmx, &artnet[ 1 ] );
+    ChannelModsHandler::ApplyMods( optimized, dmx_optimized, &artnet[ 1 ] );
+
+    for( int channel = 0; channel < 513; channel++ ) {
+      if( dmx[ channel ] != dmx_optimized[ channel ] ) {
+        return channel;
+      }
+    }
+  }
+  return -1;
+}
+
+static bool TestRandomLists( bool opaque ) {
+  static ChannelModsOptimizer optimizer;
+  std::vector< ChannelMod > mods;
+  std::vector< ChannelMod > optimized;
+  std::vector< ChannelMod > optimized_again;
+
+  for( int list = 0; list < TEST_LISTS; list++ ) {
+    uint32_t list_seed = s_random_state;
+    RandomList( mods, opaque );
+    optimizer.Optimize( mods, optimized );
+
+    int channel = FirstDifference( mods, optimized );
+    if( channel >= 0 ) {
+      printf( "FAIL optimized output differs on channel %d, list %d, seed %u\n", channel, list, list_seed );
+      PrintList( "configured", mods );
+      PrintList( "optimized", optimized );
+      return false;
+    }
+    if( optimized.size() > mods.size() || optimizer.GetModsIn() != (int)mods.size() || optimizer.GetModsOut() != (int)optimized.size() ) {
+      printf( "FAIL %d mods optimized to %d, list %d, seed %u\n", (int)mods.size(), (int)optimized.size(), list, list_seed );
+      return false;
+    }
+
+    // Optimizing again finds nothing new that changes the output, & never grows the list.
+    optimizer.Optimize( optimized, optimized_again );
+    if( optimized_again.size() > optimized.size() || FirstDifference( mods, optimized_again ) >= 0 ) {
+      printf( "FAIL optimizing twice, list %d, seed %u\n", list, list_seed );
+      PrintList( "optimized", optimized );
+      PrintList( "optimized again", optimized_again );
+      return false;
+    }
+
+    // Verify() has to agree, & refuse lists reading past its buffers.
+    bool reads_past_data = std::any_of( mods.begin(), mods.end(), ReadsPastData ) || std::any_of( optimized.begin(), optimized.end(), ReadsPastData );
+    if( ChannelModsOptimizer::Verify( mods, optimized, 4 ) == reads_past_data ) {
+      printf( "FAIL Verify(), list %d, seed %u\n", list, list_seed );
+      return false;
+    }
+  }
+  return true;
+}
+
+struct OptimizerCase {
+  const char*               m_ptr_name;
+  std::vector< ChannelMod > m_mods;
+  int                       m_mods_out;
+};
+
+static bool TestKnownLists() {
+  // { sequence, channel, type, value }
+  static const OptimizerCase cases[] = {
+    { "add 0",             { { 10, 1, CHANNELMODTYPE::ADD_VALUE, 0 } }, 0 },
+    { "self copy",         { { 10, 5, CHANNELMODTYPE::COPY_FROM_CHANNEL, 5 } }, 0 },
+    { "channel above 512", { { 10, 513, CHANNELMODTYPE::EQUALS_VALUE, 9 } }, 0 },
+    { "equals then add",   { { 10, 1, CHANNELMODTYPE::EQUALS_VALUE, 100 }, { 20, 1, CHANNELMODTYPE::ADD_VALUE, 20 } }, 1 },
+    { "overwritten",       { { 10, 2, CHANNELMODTYPE::ADD_VALUE, 5 }, { 20, 2, CHANNELMODTYPE::EQUALS_VALUE, 7 } }, 1 },
+    { "add chain",         { { 10, 3, CHANNELMODTYPE::ADD_VALUE, 200 }, { 20, 3, CHANNELMODTYPE::ADD_VALUE, 100 } }, 1 },
+    { "read before write", { { 10, 4, CHANNELMODTYPE::ADD_VALUE, 5 }, { 20, 6, CHANNELMODTYPE::COPY_FROM_CHANNEL, 4 }, { 30, 4, CHANNELMODTYPE::EQUALS_VALUE, 1 } }, 3 },
+  };
+
+  ChannelModsOptimizer      optimizer;
+  std::vector< ChannelMod > optimized;
+  bool                      passed = true;
+
+  for( const OptimizerCase& test_case : cases ) {
+    optimizer.Optimize( test_case.m_mods, optimized );
+    if( (int)optimized.size() != test_case.m_mods_out || FirstDifference( test_case.m_mods, optimized ) >= 0 ) {
+      printf( "FAIL %s, %d mods, expected %d\n", test_case.m_ptr_name, (int)optimized.size(), test_case.m_mods_out );
+      PrintList( "optimized", optimized );
+      passed = false;
+    }
+  }
+  return passed;
+}
+
+int main() {
+  bool passed = true;
+  passed &= TestKnownLists();
+  passed &= TestRandomLists( false );
+  passed &= TestRandomLists( true );
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
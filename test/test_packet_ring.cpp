@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
+#include "PacketRing.h"
+
+// Stress test of PacketRing with a producer & a consumer thread, the way the network receive task & loop() use
+// it.  Built with -fsanitize=thread, so a missing acquire / release on the indexes shows up as a data race, on
+// top of the consumer checking every datagram arrives once, in order, with its tag & the content written.
+
+#define TEST_DATAGRAMS  200000
+#define TEST_BATCH_MAX  UDP_SOCKET_BATCH_MAX
+
+static std::atomic< bool > s_failed( false );   // Stops the producer.
+
+// Fills the slot the way ReceiveBatch() does, the content follows from the datagram number.
+static void WriteDatagram( UdpDatagram* ptr_datagram, uint32_t number ) {
+  int length = 18 + number % ( PACKET_RING_SLOT_SIZE - 18 );
+  for( int i = 0; i < length; i++ ) {
+    ptr_datagram->m_ptr_buffer[ i ] = (uint8_t)( number + i );
+  }
+  memcpy( ptr_datagram->m_ptr_buffer, &number, sizeof( number ) );
+  ptr_datagram->m_length      = length;
+  ptr_datagram->m_truncated   = false;
+  ptr_datagram->m_source_ip   = number;
+  ptr_datagram->m_source_port = 6454;
+  ptr_datagram->m_received_us = number;
+}
+
+static bool CheckDatagram( const UdpDatagram* ptr_datagram, uint32_t number ) {
+  uint32_t written;
+  memcpy( &written, ptr_datagram->m_ptr_buffer, sizeof( written ) );
+  if( written != number || ptr_datagram->m_source_ip != number || ptr_datagram->m_received_us != number ) {
+    printf( "FAIL datagram %u arrived as %u\n", number, written );
+    return false;
+  }
+  if( ptr_datagram->m_length != 18 + (int)( number % ( PACKET_RING_SLOT_SIZE - 18 ) ) ) {
+    printf( "FAIL datagram %u length %d\n", number, ptr_datagram->m_length );
+    return false;
+  }
+  for( int i = sizeof( number ); i < ptr_datagram->m_length; i++ ) {
+    if( ptr_datagram->m_ptr_buffer[ i ] != (uint8_t)( number + i ) ) {
+      printf( "FAIL datagram %u byte %d\n", number, i );
+      return false;
+    }
+  }
+  return true;
+}
+
+static void Produce( PacketRing* ptr_ring ) {
+  uint32_t number = 0;
+  uint32_t random = 1;
+
+  while( number < TEST_DATAGRAMS && !s_failed.load() ) {
+    UdpDatagram* ptr_datagrams;
+    int          free_slots = ptr_ring->GetWriteSlots( &ptr_datagrams );
+    if( free_slots == 0 ) {
+      ptr_ring->AddOverruns( 1 );
+      std::this_thread::yield();
+      continue;
+    }
+
+    // Batches of 1 to TEST_BATCH_MAX, as many as fit.
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    int count = 1 + random % TEST_BATCH_MAX;
+    if( count > free_slots ) {
+      count = free_slots;
+    }
+    if( count > (int)( TEST_DATAGRAMS - number ) ) {
+      count = TEST_DATAGRAMS - number;
+    }
+
+    for( int i = 0; i < count; i++ ) {
+      WriteDatagram( &ptr_datagrams[ i ], number + i );
+    }
+    // Tagged with the number of its first datagram.
+    ptr_ring->Publish( count, (int)number );
+    number += count;
+  }
+}
+
+static bool Consume( PacketRing* ptr_ring ) {
+  uint32_t number   = 0;
+  int      tag_last = 0;
+
+  while( number < TEST_DATAGRAMS ) {
+    int occupancy = ptr_ring->GetOccupancy();
+    if( occupancy < 0 || occupancy > PACKET_RING_SLOTS ) {
+      printf( "FAIL occupancy %d\n", occupancy );
+      return false;
+    }
+
+    int                tag;
+    const UdpDatagram* ptr_datagram = ptr_ring->Peek( &tag );
+    if( ptr_datagram == nullptr ) {
+      std::this_thread::yield();
+      continue;
+    }
+    if( !CheckDatagram( ptr_datagram, number ) ) {
+      return false;
+    }
+    // The tag of a batch is on each of its datagrams.
+    if( tag < tag_last || tag > (int)number || (int)number - tag >= TEST_BATCH_MAX ) {
+      printf( "FAIL datagram %u tag %d\n", number, tag );
+      return false;
+    }
+    tag_last = tag;
+    ptr_ring->Release();
+    number++;
+  }
+  return true;
+}
+
+int main() {
+  static PacketRing ring;
+  bool              passed = true;
+
+  std::thread producer( Produce, &ring );
+  passed &= Consume( &ring );
+  s_failed.store( !passed );
+  producer.join();
+
+  if( passed && ring.GetOccupancy() != 0 ) {
+    printf( "FAIL %d datagrams left in the ring\n", ring.GetOccupancy() );
+    passed = false;
+  }
+  printf( "%u datagrams, %lu times full\n", (unsigned int)TEST_DATAGRAMS, ring.GetOverruns() );
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
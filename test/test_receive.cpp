@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <thread>
+#include <LittleFS.h>
+#include "ESP32Artnet2DMX.h"
+#include "UdpSocket.h"
+
+// Receive throughput over loopback: bursts of ArtDmx go to the engine's Art-Net socket, where the receive task
+// peeks, batches & rejects them into the ring as on the node, & loop() handles them.  A burst is sent whole
+// before the next, so the ring never overruns & every datagram must be handled or rejected.  Per phase the
+// datagrams per second, the receive task's time per accepted & rejected ArtDmx & the datagrams per batch are
+// printed.
+//
+//   test_receive <config directory>
+//
+// The config directory has the node's config_adapter.json & config_mods.json, for universe TEST_UNIVERSE.
+
+#define TEST_BURSTS      2000
+#define TEST_BURST_MAX   16
+#define TEST_UNIVERSE    1
+#define TEST_WAIT_MS     2000    // Wall clock time a burst may take to be handled.
+
+struct ReceivePhase {
+  const char* m_ptr_name;
+  const char* m_ptr_burst;       // One datagram per character: a = accepted, r = rejected.
+};
+
+static const ReceivePhase s_phases[] = {
+  { "accepted", "aaaaaaaa" },
+  { "rejected", "rrrrrrrrrrrrrrrr" },
+  { "mixed",    "arararararararar" },
+  { "runs",     "rrrraaaarrrraaaa" },
+};
+
+static size_t BuildArtDmx( uint8_t* ptr_packet, uint16_t universe, uint8_t sequence ) {
+  memset( ptr_packet, 0, ARTNET_PACKET_MAXSIZE );
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)ptr_packet;
+  memcpy( ptr_header->m_ID, ARTNET_HEADER_ID, sizeof( ptr_header->m_ID ) );
+  ptr_header->m_OpCode = ARTNET_OPCODE_DMX;
+
+  ArtNetPacketDMX* ptr_packet_dmx = (ArtNetPacketDMX*)&ptr_packet[ ARTNET_PACKET_PAYLOAD_START ];
+  ptr_packet_dmx->m_ProtocolLo = ARTNET_VERSION;
+  ptr_packet_dmx->m_Sequence   = sequence;
+  ptr_packet_dmx->m_SubUni     = universe & 0xFF;
+  ptr_packet_dmx->m_Net        = universe >> 8;
+  ptr_packet_dmx->m_LengthHi   = 512 >> 8;
+  ptr_packet_dmx->m_Length     = 512 & 0xFF;
+  for( int i = 0; i < 512; i++ ) {
+    ptr_packet_dmx->m_Data[ i ] = (uint8_t)( sequence + i );
+  }
+  return ARTNET_PACKET_DMX_DATA_START + 512;
+}
+
+static bool RunPhase( ESP32Artnet2DMX* ptr_engine, UdpSocket* ptr_socket, const ReceivePhase& phase ) {
+  static uint8_t   packets[ TEST_BURST_MAX ][ ARTNET_PACKET_MAXSIZE ];
+  size_t           lengths[ TEST_BURST_MAX ];
+  int              burst_size = strlen( phase.m_ptr_burst );
+  const NodeStats& stats      = ptr_engine->GetNodeStats();
+
+  unsigned long      dequeued_start    = stats.m_ring_dequeued;
+  unsigned long      rejected_start    = stats.m_artnet_rejected_count;
+  unsigned long      accepted_start    = stats.m_artnet_accepted_count;
+  unsigned long long accepted_us_start = stats.m_artnet_accepted_us_total;
+  unsigned long long rejected_us_start = stats.m_artnet_rejected_us_total;
+  unsigned long      batches_start     = stats.m_socket_batches;
+  unsigned long      received_start    = stats.m_socket_received;
+  unsigned long      expected_accepted = 0;
+  unsigned long      expected_rejected = 0;
+  uint8_t            sequence          = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for( int burst = 0; burst < TEST_BURSTS; burst++ ) {
+    for( int i = 0; i < burst_size; i++ ) {
+      bool accepted = ( phase.m_ptr_burst[ i ] == 'a' );
+      sequence      = ( sequence == 255 ) ? 1 : sequence + 1;
+      lengths[ i ]  = BuildArtDmx( packets[ i ], accepted ? TEST_UNIVERSE : TEST_UNIVERSE + 1, sequence );
+      expected_accepted += accepted ? 1 : 0;
+      expected_rejected += accepted ? 0 : 1;
+    }
+    for( int i = 0; i < burst_size; i++ ) {
+      if( !ptr_socket->SendTo( htonl( INADDR_LOOPBACK ), ARTNET_UDP_PORT, packets[ i ], lengths[ i ] ) ) {
+        printf( "FAIL %s, sending burst %d\n", phase.m_ptr_name, burst );
+        return false;
+      }
+    }
+
+    auto wait_start = std::chrono::steady_clock::now();
+    while( stats.m_ring_dequeued - dequeued_start < expected_accepted || stats.m_artnet_rejected_count - rejected_start < expected_rejected ) {
+      if( std::chrono::steady_clock::now() - wait_start > std::chrono::milliseconds( TEST_WAIT_MS ) ) {
+        printf( "FAIL %s, burst %d, %lu of %lu handled, %lu of %lu rejected, %lu overruns\n", phase.m_ptr_name, burst,
+                stats.m_ring_dequeued - dequeued_start, expected_accepted, stats.m_artnet_rejected_count - rejected_start,
+                expected_rejected, stats.m_ring_overruns );
+        return false;
+      }
+      std::this_thread::yield();
+      ptr_engine->Update();
+    }
+  }
+  double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+  unsigned long dequeued = stats.m_ring_dequeued - dequeued_start;
+  unsigned long rejected = stats.m_artnet_rejected_count - rejected_start;
+  unsigned long accepted = stats.m_artnet_accepted_count - accepted_start;
+  unsigned long batches  = stats.m_socket_batches - batches_start;
+  unsigned long received = stats.m_socket_received - received_start;
+  if( dequeued != expected_accepted || accepted != expected_accepted || rejected != expected_rejected || stats.m_ring_overruns != 0 ) {
+    printf( "FAIL %s, %lu handled & %lu accepted of %lu, %lu of %lu rejected, %lu overruns\n", phase.m_ptr_name, dequeued, accepted,
+            expected_accepted, rejected, expected_rejected, stats.m_ring_overruns );
+    return false;
+  }
+
+  printf( "%-8s %lu datagrams in %.3f s, %.0f datagrams/s, %.2f us per accepted, %.2f us per rejected, %.1f received per batch\n",
+          phase.m_ptr_name, dequeued + rejected, seconds, ( dequeued + rejected ) / seconds,
+          accepted > 0 ? (double)( stats.m_artnet_accepted_us_total - accepted_us_start ) / accepted : 0.0,
+          rejected > 0 ? (double)( stats.m_artnet_rejected_us_total - rejected_us_start ) / rejected : 0.0,
+          batches > 0 ? (double)received / batches : 0.0 );
+  return true;
+}
+
+int main( int argc, char** argv ) {
+  if( argc != 2 ) {
+    printf( "test_receive <config directory>\n" );
+    return 1;
+  }
+
+  // Not deleted, the receive & logger tasks are threads that end with the process.
+  LittleFS.SetHostRoot( argv[ 1 ] );
+  ESP32Artnet2DMX* ptr_engine = new ESP32Artnet2DMX();
+  ptr_engine->Init();
+  ptr_engine->Update();
+
+  UdpSocket socket;
+  bool      passed = ptr_engine->IsStarted() && socket.Begin( 0, 0 );
+  if( !passed ) {
+    printf( "FAIL the engine didn't start\n" );
+  }
+  for( const ReceivePhase& phase : s_phases ) {
+    passed = passed && RunPhase( ptr_engine, &socket, phase );
+  }
+  ptr_engine->Stop();
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
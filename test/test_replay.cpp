@@ -0,0 +1,584 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <esp_dmx.h>
+#include "AllocTracker.h"
+#include "ESP32Artnet2DMX.h"
+
+// Replays a capture through the whole engine on the host, a regression test on recorded traffic.
+//
+//   test_replay <case directory> [ --update ]
+//
+// The case directory is a corpus entry: config_adapter.json & config_mods.json as the node would have them in
+// LittleFS, capture.pcap with the Art-Net & sACN traffic, & expected.txt.  Every datagram is sent over loopback
+// to the engine's own sockets, so it goes through the receive task, the ring & CheckForNetworkData() like on
+// the node.  The clock is virtual & follows the capture: between datagrams loop() & the DMX frame timer run at
+// the times they would have, & the DMX driver stub records the frames.  What the engine did with each datagram,
+// every change of the DMX output & the ArtPollReplies it sent make up the log, which must match expected.txt.
+// Any allocation on the hot path fails the replay, malloc() & realloc() included.
+// --update writes expected.txt instead, after a change that is meant to alter the output.
+//
+// Captured sources a.b.c.d are sent from 127.b.c.d, so a config that only allows some sources lists those.
+// Link types read are raw IP, Ethernet, Linux cooked & BSD loopback, IPv4 only.  tools/pcap_replay.py corpus
+// turns other captures, pcapng included, into a capture.pcap.
+
+#define REPLAY_WAIT_MS        2000    // Wall clock time a datagram may take to reach the engine.
+#define REPLAY_LOOPBACK_IP    0x7F000001
+#define REPLAY_START_US       1000000000ULL   // Virtual time of the first datagram, clear of 0 & wraps.
+#define REPLAY_TAIL_US        5000000         // Run on after the last datagram, past the Art-Net & ArtSync timeouts.
+
+#define PCAP_MAGIC_US         0xA1B2C3D4
+#define PCAP_MAGIC_NS         0xA1B23C4D
+#define LINKTYPE_NULL         0
+#define LINKTYPE_ETHERNET     1
+#define LINKTYPE_RAW          101
+#define LINKTYPE_LOOP         108
+#define LINKTYPE_SLL          113
+#define LINKTYPE_IPV4         228
+
+struct CapturedDatagram {
+  uint64_t               m_time_us;     // From the first datagram.
+  uint32_t               m_source_ip;   // Network order.
+  uint16_t               m_port;        // Destination, ARTNET_UDP_PORT or E131_UDP_PORT.
+  std::vector< uint8_t > m_payload;
+};
+
+static uint32_t ReadUint32( const uint8_t* ptr_data, bool swapped ) {
+  uint32_t value;
+  memcpy( &value, ptr_data, sizeof( value ) );
+  return swapped ? __builtin_bswap32( value ) : value;
+}
+
+// Offset of the IPv4 header in a link layer frame, -1 if it isn't IPv4.
+static int NetworkOffset( uint32_t linktype, const uint8_t* ptr_frame, size_t length ) {
+  switch( linktype ) {
+    case LINKTYPE_ETHERNET: {
+      size_t offset = 12;
+      while( offset + 2 <= length ) {
+        uint16_t ethertype = ptr_frame[ offset ] << 8 | ptr_frame[ offset + 1 ];
+        if( ethertype == 0x8100 || ethertype == 0x88A8 ) {
+          offset += 4;
+          continue;
+        }
+        return ( ethertype == 0x0800 ) ? (int)offset + 2 : -1;
+      }
+      return -1;
+    }
+    case LINKTYPE_SLL:
+      return ( length >= 16 && ( ptr_frame[ 14 ] << 8 | ptr_frame[ 15 ] ) == 0x0800 ) ? 16 : -1;
+    case LINKTYPE_NULL:
+    case LINKTYPE_LOOP:
+      // Address family in the byte order of the capturing host, 2 is IPv4.
+      return ( length >= 4 && ( ReadUint32( ptr_frame, false ) == 2 || ReadUint32( ptr_frame, true ) == 2 ) ) ? 4 : -1;
+    case LINKTYPE_RAW:
+    case LINKTYPE_IPV4:
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+// Unfragmented IPv4 UDP datagrams to the Art-Net or sACN port.
+static bool ParseFrame( uint32_t linktype, const uint8_t* ptr_frame, size_t length, CapturedDatagram* ptr_datagram ) {
+  int offset = NetworkOffset( linktype, ptr_frame, length );
+  if( offset < 0 || (size_t)offset + 20 > length ) {
+    return false;
+  }
+  const uint8_t* ptr_ip        = &ptr_frame[ offset ];
+  size_t         header_length = ( ptr_ip[ 0 ] & 0x0F ) * 4;
+  uint16_t       fragment      = ( ptr_ip[ 6 ] << 8 | ptr_ip[ 7 ] ) & 0x3FFF;
+  if( ( ptr_ip[ 0 ] >> 4 ) != 4 || ptr_ip[ 9 ] != 17 || fragment != 0 || offset + header_length + 8 > length ) {
+    return false;
+  }
+
+  const uint8_t* ptr_udp    = &ptr_ip[ header_length ];
+  uint16_t       port       = ptr_udp[ 2 ] << 8 | ptr_udp[ 3 ];
+  size_t         udp_length = ptr_udp[ 4 ] << 8 | ptr_udp[ 5 ];
+  if( ( port != ARTNET_UDP_PORT && port != E131_UDP_PORT ) || udp_length < 8 ) {
+    return false;
+  }
+  size_t payload_length = std::min( udp_length - 8, length - offset - header_length - 8 );
+
+  memcpy( &ptr_datagram->m_source_ip, &ptr_ip[ 12 ], sizeof( ptr_datagram->m_source_ip ) );
+  ptr_datagram->m_port = port;
+  ptr_datagram->m_payload.assign( &ptr_udp[ 8 ], &ptr_udp[ 8 ] + payload_length );
+  return true;
+}
+
+static bool ReadCapture( const std::string& filename, std::vector< CapturedDatagram >* ptr_datagrams ) {
+  std::ifstream file( filename, std::ios::binary );
+  std::string   data( ( std::istreambuf_iterator< char >( file ) ), std::istreambuf_iterator< char >() );
+  const uint8_t* ptr_data = (const uint8_t*)data.data();
+  if( data.size() < 24 ) {
+    printf( "FAIL %s is not a pcap file\n", filename.c_str() );
+    return false;
+  }
+
+  uint32_t magic   = ReadUint32( ptr_data, false );
+  bool     swapped = ( magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS );
+  magic            = ReadUint32( ptr_data, swapped );
+  if( magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS ) {
+    printf( "FAIL %s is not a classic pcap file, tools/pcap_replay.py corpus converts it\n", filename.c_str() );
+    return false;
+  }
+  uint64_t fraction_ns = ( magic == PCAP_MAGIC_NS ) ? 1 : 1000;
+  uint32_t linktype    = ReadUint32( &ptr_data[ 20 ], swapped ) & 0x0FFFFFFF;
+
+  bool     first      = true;
+  uint64_t start_ns   = 0;
+  size_t   position   = 24;
+  while( position + 16 <= data.size() ) {
+    uint64_t time_ns  = ReadUint32( &ptr_data[ position ], swapped ) * 1000000000ULL + ReadUint32( &ptr_data[ position + 4 ], swapped ) * fraction_ns;
+    size_t   captured = ReadUint32( &ptr_data[ position + 8 ], swapped );
+    position += 16;
+    if( position + captured > data.size() ) {
+      break;
+    }
+
+    CapturedDatagram datagram;
+    if( ParseFrame( linktype, &ptr_data[ position ], captured, &datagram ) ) {
+      if( first ) {
+        start_ns = time_ns;
+        first    = false;
+      }
+      // Out of order records are sent at the time of the one before.
+      datagram.m_time_us = ( time_ns > start_ns ) ? ( time_ns - start_ns ) / 1000 : 0;
+      if( !ptr_datagrams->empty() && datagram.m_time_us < ptr_datagrams->back().m_time_us ) {
+        datagram.m_time_us = ptr_datagrams->back().m_time_us;
+      }
+      ptr_datagrams->push_back( datagram );
+    }
+    position += captured;
+  }
+  return true;
+}
+
+// Stands in for the esp_timer, fired by the replay at the virtual time of each frame.
+class ReplayFrameTimer : public FrameTimer {
+public:
+  ReplayFrameTimer() {
+    m_running = false;
+  }
+
+  bool Start( uint32_t period_us, Callback callback, void* ptr_argument ) override {
+    m_period_us    = period_us;
+    m_callback     = callback;
+    m_ptr_argument = ptr_argument;
+    m_next_us      = micros() + period_us;
+    m_running      = true;
+    return true;
+  }
+
+  void Stop() override {
+    m_running = false;
+  }
+
+  uint64_t NowUs() override {
+    return micros();
+  }
+
+  // Time of the next frame, 0 if stopped.
+  uint64_t GetNextUs() const {
+    return m_running ? m_next_us : 0;
+  }
+
+  void Fire() {
+    m_next_us += m_period_us;
+    m_callback( m_ptr_argument );
+  }
+
+private:
+  bool     m_running;
+  uint32_t m_period_us;
+  uint64_t m_next_us;
+  Callback m_callback;
+  void*    m_ptr_argument;
+};
+
+// Sockets the captured sources send from.  Art-Net ones are bound to port 6454, so a unicast ArtPollReply to the
+// source comes back to the replay instead of the engine's socket.
+class ReplaySenders {
+public:
+  ~ReplaySenders() {
+    for( auto& entry : m_sockets ) {
+      close( entry.second );
+    }
+  }
+
+  // 127.b.c.d for a.b.c.d, never the engine's 127.0.0.1.
+  static uint32_t MapSource( uint32_t source_ip ) {
+    uint32_t mapped = ( ntohl( source_ip ) & 0x00FFFFFF ) | 0x7F000000;
+    return htonl( mapped == REPLAY_LOOPBACK_IP ? REPLAY_LOOPBACK_IP + 1 : mapped );
+  }
+
+  int GetSocket( uint32_t source_ip, uint16_t port ) {
+    uint64_t key = (uint64_t)source_ip << 16 | port;
+    auto     it  = m_sockets.find( key );
+    if( it != m_sockets.end() ) {
+      return it->second;
+    }
+
+    int                sock   = socket( AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0 );
+    int                enable = 1;
+    struct sockaddr_in address;
+    memset( &address, 0, sizeof( address ) );
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = source_ip;
+    address.sin_port        = htons( port == ARTNET_UDP_PORT ? ARTNET_UDP_PORT : 0 );
+    setsockopt( sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof( enable ) );
+    if( sock < 0 || bind( sock, (struct sockaddr*)&address, sizeof( address ) ) != 0 ) {
+      printf( "FAIL no socket on %s:%d\n", IPAddress( source_ip ).toString().c_str(), ntohs( address.sin_port ) );
+      if( sock >= 0 ) {
+        close( sock );
+      }
+      return -1;
+    }
+    m_sockets[ key ] = sock;
+    return sock;
+  }
+
+  // Takes every datagram the engine sent to the Art-Net senders.
+  template< typename Function > void ReceiveReplies( Function on_reply ) {
+    uint8_t buffer[ 1500 ];
+    for( auto& entry : m_sockets ) {
+      if( ( entry.first & 0xFFFF ) != ARTNET_UDP_PORT ) {
+        continue;
+      }
+      ssize_t length;
+      while( ( length = recv( entry.second, buffer, sizeof( buffer ), 0 ) ) >= 0 ) {
+        on_reply( (uint32_t)( entry.first >> 16 ), buffer, (int)length );
+      }
+    }
+  }
+
+private:
+  std::map< uint64_t, int > m_sockets;
+};
+
+static const char* ArtNetOpCodeName( const uint8_t* ptr_payload, int length ) {
+  if( length < ARTNET_PACKET_MINSIZE_HEADER || memcmp( ptr_payload, ARTNET_HEADER_ID, sizeof( ARTNET_HEADER_ID ) ) != 0 ) {
+    return "not-Art-Net";
+  }
+  switch( ( (const ArtNetPacketHeader*)ptr_payload )->m_OpCode ) {
+    case ARTNET_OPCODE_POLL:      return "ArtPoll";
+    case ARTNET_OPCODE_POLLREPLY: return "ArtPollReply";
+    case ARTNET_OPCODE_DMX:       return "ArtDmx";
+    case ARTNET_OPCODE_SYNC:      return "ArtSync";
+    case ARTNET_OPCODE_ADDRESS:   return "ArtAddress";
+    case ARTNET_OPCODE_COMMAND:   return "ArtCommand";
+    case ARTNET_OPCODE_IPPROG:    return "ArtIpProg";
+    case ARTNET_OPCODE_TIMECODE:  return "ArtTimeCode";
+    default:                      return "ArtOther";
+  }
+}
+
+static uint32_t Fnv1a( const uint8_t* ptr_data, size_t size ) {
+  uint32_t hash = 2166136261u;
+  for( size_t i = 0; i < size; i++ ) {
+    hash = ( hash ^ ptr_data[ i ] ) * 16777619u;
+  }
+  return hash;
+}
+
+// The log compared against expected.txt.
+class ReplayLog {
+public:
+  ReplayLog() {
+    m_sent_count = 0;
+    m_frame_hash = 0;
+    m_frame_size = 0;
+  }
+
+  void Line( uint64_t time_us, const char* ptr_format, ... ) __attribute__( ( format( printf, 3, 4 ) ) ) {
+    char    text[ 256 ];
+    va_list arguments;
+    va_start( arguments, ptr_format );
+    vsnprintf( text, sizeof( text ), ptr_format, arguments );
+    va_end( arguments );
+
+    char time_text[ 32 ];
+    snprintf( time_text, sizeof( time_text ), "%llu.%06llu ", (unsigned long long)( time_us / 1000000 ), (unsigned long long)( time_us % 1000000 ) );
+    m_text += time_text;
+    m_text += text;
+    m_text += '\n';
+  }
+
+  // A line when the DMX output changes, not for every frame.
+  void CheckOutput( uint64_t time_us ) {
+    unsigned long sent_count = HostDmxGetSentCount();
+    if( sent_count == m_sent_count ) {
+      return;
+    }
+    m_sent_count = sent_count;
+
+    size_t         size;
+    const uint8_t* ptr_frame = HostDmxGetSentFrame( &size );
+    uint32_t       hash      = Fnv1a( ptr_frame, size );
+    if( hash == m_frame_hash && size == m_frame_size ) {
+      return;
+    }
+    m_frame_hash = hash;
+    m_frame_size = size;
+
+    // Start code, then the first few slots to make a diff readable.
+    std::string slots;
+    for( size_t i = 1; i < size && i <= 8; i++ ) {
+      slots += " " + std::to_string( ptr_frame[ i ] );
+    }
+    this->Line( time_us, "dmx frame %lu, %d slots, fnv1a %08x, start code %d, slots 1-8%s", sent_count, (int)size - 1, hash,
+                size > 0 ? ptr_frame[ 0 ] : -1, slots.c_str() );
+  }
+
+  const std::string& GetText() const {
+    return m_text;
+  }
+
+private:
+  std::string   m_text;
+  unsigned long m_sent_count;
+  uint32_t      m_frame_hash;
+  size_t        m_frame_size;
+};
+
+class Replay {
+public:
+  Replay( ESP32Artnet2DMX* ptr_engine, ReplayFrameTimer* ptr_timer ) : m_ptr_engine( ptr_engine ), m_ptr_timer( ptr_timer ) {
+    m_time_us = REPLAY_START_US;
+  }
+
+  // loop() & the frame timer, in time order, up to time_us.
+  void RunUntil( uint64_t time_us ) {
+    uint64_t next_us;
+    while( ( next_us = m_ptr_timer->GetNextUs() ) != 0 && next_us <= time_us ) {
+      this->SetTime( next_us );
+      m_ptr_engine->Update();
+      m_Log.CheckOutput( this->GetTime() );
+      if( m_ptr_timer->GetNextUs() == next_us ) {
+        m_ptr_timer->Fire();
+        m_Log.CheckOutput( this->GetTime() );
+      }
+    }
+    this->SetTime( time_us );
+  }
+
+  // Sends one datagram, then runs loop() until the engine has handled or rejected it.
+  bool Send( const CapturedDatagram& datagram ) {
+    unsigned long allocations = AllocTracker::GetHotPathAllocationCount();
+    this->RunUntil( REPLAY_START_US + datagram.m_time_us );
+
+    const uint8_t* ptr_payload = datagram.m_payload.data();
+    int            length      = datagram.m_payload.size();
+    uint32_t       source_ip   = ReplaySenders::MapSource( datagram.m_source_ip );
+    bool           is_artnet   = ( datagram.m_port == ARTNET_UDP_PORT );
+    std::string    name        = is_artnet ? ArtNetOpCodeName( ptr_payload, length ) : "E1.31";
+    std::string    from        = IPAddress( source_ip ).toString().c_str();
+
+    if( !is_artnet && !m_sacn_enabled ) {
+      m_Log.Line( this->GetTime(), "%s %s %d bytes from %s not sent, sACN is disabled", "sacn", name.c_str(), length, from.c_str() );
+      return true;
+    }
+
+    int sock = m_Senders.GetSocket( source_ip, datagram.m_port );
+    if( sock < 0 ) {
+      return false;
+    }
+
+    const NodeStats&   stats    = m_ptr_engine->GetNodeStats();
+    unsigned long      queued   = stats.m_ring_dequeued;
+    unsigned long      rejected = stats.m_artnet_rejected_count;
+    struct sockaddr_in address;
+    memset( &address, 0, sizeof( address ) );
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl( REPLAY_LOOPBACK_IP );
+    address.sin_port        = htons( datagram.m_port );
+    if( sendto( sock, ptr_payload, length, 0, (struct sockaddr*)&address, sizeof( address ) ) != length ) {
+      printf( "FAIL sending %d bytes from %s\n", length, from.c_str() );
+      return false;
+    }
+
+    auto wait_start = std::chrono::steady_clock::now();
+    while( stats.m_ring_dequeued == queued && stats.m_artnet_rejected_count == rejected ) {
+      if( std::chrono::steady_clock::now() - wait_start > std::chrono::milliseconds( REPLAY_WAIT_MS ) ) {
+        printf( "FAIL %s from %s at %.6f s never reached the engine\n", name.c_str(), from.c_str(), datagram.m_time_us / 1e6 );
+        return false;
+      }
+      std::this_thread::yield();
+      m_ptr_engine->Update();
+    }
+
+    m_Log.Line( this->GetTime(), "%s %s %d bytes from %s %s", is_artnet ? "artnet" : "sacn", name.c_str(), length, from.c_str(),
+                stats.m_ring_dequeued != queued ? "handled" : "rejected on the header" );
+    m_Log.CheckOutput( this->GetTime() );
+    if( AllocTracker::GetHotPathAllocationCount() != allocations ) {
+      printf( "FAIL %lu allocations on the hot path up to %s from %s at %.6f s\n", AllocTracker::GetHotPathAllocationCount() - allocations,
+              name.c_str(), from.c_str(), datagram.m_time_us / 1e6 );
+      return false;
+    }
+
+    // Loopback queues the replies before sendto() returns.
+    m_Senders.ReceiveReplies( [ this ]( uint32_t target_ip, const uint8_t* ptr_reply, int reply_length ) {
+      m_Log.Line( this->GetTime(), "reply %s %d bytes to %s", ArtNetOpCodeName( ptr_reply, reply_length ), reply_length,
+                  IPAddress( target_ip ).toString().c_str() );
+    } );
+    return true;
+  }
+
+  // The counters a datagram can end up in, once at the end.
+  void LogStats() {
+    const NodeStats& stats = m_ptr_engine->GetNodeStats();
+    m_Log.Line( this->GetTime(), "artnet rejected source %lu, rejected universe %lu, sync %lu", stats.m_artnet_rejected_source,
+                stats.m_artnet_rejected_universe, stats.m_sync_count );
+    m_Log.Line( this->GetTime(), "sacn packets %lu, discarded universe %lu, discarded priority %lu, invalid %lu, terminated %lu",
+                stats.m_sacn_packets, stats.m_sacn_discarded_universe, stats.m_sacn_discarded_priority, stats.m_sacn_invalid,
+                stats.m_sacn_terminated );
+    m_Log.Line( this->GetTime(), "dmx frames %lu", stats.m_dmx_frames );
+  }
+
+  void SetSacnEnabled( bool sacn_enabled ) {
+    m_sacn_enabled = sacn_enabled;
+  }
+
+  const std::string& GetLog() const {
+    return m_Log.GetText();
+  }
+
+private:
+  void SetTime( uint64_t time_us ) {
+    m_time_us = time_us;
+    HostClockSet( time_us );
+  }
+
+  uint64_t GetTime() const {
+    return m_time_us - REPLAY_START_US;
+  }
+
+  ESP32Artnet2DMX*  m_ptr_engine;
+  ReplayFrameTimer* m_ptr_timer;
+  ReplaySenders     m_Senders;
+  ReplayLog         m_Log;
+  uint64_t          m_time_us;
+  bool              m_sacn_enabled;
+};
+
+// The engine must be linked with the malloc() wrappers, or a String on the hot path would go unseen.
+static bool CheckAllocTracker() {
+  unsigned long allocations = AllocTracker::GetHotPathAllocationCount();
+  AllocTracker::EnterHotPath();
+  void* volatile ptr = malloc( 16 );
+  ptr = realloc( ptr, 4096 );
+  free( ptr );
+  AllocTracker::LeaveHotPath();
+  if( AllocTracker::GetHotPathAllocationCount() - allocations != 2 ) {
+    printf( "FAIL malloc() & realloc() are not counted, the engine needs ALLOC_TRACKER_WRAP_MALLOC & -Wl,--wrap\n" );
+    return false;
+  }
+  return true;
+}
+
+// Prints the first line that differs.
+static bool CompareLog( const std::string& log, const std::string& expected ) {
+  std::istringstream log_lines( log );
+  std::istringstream expected_lines( expected );
+  std::string        log_line;
+  std::string        expected_line;
+  for( int line = 1;; line++ ) {
+    bool has_log      = (bool)std::getline( log_lines, log_line );
+    bool has_expected = (bool)std::getline( expected_lines, expected_line );
+    if( !has_log && !has_expected ) {
+      return true;
+    }
+    if( !has_log || !has_expected || log_line != expected_line ) {
+      printf( "FAIL line %d\n  expected: %s\n  replayed: %s\n", line, has_expected ? expected_line.c_str() : "( end )",
+              has_log ? log_line.c_str() : "( end )" );
+      return false;
+    }
+  }
+}
+
+int main( int argc, char** argv ) {
+  if( argc < 2 || ( argc == 3 && strcmp( argv[ 2 ], "--update" ) != 0 ) || argc > 3 ) {
+    printf( "test_replay <case directory> [ --update ]\n" );
+    return 1;
+  }
+  std::string directory = argv[ 1 ];
+  bool        update    = ( argc == 3 );
+
+  std::vector< CapturedDatagram > datagrams;
+  if( !CheckAllocTracker() || !ReadCapture( directory + "/capture.pcap", &datagrams ) ) {
+    printf( "FAILED\n" );
+    return 1;
+  }
+
+  // The node's LittleFS, the replay never writes to the case directory.
+  LittleFS.SetHostRoot( directory.c_str() );
+  DynamicJsonDocument doc( 32768 );
+  File                config = LittleFS.open( "/config_adapter.json", "r" );
+  if( !config || deserializeJson( doc, config ) ) {
+    printf( "FAIL %s/config_adapter.json missing or not valid\n", directory.c_str() );
+    printf( "FAILED\n" );
+    return 1;
+  }
+
+  // Not deleted, the receive & logger tasks are threads that end with the process.
+  ReplayFrameTimer* ptr_timer  = new ReplayFrameTimer();
+  ESP32Artnet2DMX*  ptr_engine = new ESP32Artnet2DMX();
+  ptr_engine->SetFrameTimer( ptr_timer );
+  ptr_engine->Init();
+
+  // Benchmarks in Init() need a running clock, from here time only moves with the capture.
+  Replay replay( ptr_engine, ptr_timer );
+  replay.SetSacnEnabled( doc[ "sacn_enabled" ] | false );
+  replay.RunUntil( REPLAY_START_US );
+  ptr_engine->Update();
+
+  bool passed = ptr_engine->IsStarted();
+  if( !passed ) {
+    printf( "FAIL the engine didn't start\n" );
+  }
+  for( size_t i = 0; i < datagrams.size() && passed; i++ ) {
+    passed = replay.Send( datagrams[ i ] );
+  }
+  if( passed ) {
+    unsigned long allocations = AllocTracker::GetHotPathAllocationCount();
+    uint64_t      end_us      = REPLAY_START_US + ( datagrams.empty() ? 0 : datagrams.back().m_time_us ) + REPLAY_TAIL_US;
+    replay.RunUntil( end_us );
+    replay.LogStats();
+    if( AllocTracker::GetHotPathAllocationCount() != allocations ) {
+      printf( "FAIL %lu allocations on the hot path after the last datagram\n", AllocTracker::GetHotPathAllocationCount() - allocations );
+      passed = false;
+    }
+  }
+  ptr_engine->Stop();
+
+  std::string expected_filename = directory + "/expected.txt";
+  if( passed && update ) {
+    std::ofstream expected_file( expected_filename );
+    expected_file << replay.GetLog();
+    printf( "%s written, %d datagrams\n", expected_filename.c_str(), (int)datagrams.size() );
+  } else if( passed ) {
+    std::ifstream expected_file( expected_filename );
+    std::string   expected( ( std::istreambuf_iterator< char >( expected_file ) ), std::istreambuf_iterator< char >() );
+    if( !expected_file ) {
+      printf( "FAIL no %s, run with --update to create it\n", expected_filename.c_str() );
+      passed = false;
+    } else {
+      passed = CompareLog( replay.GetLog(), expected );
+    }
+    printf( "%d datagrams replayed\n", (int)datagrams.size() );
+  }
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
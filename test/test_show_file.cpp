@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <vector>
+#include "ShowRecorder.h"
+#include "ShowPlayer.h"
+
+// Round trip of the show file format: frames go through ShowRecorder into a file on the LittleFS stub & are played
+// back by ShowPlayer one frame time at a time, every slot checked against the frame that was recorded.  Covers
+// keyframes & delta runs, the recorder's write buffer wrapping & overflowing between Flush() calls, & corrupt
+// files the player must stop on.
+
+#define TEST_FILE        "/test_show.bin"
+#define TEST_START_MS    1000000
+#define TEST_FRAME_MS    25
+#define TEST_FRAMES      400     // 10 s, so keyframes are also written for SHOWFILE_KEYFRAME_INTERVAL_MS.
+
+struct RecordedFrame {
+  uint32_t m_time_ms;            // Since the start of the recording.
+  uint8_t  m_slots[ SHOWFILE_SLOTS_MAX ];
+};
+
+struct FileFrames {
+  int    m_keyframes;
+  int    m_deltas;
+  size_t m_delta_bytes;
+};
+
+// Every 50th frame changes all slots, the rest change a few slots with small gaps between them or nothing.
+static void BuildFrame( int frame, uint8_t* slots ) {
+  if( frame % 50 == 0 ) {
+    for( int i = 0; i < SHOWFILE_SLOTS_MAX; i++ ) {
+      slots[ i ] = (uint8_t)( frame + i );
+    }
+    return;
+  }
+  if( frame % 7 == 3 ) {
+    return;
+  }
+  int slot = ( frame * 37 ) % ( SHOWFILE_SLOTS_MAX - 8 );
+  slots[ slot ]    += 1;
+  slots[ slot + 1 ] = (uint8_t)frame;
+  slots[ slot + 4 ] = (uint8_t)( frame * 3 );
+  slots[ SHOWFILE_SLOTS_MAX - 1 - frame % 3 ] ^= 0x55;
+}
+
+static void RecordFrame( ShowRecorder* ptr_recorder, int frame, const uint8_t* slots, std::vector< RecordedFrame >* ptr_frames ) {
+  unsigned long frame_count = ptr_recorder->GetFrameCount();
+  uint32_t      time_ms     = frame * TEST_FRAME_MS;
+  ptr_recorder->RecordFrame( slots, TEST_START_MS + time_ms );
+
+  // Frames that didn't change or didn't fit in the write buffer aren't in the file.
+  if( ptr_recorder->GetFrameCount() != frame_count ) {
+    RecordedFrame recorded;
+    recorded.m_time_ms = time_ms;
+    memcpy( recorded.m_slots, slots, SHOWFILE_SLOTS_MAX );
+    ptr_frames->push_back( recorded );
+  }
+}
+
+static FileFrames CountFrames() {
+  FileFrames frames = { 0, 0, 0 };
+  File       file   = LittleFS.open( TEST_FILE, "r" );
+  file.seek( sizeof( ShowFileHeader ), SeekSet );
+
+  ShowFileFrameHeader frame_header;
+  while( file.read( (uint8_t*)&frame_header, sizeof( frame_header ) ) == sizeof( frame_header ) ) {
+    if( frame_header.m_Type == SHOWFILE_FRAME_KEY ) {
+      frames.m_keyframes++;
+    } else if( frame_header.m_Length > 0 ) {
+      frames.m_deltas++;
+      frames.m_delta_bytes += frame_header.m_Length;
+    }
+    file.seek( frame_header.m_Length, SeekCur );
+  }
+  return frames;
+}
+
+// Plays the file at each recorded frame's time.  Returns the number of frames that matched, from the start.
+static size_t Play( const char* ptr_name, const std::vector< RecordedFrame >& frames ) {
+  ShowPlayer player;
+  uint8_t    slots[ SHOWFILE_SLOTS_MAX ];
+  memset( slots, 0, sizeof( slots ) );
+
+  HostClockSet( (uint64_t)TEST_START_MS * 1000 );
+  if( !player.Start( TEST_FILE, false ) ) {
+    printf( "FAIL %s, the player didn't start\n", ptr_name );
+    return 0;
+  }
+
+  for( size_t i = 0; i < frames.size(); i++ ) {
+    player.Update( TEST_START_MS + frames[ i ].m_time_ms, slots );
+    if( memcmp( slots, frames[ i ].m_slots, SHOWFILE_SLOTS_MAX ) != 0 ) {
+      return i;
+    }
+    if( !player.IsPlaying() ) {
+      return i;
+    }
+  }
+  return frames.size();
+}
+
+static bool TestFullAndDelta() {
+  ShowRecorder                 recorder;
+  std::vector< RecordedFrame > frames;
+  uint8_t                      slots[ SHOWFILE_SLOTS_MAX ];
+  memset( slots, 0, sizeof( slots ) );
+
+  HostClockSet( (uint64_t)TEST_START_MS * 1000 );
+  if( !recorder.Start( TEST_FILE ) ) {
+    printf( "FAIL full & delta, the recorder didn't start\n" );
+    return false;
+  }
+  for( int frame = 0; frame < TEST_FRAMES; frame++ ) {
+    BuildFrame( frame, slots );
+    RecordFrame( &recorder, frame, slots, &frames );
+    recorder.Flush();
+  }
+  HostClockSet( (uint64_t)( TEST_START_MS + TEST_FRAMES * TEST_FRAME_MS ) * 1000 );
+  recorder.Stop();
+
+  FileFrames file_frames = CountFrames();
+  bool       passed      = true;
+  if( recorder.GetOverflowCount() != 0 || frames.size() != recorder.GetFrameCount() ) {
+    printf( "FAIL full & delta, %lu overflows, %lu frames recorded of %d\n", recorder.GetOverflowCount(), recorder.GetFrameCount(),
+            (int)frames.size() );
+    passed = false;
+  }
+  // A keyframe for every full change & one more inside each gap longer than the keyframe interval, deltas for the rest.
+  int keyframes_min = TEST_FRAMES / 50 + 1;
+  int keyframes_max = keyframes_min + TEST_FRAMES * TEST_FRAME_MS / SHOWFILE_KEYFRAME_INTERVAL_MS + 1;
+  if( file_frames.m_keyframes < keyframes_min || file_frames.m_keyframes > keyframes_max ||
+      file_frames.m_keyframes + file_frames.m_deltas != (int)frames.size() ) {
+    printf( "FAIL full & delta, %d keyframes & %d deltas for %d frames\n", file_frames.m_keyframes, file_frames.m_deltas, (int)frames.size() );
+    passed = false;
+  }
+  // The runs of the few changed slots & their merged gaps, not whole frames.
+  if( file_frames.m_deltas > 0 && file_frames.m_delta_bytes / file_frames.m_deltas > 2 * sizeof( ShowFileRun ) + 8 ) {
+    printf( "FAIL full & delta, %d bytes per delta\n", (int)( file_frames.m_delta_bytes / file_frames.m_deltas ) );
+    passed = false;
+  }
+
+  size_t played = Play( "full & delta", frames );
+  if( played != frames.size() ) {
+    printf( "FAIL full & delta, frame %d of %d played back different\n", (int)played, (int)frames.size() );
+    passed = false;
+  }
+  return passed;
+}
+
+static bool TestRingWrap() {
+  ShowRecorder                 recorder;
+  std::vector< RecordedFrame > frames;
+  uint8_t                      slots[ SHOWFILE_SLOTS_MAX ];
+
+  HostClockSet( (uint64_t)TEST_START_MS * 1000 );
+  if( !recorder.Start( TEST_FILE ) ) {
+    printf( "FAIL ring wrap, the recorder didn't start\n" );
+    return false;
+  }
+
+  // Only full changes, so every record is a keyframe of SHOWFILE_RECORD_MAXSIZE bytes & records straddle the end of
+  // the write buffer.  First without Flush() until it overflows, then two records per Flush() of
+  // SHOWRECORDER_FLUSH_CHUNK, so the buffer stays nearly full while it wraps.
+  int frame = 0;
+  while( recorder.GetOverflowCount() < 3 ) {
+    for( int i = 0; i < SHOWFILE_SLOTS_MAX; i++ ) {
+      slots[ i ] = (uint8_t)( frame * 5 + i );
+    }
+    RecordFrame( &recorder, frame++, slots, &frames );
+  }
+  int frames_first = frame;
+  for( ; frame < frames_first + TEST_FRAMES; frame++ ) {
+    for( int i = 0; i < SHOWFILE_SLOTS_MAX; i++ ) {
+      slots[ i ] = (uint8_t)( frame * 5 + i );
+    }
+    RecordFrame( &recorder, frame, slots, &frames );
+    if( frame % 2 == 1 ) {
+      recorder.Flush();
+    }
+  }
+  HostClockSet( (uint64_t)( TEST_START_MS + frame * TEST_FRAME_MS ) * 1000 );
+  recorder.Stop();
+
+  bool          passed         = true;
+  unsigned long frames_dropped = frame - frames.size();
+  if( recorder.GetOverflowCount() != frames_dropped || frames.size() != recorder.GetFrameCount() ) {
+    printf( "FAIL ring wrap, %lu overflows for %lu frames dropped\n", recorder.GetOverflowCount(), frames_dropped );
+    passed = false;
+  }
+  if( recorder.GetBytesWritten() < 4 * SHOWRECORDER_BUFFER_SIZE ) {
+    printf( "FAIL ring wrap, %lu bytes written\n", recorder.GetBytesWritten() );
+    passed = false;
+  }
+  if( LittleFS.open( TEST_FILE, "r" ).size() != recorder.GetBytesWritten() ) {
+    printf( "FAIL ring wrap, the file has %d of %lu bytes\n", (int)LittleFS.open( TEST_FILE, "r" ).size(), recorder.GetBytesWritten() );
+    passed = false;
+  }
+
+  size_t played = Play( "ring wrap", frames );
+  if( played != frames.size() ) {
+    printf( "FAIL ring wrap, frame %d of %d played back different\n", (int)played, (int)frames.size() );
+    passed = false;
+  }
+  return passed;
+}
+
+// Records a short show, then breaks the frame at frame_corrupt with corrupt().  Playback must match up to it & stop there.
+static bool TestCorrupt( const char* ptr_name, void ( *corrupt )( File& file, const ShowFileFrameHeader& frame_header ) ) {
+  const size_t                 frame_corrupt = 6;
+  ShowRecorder                 recorder;
+  std::vector< RecordedFrame > frames;
+  uint8_t                      slots[ SHOWFILE_SLOTS_MAX ];
+  memset( slots, 0, sizeof( slots ) );
+
+  HostClockSet( (uint64_t)TEST_START_MS * 1000 );
+  recorder.Start( TEST_FILE );
+  for( int frame = 0; frame < 20; frame++ ) {
+    BuildFrame( frame, slots );
+    RecordFrame( &recorder, frame, slots, &frames );
+  }
+  recorder.Stop();
+
+  // Find the frame in the file, then corrupt it in place.  Written files are shared by every File on them.
+  File file = LittleFS.open( TEST_FILE, "r" );
+  file.seek( sizeof( ShowFileHeader ), SeekSet );
+  ShowFileFrameHeader frame_header;
+  for( size_t i = 0; i <= frame_corrupt; i++ ) {
+    file.read( (uint8_t*)&frame_header, sizeof( frame_header ) );
+    if( i < frame_corrupt ) {
+      file.seek( frame_header.m_Length, SeekCur );
+    }
+  }
+  if( frame_header.m_Type != SHOWFILE_FRAME_DELTA ) {
+    printf( "FAIL %s, frame %d isn't a delta\n", ptr_name, (int)frame_corrupt );
+    return false;
+  }
+  file.seek( file.position() - sizeof( frame_header ), SeekSet );
+  corrupt( file, frame_header );
+
+  ShowPlayer player;
+  memset( slots, 0, sizeof( slots ) );
+  HostClockSet( (uint64_t)TEST_START_MS * 1000 );
+  if( !player.Start( TEST_FILE, false ) ) {
+    printf( "FAIL %s, the player didn't start\n", ptr_name );
+    return false;
+  }
+  bool passed = true;
+  for( size_t i = 0; i < frame_corrupt && passed; i++ ) {
+    player.Update( TEST_START_MS + frames[ i ].m_time_ms, slots );
+    if( !player.IsPlaying() || memcmp( slots, frames[ i ].m_slots, SHOWFILE_SLOTS_MAX ) != 0 ) {
+      printf( "FAIL %s, frame %d before the corrupt frame played back different\n", ptr_name, (int)i );
+      passed = false;
+    }
+  }
+  player.Update( TEST_START_MS + frames[ frame_corrupt ].m_time_ms, slots );
+  if( passed && player.IsPlaying() ) {
+    printf( "FAIL %s, still playing after the corrupt frame\n", ptr_name );
+    passed = false;
+  }
+  return passed;
+}
+
+static void CorruptType( File& file, const ShowFileFrameHeader& frame_header ) {
+  ShowFileFrameHeader corrupt_header = frame_header;
+  corrupt_header.m_Type              = 'X';
+  file.write( (const uint8_t*)&corrupt_header, sizeof( corrupt_header ) );
+}
+
+static void CorruptRunSlot( File& file, const ShowFileFrameHeader& frame_header ) {
+  ShowFileRun run;
+  file.seek( sizeof( frame_header ), SeekCur );
+  file.read( (uint8_t*)&run, sizeof( run ) );
+  run.m_Slot = 0;
+  file.seek( file.position() - sizeof( run ), SeekSet );
+  file.write( (const uint8_t*)&run, sizeof( run ) );
+}
+
+static void CorruptRunLength( File& file, const ShowFileFrameHeader& frame_header ) {
+  ShowFileRun run;
+  file.seek( sizeof( frame_header ), SeekCur );
+  file.read( (uint8_t*)&run, sizeof( run ) );
+  run.m_Count = 255;
+  file.seek( file.position() - sizeof( run ), SeekSet );
+  file.write( (const uint8_t*)&run, sizeof( run ) );
+}
+
+static bool TestNotShowFile() {
+  File file = LittleFS.open( TEST_FILE, "w" );
+  file.write( (const uint8_t*)"A2DX", 4 );
+  uint8_t zeros[ sizeof( ShowFileHeader ) ] = {};
+  file.write( zeros, sizeof( zeros ) );
+  file.close();
+
+  ShowPlayer player;
+  if( player.Start( TEST_FILE, false ) || player.IsPlaying() ) {
+    printf( "FAIL not a show file, the player started\n" );
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  bool passed = true;
+  passed &= TestFullAndDelta();
+  passed &= TestRingWrap();
+  passed &= TestCorrupt( "corrupt type", CorruptType );
+  passed &= TestCorrupt( "corrupt run slot", CorruptRunSlot );
+  passed &= TestCorrupt( "corrupt run length", CorruptRunLength );
+  passed &= TestNotShowFile();
+
+  printf( "%s\n", passed ? "PASSED" : "FAILED" );
+  return passed ? 0 : 1;
+}
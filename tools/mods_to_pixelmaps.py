@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+"""
+Finds the channel mods in an ESP32-Artnet2DMX config_mods.json that are really pixel maps, and replaces them.
+
+  mods_to_pixelmaps.py config_mods.json new_config_mods.json
+
+Runs of 'Copy from Art-Net channel' mods that follow a pixel layout become pixel maps : any colour order, RGB(W)
+interleaved or in colour planes, grouped or reversed.  Zig-zag & repeated layouts come out as several maps.
+A mod is only converted when it's the first mod of its channel & no mod copies from that channel, so all the other
+mods still run after the pixel maps exactly as before.  The new config is checked against the old one on random
+Art-Net frames before it's written.
+Refer to tools/pixel_maps.schema.json for the pixel map format & source/PixelMapper.cpp for how maps are applied.
+"""
+
+import itertools
+import json
+import random
+import sys
+
+CHANNELS_MAX     = 512
+PIXEL_MAPS_MAX   = 32
+VERIFY_FRAMES    = 200
+
+NOTHING              = 0
+EQUALS_VALUE         = 1
+ADD_VALUE            = 2
+MINUS_VALUE          = 3
+COPY_FROM_CHANNEL    = 4
+ADD_FROM_CHANNEL     = 5
+MINUS_FROM_CHANNEL   = 6
+ABOVE_0_ADD_VALUE    = 7
+ABOVE_0_MINUS_VALUE  = 8
+COPY_FROM_ARTNET     = 9
+ADD_FROM_ARTNET      = 10
+MINUS_FROM_ARTNET    = 11
+IF_0_ADD_FROM_ARTNET = 12
+
+COMPONENTS = "RGBW"
+
+
+def colour_orders():
+  """Yields every colour order the device accepts."""
+  yield "W"
+  for length in ( 3, 4 ):
+    for order in itertools.permutations( COMPONENTS[ 0 : length ] ):
+      yield "".join( order )
+
+
+def expand_pixel_map( pixel_map ):
+  """Returns [ ( output, input ) ] with 0 based channels, the same as PixelMapper::AddMap()."""
+  order    = pixel_map[ "colour_order" ]
+  count    = pixel_map[ "pixel_count" ]
+  grouping = pixel_map.get( "grouping", 1 )
+  plane    = pixel_map.get( "colour_plane", 0 )
+  width    = pixel_map.get( "zigzag_width", 0 )
+  channels = len( order )
+  components = [ 0 ] if channels == 1 else [ COMPONENTS.index( component ) for component in order ]
+
+  pairs  = []
+  output = pixel_map[ "output_start" ] - 1
+  for _ in range( pixel_map.get( "repeat", 1 ) ):
+    for pixel in range( count ):
+      position = pixel
+      if width > 0 and ( pixel // width ) % 2 == 1:
+        row_start  = ( pixel // width ) * width
+        row_length = min( width, count - row_start )
+        position   = row_start + row_length - 1 - ( pixel - row_start )
+      if pixel_map.get( "reverse", False ):
+        position = count - 1 - position
+      input_pixel = position // grouping
+
+      for component in components:
+        if plane > 0:
+          input = input_pixel + component * plane
+        else:
+          input = input_pixel * channels + component
+        pairs.append( ( output, pixel_map[ "input_start" ] - 1 + input ) )
+        output += 1
+  return pairs
+
+
+def add_value( value, amount ):
+  # Same unsigned arithmetic as the device, amounts above 255 wrap.
+  if value > ( 255 - amount ) % 2**32:
+    return 255
+  return ( value + amount ) & 0xFF
+
+
+def minus_value( value, amount ):
+  if value < amount:
+    return 0
+  return ( value - amount ) & 0xFF
+
+
+def apply_config( config, artnet ):
+  """Returns the DMX output for one merged Art-Net frame, the same as ESP32Artnet2DMX::HandleDMXFrame()."""
+  dmx = bytearray( 513 )
+  if config.get( "copy_artnet_to_dmx", False ):
+    dmx[ 1 : 513 ] = artnet
+
+  for pixel_map in config.get( "pixel_maps", [] ):
+    for output, input in expand_pixel_map( pixel_map ):
+      dmx[ output + 1 ] = artnet[ input ]
+
+  for mod in sorted( config.get( "channel_mods", [] ), key = lambda mod: mod[ "sequence" ] ):
+    channel, mod_type, value = mod[ "channel" ], mod[ "mod_type" ], mod[ "mod_value" ]
+    if channel > 512:
+      continue
+    if mod_type == EQUALS_VALUE:
+      dmx[ channel ] = value & 0xFF
+    elif mod_type == ADD_VALUE:
+      dmx[ channel ] = add_value( dmx[ channel ], value )
+    elif mod_type == MINUS_VALUE:
+      dmx[ channel ] = minus_value( dmx[ channel ], value )
+    elif mod_type == COPY_FROM_CHANNEL:
+      dmx[ channel ] = dmx[ value ]
+    elif mod_type == ADD_FROM_CHANNEL:
+      dmx[ channel ] = min( dmx[ channel ] + dmx[ value ], 255 )
+    elif mod_type == MINUS_FROM_CHANNEL:
+      dmx[ channel ] = max( dmx[ channel ] - dmx[ value ], 0 )
+    elif mod_type == ABOVE_0_ADD_VALUE:
+      if dmx[ channel ] > 0:
+        dmx[ channel ] = add_value( dmx[ channel ], value )
+    elif mod_type == ABOVE_0_MINUS_VALUE:
+      if dmx[ channel ] > 0:
+        dmx[ channel ] = minus_value( dmx[ channel ], value )
+    elif mod_type == COPY_FROM_ARTNET:
+      dmx[ channel ] = artnet[ value - 1 ]
+    elif mod_type == ADD_FROM_ARTNET:
+      dmx[ channel ] = min( dmx[ channel ] + artnet[ value - 1 ], 255 )
+    elif mod_type == MINUS_FROM_ARTNET:
+      dmx[ channel ] = max( dmx[ channel ] - artnet[ value - 1 ], 0 )
+    elif mod_type == IF_0_ADD_FROM_ARTNET:
+      if dmx[ channel ] == 0:
+        dmx[ channel ] = artnet[ value - 1 ]
+  return bytes( dmx )
+
+
+def find_convertible( mods ):
+  """Returns { output channel : ( Art-Net channel, mod ) } of the copy mods a pixel map can replace."""
+  read_channels = set( mod[ "mod_value" ] for mod in mods if mod[ "mod_type" ] in ( COPY_FROM_CHANNEL, ADD_FROM_CHANNEL, MINUS_FROM_CHANNEL ) )
+
+  first_mods = {}
+  for mod in sorted( mods, key = lambda mod: mod[ "sequence" ] ):
+    first_mods.setdefault( mod[ "channel" ], mod )
+
+  convertible = {}
+  for channel, mod in first_mods.items():
+    if mod[ "mod_type" ] != COPY_FROM_ARTNET or not 1 <= channel <= CHANNELS_MAX or not 1 <= mod[ "mod_value" ] <= CHANNELS_MAX:
+      continue
+    if channel in read_channels:
+      continue
+    convertible[ channel ] = ( mod[ "mod_value" ], mod )
+  return convertible
+
+
+def longest_map( sources, output_start, order, planar, reverse ):
+  """Returns ( pixel map, pixel count ) of the longest map of this layout starting at output_start, or None."""
+  channels = len( order )
+  first    = [ sources.get( output_start + k ) for k in range( channels ) ]
+  if None in first:
+    return None
+  components = [ 0 ] if channels == 1 else [ COMPONENTS.index( component ) for component in order ]
+
+  # The component stride follows from the first pixel.
+  if channels == 1 or not planar:
+    plane = 0
+    component_stride = 1
+  else:
+    plane = first[ components.index( 1 ) ] - first[ components.index( 0 ) ]
+    if plane < 1:
+      return None
+    component_stride = plane
+  base = first[ components.index( 0 ) ]
+  if any( first[ k ] != base + components[ k ] * component_stride for k in range( channels ) ):
+    return None
+  pixel_stride = 1 if plane > 0 else channels
+
+  def pixel_sources( pixel ):
+    return [ sources.get( output_start + pixel * channels + k ) for k in range( channels ) ]
+
+  if reverse:
+    grouping = 1
+    step     = -pixel_stride
+  else:
+    grouping = 1
+    while pixel_sources( grouping ) == first:
+      grouping += 1
+    step = pixel_stride
+
+  count = 1
+  while output_start + ( count + 1 ) * channels - 1 <= CHANNELS_MAX:
+    input_pixel = count // grouping
+    expected    = [ base + input_pixel * step + components[ k ] * component_stride for k in range( channels ) ]
+    if min( expected ) < 1 or pixel_sources( count ) != expected:
+      break
+    count += 1
+
+  input_start = base + ( ( count - 1 ) // grouping ) * step if reverse else base
+  pixel_map = {
+    "output_start" : output_start,
+    "pixel_count"  : count,
+    "input_start"  : input_start,
+    "colour_order" : order,
+    "colour_plane" : plane,
+    "grouping"     : grouping,
+    "reverse"      : reverse,
+    "zigzag_width" : 0,
+    "repeat"       : 1,
+  }
+  return pixel_map, count
+
+
+def shorten( pixel_map, count ):
+  shortened = dict( pixel_map, pixel_count = count )
+  if pixel_map[ "reverse" ]:
+    # The first output pixel keeps its Art-Net pixel.
+    stride = 1 if pixel_map[ "colour_plane" ] > 0 else len( pixel_map[ "colour_order" ] )
+    shortened[ "input_start" ] += ( pixel_map[ "pixel_count" ] - count ) * stride
+  return shortened
+
+
+def find_pixel_maps( sources ):
+  """Returns the fewest pixel maps that, with the copy mods left over, cover all of sources."""
+  layouts = [ ( order, planar, reverse ) for order in colour_orders() for planar in ( False, True ) for reverse in ( False, True ) ]
+
+  # best[ channel ] = ( cost, pixel map, channels covered ) from channel to the end.  A map or a leftover mod costs 1.
+  best = [ None ] * ( CHANNELS_MAX + 2 )
+  best[ CHANNELS_MAX + 1 ] = ( 0, None, 1 )
+  for channel in range( CHANNELS_MAX, 0, -1 ):
+    best[ channel ] = ( best[ channel + 1 ][ 0 ] + ( 1 if channel in sources else 0 ), None, 1 )
+    if channel not in sources:
+      continue
+    for order, planar, reverse in layouts:
+      if len( order ) == 1 and planar:
+        continue
+      found = longest_map( sources, channel, order, planar, reverse )
+      if found is None:
+        continue
+      pixel_map, count = found
+      for pixels in range( 1, count + 1 ):
+        covered = pixels * len( order )
+        if covered < 2:
+          continue
+        cost = 1 + best[ channel + covered ][ 0 ]
+        if cost < best[ channel ][ 0 ]:
+          best[ channel ] = ( cost, ( pixel_map, pixels ), covered )
+
+  pixel_maps = []
+  channel    = 1
+  while channel <= CHANNELS_MAX:
+    _, found, covered = best[ channel ]
+    if found is not None:
+      pixel_maps.append( shorten( *found ) )
+    channel += covered
+  return pixel_maps
+
+
+def convert( config ):
+  mods        = config.get( "channel_mods", [] )
+  convertible = find_convertible( mods )
+  sources     = { channel : source for channel, ( source, _ ) in convertible.items() }
+
+  new_maps  = find_pixel_maps( sources )
+  converted = set()
+  for pixel_map in new_maps:
+    for output, input in expand_pixel_map( pixel_map ):
+      if sources.get( output + 1 ) != input + 1:
+        raise AssertionError( "Pixel map at output channel %i doesn't match the mods" % pixel_map[ "output_start" ] )
+      converted.add( id( convertible[ output + 1 ][ 1 ] ) )
+
+  new_config = dict( config )
+  new_config[ "channel_mods" ] = [ mod for mod in mods if id( mod ) not in converted ]
+  new_config[ "pixel_maps" ]   = config.get( "pixel_maps", [] ) + new_maps
+  if len( new_config[ "pixel_maps" ] ) > PIXEL_MAPS_MAX:
+    raise ValueError( "%i pixel maps, the device takes up to %i" % ( len( new_config[ "pixel_maps" ] ), PIXEL_MAPS_MAX ) )
+  return new_config, len( converted ), len( new_maps )
+
+
+def verify( config, new_config ):
+  generator = random.Random( 1 )
+  for frame in range( VERIFY_FRAMES ):
+    # Plenty of zeros, so the 'if 0' & 'above 0' mods take both paths.
+    artnet = bytes( generator.choice( ( 0, 255, generator.randrange( 256 ) ) ) for _ in range( CHANNELS_MAX ) )
+    if apply_config( config, artnet ) != apply_config( new_config, artnet ):
+      raise AssertionError( "Converted config differs from the original on random frame %i" % frame )
+
+
+if __name__ == "__main__":
+  if len( sys.argv ) != 3:
+    print( __doc__ )
+    sys.exit( 1 )
+
+  with open( sys.argv[ 1 ] ) as config_file:
+    config = json.load( config_file )
+
+  new_config, mods_converted, maps_added = convert( config )
+  verify( config, new_config )
+
+  with open( sys.argv[ 2 ], "w" ) as config_file:
+    json.dump( new_config, config_file, indent = 1 )
+
+  print( "%i of %i mods replaced by %i pixel maps (%i channels), %i mods left.  Output identical on %i random frames." % (
+    mods_converted, len( config.get( "channel_mods", [] ) ), maps_added,
+    sum( len( expand_pixel_map( pixel_map ) ) for pixel_map in new_config[ "pixel_maps" ] ),
+    len( new_config[ "channel_mods" ] ), VERIFY_FRAMES ) )
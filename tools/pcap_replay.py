@@ -0,0 +1,436 @@
+#!/usr/bin/env python3
+"""
+Replays the Art-Net packets of a pcap or pcapng capture into an ESP32-Artnet2DMX node & reports what it did with them.
+
+  pcap_replay.py summary capture.pcapng
+  pcap_replay.py frames  capture.pcapng universe frames.csv
+  pcap_replay.py replay  capture.pcapng node_ip [ --speed 1.0 | --fast ] [ --record show.a2ds ]
+  pcap_replay.py corpus  capture.pcapng test/replay/case
+
+summary  lists the Art-Net packets in the capture by OpCode, universe & source, with sequence gaps & the busiest 10 ms.
+frames   writes the ArtDmx frames of a universe as CSV, same layout as showfile_csv.py, to compare against a recording.
+replay   resets the node stats, sends the UDP 6454 payloads to the node with the captured timing ( --speed scales it,
+         --fast sends as fast as possible ), then prints the /stats of the replay: output frames, drops & the timing of each
+         stage.  --record records the node output while replaying & downloads it, the final DMX frame sequence.
+corpus   writes the IPv4 Art-Net & sACN datagrams as the capture.pcap of a test/replay case, which the host test replays
+         through the engine without a node.
+
+The node sees the packets coming from this host, so the source allow list must include it.
+Link types read are Ethernet, Linux cooked ( SLL & SLL2 ), BSD loopback & raw IP, IPv4 & IPv6, fragments are skipped.
+"""
+
+import csv
+import json
+import os
+import socket
+import struct
+import sys
+import time
+import urllib.request
+
+import showfile_csv
+
+ARTNET_PORT       = 6454
+SACN_PORT         = 5568
+ARTNET_ID         = b"Art-Net\x00"
+ARTNET_OP_DMX     = 0x5000
+ARTNET_DMX_HEADER = 18
+ARTNET_OP_NAMES   = { 0x2000: "ArtPoll", 0x2100: "ArtPollReply", 0x5000: "ArtDmx", 0x5200: "ArtSync", 0x6000: "ArtAddress",
+                      0x9700: "ArtTimeCode", 0x2400: "ArtCommand", 0xF800: "ArtIpProg", 0x5100: "ArtNzs" }
+
+LINKTYPE_NULL     = 0
+LINKTYPE_ETHERNET = 1
+LINKTYPE_RAW      = 101
+LINKTYPE_LOOP     = 108
+LINKTYPE_SLL      = 113
+LINKTYPE_IPV4     = 228
+LINKTYPE_IPV6     = 229
+LINKTYPE_SLL2     = 276
+
+PCAP_MAGIC_US     = 0xA1B2C3D4
+PCAP_MAGIC_NS     = 0xA1B23C4D
+PCAPNG_SHB        = 0x0A0D0D0A
+PCAPNG_BYTE_ORDER = 0x1A2B3C4D
+PCAPNG_IDB        = 0x00000001
+PCAPNG_SPB        = 0x00000003
+PCAPNG_EPB        = 0x00000006
+PCAPNG_TSRESOL    = 9
+
+BURST_WINDOW_S    = 0.010
+HTTP_TIMEOUT_S    = 10
+
+
+def read_pcap( data ):
+  """Yields ( time_s, linktype, frame ) of a classic pcap file."""
+  for endian in ( "<", ">" ):
+    magic = struct.unpack_from( endian + "I", data, 0 )[ 0 ]
+    if magic in ( PCAP_MAGIC_US, PCAP_MAGIC_NS ):
+      break
+  else:
+    raise ValueError( "Not a pcap file" )
+
+  resolution = 1e-9 if magic == PCAP_MAGIC_NS else 1e-6
+  linktype   = struct.unpack_from( endian + "I", data, 20 )[ 0 ] & 0x0FFFFFFF
+  record     = struct.Struct( endian + "IIII" )
+  position   = 24
+
+  while position + record.size <= len( data ):
+    seconds, fraction, captured, _ = record.unpack_from( data, position )
+    position += record.size
+    yield seconds + fraction * resolution, linktype, data[ position : position + captured ]
+    position += captured
+
+
+def read_pcapng_options( data, position, end, endian ):
+  """Yields ( code, value ) of the options of a pcapng block."""
+  while position + 4 <= end:
+    code, length = struct.unpack_from( endian + "HH", data, position )
+    position += 4
+    if code == 0:
+      break
+    yield code, data[ position : position + length ]
+    position += ( length + 3 ) & ~3
+
+
+def read_pcapng( data ):
+  """Yields ( time_s, linktype, frame ) of a pcapng file, every section & interface."""
+  endian     = "<"
+  interfaces = []
+  position   = 0
+
+  while position + 12 <= len( data ):
+    block_type = struct.unpack_from( endian + "I", data, position )[ 0 ]
+
+    if block_type == PCAPNG_SHB:
+      # The byte order magic tells the endianness of the section, the block type reads the same either way.
+      endian     = "<" if struct.unpack_from( "<I", data, position + 8 )[ 0 ] == PCAPNG_BYTE_ORDER else ">"
+      interfaces = []
+
+    length = struct.unpack_from( endian + "I", data, position + 4 )[ 0 ]
+    if length < 12 or position + length > len( data ):
+      break
+    body = position + 8
+    end  = position + length - 4
+
+    if block_type == PCAPNG_IDB:
+      linktype   = struct.unpack_from( endian + "H", data, body )[ 0 ]
+      resolution = 1e-6
+      for code, value in read_pcapng_options( data, body + 8, end, endian ):
+        if code == PCAPNG_TSRESOL and value:
+          exponent   = value[ 0 ] & 0x7F
+          resolution = 2.0 ** -exponent if value[ 0 ] & 0x80 else 10.0 ** -exponent
+      interfaces.append( ( linktype, resolution ) )
+    elif block_type == PCAPNG_EPB:
+      interface, high, low, captured, _ = struct.unpack_from( endian + "IIIII", data, body )
+      if interface < len( interfaces ):
+        linktype, resolution = interfaces[ interface ]
+        yield ( ( high << 32 ) | low ) * resolution, linktype, data[ body + 20 : body + 20 + captured ]
+    elif block_type == PCAPNG_SPB and interfaces:
+      # No timestamp, the packets are sent back to back.
+      captured = min( struct.unpack_from( endian + "I", data, body )[ 0 ], end - body - 4 )
+      yield None, interfaces[ 0 ][ 0 ], data[ body + 4 : body + 4 + captured ]
+
+    position += length
+
+
+def read_capture( filename ):
+  with open( filename, "rb" ) as capture_file:
+    data = capture_file.read()
+  if len( data ) >= 4 and struct.unpack_from( "<I", data, 0 )[ 0 ] == PCAPNG_SHB:
+    return read_pcapng( data )
+  return read_pcap( data )
+
+
+def network_layer( linktype, frame ):
+  """Returns ( ethertype, offset ) of the network header in a link layer frame, None if not IP."""
+  if linktype == LINKTYPE_ETHERNET:
+    ethertype, offset = struct.unpack_from( ">H", frame, 12 )[ 0 ], 14
+    while ethertype in ( 0x8100, 0x88A8 ) and offset + 4 <= len( frame ):
+      ethertype, offset = struct.unpack_from( ">H", frame, offset + 2 )[ 0 ], offset + 4
+    return ethertype, offset
+  if linktype == LINKTYPE_SLL:
+    return struct.unpack_from( ">H", frame, 14 )[ 0 ], 16
+  if linktype == LINKTYPE_SLL2:
+    return struct.unpack_from( ">H", frame, 0 )[ 0 ], 20
+  if linktype in ( LINKTYPE_NULL, LINKTYPE_LOOP ):
+    # Address family in host order, 2 is IPv4, 24, 28 or 30 are IPv6 depending on the BSD.
+    family = struct.unpack_from( "<I", frame, 0 )[ 0 ]
+    if family > 0xFFFF:
+      family = struct.unpack_from( ">I", frame, 0 )[ 0 ]
+    return ( 0x0800 if family == 2 else 0x86DD ), 4
+  if linktype in ( LINKTYPE_RAW, LINKTYPE_IPV4, LINKTYPE_IPV6 ):
+    return ( 0x0800 if frame[ 0 ] >> 4 == 4 else 0x86DD ), 0
+  return None
+
+
+def udp_payload( linktype, frame, port ):
+  """Returns ( source_ip, payload ) if the frame is an unfragmented UDP datagram to the port, else None."""
+  try:
+    layer = network_layer( linktype, frame )
+    if layer is None:
+      return None
+    ethertype, offset = layer
+
+    if ethertype == 0x0800:
+      header_length = ( frame[ offset ] & 0x0F ) * 4
+      flags         = struct.unpack_from( ">H", frame, offset + 6 )[ 0 ]
+      if frame[ offset + 9 ] != 17 or flags & 0x3FFF:
+        return None
+      source = socket.inet_ntop( socket.AF_INET, frame[ offset + 12 : offset + 16 ] )
+      offset += header_length
+    elif ethertype == 0x86DD:
+      if frame[ offset + 6 ] != 17:
+        return None
+      source = socket.inet_ntop( socket.AF_INET6, frame[ offset + 8 : offset + 24 ] )
+      offset += 40
+    else:
+      return None
+
+    destination_port, length = struct.unpack_from( ">HH", frame, offset + 2 )
+    if destination_port != port:
+      return None
+    return source, bytes( frame[ offset + 8 : offset + min( length, len( frame ) - offset ) ] )
+  except ( IndexError, struct.error, ValueError ):
+    return None
+
+
+def read_datagrams( filename, ports ):
+  """Returns [ ( time_s, source_ip, port, payload ) ] of the UDP datagrams to the ports, times relative to the first one."""
+  datagrams = []
+  time_last = 0.0
+  for time_s, linktype, frame in read_capture( filename ):
+    for port in ports:
+      datagram = udp_payload( linktype, frame, port )
+      if datagram is not None:
+        break
+    else:
+      continue
+    time_last = time_last if time_s is None else time_s
+    datagrams.append( ( time_last, datagram[ 0 ], port, datagram[ 1 ] ) )
+
+  # Captures merged from several interfaces need not be in time order.
+  datagrams.sort( key = lambda datagram: datagram[ 0 ] )
+  if datagrams:
+    start     = datagrams[ 0 ][ 0 ]
+    datagrams = [ ( time_s - start, source, port, payload ) for time_s, source, port, payload in datagrams ]
+  return datagrams
+
+
+def read_artnet( filename, port = ARTNET_PORT ):
+  """Returns [ ( time_s, source_ip, payload ) ] of the capture, times relative to the first packet."""
+  return [ ( time_s, source, payload ) for time_s, source, _, payload in read_datagrams( filename, ( port, ) ) ]
+
+
+def artnet_opcode( payload ):
+  if len( payload ) < 10 or payload[ 0 : 8 ] != ARTNET_ID:
+    return None
+  return struct.unpack_from( "<H", payload, 8 )[ 0 ]
+
+
+def artnet_dmx( payload ):
+  """Returns ( sequence, universe, data ) of an ArtDmx packet, else None."""
+  if artnet_opcode( payload ) != ARTNET_OP_DMX or len( payload ) < ARTNET_DMX_HEADER:
+    return None
+  sequence = payload[ 12 ]
+  universe = struct.unpack_from( "<H", payload, 14 )[ 0 ]
+  length   = struct.unpack_from( ">H", payload, 16 )[ 0 ]
+  return sequence, universe, payload[ ARTNET_DMX_HEADER : ARTNET_DMX_HEADER + length ]
+
+
+def summary( filename ):
+  packets = read_artnet( filename )
+  if not packets:
+    print( "No UDP %i packets in %s" % ( ARTNET_PORT, filename ) )
+    return
+
+  opcodes   = {}
+  streams   = {}
+  burst_max = 0
+  first     = 0
+  for i, ( time_s, source, payload ) in enumerate( packets ):
+    opcode = artnet_opcode( payload )
+    opcodes[ opcode ] = opcodes.get( opcode, 0 ) + 1
+
+    while packets[ first ][ 0 ] < time_s - BURST_WINDOW_S:
+      first += 1
+    burst_max = max( burst_max, i - first + 1 )
+
+    dmx = artnet_dmx( payload )
+    if dmx is None:
+      continue
+    sequence, universe, _ = dmx
+    stream = streams.setdefault( ( universe, source ), { "packets": 0, "lost": 0, "reordered": 0, "sequence": None } )
+    stream[ "packets" ] += 1
+    # Sequence 0 means the sender doesn't number its packets.
+    if sequence != 0 and stream[ "sequence" ] is not None:
+      step = ( sequence - stream[ "sequence" ] ) % 255
+      if step > 128:
+        stream[ "reordered" ] += 1
+      elif step > 1:
+        stream[ "lost" ] += step - 1
+    if sequence != 0:
+      stream[ "sequence" ] = sequence
+
+  duration = packets[ -1 ][ 0 ]
+  print( "%i packets over %.3f s, at most %i in %i ms" % ( len( packets ), duration, burst_max, BURST_WINDOW_S * 1000 ) )
+  for opcode, count in sorted( opcodes.items(), key = lambda item: -item[ 1 ] ):
+    name = "not Art-Net" if opcode is None else ARTNET_OP_NAMES.get( opcode, "0x%04X" % opcode )
+    print( "  %-12s %i" % ( name, count ) )
+  for ( universe, source ), stream in sorted( streams.items() ):
+    rate = stream[ "packets" ] / duration if duration > 0 else 0
+    print( "  universe %5i from %-15s %6i packets %6.1f Hz, %i lost, %i reordered" % ( universe, source, stream[ "packets" ], rate, stream[ "lost" ], stream[ "reordered" ] ) )
+
+
+def frames( filename, universe, csv_filename ):
+  """Writes the DMX frames of a universe the way the node would put them out, short packets keep the slots above."""
+  slots      = bytearray( showfile_csv.SHOWFILE_SLOTS_MAX )
+  frames_dmx  = []
+  for time_s, _, payload in read_artnet( filename ):
+    dmx = artnet_dmx( payload )
+    if dmx is None or dmx[ 1 ] != universe:
+      continue
+    data = dmx[ 2 ][ 0 : showfile_csv.SHOWFILE_SLOTS_MAX ]
+    slots[ 0 : len( data ) ] = data
+    frames_dmx.append( ( int( round( time_s * 1000 ) ), bytes( slots ) ) )
+
+  with open( csv_filename, "w", newline = "" ) as csv_file:
+    writer = csv.writer( csv_file )
+    writer.writerow( [ "time_ms" ] + [ str( slot ) for slot in range( 1, showfile_csv.SHOWFILE_SLOTS_MAX + 1 ) ] )
+    for time_ms, frame in frames_dmx:
+      writer.writerow( [ time_ms ] + list( frame ) )
+  print( "%i frames of universe %i written to %s" % ( len( frames_dmx ), universe, csv_filename ) )
+
+
+def http( node_ip, path, method = "GET" ):
+  request = urllib.request.Request( "http://%s%s" % ( node_ip, path ), data = b"" if method == "POST" else None, method = method )
+  with urllib.request.urlopen( request, timeout = HTTP_TIMEOUT_S ) as response:
+    return response.read()
+
+
+def stat( stats, section, key ):
+  return stats.get( section, {} ).get( key, 0 )
+
+
+def report( stats, sent, send_failed, elapsed_s ):
+  print( "sent %i packets in %.3f s, %i failed to send" % ( sent, elapsed_s, send_failed ) )
+
+  print( "output" )
+  print( "  frames             %i" % stat( stats, "dmx_output", "frames" ) )
+  print( "  frames late        %i" % stat( stats, "dmx_output", "frames_late" ) )
+  print( "  jitter us p50/p99  %i / %i" % ( stat( stats, "dmx_output", "jitter_us_p50" ), stat( stats, "dmx_output", "jitter_us_p99" ) ) )
+
+  print( "drops" )
+  print( "  socket             %i" % stat( stats, "artnet_socket", "drops" ) )
+  print( "  socket truncated   %i" % stat( stats, "artnet_socket", "truncated" ) )
+  print( "  ring overruns      %i" % stat( stats, "receive_ring", "overruns" ) )
+  print( "  rejected source    %i" % stat( stats, "artnet_receive", "rejected_source" ) )
+  print( "  rejected universe  %i" % stat( stats, "artnet_receive", "rejected_universe" ) )
+  for sequence in stats.get( "sequence", [] ):
+    print( "  universe %5i from %-15s %i lost, %i duplicates, %i reordered" % ( sequence.get( "universe", 0 ), sequence.get( "source_ip", "" ), sequence.get( "lost", 0 ), sequence.get( "duplicates", 0 ), sequence.get( "reordered", 0 ) ) )
+
+  print( "stage timing, us last / max" )
+  print( "  receive ring       %i avg / %i" % ( stat( stats, "receive_ring", "latency_us_avg" ), stat( stats, "receive_ring", "latency_us_max" ) ) )
+  for section, name in ( ( "merge", "merge" ), ( "patch", "patch" ), ( "pixel_maps", "pixel maps" ), ( "channel_mods", "channel mods" ) ):
+    last = "us_last" if section == "merge" else "apply_us_last"
+    print( "  %-18s %i / %i" % ( name, stat( stats, section, last ), stat( stats, section, last.replace( "last", "max" ) ) ) )
+  print( "  artsync            %i avg / %i" % ( stat( stats, "artsync", "latency_us_avg" ), stat( stats, "artsync", "latency_us_max" ) ) )
+
+
+def replay( filename, node_ip, speed, record_filename ):
+  packets = read_artnet( filename )
+  if not packets:
+    print( "No UDP %i packets in %s" % ( ARTNET_PORT, filename ) )
+    return
+
+  http( node_ip, "/reset_stats" )
+  if record_filename:
+    http( node_ip, "/show_record_start", "POST" )
+
+  sock        = socket.socket( socket.AF_INET, socket.SOCK_DGRAM )
+  sent        = 0
+  send_failed = 0
+  start       = time.perf_counter()
+  for time_s, _, payload in packets:
+    if speed > 0:
+      delay = start + time_s / speed - time.perf_counter()
+      if delay > 0:
+        time.sleep( delay )
+    try:
+      sock.sendto( payload, ( node_ip, ARTNET_PORT ) )
+      sent += 1
+    except OSError:
+      send_failed += 1
+  elapsed_s = time.perf_counter() - start
+  sock.close()
+
+  # Let the node put out what is still in the receive ring.
+  time.sleep( 0.5 )
+
+  if record_filename:
+    http( node_ip, "/show_record_stop", "POST" )
+    show = http( node_ip, "/download?file=show.a2ds" )
+    with open( record_filename, "wb" ) as show_file:
+      show_file.write( show )
+    print( "%i frames recorded to %s" % ( sum( 1 for _ in showfile_csv.read_frames( show ) ), record_filename ) )
+
+  report( json.loads( http( node_ip, "/stats" ) ), sent, send_failed, elapsed_s )
+
+
+def ipv4_datagram( source_ip, port, payload ):
+  """Returns an IPv4 UDP datagram from source_ip to 127.0.0.1, the checksums left 0."""
+  length = 28 + len( payload )
+  header = struct.pack( ">BBHHHBBH4s4s", 0x45, 0, length, 0, 0, 64, 17, 0, socket.inet_aton( source_ip ), socket.inet_aton( "127.0.0.1" ) )
+  return header + struct.pack( ">HHHH", port, port, 8 + len( payload ), 0 ) + payload
+
+
+def write_pcap( filename, datagrams ):
+  """Writes [ ( time_s, source_ip, port, payload ) ] as a classic pcap of raw IPv4 datagrams."""
+  with open( filename, "wb" ) as pcap_file:
+    pcap_file.write( struct.pack( "<IHHiIII", PCAP_MAGIC_US, 2, 4, 0, 0, 65535, LINKTYPE_RAW ) )
+    for time_s, source, port, payload in datagrams:
+      frame        = ipv4_datagram( source, port, payload )
+      microseconds = int( round( time_s * 1e6 ) )
+      pcap_file.write( struct.pack( "<IIII", microseconds // 1000000, microseconds % 1000000, len( frame ), len( frame ) ) + frame )
+
+
+def corpus( filename, directory ):
+  """Writes the IPv4 Art-Net & sACN datagrams of the capture to directory/capture.pcap, the input of test/test_replay."""
+  datagrams = [ datagram for datagram in read_datagrams( filename, ( ARTNET_PORT, SACN_PORT ) ) if ":" not in datagram[ 1 ] ]
+  if not datagrams:
+    print( "No IPv4 UDP %i or %i packets in %s" % ( ARTNET_PORT, SACN_PORT, filename ) )
+    return
+  os.makedirs( directory, exist_ok = True )
+  write_pcap( os.path.join( directory, "capture.pcap" ), datagrams )
+  print( "%i datagrams over %.3f s written to %s" % ( len( datagrams ), datagrams[ -1 ][ 0 ], os.path.join( directory, "capture.pcap" ) ) )
+  missing = [ config for config in ( "config_adapter.json", "config_mods.json" ) if not os.path.exists( os.path.join( directory, config ) ) ]
+  if missing:
+    print( "Add %s with the node's settings, then run test_replay %s --update" % ( " & ".join( missing ), directory ) )
+
+
+if __name__ == "__main__":
+  arguments = sys.argv[ 1 : ]
+  if len( arguments ) == 2 and arguments[ 0 ] == "summary":
+    summary( arguments[ 1 ] )
+  elif len( arguments ) == 4 and arguments[ 0 ] == "frames":
+    frames( arguments[ 1 ], int( arguments[ 2 ] ), arguments[ 3 ] )
+  elif len( arguments ) == 3 and arguments[ 0 ] == "corpus":
+    corpus( arguments[ 1 ], arguments[ 2 ] )
+  elif len( arguments ) >= 3 and arguments[ 0 ] == "replay":
+    speed  = 1.0
+    record = None
+    options = arguments[ 3 : ]
+    while options:
+      option = options.pop( 0 )
+      if option == "--fast":
+        speed = 0
+      elif option == "--speed" and options:
+        speed = float( options.pop( 0 ) )
+      elif option == "--record" and options:
+        record = options.pop( 0 )
+      else:
+        print( __doc__ )
+        sys.exit( 1 )
+    replay( arguments[ 1 ], arguments[ 2 ], speed, record )
+  else:
+    print( __doc__ )
+    sys.exit( 1 )
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+Converts ESP32-Artnet2DMX show recordings (show.a2ds) to and from CSV.
+
+  showfile_csv.py to-csv   show.a2ds show.csv
+  showfile_csv.py from-csv show.csv  show.a2ds
+
+CSV layout is one row per recorded frame: time_ms followed by the value of slots 1 to 512.
+Refer to source/ShowFile.h for the binary format.
+"""
+
+import csv
+import struct
+import sys
+
+SHOWFILE_ID                   = b"A2DS"
+SHOWFILE_VERSION              = 1
+SHOWFILE_SLOTS_MAX            = 512
+SHOWFILE_KEYFRAME_INTERVAL_MS = 1000
+SHOWFILE_FRAME_KEY            = 0x4B
+SHOWFILE_FRAME_DELTA          = 0x44
+SHOWFILE_RUN_GAP_MERGE        = 3
+
+HEADER       = struct.Struct( "<4sBBHH6s" )
+FRAME_HEADER = struct.Struct( "<BIH" )
+RUN          = struct.Struct( "<HB" )
+
+
+def read_frames( data ):
+  """Yields ( time_ms, frame_type, slots ) with slots being the full state after each frame."""
+  ident, version, _, slot_count, _, _ = HEADER.unpack_from( data, 0 )
+  if ident != SHOWFILE_ID or version != SHOWFILE_VERSION:
+    raise ValueError( "Not a show file" )
+
+  slots    = bytearray( SHOWFILE_SLOTS_MAX )
+  position = HEADER.size
+
+  while position + FRAME_HEADER.size <= len( data ):
+    frame_type, time_ms, length = FRAME_HEADER.unpack_from( data, position )
+    position += FRAME_HEADER.size
+    frame     = data[ position : position + length ]
+    position += length
+
+    if frame_type == SHOWFILE_FRAME_KEY:
+      count = min( length, SHOWFILE_SLOTS_MAX )
+      slots[ 0 : count ] = frame[ 0 : count ]
+    elif frame_type == SHOWFILE_FRAME_DELTA:
+      offset = 0
+      while offset + RUN.size <= length:
+        slot, count = RUN.unpack_from( frame, offset )
+        offset += RUN.size
+        if slot < 1 or slot + count - 1 > SHOWFILE_SLOTS_MAX or offset + count > length:
+          raise ValueError( "Corrupt delta frame at %i ms" % time_ms )
+        slots[ slot - 1 : slot - 1 + count ] = frame[ offset : offset + count ]
+        offset += count
+    else:
+      raise ValueError( "Unknown frame type 0x%02X at %i ms" % ( frame_type, time_ms ) )
+
+    yield time_ms, frame_type, bytes( slots )
+
+
+def encode_delta( previous, slots ):
+  """Same run building as ShowRecorder::EncodeFrame().  Returns None when larger than a keyframe."""
+  data              = bytearray()
+  run_offset        = None
+  slot_changed_last = -SHOWFILE_RUN_GAP_MERGE - 2
+
+  for i in range( SHOWFILE_SLOTS_MAX ):
+    if slots[ i ] == previous[ i ]:
+      continue
+
+    gap    = i - slot_changed_last - 1
+    extend = run_offset is not None and gap <= SHOWFILE_RUN_GAP_MERGE and data[ run_offset + 2 ] + gap + 1 <= 255
+    needed = gap + 1 if extend else RUN.size + 1
+
+    if len( data ) + needed > SHOWFILE_SLOTS_MAX:
+      return None
+
+    if extend:
+      data += slots[ slot_changed_last + 1 : i + 1 ]
+      data[ run_offset + 2 ] += gap + 1
+    else:
+      run_offset = len( data )
+      data += RUN.pack( i + 1, 1 ) + bytes( [ slots[ i ] ] )
+    slot_changed_last = i
+
+  return bytes( data )
+
+
+def write_frames( frames ):
+  """frames = iterable of ( time_ms, slots ).  Returns the encoded show file."""
+  data              = bytearray( HEADER.pack( SHOWFILE_ID, SHOWFILE_VERSION, 0, SHOWFILE_SLOTS_MAX, SHOWFILE_KEYFRAME_INTERVAL_MS, bytes( 6 ) ) )
+  previous          = None
+  keyframe_last_ms  = 0
+
+  for time_ms, slots in frames:
+    delta = None
+    if previous is not None and time_ms - keyframe_last_ms < SHOWFILE_KEYFRAME_INTERVAL_MS:
+      delta = encode_delta( previous, slots )
+
+    if delta is None:
+      data += FRAME_HEADER.pack( SHOWFILE_FRAME_KEY, time_ms, SHOWFILE_SLOTS_MAX ) + slots
+      keyframe_last_ms = time_ms
+    else:
+      data += FRAME_HEADER.pack( SHOWFILE_FRAME_DELTA, time_ms, len( delta ) ) + delta
+
+    previous = slots
+
+  return bytes( data )
+
+
+def to_csv( show_filename, csv_filename ):
+  with open( show_filename, "rb" ) as show_file:
+    data = show_file.read()
+
+  with open( csv_filename, "w", newline = "" ) as csv_file:
+    writer = csv.writer( csv_file )
+    writer.writerow( [ "time_ms" ] + [ str( slot ) for slot in range( 1, SHOWFILE_SLOTS_MAX + 1 ) ] )
+    for time_ms, _, slots in read_frames( data ):
+      writer.writerow( [ time_ms ] + list( slots ) )
+
+
+def from_csv( csv_filename, show_filename ):
+  frames = []
+  with open( csv_filename, newline = "" ) as csv_file:
+    reader = csv.reader( csv_file )
+    next( reader )
+    for row in reader:
+      if not row:
+        continue
+      values = [ int( value ) for value in row[ 1 : SHOWFILE_SLOTS_MAX + 1 ] ]
+      values += [ 0 ] * ( SHOWFILE_SLOTS_MAX - len( values ) )
+      frames.append( ( int( row[ 0 ] ), bytes( values ) ) )
+
+  frames.sort( key = lambda frame: frame[ 0 ] )
+
+  with open( show_filename, "wb" ) as show_file:
+    show_file.write( write_frames( frames ) )
+
+
+if __name__ == "__main__":
+  if len( sys.argv ) != 4 or sys.argv[ 1 ] not in ( "to-csv", "from-csv" ):
+    print( __doc__ )
+    sys.exit( 1 )
+
+  if sys.argv[ 1 ] == "to-csv":
+    to_csv( sys.argv[ 2 ], sys.argv[ 3 ] )
+  else:
+    from_csv( sys.argv[ 2 ], sys.argv[ 3 ] )